@@ -0,0 +1,148 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <tlo/arena.h>
+#include <tlo/benchmark.h>
+#include <tlo/dllist.h>
+#include <tlo/list.h>
+#include <tlo/map.h>
+#include <tlo/pool.h>
+#include <tlo/schtable.h>
+#include <tlo/sllist.h>
+
+typedef struct Parameters {
+  size_t numElements;
+  TloArena *arena;
+  TloPool *pool;
+} Parameters;
+
+static void pushBack(TloList *list, size_t numElements) {
+  for (size_t i = 0; i < numElements; ++i) {
+    int value = (int)i;
+    tlovListPushBack(list, &value);
+  }
+}
+
+static void insertThenRemoveHalf(TloMap *map, size_t numElements) {
+  for (size_t i = 0; i < numElements; ++i) {
+    int key = (int)i;
+    tlovMapInsert(map, TLO_COPY, &key, TLO_COPY, &key);
+  }
+
+  for (size_t i = 0; i < numElements; i += 2) {
+    int key = (int)i;
+    tlovMapRemove(map, &key);
+  }
+}
+
+static void sllistChurnCStdLib(const void *parameters) {
+  const Parameters *p = parameters;
+  TloSLList llist;
+  tloSLListConstruct(&llist, &tloInt, NULL);
+  pushBack(&llist.list, p->numElements);
+  tlovListDestruct(&llist.list);
+}
+
+static void sllistChurnArena(const void *parameters) {
+  const Parameters *p = parameters;
+  TloSLList llist;
+  tloSLListConstruct(&llist, &tloInt, &p->arena->allocator);
+  pushBack(&llist.list, p->numElements);
+  tloArenaReset(p->arena);
+}
+
+static void sllistChurnPool(const void *parameters) {
+  const Parameters *p = parameters;
+  TloSLList llist;
+  tloSLListConstruct(&llist, &tloInt, &p->pool->allocator);
+  pushBack(&llist.list, p->numElements);
+  tlovListDestruct(&llist.list);
+}
+
+static void dllistChurnCStdLib(const void *parameters) {
+  const Parameters *p = parameters;
+  TloDLList llist;
+  tloDLListConstruct(&llist, &tloInt, NULL);
+  pushBack(&llist.list, p->numElements);
+  tlovListDestruct(&llist.list);
+}
+
+static void dllistChurnArena(const void *parameters) {
+  const Parameters *p = parameters;
+  TloDLList llist;
+  tloDLListConstruct(&llist, &tloInt, &p->arena->allocator);
+  pushBack(&llist.list, p->numElements);
+  tloArenaReset(p->arena);
+}
+
+static void dllistChurnPool(const void *parameters) {
+  const Parameters *p = parameters;
+  TloDLList llist;
+  tloDLListConstruct(&llist, &tloInt, &p->pool->allocator);
+  pushBack(&llist.list, p->numElements);
+  tlovListDestruct(&llist.list);
+}
+
+static void schtableMapChurnCStdLib(const void *parameters) {
+  const Parameters *p = parameters;
+  TloSCHTableMap map;
+  tloSCHTableMapConstruct(&map, &tloInt, &tloInt, NULL);
+  insertThenRemoveHalf(&map.map, p->numElements);
+  tlovMapDestruct(&map.map);
+}
+
+static void schtableMapChurnArena(const void *parameters) {
+  const Parameters *p = parameters;
+  TloSCHTableMap map;
+  tloSCHTableMapConstruct(&map, &tloInt, &tloInt, &p->arena->allocator);
+  insertThenRemoveHalf(&map.map, p->numElements);
+  tloArenaReset(p->arena);
+}
+
+static void schtableMapChurnPool(const void *parameters) {
+  const Parameters *p = parameters;
+  TloSCHTableMap map;
+  tloSCHTableMapConstruct(&map, &tloInt, &tloInt, &p->pool->allocator);
+  insertThenRemoveHalf(&map.map, p->numElements);
+  tlovMapDestruct(&map.map);
+}
+
+int main(int argc, char *argv[]) {
+  if (argc < 3) {
+    printf("usage: %s <num-elements> <num-iterations>\n", argv[0]);
+    return 1;
+  }
+
+  size_t numElements = strtoull(argv[1], NULL, 10);
+  if (numElements < 1) {
+    puts("error: given number of elements is invalid");
+    return 1;
+  }
+
+  int numIterations = atoi(argv[2]);
+  if (numIterations < 1) {
+    puts("error: given number of iterations is invalid");
+    return 1;
+  }
+
+  TloArena arena;
+  tloArenaConstruct(&arena, NULL, 0);
+  TloPool pool;
+  tloPoolConstruct(&pool, NULL);
+  Parameters parameters = {
+      .numElements = numElements, .arena = &arena, .pool = &pool};
+
+  TLO_TIME_TASK(sllistChurnCStdLib, &parameters, numIterations);
+  TLO_TIME_TASK(sllistChurnArena, &parameters, numIterations);
+  TLO_TIME_TASK(sllistChurnPool, &parameters, numIterations);
+
+  TLO_TIME_TASK(dllistChurnCStdLib, &parameters, numIterations);
+  TLO_TIME_TASK(dllistChurnArena, &parameters, numIterations);
+  TLO_TIME_TASK(dllistChurnPool, &parameters, numIterations);
+
+  TLO_TIME_TASK(schtableMapChurnCStdLib, &parameters, numIterations);
+  TLO_TIME_TASK(schtableMapChurnArena, &parameters, numIterations);
+  TLO_TIME_TASK(schtableMapChurnPool, &parameters, numIterations);
+
+  tloPoolDestruct(&pool);
+  tloArenaDestruct(&arena);
+}
@@ -0,0 +1,239 @@
+#include <limits.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <tlo/benchmark.h>
+#include <tlo/bitset.h>
+#include <tlo/schtable.h>
+
+/*
+ * - compares TloBitset against TloSCHTableSet of tloInt as sets of dense
+ *   integer ids: two sets each get numKeys random ids from [0, universe)
+ * - build: inserts one set's ids
+ * - find: looks up every id in [0, universe) in one set
+ * - intersect: makes the intersection of the two sets. the hash set looks up
+ *   each id of one set in the other and inserts the ones found, and the
+ *   bitset copies one set then ANDs the other into it
+ * - also prints how many bytes each set holds once built, without malloc's
+ *   own overhead per allocation
+ */
+static size_t numBytes;
+
+static void *countingMalloc(void *context, size_t size) {
+  (void)context;
+  void *memory = malloc(size);
+  if (memory) {
+    numBytes += size;
+  }
+  return memory;
+}
+
+static void countingFree(void *context, void *memory) {
+  (void)context;
+  free(memory);
+}
+
+static void *countingRealloc(void *context, void *memory, size_t size,
+                             size_t newSize) {
+  (void)context;
+  void *newMemory = realloc(memory, newSize);
+  if (newMemory) {
+    numBytes = numBytes - size + newSize;
+  }
+  return newMemory;
+}
+
+static void countingSizedFree(void *context, void *memory, size_t size) {
+  (void)context;
+  if (memory) {
+    numBytes -= size;
+  }
+  free(memory);
+}
+
+static const TloAllocator countingAllocator = {
+    .malloc = countingMalloc,
+    .free = countingFree,
+    .realloc = countingRealloc,
+    .sizedFree = countingSizedFree};
+
+typedef struct Parameters {
+  size_t numKeys;
+  size_t universe;
+  const int *keys1;
+  const int *keys2;
+  TloSet *hashSet1;
+  TloSet *hashSet2;
+  TloBitset *bitset1;
+  TloBitset *bitset2;
+} Parameters;
+
+static void outOfMemory(void) {
+  puts("error: out of memory");
+  exit(1);
+}
+
+static TloSet *makeHashSet(const int *keys, size_t numKeys) {
+  TloSet *set = (TloSet *)tloSCHTableSetMake(&tloInt, &countingAllocator);
+  if (!set) {
+    outOfMemory();
+  }
+
+  for (size_t i = 0; i < numKeys; ++i) {
+    if (tlovSetInsert(set, &keys[i]) == TLO_ERROR) {
+      outOfMemory();
+    }
+  }
+  return set;
+}
+
+static TloBitset *makeBitset(const int *keys, size_t numKeys) {
+  TloBitset *bitset = tloBitsetMake(0, &countingAllocator);
+  if (!bitset) {
+    outOfMemory();
+  }
+
+  for (size_t i = 0; i < numKeys; ++i) {
+    if (tloBitsetInsert(bitset, (size_t)keys[i]) == TLO_ERROR) {
+      outOfMemory();
+    }
+  }
+  return bitset;
+}
+
+static void hashSetBuild(const void *parameters) {
+  const Parameters *p = parameters;
+  tloSetDelete(makeHashSet(p->keys1, p->numKeys));
+}
+
+static void bitsetBuild(const void *parameters) {
+  const Parameters *p = parameters;
+  tloBitsetDelete(makeBitset(p->keys1, p->numKeys));
+}
+
+static void checkCount(size_t count, size_t expected) {
+  if (count != expected) {
+    puts("error: the sets don't agree");
+    exit(1);
+  }
+}
+
+static void hashSetFind(const void *parameters) {
+  const Parameters *p = parameters;
+  size_t numFound = 0;
+  for (int key = 0; key < (int)p->universe; ++key) {
+    numFound += tlovSetFind(p->hashSet1, &key) != NULL;
+  }
+  checkCount(numFound, tlovSetSize(p->hashSet1));
+}
+
+static void bitsetContains(const void *parameters) {
+  const Parameters *p = parameters;
+  size_t numFound = 0;
+  for (size_t key = 0; key < p->universe; ++key) {
+    numFound += tloBitsetContains(p->bitset1, key);
+  }
+  checkCount(numFound, tloBitsetCount(p->bitset1));
+}
+
+static void hashSetIntersect(const void *parameters) {
+  const Parameters *p = parameters;
+  TloSet *intersection =
+      (TloSet *)tloSCHTableSetMake(&tloInt, &countingAllocator);
+  if (!intersection) {
+    outOfMemory();
+  }
+
+  for (size_t i = 0; i < p->numKeys; ++i) {
+    if (tlovSetFind(p->hashSet2, &p->keys1[i]) &&
+        tlovSetInsert(intersection, &p->keys1[i]) == TLO_ERROR) {
+      outOfMemory();
+    }
+  }
+
+  tloSetDelete(intersection);
+}
+
+static void bitsetAnd(const void *parameters) {
+  const Parameters *p = parameters;
+  TloBitset *intersection = tloBitsetMake(0, &countingAllocator);
+  if (!intersection || tloBitsetOr(intersection, p->bitset1) != TLO_SUCCESS) {
+    outOfMemory();
+  }
+
+  tloBitsetAnd(intersection, p->bitset2);
+  tloBitsetDelete(intersection);
+}
+
+int main(int argc, char *argv[]) {
+  if (argc < 4) {
+    printf("usage: %s <num-keys> <universe> <num-iterations>\n", argv[0]);
+    return 1;
+  }
+
+  size_t numKeys = strtoull(argv[1], NULL, 10);
+  if (numKeys < 1 || numKeys > INT_MAX) {
+    puts("error: given number of keys is invalid");
+    return 1;
+  }
+
+  size_t universe = strtoull(argv[2], NULL, 10);
+  if (universe < 1 || universe > INT_MAX) {
+    puts("error: given universe is invalid");
+    return 1;
+  }
+
+  int numIterations = atoi(argv[3]);
+  if (numIterations < 1) {
+    puts("error: given number of iterations is invalid");
+    return 1;
+  }
+
+  int *keys1 = malloc(numKeys * sizeof(*keys1));
+  int *keys2 = malloc(numKeys * sizeof(*keys2));
+  if (!keys1 || !keys2) {
+    puts("error: out of memory");
+    return 1;
+  }
+
+  uint64_t state = 88172645463325252U;
+  for (size_t i = 0; i < numKeys * 2; ++i) {
+    state ^= state << 13;
+    state ^= state >> 7;
+    state ^= state << 17;
+    int key = (int)((state >> 8) % universe);
+    if (i < numKeys) {
+      keys1[i] = key;
+    } else {
+      keys2[i - numKeys] = key;
+    }
+  }
+
+  Parameters parameters = {.numKeys = numKeys,
+                           .universe = universe,
+                           .keys1 = keys1,
+                           .keys2 = keys2};
+  TLO_TIME_TASK(bitsetBuild, &parameters, numIterations);
+  TLO_TIME_TASK(hashSetBuild, &parameters, numIterations);
+
+  numBytes = 0;
+  parameters.bitset1 = makeBitset(keys1, numKeys);
+  printf("TloBitset bytes     : %zu\n", numBytes);
+  numBytes = 0;
+  parameters.hashSet1 = makeHashSet(keys1, numKeys);
+  printf("TloSCHTableSet bytes: %zu\n", numBytes);
+  parameters.bitset2 = makeBitset(keys2, numKeys);
+  parameters.hashSet2 = makeHashSet(keys2, numKeys);
+
+  TLO_TIME_TASK(bitsetContains, &parameters, numIterations);
+  TLO_TIME_TASK(hashSetFind, &parameters, numIterations);
+  TLO_TIME_TASK(bitsetAnd, &parameters, numIterations);
+  TLO_TIME_TASK(hashSetIntersect, &parameters, numIterations);
+
+  tloSetDelete(parameters.hashSet2);
+  tloBitsetDelete(parameters.bitset2);
+  tloSetDelete(parameters.hashSet1);
+  tloBitsetDelete(parameters.bitset1);
+  free(keys2);
+  free(keys1);
+}
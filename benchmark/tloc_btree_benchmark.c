@@ -0,0 +1,227 @@
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <tlo/benchmark.h>
+#include <tlo/btree.h>
+#include <tlo/flatmap.h>
+#include <tlo/schtable.h>
+
+/*
+ * - inserts, finds, and removes numKeys random uint64_t keys with uint32_t
+ *   values in a TloBTreeMap and a TloSCHTableMap, each in a different order
+ * - then runs numKeys / 100 range scans of about 100 keys each on a
+ *   TloBTreeMap and on a TloFlatMap made from the same keys
+ */
+static size_t u64TypeHash(const void *data, size_t size) {
+  (void)size;
+  const uint64_t *key = data;
+  return (size_t)(*key * UINT64_C(0x9E3779B97F4A7C15));
+}
+
+static bool u64TypeEquals(const void *object1, const void *object2) {
+  const uint64_t *key1 = object1;
+  const uint64_t *key2 = object2;
+  return *key1 == *key2;
+}
+
+static int u64TypeCompare(const void *object1, const void *object2) {
+  uint64_t key1 = *(const uint64_t *)object1;
+  uint64_t key2 = *(const uint64_t *)object2;
+  return key1 < key2 ? -1 : key1 > key2;
+}
+
+static const TloType u64Type = {.size = sizeof(uint64_t),
+                                .equals = u64TypeEquals,
+                                .hash = u64TypeHash,
+                                .compare = u64TypeCompare};
+
+static const TloType u32Type = {.size = sizeof(uint32_t)};
+
+enum { KEYS_PER_SCAN = 100 };
+
+typedef struct Parameters {
+  size_t numKeys;
+  const uint64_t *keys;
+  const uint64_t *lookups;
+  const uint64_t *removals;
+  uint64_t keySpacing;
+} Parameters;
+
+static void insertFindRemove(TloMap *map, const Parameters *p) {
+  if (!map) {
+    puts("error: out of memory");
+    exit(1);
+  }
+
+  for (size_t i = 0; i < p->numKeys; ++i) {
+    uint64_t key = p->keys[i];
+    uint32_t value = (uint32_t)i;
+    tlovMapInsert(map, TLO_COPY, &key, TLO_COPY, &value);
+  }
+
+  for (size_t i = 0; i < p->numKeys; ++i) {
+    tlovMapFind(map, &p->lookups[i]);
+  }
+
+  for (size_t i = 0; i < p->numKeys; ++i) {
+    tlovMapRemove(map, &p->removals[i]);
+  }
+
+  tloMapDelete(map);
+}
+
+static void btreeMapInsertFindRemove(const void *parameters) {
+  insertFindRemove(
+      (TloMap *)tloBTreeMapMake(&u64Type, &u32Type, NULL), parameters);
+}
+
+static void schtableMapInsertFindRemove(const void *parameters) {
+  insertFindRemove(
+      (TloMap *)tloSCHTableMapMake(&u64Type, &u32Type, NULL), parameters);
+}
+
+typedef struct ScanParameters {
+  const Parameters *p;
+  const TloBTreeMap *btree;
+  const TloFlatMap *flatMap;
+} ScanParameters;
+
+// written to, so the scans can't be optimized away
+static volatile uint64_t sink;
+
+// each scan starts at a key's value and ends about KEYS_PER_SCAN keys later
+static void btreeMapRangeScans(const void *parameters) {
+  const ScanParameters *s = parameters;
+  uint64_t sum = 0;
+
+  for (size_t i = 0; i < s->p->numKeys / KEYS_PER_SCAN; ++i) {
+    uint64_t low = s->p->lookups[i];
+    uint64_t high = low + s->p->keySpacing * KEYS_PER_SCAN;
+    TloBTreeCursor cursor;
+    for (tloBTreeMapLowerBound(s->btree, &low, &cursor);
+         !tloBTreeCursorIsEnd(&cursor) &&
+         *(const uint64_t *)tloBTreeCursorKey(&cursor) < high;
+         tloBTreeCursorNext(&cursor)) {
+      sum += *(const uint32_t *)tloBTreeCursorValue(&cursor);
+    }
+  }
+
+  sink = sum;
+}
+
+static void flatMapRangeScans(const void *parameters) {
+  const ScanParameters *s = parameters;
+  uint64_t sum = 0;
+
+  for (size_t i = 0; i < s->p->numKeys / KEYS_PER_SCAN; ++i) {
+    uint64_t low = s->p->lookups[i];
+    uint64_t high = low + s->p->keySpacing * KEYS_PER_SCAN;
+    size_t end = tloFlatMapLowerBound(s->flatMap, &high);
+    for (size_t j = tloFlatMapLowerBound(s->flatMap, &low); j < end; ++j) {
+      sum += *(const uint32_t *)tloFlatMapValue(s->flatMap, j);
+    }
+  }
+
+  sink = sum;
+}
+
+static uint64_t state = 88172645463325252U;
+
+static uint64_t nextRandom(void) {
+  state ^= state << 13;
+  state ^= state >> 7;
+  state ^= state << 17;
+  return state;
+}
+
+static uint64_t *makeShuffledCopy(const uint64_t *keys, size_t numKeys) {
+  uint64_t *copy = malloc(numKeys * sizeof(*copy));
+  if (!copy) {
+    puts("error: out of memory");
+    exit(1);
+  }
+
+  for (size_t i = 0; i < numKeys; ++i) {
+    copy[i] = keys[i];
+  }
+
+  for (size_t i = numKeys - 1; i > 0; --i) {
+    size_t j = (size_t)(nextRandom() % (i + 1));
+    uint64_t key = copy[i];
+    copy[i] = copy[j];
+    copy[j] = key;
+  }
+
+  return copy;
+}
+
+int main(int argc, char *argv[]) {
+  if (argc < 3) {
+    printf("usage: %s <num-keys> <num-iterations>\n", argv[0]);
+    return 1;
+  }
+
+  size_t numKeys = strtoull(argv[1], NULL, 10);
+  if (numKeys < 1 || numKeys > UINT32_MAX) {
+    puts("error: given number of keys is invalid");
+    return 1;
+  }
+
+  int numIterations = atoi(argv[2]);
+  if (numIterations < 1) {
+    puts("error: given number of iterations is invalid");
+    return 1;
+  }
+
+  uint64_t *keys = malloc(numKeys * sizeof(*keys));
+  uint32_t *values = malloc(numKeys * sizeof(*values));
+  if (!keys || !values) {
+    puts("error: out of memory");
+    return 1;
+  }
+
+  // the low bits count up, so the keys never repeat
+  for (size_t i = 0; i < numKeys; ++i) {
+    keys[i] = (nextRandom() << 32) | i;
+    values[i] = (uint32_t)i;
+  }
+
+  uint64_t *lookups = makeShuffledCopy(keys, numKeys);
+  uint64_t *removals = makeShuffledCopy(keys, numKeys);
+  Parameters parameters = {.numKeys = numKeys,
+                           .keys = keys,
+                           .lookups = lookups,
+                           .removals = removals,
+                           .keySpacing = UINT64_MAX / numKeys};
+
+  TLO_TIME_TASK(btreeMapInsertFindRemove, &parameters, numIterations);
+  TLO_TIME_TASK(schtableMapInsertFindRemove, &parameters, numIterations);
+
+  TloBTreeMap *btree = tloBTreeMapMake(&u64Type, &u32Type, NULL);
+  TloFlatMap *flatMap =
+      tloFlatMapMakeFromArrays(&u64Type, &u32Type, NULL, keys, values, numKeys);
+  if (!btree || !flatMap) {
+    puts("error: out of memory");
+    return 1;
+  }
+
+  for (size_t i = 0; i < numKeys; ++i) {
+    if (tlovMapInsert(&btree->map, TLO_COPY, &keys[i], TLO_COPY,
+                      &values[i]) != TLO_SUCCESS) {
+      puts("error: out of memory");
+      return 1;
+    }
+  }
+
+  ScanParameters scanParameters = {
+      .p = &parameters, .btree = btree, .flatMap = flatMap};
+  TLO_TIME_TASK(btreeMapRangeScans, &scanParameters, numIterations);
+  TLO_TIME_TASK(flatMapRangeScans, &scanParameters, numIterations);
+
+  tloMapDelete(&flatMap->map);
+  tloMapDelete(&btree->map);
+  free(removals);
+  free(lookups);
+  free(values);
+  free(keys);
+}
@@ -0,0 +1,223 @@
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <tlo/benchmark.h>
+#include <tlo/flatmap.h>
+#include <tlo/schtable.h>
+
+/*
+ * - compares TloFlatMap against TloSCHTableMap with numKeys random uint64_t
+ *   keys and uint32_t values
+ * - build: the hash table inserts the keys one at a time, and the flat map is
+ *   made from the arrays in one go
+ * - find: looks up every key, in a different order than they were inserted
+ * - also prints how many bytes and allocations each map holds once built.
+ *   malloc's own overhead per allocation isn't counted, which flatters the
+ *   hash table, since it makes 2 allocations per key
+ */
+static size_t numBytes;
+static size_t numAllocations;
+
+static void *countingMalloc(void *context, size_t size) {
+  (void)context;
+  void *memory = malloc(size);
+  if (memory) {
+    numBytes += size;
+    ++numAllocations;
+  }
+  return memory;
+}
+
+static void countingFree(void *context, void *memory) {
+  (void)context;
+  free(memory);
+}
+
+static void *countingRealloc(void *context, void *memory, size_t size,
+                             size_t newSize) {
+  (void)context;
+  void *newMemory = realloc(memory, newSize);
+  if (newMemory) {
+    numBytes = numBytes - size + newSize;
+  }
+  return newMemory;
+}
+
+static void countingSizedFree(void *context, void *memory, size_t size) {
+  (void)context;
+  if (memory) {
+    numBytes -= size;
+    --numAllocations;
+  }
+  free(memory);
+}
+
+static const TloAllocator countingAllocator = {
+    .malloc = countingMalloc,
+    .free = countingFree,
+    .realloc = countingRealloc,
+    .sizedFree = countingSizedFree};
+
+static size_t u64TypeHash(const void *data, size_t size) {
+  (void)size;
+  const uint64_t *key = data;
+  return (size_t)(*key * UINT64_C(0x9E3779B97F4A7C15));
+}
+
+static bool u64TypeEquals(const void *object1, const void *object2) {
+  const uint64_t *key1 = object1;
+  const uint64_t *key2 = object2;
+  return *key1 == *key2;
+}
+
+static int u64TypeCompare(const void *object1, const void *object2) {
+  uint64_t key1 = *(const uint64_t *)object1;
+  uint64_t key2 = *(const uint64_t *)object2;
+  return key1 < key2 ? -1 : key1 > key2;
+}
+
+static const TloType u64Type = {.size = sizeof(uint64_t),
+                                .equals = u64TypeEquals,
+                                .hash = u64TypeHash,
+                                .compare = u64TypeCompare};
+
+static const TloType u32Type = {.size = sizeof(uint32_t)};
+
+typedef struct Parameters {
+  size_t numKeys;
+  const uint64_t *keys;
+  const uint32_t *values;
+  const uint64_t *lookups;
+  TloMap *map;
+} Parameters;
+
+static TloMap *makeSCHTableMap(const Parameters *p) {
+  TloMap *map =
+      (TloMap *)tloSCHTableMapMake(&u64Type, &u32Type, &countingAllocator);
+  if (!map) {
+    return NULL;
+  }
+
+  for (size_t i = 0; i < p->numKeys; ++i) {
+    uint64_t key = p->keys[i];
+    uint32_t value = p->values[i];
+    if (tlovMapInsert(map, TLO_COPY, &key, TLO_COPY, &value) == TLO_ERROR) {
+      tloMapDelete(map);
+      return NULL;
+    }
+  }
+
+  return map;
+}
+
+static TloMap *makeFlatMap(const Parameters *p) {
+  return (TloMap *)tloFlatMapMakeFromArrays(&u64Type, &u32Type,
+                                            &countingAllocator, p->keys,
+                                            p->values, p->numKeys);
+}
+
+static void schtableMapBuild(const void *parameters) {
+  tloMapDelete(makeSCHTableMap(parameters));
+}
+
+static void flatMapBuild(const void *parameters) {
+  tloMapDelete(makeFlatMap(parameters));
+}
+
+static void findAll(const void *parameters) {
+  const Parameters *p = parameters;
+  size_t numFound = 0;
+
+  for (size_t i = 0; i < p->numKeys; ++i) {
+    numFound += tlovMapFind(p->map, &p->lookups[i]) != NULL;
+  }
+
+  if (numFound != p->numKeys) {
+    puts("error: a key wasn't found");
+    exit(1);
+  }
+}
+
+static void benchmarkFind(const char *name, TloMap *map,
+                          Parameters *parameters, int numIterations) {
+  if (!map) {
+    puts("error: out of memory");
+    exit(1);
+  }
+
+  printf("%s\n", name);
+  printf("Bytes allocated     : %zu\n", numBytes);
+  printf("Allocations         : %zu\n", numAllocations);
+
+  parameters->map = map;
+  TLO_TIME_TASK(findAll, parameters, numIterations);
+
+  tloMapDelete(map);
+  parameters->map = NULL;
+}
+
+int main(int argc, char *argv[]) {
+  if (argc < 3) {
+    printf("usage: %s <num-keys> <num-iterations>\n", argv[0]);
+    return 1;
+  }
+
+  size_t numKeys = strtoull(argv[1], NULL, 10);
+  if (numKeys < 1 || numKeys > UINT32_MAX) {
+    puts("error: given number of keys is invalid");
+    return 1;
+  }
+
+  int numIterations = atoi(argv[2]);
+  if (numIterations < 1) {
+    puts("error: given number of iterations is invalid");
+    return 1;
+  }
+
+  uint64_t *keys = malloc(numKeys * sizeof(*keys));
+  uint32_t *values = malloc(numKeys * sizeof(*values));
+  uint64_t *lookups = malloc(numKeys * sizeof(*lookups));
+  if (!keys || !values || !lookups) {
+    puts("error: out of memory");
+    return 1;
+  }
+
+  // the low bits count up, so the keys never repeat
+  uint64_t state = 88172645463325252U;
+  for (size_t i = 0; i < numKeys; ++i) {
+    state ^= state << 13;
+    state ^= state >> 7;
+    state ^= state << 17;
+    keys[i] = (state << 32) | i;
+    values[i] = (uint32_t)i;
+  }
+
+  // Fisher-Yates shuffle, so the lookups don't follow the insertion order
+  for (size_t i = 0; i < numKeys; ++i) {
+    lookups[i] = keys[i];
+  }
+  for (size_t i = numKeys - 1; i > 0; --i) {
+    state ^= state << 13;
+    state ^= state >> 7;
+    state ^= state << 17;
+    size_t j = (size_t)(state % (i + 1));
+    uint64_t lookup = lookups[i];
+    lookups[i] = lookups[j];
+    lookups[j] = lookup;
+  }
+
+  Parameters parameters = {.numKeys = numKeys,
+                           .keys = keys,
+                           .values = values,
+                           .lookups = lookups};
+  TLO_TIME_TASK(schtableMapBuild, &parameters, numIterations);
+  TLO_TIME_TASK(flatMapBuild, &parameters, numIterations);
+  benchmarkFind("TloSCHTableMap", makeSCHTableMap(&parameters), &parameters,
+                numIterations);
+  benchmarkFind("TloFlatMap", makeFlatMap(&parameters), &parameters,
+                numIterations);
+
+  free(lookups);
+  free(values);
+  free(keys);
+}
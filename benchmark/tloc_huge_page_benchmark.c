@@ -0,0 +1,90 @@
+#include <limits.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <tlo/benchmark.h>
+#include <tlo/darray.h>
+#include <tlo/hugepage.h>
+#include <tlo/list.h>
+
+/*
+ * - reads elements at random indexes, so nearly every access misses the cache
+ *   and, once the array is much bigger than the TLB reach of normal pages, the
+ *   TLB too
+ */
+typedef struct Parameters {
+  size_t numElements;
+  const TloDArray *array;
+} Parameters;
+
+static uint64_t xorshift(uint64_t *state) {
+  *state ^= *state << 13;
+  *state ^= *state >> 7;
+  *state ^= *state << 17;
+  return *state;
+}
+
+static volatile unsigned sink;
+
+static void darrayRandomAccess(const void *parameters) {
+  const Parameters *p = parameters;
+  uint64_t state = 88172645463325252u;
+  unsigned sum = 0;
+
+  for (size_t i = 0; i < p->numElements; ++i) {
+    size_t index = (size_t)(xorshift(&state) % p->numElements);
+    sum += (unsigned)*(const int *)tlovListElement(&p->array->list, index);
+  }
+
+  sink = sum;
+}
+
+static void timeRandomAccess(const char *allocatorName,
+                             const TloAllocator *allocator, size_t numElements,
+                             int numIterations) {
+  TloDArray array;
+  if (tloDArrayConstruct(&array, &tloInt, allocator, numElements) !=
+      TLO_SUCCESS) {
+    puts("error: out of memory");
+    return;
+  }
+
+  for (size_t i = 0; i < numElements; ++i) {
+    int value = (int)i;
+    tlovListPushBack(&array.list, &value);
+  }
+
+  Parameters parameters = {.numElements = numElements, .array = &array};
+
+  printf("allocator: %s\n", allocatorName);
+  TLO_TIME_TASK(darrayRandomAccess, &parameters, numIterations);
+
+  tlovListDestruct(&array.list);
+}
+
+int main(int argc, char *argv[]) {
+  if (argc < 3) {
+    printf("usage: %s <num-elements> <num-iterations>\n", argv[0]);
+    return 1;
+  }
+
+  size_t numElements = strtoull(argv[1], NULL, 10);
+  if (numElements < 1 || numElements > INT_MAX) {
+    puts("error: given number of elements is invalid");
+    return 1;
+  }
+
+  int numIterations = atoi(argv[2]);
+  if (numIterations < 1) {
+    puts("error: given number of iterations is invalid");
+    return 1;
+  }
+
+  timeRandomAccess("CStdLib", &tloCStdLibAllocator, numElements, numIterations);
+
+  TloHugePageAllocator hugePageAllocator;
+  tloHugePageAllocatorConstruct(&hugePageAllocator, NULL, 0);
+  timeRandomAccess("HugePage", &hugePageAllocator.allocator, numElements,
+                   numIterations);
+  tloHugePageAllocatorDestruct(&hugePageAllocator);
+}
@@ -6,6 +6,10 @@
 #include <tlo/dllist.h>
 #include <tlo/list.h>
 #include <tlo/sllist.h>
+#include <tlo/tdarray.h>
+#include <tlo/unrolledlist.h>
+
+TLO_DEFINE_DARRAY(IntArray, int)
 
 static void pushBackThenPopBack(TloList *list, size_t maxListSize) {
   for (size_t i = 0; i < maxListSize; ++i) {
@@ -24,6 +28,21 @@ static void darrayPushBackThenPopBack(const void *parameters) {
   pushBackThenPopBack((TloList *)tloDArrayMake(&tloInt, NULL, 0), *maxListSize);
 }
 
+static void intArrayPushBackThenPopBack(const void *parameters) {
+  const size_t *maxListSize = parameters;
+  IntArray *array = IntArrayMake(NULL, 0);
+
+  for (size_t i = 0; i < *maxListSize; ++i) {
+    IntArrayPushBack(array, (int)i);
+  }
+
+  while (!IntArrayIsEmpty(array)) {
+    IntArrayPopBack(array);
+  }
+
+  IntArrayDelete(array);
+}
+
 static void cdarrayPushBackThenPopBack(const void *parameters) {
   const size_t *maxListSize = parameters;
   pushBackThenPopBack((TloList *)tloCDArrayMake(&tloInt, NULL, 0),
@@ -35,6 +54,12 @@ static void dllistPushBackThenPopBack(const void *parameters) {
   pushBackThenPopBack((TloList *)tloDLListMake(&tloInt, NULL), *maxListSize);
 }
 
+static void unrolledListPushBackThenPopBack(const void *parameters) {
+  const size_t *maxListSize = parameters;
+  pushBackThenPopBack((TloList *)tloUnrolledListMake(&tloInt, NULL, 0),
+                      *maxListSize);
+}
+
 static void pushFrontThenPopFront(TloList *list, size_t maxListSize) {
   for (size_t i = 0; i < maxListSize; ++i) {
     tlovListPushFront(list, &i);
@@ -63,6 +88,12 @@ static void dllistPushFrontThenPopFront(const void *parameters) {
   pushFrontThenPopFront((TloList *)tloDLListMake(&tloInt, NULL), *maxListSize);
 }
 
+static void unrolledListPushFrontThenPopFront(const void *parameters) {
+  const size_t *maxListSize = parameters;
+  pushFrontThenPopFront((TloList *)tloUnrolledListMake(&tloInt, NULL, 0),
+                        *maxListSize);
+}
+
 static void pushBackThenPopFront(TloList *list, size_t maxListSize) {
   for (size_t i = 0; i < maxListSize; ++i) {
     tlovListPushBack(list, &i);
@@ -91,6 +122,12 @@ static void dllistPushBackThenPopFront(const void *parameters) {
   pushBackThenPopFront((TloList *)tloDLListMake(&tloInt, NULL), *maxListSize);
 }
 
+static void unrolledListPushBackThenPopFront(const void *parameters) {
+  const size_t *maxListSize = parameters;
+  pushBackThenPopFront((TloList *)tloUnrolledListMake(&tloInt, NULL, 0),
+                       *maxListSize);
+}
+
 static void pushFrontThenPopBack(TloList *list, size_t maxListSize) {
   for (size_t i = 0; i < maxListSize; ++i) {
     tlovListPushFront(list, &i);
@@ -114,6 +151,12 @@ static void dllistPushFrontThenPopBack(const void *parameters) {
   pushFrontThenPopBack((TloList *)tloDLListMake(&tloInt, NULL), *maxListSize);
 }
 
+static void unrolledListPushFrontThenPopBack(const void *parameters) {
+  const size_t *maxListSize = parameters;
+  pushFrontThenPopBack((TloList *)tloUnrolledListMake(&tloInt, NULL, 0),
+                       *maxListSize);
+}
+
 int main(int argc, char *argv[]) {
   if (argc < 3) {
     printf("usage: %s <max-list-size> <num-iterations>\n", argv[0]);
@@ -133,6 +176,7 @@ int main(int argc, char *argv[]) {
   }
 
   TLO_TIME_TASK(darrayPushBackThenPopBack, &maxListSize, numIterations);
+  TLO_TIME_TASK(intArrayPushBackThenPopBack, &maxListSize, numIterations);
 
   TLO_TIME_TASK(cdarrayPushBackThenPopBack, &maxListSize, numIterations);
   TLO_TIME_TASK(cdarrayPushFrontThenPopFront, &maxListSize, numIterations);
@@ -146,4 +190,9 @@ int main(int argc, char *argv[]) {
   TLO_TIME_TASK(dllistPushFrontThenPopFront, &maxListSize, numIterations);
   TLO_TIME_TASK(dllistPushBackThenPopFront, &maxListSize, numIterations);
   TLO_TIME_TASK(dllistPushFrontThenPopBack, &maxListSize, numIterations);
+
+  TLO_TIME_TASK(unrolledListPushBackThenPopBack, &maxListSize, numIterations);
+  TLO_TIME_TASK(unrolledListPushFrontThenPopFront, &maxListSize, numIterations);
+  TLO_TIME_TASK(unrolledListPushBackThenPopFront, &maxListSize, numIterations);
+  TLO_TIME_TASK(unrolledListPushFrontThenPopBack, &maxListSize, numIterations);
 }
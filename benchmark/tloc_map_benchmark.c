@@ -0,0 +1,99 @@
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <tlo/benchmark.h>
+#include <tlo/map.h>
+#include <tlo/schtable.h>
+#include <tlo/tschtable.h>
+
+static size_t hashU64(uint64_t key) {
+  return (size_t)(key * UINT64_C(0x9E3779B97F4A7C15));
+}
+
+#define EQUALS_U64(_key1, _key2) ((_key1) == (_key2))
+
+TLO_DEFINE_SCHTABLE_MAP(U64U32Map, uint64_t, uint32_t, hashU64, EQUALS_U64)
+
+static size_t u64TypeHash(const void *data, size_t size) {
+  (void)size;
+  const uint64_t *key = data;
+  return hashU64(*key);
+}
+
+static bool u64TypeEquals(const void *object1, const void *object2) {
+  const uint64_t *key1 = object1;
+  const uint64_t *key2 = object2;
+  return *key1 == *key2;
+}
+
+static const TloType u64Type = {
+    .size = sizeof(uint64_t), .equals = u64TypeEquals, .hash = u64TypeHash};
+
+static const TloType u32Type = {.size = sizeof(uint32_t)};
+
+static void insertFindRemove(TloMap *map, size_t numKeys) {
+  for (size_t i = 0; i < numKeys; ++i) {
+    uint64_t key = i;
+    uint32_t value = (uint32_t)i;
+    tlovMapInsert(map, TLO_COPY, &key, TLO_COPY, &value);
+  }
+
+  for (size_t i = 0; i < numKeys; ++i) {
+    uint64_t key = i;
+    tlovMapFind(map, &key);
+  }
+
+  for (size_t i = 0; i < numKeys; ++i) {
+    uint64_t key = i;
+    tlovMapRemove(map, &key);
+  }
+
+  tloMapDelete(map);
+}
+
+static void schtableMapInsertFindRemove(const void *parameters) {
+  const size_t *numKeys = parameters;
+  insertFindRemove((TloMap *)tloSCHTableMapMake(&u64Type, &u32Type, NULL),
+                   *numKeys);
+}
+
+static void u64U32MapInsertFindRemove(const void *parameters) {
+  const size_t *numKeys = parameters;
+  U64U32Map *map = U64U32MapMake(NULL);
+
+  for (size_t i = 0; i < *numKeys; ++i) {
+    U64U32MapInsert(map, i, (uint32_t)i);
+  }
+
+  for (size_t i = 0; i < *numKeys; ++i) {
+    U64U32MapFind(map, i);
+  }
+
+  for (size_t i = 0; i < *numKeys; ++i) {
+    U64U32MapRemove(map, i);
+  }
+
+  U64U32MapDelete(map);
+}
+
+int main(int argc, char *argv[]) {
+  if (argc < 3) {
+    printf("usage: %s <num-keys> <num-iterations>\n", argv[0]);
+    return 1;
+  }
+
+  size_t numKeys = strtoull(argv[1], NULL, 10);
+  if (numKeys < 1) {
+    puts("error: given number of keys is invalid");
+    return 1;
+  }
+
+  int numIterations = atoi(argv[2]);
+  if (numIterations < 1) {
+    puts("error: given number of iterations is invalid");
+    return 1;
+  }
+
+  TLO_TIME_TASK(schtableMapInsertFindRemove, &numKeys, numIterations);
+  TLO_TIME_TASK(u64U32MapInsertFindRemove, &numKeys, numIterations);
+}
@@ -0,0 +1,243 @@
+#define _POSIX_C_SOURCE 200809L
+#include <limits.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+#include <tlo/cdarray.h>
+#include <tlo/mpmcqueue.h>
+
+/*
+ * - n producer threads send numMessages messages in total to n consumer
+ *   threads through one queue, for n from 1 to the number of cores
+ * - compares TloMPMCQueue, both yielding while full or empty and blocking on a
+ *   futex, against a TloCDArray behind a mutex
+ * - times are wall clock, since TloStopwatch measures the CPU time of all
+ *   threads added up
+ */
+typedef uint64_t Message;
+
+static const TloType messageType = {.size = sizeof(Message)};
+
+typedef struct MutexQueue {
+  pthread_mutex_t mutex;
+  TloCDArray array;
+  size_t capacity;
+} MutexQueue;
+
+typedef struct Channel {
+  const char *name;
+  void *queue;
+  void (*send)(void *queue, Message message);
+  Message (*receive)(void *queue);
+} Channel;
+
+static void mpmcQueueSendYielding(void *queue, Message message) {
+  while (!tloMPMCQueueTryMove(queue, &message)) {
+    sched_yield();
+  }
+}
+
+static Message mpmcQueueReceiveYielding(void *queue) {
+  Message message;
+  while (!tloMPMCQueueTryPop(queue, &message)) {
+    sched_yield();
+  }
+  return message;
+}
+
+static void mpmcQueueSendBlocking(void *queue, Message message) {
+  tloMPMCQueueMove(queue, &message);
+}
+
+static Message mpmcQueueReceiveBlocking(void *queue) {
+  Message message;
+  tloMPMCQueuePop(queue, &message);
+  return message;
+}
+
+static bool mutexQueueTryPush(MutexQueue *queue, Message message) {
+  bool pushed = false;
+
+  pthread_mutex_lock(&queue->mutex);
+  if (tlovListSize(&queue->array.list) < queue->capacity) {
+    pushed = tlovListPushBack(&queue->array.list, &message) == TLO_SUCCESS;
+  }
+  pthread_mutex_unlock(&queue->mutex);
+
+  return pushed;
+}
+
+static bool mutexQueueTryPop(MutexQueue *queue, Message *message) {
+  bool popped = false;
+
+  pthread_mutex_lock(&queue->mutex);
+  if (!tlovListIsEmpty(&queue->array.list)) {
+    *message = *(const Message *)tlovListFront(&queue->array.list);
+    tlovListPopFront(&queue->array.list);
+    popped = true;
+  }
+  pthread_mutex_unlock(&queue->mutex);
+
+  return popped;
+}
+
+static void mutexQueueSendYielding(void *queue, Message message) {
+  while (!mutexQueueTryPush(queue, message)) {
+    sched_yield();
+  }
+}
+
+static Message mutexQueueReceiveYielding(void *queue) {
+  Message message;
+  while (!mutexQueueTryPop(queue, &message)) {
+    sched_yield();
+  }
+  return message;
+}
+
+static long double now(void) {
+  struct timespec time;
+  timespec_get(&time, TIME_UTC);
+  return (long double)time.tv_sec + (long double)time.tv_nsec / 1e9L;
+}
+
+typedef struct ThreadParameters {
+  const Channel *channel;
+  Message first;
+  size_t count;
+  Message sum;
+} ThreadParameters;
+
+static void *produce(void *parameters) {
+  ThreadParameters *p = parameters;
+  for (size_t i = 0; i < p->count; ++i) {
+    p->channel->send(p->channel->queue, p->first + i);
+  }
+  return NULL;
+}
+
+static void *consume(void *parameters) {
+  ThreadParameters *p = parameters;
+  Message sum = 0;
+  for (size_t i = 0; i < p->count; ++i) {
+    sum += p->channel->receive(p->channel->queue);
+  }
+  p->sum = sum;
+  return NULL;
+}
+
+enum { MAX_THREADS = 256 };
+
+// splits numMessages as evenly as possible between numThreads threads
+static void split(ThreadParameters *parameters, const Channel *channel,
+                  size_t numMessages, size_t numThreads) {
+  Message first = 0;
+  for (size_t i = 0; i < numThreads; ++i) {
+    size_t count =
+        numMessages / numThreads + (i < numMessages % numThreads ? 1 : 0);
+    parameters[i] = (ThreadParameters){
+        .channel = channel, .first = first, .count = count, .sum = 0};
+    first += count;
+  }
+}
+
+static void timeChannel(const Channel *channel, size_t numMessages,
+                        size_t numThreads) {
+  static ThreadParameters producerParameters[MAX_THREADS];
+  static ThreadParameters consumerParameters[MAX_THREADS];
+  pthread_t producers[MAX_THREADS];
+  pthread_t consumers[MAX_THREADS];
+  split(producerParameters, channel, numMessages, numThreads);
+  split(consumerParameters, channel, numMessages, numThreads);
+
+  long double start = now();
+  for (size_t i = 0; i < numThreads; ++i) {
+    if (pthread_create(&consumers[i], NULL, consume, &consumerParameters[i]) ||
+        pthread_create(&producers[i], NULL, produce, &producerParameters[i])) {
+      puts("error: couldn't create threads");
+      exit(1);
+    }
+  }
+
+  Message sum = 0;
+  for (size_t i = 0; i < numThreads; ++i) {
+    pthread_join(producers[i], NULL);
+    pthread_join(consumers[i], NULL);
+    sum += consumerParameters[i].sum;
+  }
+  long double seconds = now() - start;
+
+  if (sum != (Message)numMessages * (numMessages - 1) / 2) {
+    puts("error: messages got lost");
+    exit(1);
+  }
+
+  printf("%s, %zu producers and %zu consumers\n", channel->name, numThreads,
+         numThreads);
+  printf("Total time          : %Lg seconds\n", seconds);
+  printf("Messages per second : %Lg\n", (long double)numMessages / seconds);
+}
+
+int main(int argc, char *argv[]) {
+  if (argc < 3) {
+    printf("usage: %s <num-messages> <capacity> [max-threads]\n", argv[0]);
+    return 1;
+  }
+
+  size_t numMessages = strtoull(argv[1], NULL, 10);
+  if (numMessages < 1 || numMessages > INT_MAX) {
+    puts("error: given number of messages is invalid");
+    return 1;
+  }
+
+  size_t capacity = strtoull(argv[2], NULL, 10);
+  if (capacity < 1 || capacity > INT_MAX) {
+    puts("error: given capacity is invalid");
+    return 1;
+  }
+
+  // defaults to the number of cores
+  long maxThreads =
+      argc > 3 ? atol(argv[3]) : sysconf(_SC_NPROCESSORS_ONLN);
+  if (maxThreads < 1 || maxThreads > MAX_THREADS) {
+    puts("error: given maximum number of threads is invalid");
+    return 1;
+  }
+
+  TloMPMCQueue *queue = tloMPMCQueueMake(&messageType, NULL, capacity);
+  MutexQueue mutexQueue = {.capacity = capacity};
+  if (!queue || tloCDArrayConstruct(&mutexQueue.array, &messageType, NULL,
+                                    capacity) != TLO_SUCCESS) {
+    puts("error: out of memory");
+    return 1;
+  }
+  pthread_mutex_init(&mutexQueue.mutex, NULL);
+
+  const Channel channels[] = {
+      {.name = "TloMPMCQueue, yielding",
+       .queue = queue,
+       .send = mpmcQueueSendYielding,
+       .receive = mpmcQueueReceiveYielding},
+      {.name = "TloMPMCQueue, blocking",
+       .queue = queue,
+       .send = mpmcQueueSendBlocking,
+       .receive = mpmcQueueReceiveBlocking},
+      {.name = "mutex and TloCDArray, yielding",
+       .queue = &mutexQueue,
+       .send = mutexQueueSendYielding,
+       .receive = mutexQueueReceiveYielding}};
+
+  for (size_t numThreads = 1; numThreads <= (size_t)maxThreads; ++numThreads) {
+    for (size_t i = 0; i < sizeof(channels) / sizeof(channels[0]); ++i) {
+      timeChannel(&channels[i], numMessages, numThreads);
+    }
+  }
+
+  tloMPMCQueueDelete(queue);
+  tlovListDestruct(&mutexQueue.array.list);
+  pthread_mutex_destroy(&mutexQueue.mutex);
+}
@@ -0,0 +1,118 @@
+#define _POSIX_C_SOURCE 200809L
+#include <limits.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <tlo/sort.h>
+#include <tlo/threadpool.h>
+
+/*
+ * - sorts numElements random 8 byte keys with tloParallelSort, both unstable
+ *   and stable, on n threads, for n from 1 to the number of cores
+ * - speedups are relative to tloSort on the calling thread alone
+ * - times are wall clock, since TloStopwatch measures the CPU time of all
+ *   threads added up
+ */
+static int compareUInt64s(const void *object1, const void *object2) {
+  uint64_t key1 = *(const uint64_t *)object1;
+  uint64_t key2 = *(const uint64_t *)object2;
+  return key1 < key2 ? -1 : key1 > key2;
+}
+
+static const TloType uint64Type = {.size = sizeof(uint64_t),
+                                   .compare = compareUInt64s};
+
+static long double now(void) {
+  struct timespec time;
+  timespec_get(&time, TIME_UTC);
+  return (long double)time.tv_sec + (long double)time.tv_nsec / 1e9L;
+}
+
+static void checkSorted(const uint64_t *keys, size_t numElements) {
+  for (size_t i = 1; i < numElements; ++i) {
+    if (keys[i - 1] > keys[i]) {
+      puts("error: keys aren't sorted");
+      exit(1);
+    }
+  }
+}
+
+static void printResult(const char *name, size_t numThreads,
+                        long double seconds, long double baseline) {
+  printf("%s, %zu threads\n", name, numThreads);
+  printf("Total time : %Lg seconds\n", seconds);
+  printf("Speedup    : %Lg\n", baseline / seconds);
+}
+
+int main(int argc, char *argv[]) {
+  if (argc < 2) {
+    printf("usage: %s <num-elements> [max-threads]\n", argv[0]);
+    return 1;
+  }
+
+  size_t numElements = strtoull(argv[1], NULL, 10);
+  if (numElements < 1 || numElements > SIZE_MAX / sizeof(uint64_t)) {
+    puts("error: given number of elements is invalid");
+    return 1;
+  }
+
+  // defaults to the number of cores
+  long maxThreads = argc > 2 ? atol(argv[2]) : sysconf(_SC_NPROCESSORS_ONLN);
+  if (maxThreads < 1 || maxThreads > 256) {
+    puts("error: given maximum number of threads is invalid");
+    return 1;
+  }
+
+  uint64_t *unsorted = malloc(numElements * sizeof(uint64_t));
+  uint64_t *keys = malloc(numElements * sizeof(uint64_t));
+  if (!unsorted || !keys) {
+    puts("error: out of memory");
+    return 1;
+  }
+
+  uint64_t state = 88172645463325252U;
+  for (size_t i = 0; i < numElements; ++i) {
+    state ^= state << 13;
+    state ^= state >> 7;
+    state ^= state << 17;
+    unsorted[i] = state;
+  }
+
+  memcpy(keys, unsorted, numElements * sizeof(uint64_t));
+  long double start = now();
+  tloSort(keys, numElements, &uint64Type);
+  long double baseline = now() - start;
+  checkSorted(keys, numElements);
+  printResult("tloSort", 1, baseline, baseline);
+
+  for (size_t numThreads = 1; numThreads <= (size_t)maxThreads; ++numThreads) {
+    TloThreadPool *pool = tloThreadPoolMake(numThreads, NULL);
+    if (!pool) {
+      puts("error: couldn't start thread pool");
+      return 1;
+    }
+
+    for (int stable = 0; stable <= 1; ++stable) {
+      memcpy(keys, unsorted, numElements * sizeof(uint64_t));
+      start = now();
+      TloError error = tloParallelSort(keys, numElements, &uint64Type, stable,
+                                       pool, NULL);
+      long double seconds = now() - start;
+      if (error) {
+        puts("error: out of memory");
+        return 1;
+      }
+      checkSorted(keys, numElements);
+      printResult(stable ? "tloParallelSort, stable" : "tloParallelSort",
+                  numThreads, seconds, baseline);
+    }
+
+    tloThreadPoolDelete(pool);
+  }
+
+  free(keys);
+  free(unsorted);
+}
@@ -0,0 +1,177 @@
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <tlo/benchmark.h>
+#include <tlo/priorityqueue.h>
+
+/*
+ * - models a timer scheduler: numTimers deadlines are pending, and each
+ *   operation takes the earliest one, then schedules a new deadline a random
+ *   delay after it
+ * - compares a linear scan of a TloDArray, which removes what it finds with
+ *   tlovListUnorderedRemove, against TloPriorityQueue with arities 2, 4,
+ *   and 8
+ * - every task sums the deadlines it takes and checks the sum against the
+ *   linear scan's, since ties don't change which deadlines come out
+ */
+static int u64TypeCompare(const void *object1, const void *object2) {
+  uint64_t key1 = *(const uint64_t *)object1;
+  uint64_t key2 = *(const uint64_t *)object2;
+  return key1 < key2 ? -1 : key1 > key2;
+}
+
+static const TloType u64Type = {.size = sizeof(uint64_t),
+                                .compare = u64TypeCompare};
+
+enum { MAX_DELAY = 1 << 20 };
+
+typedef struct Parameters {
+  size_t numTimers;
+  size_t numOperations;
+  const uint64_t *deadlines;
+} Parameters;
+
+// set by the first task that runs
+static uint64_t expectedSum;
+
+static uint64_t nextDelay(uint64_t *state) {
+  *state ^= *state << 13;
+  *state ^= *state >> 7;
+  *state ^= *state << 17;
+  return 1 + (*state >> 8) % MAX_DELAY;
+}
+
+static void checkSum(uint64_t sum) {
+  if (!expectedSum) {
+    expectedSum = sum;
+  } else if (sum != expectedSum) {
+    puts("error: deadlines were taken out of order");
+    exit(1);
+  }
+}
+
+static void outOfMemory(void) {
+  puts("error: out of memory");
+  exit(1);
+}
+
+static void linearScan(const void *parameters) {
+  const Parameters *p = parameters;
+  TloDArray array;
+  if (tloDArrayConstruct(&array, &u64Type, NULL, p->numTimers) !=
+      TLO_SUCCESS) {
+    outOfMemory();
+  }
+  for (size_t i = 0; i < p->numTimers; ++i) {
+    tlovListPushBack(&array.list, &p->deadlines[i]);
+  }
+
+  uint64_t state = 88172645463325252U;
+  uint64_t sum = 0;
+  for (size_t i = 0; i < p->numOperations; ++i) {
+    const uint64_t *deadlines = tlovListElement(&array.list, 0);
+    size_t earliest = 0;
+    for (size_t j = 1; j < p->numTimers; ++j) {
+      if (deadlines[j] < deadlines[earliest]) {
+        earliest = j;
+      }
+    }
+
+    uint64_t now = deadlines[earliest];
+    sum += now;
+    tlovListUnorderedRemove(&array.list, earliest);
+    uint64_t deadline = now + nextDelay(&state);
+    if (tlovListPushBack(&array.list, &deadline) != TLO_SUCCESS) {
+      outOfMemory();
+    }
+  }
+
+  tlovListDestruct(&array.list);
+  checkSum(sum);
+}
+
+static void timeHeap(const Parameters *p, size_t arity) {
+  TloDArray array;
+  if (tloDArrayConstruct(&array, &u64Type, NULL, p->numTimers) !=
+      TLO_SUCCESS) {
+    outOfMemory();
+  }
+  for (size_t i = 0; i < p->numTimers; ++i) {
+    tlovListPushBack(&array.list, &p->deadlines[i]);
+  }
+
+  TloPriorityQueue queue;
+  if (tloPriorityQueueConstructFromDArray(&queue, &array, arity, false) !=
+      TLO_SUCCESS) {
+    outOfMemory();
+  }
+  tlovListDestruct(&array.list);
+
+  uint64_t state = 88172645463325252U;
+  uint64_t sum = 0;
+  for (size_t i = 0; i < p->numOperations; ++i) {
+    uint64_t now = *(const uint64_t *)tloPriorityQueueTop(&queue);
+    sum += now;
+    tloPriorityQueuePop(&queue);
+    uint64_t deadline = now + nextDelay(&state);
+    if (tloPriorityQueuePush(&queue, &deadline, NULL) != TLO_SUCCESS) {
+      outOfMemory();
+    }
+  }
+
+  tloPriorityQueueDestruct(&queue);
+  checkSum(sum);
+}
+
+static void binaryHeap(const void *parameters) { timeHeap(parameters, 2); }
+
+static void fourAryHeap(const void *parameters) { timeHeap(parameters, 4); }
+
+static void eightAryHeap(const void *parameters) { timeHeap(parameters, 8); }
+
+int main(int argc, char *argv[]) {
+  if (argc < 4) {
+    printf("usage: %s <num-timers> <num-operations> <num-iterations>\n",
+           argv[0]);
+    return 1;
+  }
+
+  size_t numTimers = strtoull(argv[1], NULL, 10);
+  if (numTimers < 1 || numTimers > UINT32_MAX) {
+    puts("error: given number of timers is invalid");
+    return 1;
+  }
+
+  size_t numOperations = strtoull(argv[2], NULL, 10);
+  if (numOperations < 1) {
+    puts("error: given number of operations is invalid");
+    return 1;
+  }
+
+  int numIterations = atoi(argv[3]);
+  if (numIterations < 1) {
+    puts("error: given number of iterations is invalid");
+    return 1;
+  }
+
+  uint64_t *deadlines = malloc(numTimers * sizeof(*deadlines));
+  if (!deadlines) {
+    puts("error: out of memory");
+    return 1;
+  }
+
+  uint64_t state = 2463534242U;
+  for (size_t i = 0; i < numTimers; ++i) {
+    deadlines[i] = nextDelay(&state);
+  }
+
+  Parameters parameters = {.numTimers = numTimers,
+                           .numOperations = numOperations,
+                           .deadlines = deadlines};
+  TLO_TIME_TASK(linearScan, &parameters, numIterations);
+  TLO_TIME_TASK(binaryHeap, &parameters, numIterations);
+  TLO_TIME_TASK(fourAryHeap, &parameters, numIterations);
+  TLO_TIME_TASK(eightAryHeap, &parameters, numIterations);
+
+  free(deadlines);
+}
@@ -0,0 +1,272 @@
+#define _POSIX_C_SOURCE 200809L
+#include <limits.h>
+#include <pthread.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+#include <tlo/btree.h>
+#include <tlo/skiplist.h>
+
+/*
+ * - n threads do numOperations finds, inserts, and removes in total on one
+ *   ordered map, for n from 1 to the number of cores
+ * - the map starts with numKeys keys, every other one of the range
+ *   [0, 2 * numKeys), and operations pick keys from the whole range, so about
+ *   half of them find their key. updatePercent of them are split evenly
+ *   between inserts and removes, which keeps the size about the same
+ * - compares TloSkipListMap against a TloBTreeMap behind a mutex
+ * - times are wall clock, since TloStopwatch measures the CPU time of all
+ *   threads added up
+ */
+static int u64TypeCompare(const void *object1, const void *object2) {
+  uint64_t key1 = *(const uint64_t *)object1;
+  uint64_t key2 = *(const uint64_t *)object2;
+  return key1 < key2 ? -1 : key1 > key2;
+}
+
+static const TloType u64Type = {.size = sizeof(uint64_t),
+                                .compare = u64TypeCompare};
+
+typedef struct MutexMap {
+  pthread_mutex_t mutex;
+  TloBTreeMap btree;
+} MutexMap;
+
+typedef struct OrderedMap {
+  const char *name;
+  void *map;
+  // returns what the calling thread passes to the functions below
+  void *(*attach)(void *map);
+  void (*detach)(void *handle);
+  bool (*find)(void *handle, uint64_t key);
+  bool (*insert)(void *handle, uint64_t key);
+  bool (*remove)(void *handle, uint64_t key);
+} OrderedMap;
+
+static void *skipListAttach(void *map) { return tloSkipListMapAttach(map); }
+
+static void skipListDetach(void *handle) { tloSkipListMapDetach(handle); }
+
+static bool skipListFind(void *handle, uint64_t key) {
+  tloSkipListThreadPin(handle);
+  const uint64_t *value = tloSkipListMapFind(handle, &key);
+  bool found = value && *value == key;
+  tloSkipListThreadUnpin(handle);
+  return found;
+}
+
+static bool skipListInsert(void *handle, uint64_t key) {
+  return tloSkipListMapInsert(handle, TLO_COPY, &key, TLO_COPY, &key) ==
+         TLO_SUCCESS;
+}
+
+static bool skipListRemove(void *handle, uint64_t key) {
+  return tloSkipListMapRemove(handle, &key);
+}
+
+static void *mutexMapAttach(void *map) { return map; }
+
+static void mutexMapDetach(void *handle) { (void)handle; }
+
+static bool mutexMapFind(void *handle, uint64_t key) {
+  MutexMap *map = handle;
+  pthread_mutex_lock(&map->mutex);
+  const uint64_t *value = tlovMapFind(&map->btree.map, &key);
+  bool found = value && *value == key;
+  pthread_mutex_unlock(&map->mutex);
+  return found;
+}
+
+static bool mutexMapInsert(void *handle, uint64_t key) {
+  MutexMap *map = handle;
+  pthread_mutex_lock(&map->mutex);
+  bool inserted = tlovMapInsert(&map->btree.map, TLO_COPY, &key, TLO_COPY,
+                                &key) == TLO_SUCCESS;
+  pthread_mutex_unlock(&map->mutex);
+  return inserted;
+}
+
+static bool mutexMapRemove(void *handle, uint64_t key) {
+  MutexMap *map = handle;
+  pthread_mutex_lock(&map->mutex);
+  bool removed = tlovMapRemove(&map->btree.map, &key);
+  pthread_mutex_unlock(&map->mutex);
+  return removed;
+}
+
+static long double now(void) {
+  struct timespec time;
+  timespec_get(&time, TIME_UTC);
+  return (long double)time.tv_sec + (long double)time.tv_nsec / 1e9L;
+}
+
+typedef struct ThreadParameters {
+  const OrderedMap *map;
+  size_t numKeys;
+  size_t count;
+  unsigned updatePercent;
+  uint64_t seed;
+  size_t numSucceeded;
+  bool attached;
+} ThreadParameters;
+
+static void *run(void *parameters) {
+  ThreadParameters *p = parameters;
+  const OrderedMap *map = p->map;
+  void *handle = map->attach(map->map);
+  if (!handle) {
+    return NULL;
+  }
+
+  uint64_t state = p->seed;
+  size_t numSucceeded = 0;
+  for (size_t i = 0; i < p->count; ++i) {
+    state ^= state << 13;
+    state ^= state >> 7;
+    state ^= state << 17;
+    uint64_t key = (state >> 8) % (p->numKeys * 2);
+    unsigned roll = (unsigned)(state % 200);
+
+    if (roll < p->updatePercent) {
+      numSucceeded += map->insert(handle, key);
+    } else if (roll < p->updatePercent * 2) {
+      numSucceeded += map->remove(handle, key);
+    } else {
+      numSucceeded += map->find(handle, key);
+    }
+  }
+
+  map->detach(handle);
+  p->numSucceeded = numSucceeded;
+  p->attached = true;
+  return NULL;
+}
+
+enum { MAX_THREADS = 256 };
+
+static void timeMap(const OrderedMap *map, size_t numKeys,
+                    size_t numOperations, unsigned updatePercent,
+                    size_t numThreads) {
+  static ThreadParameters parameters[MAX_THREADS];
+  pthread_t threads[MAX_THREADS];
+
+  for (size_t i = 0; i < numThreads; ++i) {
+    size_t count = numOperations / numThreads +
+                   (i < numOperations % numThreads ? 1 : 0);
+    parameters[i] = (ThreadParameters){.map = map,
+                                       .numKeys = numKeys,
+                                       .count = count,
+                                       .updatePercent = updatePercent,
+                                       .seed = 88172645463325252U + i};
+  }
+
+  long double start = now();
+  for (size_t i = 0; i < numThreads; ++i) {
+    if (pthread_create(&threads[i], NULL, run, &parameters[i])) {
+      puts("error: couldn't create threads");
+      exit(1);
+    }
+  }
+
+  size_t numSucceeded = 0;
+  for (size_t i = 0; i < numThreads; ++i) {
+    pthread_join(threads[i], NULL);
+    if (!parameters[i].attached) {
+      puts("error: out of memory");
+      exit(1);
+    }
+    numSucceeded += parameters[i].numSucceeded;
+  }
+  long double seconds = now() - start;
+
+  printf("%s, %zu threads\n", map->name, numThreads);
+  printf("Total time          : %Lg seconds\n", seconds);
+  printf("Operations/second   : %Lg\n",
+         (long double)numOperations / seconds);
+  printf("Succeeded           : %zu\n", numSucceeded);
+}
+
+int main(int argc, char *argv[]) {
+  if (argc < 4) {
+    printf(
+        "usage: %s <num-keys> <num-operations> <update-percent> "
+        "[max-threads]\n",
+        argv[0]);
+    return 1;
+  }
+
+  size_t numKeys = strtoull(argv[1], NULL, 10);
+  if (numKeys < 1 || numKeys > UINT32_MAX) {
+    puts("error: given number of keys is invalid");
+    return 1;
+  }
+
+  size_t numOperations = strtoull(argv[2], NULL, 10);
+  if (numOperations < 1) {
+    puts("error: given number of operations is invalid");
+    return 1;
+  }
+
+  int updatePercent = atoi(argv[3]);
+  if (updatePercent < 0 || updatePercent > 100) {
+    puts("error: given update percentage is invalid");
+    return 1;
+  }
+
+  // defaults to the number of cores
+  long maxThreads =
+      argc > 4 ? atol(argv[4]) : sysconf(_SC_NPROCESSORS_ONLN);
+  if (maxThreads < 1 || maxThreads > MAX_THREADS) {
+    puts("error: given maximum number of threads is invalid");
+    return 1;
+  }
+
+  TloSkipListMap *skipList = tloSkipListMapMake(&u64Type, &u64Type, NULL);
+  MutexMap mutexMap;
+  tloBTreeMapConstruct(&mutexMap.btree, &u64Type, &u64Type, NULL);
+  pthread_mutex_init(&mutexMap.mutex, NULL);
+  TloSkipListThread *thread = skipList ? tloSkipListMapAttach(skipList) : NULL;
+  if (!thread) {
+    puts("error: out of memory");
+    return 1;
+  }
+
+  for (uint64_t key = 0; key < numKeys * 2; key += 2) {
+    if (tloSkipListMapInsert(thread, TLO_COPY, &key, TLO_COPY, &key) !=
+            TLO_SUCCESS ||
+        tlovMapInsert(&mutexMap.btree.map, TLO_COPY, &key, TLO_COPY, &key) !=
+            TLO_SUCCESS) {
+      puts("error: out of memory");
+      return 1;
+    }
+  }
+  tloSkipListMapDetach(thread);
+
+  const OrderedMap maps[] = {{.name = "TloSkipListMap",
+                              .map = skipList,
+                              .attach = skipListAttach,
+                              .detach = skipListDetach,
+                              .find = skipListFind,
+                              .insert = skipListInsert,
+                              .remove = skipListRemove},
+                             {.name = "mutex and TloBTreeMap",
+                              .map = &mutexMap,
+                              .attach = mutexMapAttach,
+                              .detach = mutexMapDetach,
+                              .find = mutexMapFind,
+                              .insert = mutexMapInsert,
+                              .remove = mutexMapRemove}};
+
+  for (size_t numThreads = 1; numThreads <= (size_t)maxThreads; ++numThreads) {
+    for (size_t i = 0; i < sizeof(maps) / sizeof(maps[0]); ++i) {
+      timeMap(&maps[i], numKeys, numOperations, (unsigned)updatePercent,
+              numThreads);
+    }
+  }
+
+  tloSkipListMapDelete(skipList);
+  tlovMapDestruct(&mutexMap.btree.map);
+  pthread_mutex_destroy(&mutexMap.mutex);
+}
@@ -0,0 +1,157 @@
+#include <limits.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <tlo/benchmark.h>
+#include <tlo/darray.h>
+#include <tlo/sort.h>
+
+/*
+ * - sorts a TloDArray of numElements elements with tlovListSort, tloSort,
+ *   tloRadixSort, and qsort, for elements of 4, 8, and 16 bytes with integer
+ *   keys and a few orders
+ * - tlovListSort picks tloRadixSort for these types, unless there are very
+ *   few elements
+ * - every iteration copies the unsorted elements back in first, for all
+ */
+typedef struct Key16 {
+  uint64_t key;
+  uint64_t payload;
+} Key16;
+
+static int compareUInt64s(const void *object1, const void *object2) {
+  uint64_t key1 = *(const uint64_t *)object1;
+  uint64_t key2 = *(const uint64_t *)object2;
+  return key1 < key2 ? -1 : key1 > key2;
+}
+
+static const TloIntegerKey uint64Key = {
+    .offset = 0, .size = sizeof(uint64_t), .isSigned = false};
+
+static const TloType uint64Type = {.size = sizeof(uint64_t),
+                                   .compare = compareUInt64s,
+                                   .integerKey = &uint64Key};
+static const TloType key16Type = {.size = sizeof(Key16),
+                                  .compare = compareUInt64s,
+                                  .integerKey = &uint64Key};
+
+typedef struct Parameters {
+  TloDArray *array;
+  const unsigned char *unsorted;
+} Parameters;
+
+static void *refill(const Parameters *p) {
+  size_t size = tlovListSize(&p->array->list);
+  unsigned char *elements = tlovListMutableElement(&p->array->list, 0);
+  memcpy(elements, p->unsorted, size * tloListValueType(&p->array->list)->size);
+  return elements;
+}
+
+static void tlovListSortTask(const void *parameters) {
+  const Parameters *p = parameters;
+  refill(p);
+  tlovListSort(&p->array->list);
+}
+
+static void tloSortTask(const void *parameters) {
+  const Parameters *p = parameters;
+  tloSort(refill(p), tlovListSize(&p->array->list),
+          tloListValueType(&p->array->list));
+}
+
+static void tloRadixSortTask(const void *parameters) {
+  const Parameters *p = parameters;
+  tloRadixSort(refill(p), tlovListSize(&p->array->list),
+               tloListValueType(&p->array->list), NULL);
+}
+
+static void qsortTask(const void *parameters) {
+  const Parameters *p = parameters;
+  const TloType *type = tloListValueType(&p->array->list);
+  qsort(refill(p), tlovListSize(&p->array->list), type->size, type->compare);
+}
+
+typedef enum Order { RANDOM, ASCENDING, DESCENDING, FEW_UNIQUE } Order;
+
+static uint64_t keyAt(Order order, size_t index, size_t numElements) {
+  static uint64_t state = 88172645463325252U;
+
+  switch (order) {
+    case ASCENDING:
+      return index;
+    case DESCENDING:
+      return numElements - index;
+    default:
+      state ^= state << 13;
+      state ^= state >> 7;
+      state ^= state << 17;
+      return order == FEW_UNIQUE ? state % 16 : state;
+  }
+}
+
+static void benchmark(const TloType *type, Order order, size_t numElements,
+                      int numIterations, const char *description) {
+  TloDArray *array = tloDArrayMake(type, NULL, numElements);
+  unsigned char *unsorted = malloc(numElements * type->size);
+  if (!array || !unsorted) {
+    puts("error: out of memory");
+    exit(1);
+  }
+
+  for (size_t i = 0; i < numElements; ++i) {
+    // the key is at the start of every element type
+    unsigned char element[sizeof(Key16)] = {0};
+    uint64_t key = keyAt(order, i, numElements);
+    if (type == &tloInt) {
+      int value = (int)(key % INT_MAX);
+      memcpy(element, &value, sizeof(value));
+    } else {
+      memcpy(element, &key, sizeof(key));
+    }
+    memcpy(unsorted + i * type->size, element, type->size);
+    tlovListPushBack(&array->list, element);
+  }
+
+  printf("%s\n", description);
+  Parameters parameters = {.array = array, .unsorted = unsorted};
+  TLO_TIME_TASK(tlovListSortTask, &parameters, numIterations);
+  TLO_TIME_TASK(tloSortTask, &parameters, numIterations);
+  TLO_TIME_TASK(tloRadixSortTask, &parameters, numIterations);
+  TLO_TIME_TASK(qsortTask, &parameters, numIterations);
+
+  free(unsorted);
+  tloListDelete(&array->list);
+}
+
+int main(int argc, char *argv[]) {
+  if (argc < 3) {
+    printf("usage: %s <num-elements> <num-iterations>\n", argv[0]);
+    return 1;
+  }
+
+  size_t numElements = strtoull(argv[1], NULL, 10);
+  if (numElements < 1) {
+    puts("error: given number of elements is invalid");
+    return 1;
+  }
+
+  int numIterations = atoi(argv[2]);
+  if (numIterations < 1) {
+    puts("error: given number of iterations is invalid");
+    return 1;
+  }
+
+  static const char *orderNames[] = {"random", "ascending", "descending",
+                                     "few unique"};
+  const TloType *types[] = {&tloInt, &uint64Type, &key16Type};
+  for (size_t i = 0; i < sizeof(types) / sizeof(types[0]); ++i) {
+    for (int order = RANDOM; order <= FEW_UNIQUE; ++order) {
+      char description[64];
+      snprintf(description, sizeof(description), "%zu byte elements, %s",
+               types[i]->size, orderNames[order]);
+      benchmark(types[i], (Order)order, numElements, numIterations,
+                description);
+    }
+  }
+}
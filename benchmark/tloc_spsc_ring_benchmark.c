@@ -0,0 +1,296 @@
+#define _POSIX_C_SOURCE 200809L
+#include <limits.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <tlo/cdarray.h>
+#include <tlo/spscring.h>
+#include <tlo/statistics.h>
+
+/*
+ * - passes messages from one thread to another through either a TloSPSCRing or
+ *   a TloCDArray behind a mutex
+ * - throughput: the producer sends numMessages messages as fast as it can
+ * - latency: the two threads bounce one message back and forth, and each round
+ *   trip is timed
+ * - times are wall clock, since TloStopwatch measures the CPU time of all
+ *   threads added up
+ */
+enum { BATCH_SIZE = 64 };
+
+typedef uint64_t Message;
+
+static const TloType messageType = {.size = sizeof(Message)};
+
+typedef struct MutexQueue {
+  pthread_mutex_t mutex;
+  TloCDArray array;
+} MutexQueue;
+
+typedef struct Channel {
+  const char *name;
+  void *queue;
+  size_t (*push)(void *queue, const Message *messages, size_t count);
+  size_t (*pop)(void *queue, Message *messages, size_t count);
+} Channel;
+
+static size_t ringPushOne(void *queue, const Message *messages, size_t count) {
+  (void)count;
+  return tloSPSCRingTryPush(queue, messages);
+}
+
+static size_t ringPopOne(void *queue, Message *messages, size_t count) {
+  (void)count;
+  return tloSPSCRingTryPop(queue, messages);
+}
+
+static size_t ringPushMany(void *queue, const Message *messages,
+                           size_t count) {
+  return tloSPSCRingPushMany(queue, messages, count);
+}
+
+static size_t ringPopMany(void *queue, Message *messages, size_t count) {
+  return tloSPSCRingPopMany(queue, messages, count);
+}
+
+static size_t mutexQueuePushOne(void *queue, const Message *messages,
+                                size_t count) {
+  (void)count;
+  MutexQueue *mutexQueue = queue;
+
+  pthread_mutex_lock(&mutexQueue->mutex);
+  TloError error = tlovListPushBack(&mutexQueue->array.list, messages);
+  pthread_mutex_unlock(&mutexQueue->mutex);
+
+  return error == TLO_SUCCESS;
+}
+
+static size_t mutexQueuePopOne(void *queue, Message *messages, size_t count) {
+  (void)count;
+  MutexQueue *mutexQueue = queue;
+  size_t popped = 0;
+
+  pthread_mutex_lock(&mutexQueue->mutex);
+  if (!tlovListIsEmpty(&mutexQueue->array.list)) {
+    *messages = *(const Message *)tlovListFront(&mutexQueue->array.list);
+    tlovListPopFront(&mutexQueue->array.list);
+    popped = 1;
+  }
+  pthread_mutex_unlock(&mutexQueue->mutex);
+
+  return popped;
+}
+
+static long double now(void) {
+  struct timespec time;
+  timespec_get(&time, TIME_UTC);
+  return (long double)time.tv_sec + (long double)time.tv_nsec / 1e9L;
+}
+
+// sends count messages, yielding whenever the channel is full
+static void sendAll(const Channel *channel, Message first, size_t count,
+                    size_t batchSize) {
+  Message batch[BATCH_SIZE];
+  size_t sent = 0;
+
+  while (sent < count) {
+    size_t toSend = count - sent < batchSize ? count - sent : batchSize;
+    for (size_t i = 0; i < toSend; ++i) {
+      batch[i] = first + sent + i;
+    }
+
+    size_t pushed = channel->push(channel->queue, batch, toSend);
+    if (!pushed) {
+      sched_yield();
+    }
+    sent += pushed;
+  }
+}
+
+// receives count messages, yielding whenever the channel is empty
+static Message receiveAll(const Channel *channel, size_t count,
+                          size_t batchSize) {
+  Message batch[BATCH_SIZE];
+  Message sum = 0;
+  size_t received = 0;
+
+  while (received < count) {
+    size_t wanted = count - received < batchSize ? count - received : batchSize;
+    size_t popped = channel->pop(channel->queue, batch, wanted);
+    if (!popped) {
+      sched_yield();
+    }
+    for (size_t i = 0; i < popped; ++i) {
+      sum += batch[i];
+    }
+    received += popped;
+  }
+
+  return sum;
+}
+
+typedef struct ThroughputParameters {
+  const Channel *channel;
+  size_t numMessages;
+  size_t batchSize;
+} ThroughputParameters;
+
+static void *produce(void *parameters) {
+  const ThroughputParameters *p = parameters;
+  sendAll(p->channel, 0, p->numMessages, p->batchSize);
+  return NULL;
+}
+
+static void timeThroughput(const Channel *channel, size_t numMessages,
+                           size_t batchSize) {
+  ThroughputParameters parameters = {
+      .channel = channel, .numMessages = numMessages, .batchSize = batchSize};
+
+  long double start = now();
+  pthread_t producer;
+  if (pthread_create(&producer, NULL, produce, &parameters) != 0) {
+    puts("error: couldn't create producer thread");
+    return;
+  }
+  Message sum = receiveAll(channel, numMessages, batchSize);
+  pthread_join(producer, NULL);
+  long double seconds = now() - start;
+
+  if (sum != (Message)numMessages * (numMessages - 1) / 2) {
+    puts("error: messages got lost");
+    return;
+  }
+
+  printf("%s throughput (batch size %zu)\n", channel->name, batchSize);
+  printf("Number of messages  : %zu\n", numMessages);
+  printf("Total time          : %Lg seconds\n", seconds);
+  printf("Messages per second : %Lg\n", (long double)numMessages / seconds);
+}
+
+typedef struct LatencyParameters {
+  const Channel *request;
+  const Channel *response;
+  size_t numRoundTrips;
+} LatencyParameters;
+
+static void *echo(void *parameters) {
+  const LatencyParameters *p = parameters;
+  for (size_t i = 0; i < p->numRoundTrips; ++i) {
+    Message message = receiveAll(p->request, 1, 1);
+    sendAll(p->response, message, 1, 1);
+  }
+  return NULL;
+}
+
+static void timeLatency(const Channel *request, const Channel *response,
+                        size_t numRoundTrips) {
+  LatencyParameters parameters = {
+      .request = request, .response = response, .numRoundTrips = numRoundTrips};
+
+  pthread_t echoer;
+  if (pthread_create(&echoer, NULL, echo, &parameters) != 0) {
+    puts("error: couldn't create echo thread");
+    return;
+  }
+
+  TloStatAccumulator roundTrips;
+  tloStatAccConstruct(&roundTrips);
+  for (size_t i = 0; i < numRoundTrips; ++i) {
+    long double start = now();
+    sendAll(request, i, 1, 1);
+    receiveAll(response, 1, 1);
+    tloStatAccAdd(&roundTrips, (now() - start) * 1e9L);
+  }
+  pthread_join(echoer, NULL);
+
+  printf("%s round trip latency\n", request->name);
+  printf("Number of round trips: %zu\n", numRoundTrips);
+  printf("Mean                 : %Lg ns\n", tloStatAccMean(&roundTrips));
+  printf("Minimum              : %Lg ns\n", tloStatAccMinimum(&roundTrips));
+  printf("Maximum              : %Lg ns\n", tloStatAccMaximum(&roundTrips));
+}
+
+static void benchmarkSPSCRing(size_t numMessages, size_t capacity) {
+  TloSPSCRing *rings[2] = {tloSPSCRingMake(&messageType, NULL, capacity),
+                           tloSPSCRingMake(&messageType, NULL, capacity)};
+  if (!rings[0] || !rings[1]) {
+    puts("error: out of memory");
+    tloSPSCRingDelete(rings[0]);
+    tloSPSCRingDelete(rings[1]);
+    return;
+  }
+
+  Channel one = {.name = "TloSPSCRing",
+                 .queue = rings[0],
+                 .push = ringPushOne,
+                 .pop = ringPopOne};
+  Channel many = {.name = "TloSPSCRing",
+                  .queue = rings[0],
+                  .push = ringPushMany,
+                  .pop = ringPopMany};
+  Channel back = {.name = "TloSPSCRing",
+                  .queue = rings[1],
+                  .push = ringPushOne,
+                  .pop = ringPopOne};
+
+  timeThroughput(&one, numMessages, 1);
+  timeThroughput(&many, numMessages, BATCH_SIZE);
+  timeLatency(&one, &back, numMessages / 100 + 1);
+
+  tloSPSCRingDelete(rings[0]);
+  tloSPSCRingDelete(rings[1]);
+}
+
+static void benchmarkMutexCDArray(size_t numMessages, size_t capacity) {
+  MutexQueue queues[2];
+  for (int i = 0; i < 2; ++i) {
+    pthread_mutex_init(&queues[i].mutex, NULL);
+    if (tloCDArrayConstruct(&queues[i].array, &messageType, NULL, capacity) !=
+        TLO_SUCCESS) {
+      puts("error: out of memory");
+      return;
+    }
+  }
+
+  Channel one = {.name = "mutex and TloCDArray",
+                 .queue = &queues[0],
+                 .push = mutexQueuePushOne,
+                 .pop = mutexQueuePopOne};
+  Channel back = {.name = "mutex and TloCDArray",
+                  .queue = &queues[1],
+                  .push = mutexQueuePushOne,
+                  .pop = mutexQueuePopOne};
+
+  timeThroughput(&one, numMessages, 1);
+  timeLatency(&one, &back, numMessages / 100 + 1);
+
+  for (int i = 0; i < 2; ++i) {
+    tlovListDestruct(&queues[i].array.list);
+    pthread_mutex_destroy(&queues[i].mutex);
+  }
+}
+
+int main(int argc, char *argv[]) {
+  if (argc < 3) {
+    printf("usage: %s <num-messages> <capacity>\n", argv[0]);
+    return 1;
+  }
+
+  size_t numMessages = strtoull(argv[1], NULL, 10);
+  if (numMessages < 1 || numMessages > INT_MAX) {
+    puts("error: given number of messages is invalid");
+    return 1;
+  }
+
+  size_t capacity = strtoull(argv[2], NULL, 10);
+  if (capacity < 1 || capacity > INT_MAX) {
+    puts("error: given capacity is invalid");
+    return 1;
+  }
+
+  benchmarkSPSCRing(numMessages, capacity);
+  benchmarkMutexCDArray(numMessages, capacity);
+}
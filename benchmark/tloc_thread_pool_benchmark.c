@@ -0,0 +1,140 @@
+#define _POSIX_C_SOURCE 200809L
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+#include <tlo/threadpool.h>
+
+/*
+ * - runs numTasks tiny tasks on a TloThreadPool with n threads, for n from 1
+ *   to the number of cores, to measure how much each task costs the scheduler
+ * - submitted: the main thread submits every task, so they all go through the
+ *   shared queue
+ * - spawned: tasks split themselves in two until there are numTasks leaves,
+ *   so most go through the workers' own deques and get stolen
+ * - parallel for: one call with a grain size of 1
+ * - calling the task function directly in a loop is the baseline
+ * - times are wall clock, since TloStopwatch measures the CPU time of all
+ *   threads added up
+ */
+static void emptyTask(void *argument) { (void)argument; }
+
+// called through a volatile pointer so the loop can't be optimized away
+static void (*volatile directTask)(void *argument) = emptyTask;
+
+static long double now(void) {
+  struct timespec time;
+  timespec_get(&time, TIME_UTC);
+  return (long double)time.tv_sec + (long double)time.tv_nsec / 1e9L;
+}
+
+static void printResult(const char *name, size_t numThreads, size_t numTasks,
+                        long double seconds) {
+  printf("%s, %zu threads\n", name, numThreads);
+  printf("Total time      : %Lg seconds\n", seconds);
+  printf("Tasks per second: %Lg\n", (long double)numTasks / seconds);
+  printf("Time per task   : %Lg ns\n", seconds * 1e9L / (long double)numTasks);
+}
+
+/*
+ * - a subtree of the spawned tasks. its numLeaves descriptors are stored from
+ *   its own one on, and the first is its own
+ */
+typedef struct Spawn {
+  TloThreadPool *pool;
+  TloTaskGroup *group;
+  size_t numLeaves;
+} Spawn;
+
+static void spawn(void *argument);
+
+// keeps splitting numLeaves in two, submitting the second half each time
+static void spawnTree(TloThreadPool *pool, TloTaskGroup *group,
+                      size_t numLeaves, Spawn *spawns) {
+  while (numLeaves > 1) {
+    size_t numKept = numLeaves - numLeaves / 2;
+    spawns[numKept] =
+        (Spawn){.pool = pool, .group = group, .numLeaves = numLeaves / 2};
+    tloThreadPoolSubmit(pool, group, spawn, &spawns[numKept]);
+    numLeaves = numKept;
+  }
+}
+
+static void spawn(void *argument) {
+  Spawn *s = argument;
+  spawnTree(s->pool, s->group, s->numLeaves, s);
+}
+
+static void emptyBody(size_t begin, size_t end, void *argument) {
+  (void)begin;
+  (void)end;
+  (void)argument;
+}
+
+static void benchmarkThreadPool(size_t numTasks, size_t numThreads,
+                                Spawn *spawns) {
+  TloThreadPool *pool = tloThreadPoolMake(numThreads, NULL);
+  if (!pool) {
+    puts("error: couldn't start thread pool");
+    exit(1);
+  }
+
+  long double start = now();
+  for (size_t i = 0; i < numTasks; ++i) {
+    tloThreadPoolSubmit(pool, NULL, emptyTask, NULL);
+  }
+  tloThreadPoolWait(pool, NULL);
+  printResult("Submitted", numThreads, numTasks, now() - start);
+
+  TloTaskGroup group;
+  tloTaskGroupConstruct(&group);
+  start = now();
+  spawnTree(pool, &group, numTasks, spawns);
+  tloThreadPoolWait(pool, &group);
+  printResult("Spawned", numThreads, numTasks, now() - start);
+
+  start = now();
+  tloThreadPoolParallelFor(pool, 0, numTasks, 1, emptyBody, NULL);
+  printResult("Parallel for", numThreads, numTasks, now() - start);
+
+  tloThreadPoolDelete(pool);
+}
+
+int main(int argc, char *argv[]) {
+  if (argc < 2) {
+    printf("usage: %s <num-tasks> [max-threads]\n", argv[0]);
+    return 1;
+  }
+
+  size_t numTasks = strtoull(argv[1], NULL, 10);
+  if (numTasks < 1 || numTasks > INT_MAX) {
+    puts("error: given number of tasks is invalid");
+    return 1;
+  }
+
+  // defaults to the number of cores
+  long maxThreads = argc > 2 ? atol(argv[2]) : sysconf(_SC_NPROCESSORS_ONLN);
+  if (maxThreads < 1 || maxThreads > 256) {
+    puts("error: given maximum number of threads is invalid");
+    return 1;
+  }
+
+  Spawn *spawns = malloc(numTasks * sizeof(spawns[0]));
+  if (!spawns) {
+    puts("error: out of memory");
+    return 1;
+  }
+
+  long double start = now();
+  for (size_t i = 0; i < numTasks; ++i) {
+    directTask(NULL);
+  }
+  printResult("Direct calls", 1, numTasks, now() - start);
+
+  for (size_t numThreads = 1; numThreads <= (size_t)maxThreads; ++numThreads) {
+    benchmarkThreadPool(numTasks, numThreads, spawns);
+  }
+
+  free(spawns);
+}
@@ -0,0 +1,196 @@
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <tlo/benchmark.h>
+#include <tlo/priorityqueue.h>
+#include <tlo/timerwheel.h>
+
+/*
+ * - models connection timeouts: each of numTimers connections has a timeout
+ *   pending, and each operation is activity on a random connection, which
+ *   pushes its timeout back. the clock ticks once every OPERATIONS_PER_TICK
+ *   operations, and connections that time out are reopened with a new
+ *   timeout
+ * - compares TloTimerWheel against TloPriorityQueue with handles, which
+ *   removes a timeout and pushes a new one for each operation
+ * - a timeout's delay depends only on its connection and when it's set, so
+ *   both take the same timeouts and count the same number of them
+ */
+enum { MAX_DELAY = 1 << 16, OPERATIONS_PER_TICK = 64 };
+
+typedef struct Parameters {
+  size_t numTimers;
+  size_t numOperations;
+} Parameters;
+
+// set by the first task that runs
+static size_t expectedNumTimeouts;
+
+static uint64_t delayOf(size_t connection, uint64_t now) {
+  uint64_t hash = ((uint64_t)connection << 32 ^ now) *
+                  UINT64_C(0x9E3779B97F4A7C15);
+  return 1 + (hash >> 40) % MAX_DELAY;
+}
+
+static size_t randomConnection(uint64_t *state, size_t numTimers) {
+  *state ^= *state << 13;
+  *state ^= *state >> 7;
+  *state ^= *state << 17;
+  return (size_t)((*state >> 8) % numTimers);
+}
+
+static void checkNumTimeouts(size_t numTimeouts) {
+  if (!expectedNumTimeouts) {
+    expectedNumTimeouts = numTimeouts;
+    printf("Timeouts            : %zu\n", numTimeouts);
+  } else if (numTimeouts != expectedNumTimeouts) {
+    puts("error: timeouts differ");
+    exit(1);
+  }
+}
+
+static void outOfMemory(void) {
+  puts("error: out of memory");
+  exit(1);
+}
+
+static void timerWheel(const void *parameters) {
+  const Parameters *p = parameters;
+  TloTimer *timers = malloc(p->numTimers * sizeof(*timers));
+  TloTimerWheel *wheel = malloc(sizeof(*wheel));
+  if (!timers || !wheel) {
+    outOfMemory();
+  }
+
+  uint64_t now = 0;
+  tloTimerWheelConstruct(wheel, now);
+  for (size_t i = 0; i < p->numTimers; ++i) {
+    tloTimerConstruct(&timers[i]);
+    tloTimerWheelSchedule(wheel, &timers[i], now + delayOf(i, now));
+  }
+
+  uint64_t state = 88172645463325252U;
+  size_t numTimeouts = 0;
+  TloIDLList expired;
+  tloIDLListConstruct(&expired);
+  for (size_t i = 0; i < p->numOperations; ++i) {
+    size_t connection = randomConnection(&state, p->numTimers);
+    tloTimerWheelCancel(wheel, &timers[connection]);
+    tloTimerWheelSchedule(wheel, &timers[connection],
+                          now + delayOf(connection, now));
+
+    if ((i + 1) % OPERATIONS_PER_TICK == 0) {
+      ++now;
+      numTimeouts += tloTimerWheelAdvance(wheel, now, &expired);
+      while (!tloIDLListIsEmpty(&expired)) {
+        TloTimer *timer =
+            TLO_CONTAINER_OF(tloIDLListPopFront(&expired), TloTimer, hook);
+        size_t timedOut = (size_t)(timer - timers);
+        tloTimerWheelSchedule(wheel, timer, now + delayOf(timedOut, now));
+      }
+    }
+  }
+
+  free(wheel);
+  free(timers);
+  checkNumTimeouts(numTimeouts);
+}
+
+typedef struct Timeout {
+  uint64_t deadline;
+  size_t connection;
+} Timeout;
+
+static int timeoutTypeCompare(const void *object1, const void *object2) {
+  const Timeout *timeout1 = object1;
+  const Timeout *timeout2 = object2;
+  return timeout1->deadline < timeout2->deadline
+             ? -1
+             : timeout1->deadline > timeout2->deadline;
+}
+
+static const TloType timeoutType = {.size = sizeof(Timeout),
+                                    .compare = timeoutTypeCompare};
+
+static void schedule(TloPriorityQueue *queue, TloPriorityQueueHandle *handles,
+                     size_t connection, uint64_t now) {
+  Timeout timeout = {.deadline = now + delayOf(connection, now),
+                     .connection = connection};
+  if (tloPriorityQueuePush(queue, &timeout, &handles[connection]) !=
+      TLO_SUCCESS) {
+    outOfMemory();
+  }
+}
+
+static void priorityQueue(const void *parameters) {
+  const Parameters *p = parameters;
+  TloPriorityQueueHandle *handles = malloc(p->numTimers * sizeof(*handles));
+  TloPriorityQueue queue;
+  if (!handles ||
+      tloPriorityQueueConstruct(&queue, &timeoutType, NULL, 4, true) !=
+          TLO_SUCCESS) {
+    outOfMemory();
+  }
+
+  uint64_t now = 0;
+  for (size_t i = 0; i < p->numTimers; ++i) {
+    schedule(&queue, handles, i, now);
+  }
+
+  uint64_t state = 88172645463325252U;
+  size_t numTimeouts = 0;
+  for (size_t i = 0; i < p->numOperations; ++i) {
+    size_t connection = randomConnection(&state, p->numTimers);
+    tloPriorityQueueRemove(&queue, handles[connection]);
+    schedule(&queue, handles, connection, now);
+
+    if ((i + 1) % OPERATIONS_PER_TICK == 0) {
+      ++now;
+      for (;;) {
+        const Timeout *top = tloPriorityQueueTop(&queue);
+        if (top->deadline > now) {
+          break;
+        }
+        size_t timedOut = top->connection;
+        tloPriorityQueuePop(&queue);
+        schedule(&queue, handles, timedOut, now);
+        ++numTimeouts;
+      }
+    }
+  }
+
+  tloPriorityQueueDestruct(&queue);
+  free(handles);
+  checkNumTimeouts(numTimeouts);
+}
+
+int main(int argc, char *argv[]) {
+  if (argc < 4) {
+    printf("usage: %s <num-timers> <num-operations> <num-iterations>\n",
+           argv[0]);
+    return 1;
+  }
+
+  size_t numTimers = strtoull(argv[1], NULL, 10);
+  if (numTimers < 1 || numTimers > UINT32_MAX) {
+    puts("error: given number of timers is invalid");
+    return 1;
+  }
+
+  size_t numOperations = strtoull(argv[2], NULL, 10);
+  if (numOperations < 1) {
+    puts("error: given number of operations is invalid");
+    return 1;
+  }
+
+  int numIterations = atoi(argv[3]);
+  if (numIterations < 1) {
+    puts("error: given number of iterations is invalid");
+    return 1;
+  }
+
+  Parameters parameters = {.numTimers = numTimers,
+                           .numOperations = numOperations};
+  TLO_TIME_TASK(timerWheel, &parameters, numIterations);
+  TLO_TIME_TASK(priorityQueue, &parameters, numIterations);
+}
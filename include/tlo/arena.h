@@ -0,0 +1,66 @@
+#ifndef TLO_ARENA_H
+#define TLO_ARENA_H
+
+#include "tlo/util.h"
+
+/*
+ * - bump allocator that hands out memory from large blocks
+ * - free is a no-op. memory is given back all at once with tloArenaReset or
+ *   tloArenaDestruct, which take time proportional to the number of blocks
+ *   rather than the number of allocations
+ * - sizedFree and realloc of the most recent allocation shrink or grow it in
+ *   place, so stack-like usage doesn't use up the current block
+ * - every allocation is aligned for any type, like C's malloc
+ * - allocations bigger than a block get a block of their own
+ * - the arena's allocator stores the arena's address as its context, so an
+ *   arena must not be moved or copied after it is constructed
+ * - a container using an arena doesn't have to be destructed before the arena
+ *   is reset, as long as its elements don't own memory from another allocator
+ *   and the container isn't used afterwards
+ */
+typedef struct TloArenaBlock TloArenaBlock;
+
+typedef struct TloArena {
+  // public, use only for passing to functions that take a TloAllocator
+  TloAllocator allocator;
+
+  // private
+  const TloAllocator *blockAllocator;
+  size_t blockSize;
+  TloArenaBlock *blocks;
+  unsigned char *position;
+  unsigned char *end;
+} TloArena;
+
+enum { TLO_ARENA_DEFAULT_BLOCK_SIZE = 64 * 1024 };
+
+/*
+ * - blocks are allocated with blockAllocator when needed
+ * - if blockAllocator is NULL, uses tloCStdLibAllocator
+ * - if blockSize is 0, uses TLO_ARENA_DEFAULT_BLOCK_SIZE
+ */
+void tloArenaConstruct(TloArena *arena, const TloAllocator *blockAllocator,
+                       size_t blockSize);
+
+/*
+ * - frees all blocks, which invalidates all memory allocated from arena
+ */
+void tloArenaDestruct(TloArena *arena);
+
+/*
+ * - uses given block allocator's malloc then tloArenaConstruct
+ */
+TloArena *tloArenaMake(const TloAllocator *blockAllocator, size_t blockSize);
+
+/*
+ * - tloArenaDestruct then block allocator's free
+ */
+void tloArenaDelete(TloArena *arena);
+
+/*
+ * - invalidates all memory allocated from arena
+ * - keeps the current block for reuse and frees the others
+ */
+void tloArenaReset(TloArena *arena);
+
+#endif  // TLO_ARENA_H
@@ -0,0 +1,109 @@
+#ifndef TLO_BITSET_H
+#define TLO_BITSET_H
+
+#include "tlo/util.h"
+
+/*
+ * - a dynamically sized array of bits, and a set of small non-negative
+ *   integer keys that takes one bit per possible key, where a TloSCHTableSet
+ *   takes dozens of bytes per key it holds
+ * - bits are kept in uint64_t words. the bulk operations go a word at a time
+ *   in loops the compiler vectorizes, with SSE2 on any x86-64 CPU, or with
+ *   AVX2 if built with TLOC_TARGET_NATIVE on a CPU that has it
+ * - the bits past size in the last word are always 0, so whole words can be
+ *   counted and compared
+ */
+typedef struct TloBitset {
+  // private
+  uint64_t *words;
+  size_t size;
+  size_t capacity;
+  const TloAllocator *allocator;
+} TloBitset;
+
+/*
+ * - constructs a bitset of size bits, all 0
+ * - if allocator is NULL, uses tloCStdLibAllocator
+ * - returns TLO_ERROR if memory can't be allocated
+ */
+TloError tloBitsetConstruct(TloBitset *bitset, size_t size,
+                            const TloAllocator *allocator);
+
+void tloBitsetDestruct(TloBitset *bitset);
+
+/*
+ * - uses given allocator's malloc then tloBitsetConstruct
+ * - if allocator is NULL, uses tloCStdLibAllocator
+ */
+TloBitset *tloBitsetMake(size_t size, const TloAllocator *allocator);
+
+// uses tloBitsetDestruct then bitset's allocator's free
+void tloBitsetDelete(TloBitset *bitset);
+
+// number of bits, not the number of 1 bits, which is tloBitsetCount
+size_t tloBitsetSize(const TloBitset *bitset);
+
+/*
+ * - bits added at the end are 0
+ * - returns TLO_ERROR if memory can't be allocated, leaving bitset as is
+ */
+TloError tloBitsetResize(TloBitset *bitset, size_t size);
+
+// index must be less than size
+bool tloBitsetTest(const TloBitset *bitset, size_t index);
+void tloBitsetSet(TloBitset *bitset, size_t index);
+void tloBitsetClear(TloBitset *bitset, size_t index);
+void tloBitsetFlip(TloBitset *bitset, size_t index);
+
+void tloBitsetSetAll(TloBitset *bitset);
+void tloBitsetClearAll(TloBitset *bitset);
+
+// number of 1 bits
+size_t tloBitsetCount(const TloBitset *bitset);
+
+// returns true if any bit is 1
+bool tloBitsetAny(const TloBitset *bitset);
+
+/*
+ * - returns the index of the first 1 bit at or after index, or size if there
+ *   is none. index can be size
+ * - goes through the 1 bits in order with:
+ *   for (size_t i = tloBitsetFindNext(bitset, 0); i < tloBitsetSize(bitset);
+ *        i = tloBitsetFindNext(bitset, i + 1))
+ */
+size_t tloBitsetFindNext(const TloBitset *bitset, size_t index);
+
+/*
+ * - the bulk operations set bitset to bitset op other, bit by bit. bits past
+ *   other's size count as 0
+ * - bitset and other can be the same
+ */
+void tloBitsetAnd(TloBitset *bitset, const TloBitset *other);
+
+// bitset AND NOT other, which removes other's keys from bitset
+void tloBitsetAndNot(TloBitset *bitset, const TloBitset *other);
+
+/*
+ * - if other is bigger than bitset, first resizes bitset to other's size
+ * - returns TLO_ERROR if memory can't be allocated, leaving bitset as is
+ */
+TloError tloBitsetOr(TloBitset *bitset, const TloBitset *other);
+TloError tloBitsetXor(TloBitset *bitset, const TloBitset *other);
+
+/*
+ * - the set functions treat bitset as the set of the indices of its 1 bits
+ * - sets bit key, first growing bitset to key + 1 bits if it's smaller. the
+ *   memory for the bits is grown by at least doubling, so inserting keys
+ *   counting up is amortized O(1)
+ * - returns TLO_DUPLICATE if bit key was already 1
+ * - returns TLO_ERROR if memory can't be allocated, leaving bitset as is
+ */
+TloError tloBitsetInsert(TloBitset *bitset, size_t key);
+
+// returns false if key is not less than size
+bool tloBitsetContains(const TloBitset *bitset, size_t key);
+
+// returns true if bit key was 1 and is now 0
+bool tloBitsetRemove(TloBitset *bitset, size_t key);
+
+#endif  // TLO_BITSET_H
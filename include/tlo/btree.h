@@ -0,0 +1,89 @@
+#ifndef TLO_BTREE_H
+#define TLO_BTREE_H
+
+#include "tlo/map.h"
+
+/*
+ * - a node holds between minDegree - 1 and 2 * minDegree - 1 keys, with their
+ *   values, and one more children than keys if it isn't a leaf. only the root
+ *   can have fewer keys
+ * - keys, values, and children are stored inline after this header, in one
+ *   allocation, in that order
+ */
+typedef struct TloBTreeNode {
+  // private
+  struct TloBTreeNode *parent;
+  size_t numKeys;
+  bool isLeaf;
+} TloBTreeNode;
+
+/*
+ * - ordered map, kept sorted by key type's compare, which must not be NULL
+ * - a B-tree with nodes of a few cache lines, so a lookup touches O(log n)
+ *   nodes and binary searches a handful of cache lines in each. each key and
+ *   value is stored once, inline in its node
+ * - insertion and removal split, merge, and rebalance nodes on the way down,
+ *   so they never have to come back up
+ * - keys and values are moved between nodes with memcpy, so insertion and
+ *   removal invalidate pointers to them and all cursors
+ */
+typedef struct TloBTreeMap {
+  // public, use only for passing to tloMap and tlovMap functions
+  TloMap map;
+
+  // private
+  TloBTreeNode *root;
+  size_t size;
+  size_t minDegree;
+  size_t valuesOffset;
+  size_t childrenOffset;
+} TloBTreeMap;
+
+/*
+ * - a position in a TloBTreeMap's keys in ascending order, or the end, which
+ *   is past the greatest key
+ */
+typedef struct TloBTreeCursor {
+  // private
+  const TloBTreeMap *btree;
+  TloBTreeNode *node;
+  size_t index;
+} TloBTreeCursor;
+
+void tloBTreeMapConstruct(TloBTreeMap *btree, const TloType *keyType,
+                          const TloType *valueType,
+                          const TloAllocator *allocator);
+
+TloBTreeMap *tloBTreeMapMake(const TloType *keyType, const TloType *valueType,
+                             const TloAllocator *allocator);
+
+// points cursor at the least key, or the end if btree is empty
+void tloBTreeMapFirst(const TloBTreeMap *btree, TloBTreeCursor *cursor);
+
+/*
+ * - points cursor at the first key that is not less than key, or the end if
+ *   there is none
+ * - for range scans: the keys k with low <= k < high are the ones from
+ *   LowerBound(low) on, until a key is not less than high
+ */
+void tloBTreeMapLowerBound(const TloBTreeMap *btree, const void *key,
+                           TloBTreeCursor *cursor);
+
+// points cursor at the first key that is greater than key, or the end
+void tloBTreeMapUpperBound(const TloBTreeMap *btree, const void *key,
+                           TloBTreeCursor *cursor);
+
+bool tloBTreeCursorIsEnd(const TloBTreeCursor *cursor);
+
+// cursor must not be at the end
+const void *tloBTreeCursorKey(const TloBTreeCursor *cursor);
+const void *tloBTreeCursorValue(const TloBTreeCursor *cursor);
+void *tloBTreeCursorMutableValue(TloBTreeCursor *cursor);
+
+/*
+ * - moves cursor to the next greater key, or the end
+ * - cursor must not be at the end
+ */
+void tloBTreeCursorNext(TloBTreeCursor *cursor);
+
+#endif  // TLO_BTREE_H
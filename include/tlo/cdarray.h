@@ -5,6 +5,8 @@
 
 /*
  * - circular dynamic array
+ * - capacity is always 0 or a power of 2, so indexing wraps around with a mask
+ *   instead of a division
  */
 typedef struct TloCDArray {
   // public, use only for passing to tloList and tlovList functions
@@ -17,6 +19,10 @@ typedef struct TloCDArray {
   size_t capacity;
 } TloCDArray;
 
+/*
+ * - rounds capacity up to the nearest power of 2
+ * - returns TLO_ERROR if that power of 2 doesn't fit in a size_t
+ */
 TloError tloCDArrayConstruct(TloCDArray *array, const TloType *valueType,
                              const TloAllocator *allocator, size_t capacity);
 
@@ -41,4 +47,60 @@ TloCDArray *tloCDArrayMakeCopy(const TloCDArray *other);
  */
 TloError tloCDArrayCopy(TloCDArray *array, const TloCDArray *other);
 
+/*
+ * - a run of size contiguous elements starting at elements
+ * - if size is 0, elements is NULL
+ */
+typedef struct TloCDArraySpan {
+  // public
+  const void *elements;
+  size_t size;
+} TloCDArraySpan;
+
+typedef struct TloCDArrayMutableSpan {
+  // public
+  void *elements;
+  size_t size;
+} TloCDArrayMutableSpan;
+
+/*
+ * - sets spans[0] and spans[1] to the at most 2 contiguous runs that hold
+ *   array's elements, from front to back. spans that aren't needed are empty
+ * - returns the number of spans that aren't empty: 0, 1, or 2
+ * - lets elements be handed to memcpy or writev without a call per element
+ * - spans are invalidated by any call that changes array
+ */
+size_t tloCDArraySpans(const TloCDArray *array, TloCDArraySpan spans[2]);
+size_t tloCDArrayMutableSpans(TloCDArray *array,
+                              TloCDArrayMutableSpan spans[2]);
+
+/*
+ * - like tloCDArrayMutableSpans, but for the unused slots just after the back,
+ *   in the order that tloCDArrayProduce appends them
+ * - use tloCDArrayReserve first to make sure there are enough of them
+ */
+size_t tloCDArrayFreeSpans(TloCDArray *array, TloCDArrayMutableSpan spans[2]);
+
+/*
+ * - makes capacity at least the given capacity, rounded up to a power of 2
+ * - keeps elements, but invalidates spans
+ */
+TloError tloCDArrayReserve(TloCDArray *array, size_t capacity);
+
+/*
+ * - destructs the count elements at the front and removes them
+ * - like count calls of tlovListPopFront, but advances front in one step
+ * - count must not be more than the size
+ */
+void tloCDArrayConsume(TloCDArray *array, size_t count);
+
+/*
+ * - appends the count elements that were written to the front of the free
+ *   spans, for example with memcpy or readv
+ * - the elements are taken as they are and not copied with the value type's
+ *   constructCopy
+ * - count must not be more than capacity minus size
+ */
+void tloCDArrayProduce(TloCDArray *array, size_t count);
+
 #endif  // TLO_CDARRAY_H
@@ -8,9 +8,11 @@
  */
 typedef struct TloDLLNode {
   // private
-  void *data;
   struct TloDLLNode *next;
   struct TloDLLNode *prev;
+
+  // the element, stored in the same allocation as the node
+  _Alignas(max_align_t) unsigned char data[];
 } TloDLLNode;
 
 typedef struct TloDLList {
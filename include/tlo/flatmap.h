@@ -0,0 +1,122 @@
+#ifndef TLO_FLATMAP_H
+#define TLO_FLATMAP_H
+
+#include "tlo/darray.h"
+#include "tlo/map.h"
+#include "tlo/set.h"
+
+/*
+ * - sorted set and map that keep their keys in a TloDArray, in ascending order
+ *   of key type's compare, which must not be NULL, and find them with binary
+ *   search
+ * - use a third of the memory of TloSCHTable and iterate in order, at the
+ *   cost of O(log n) lookups, which are several times slower than hashing, and
+ *   O(n) insertion and removal, since the keys after the one inserted or
+ *   removed are shifted over. best for maps that are read far more than they
+ *   are written, or built all at once with the FromArray functions
+ * - the map keeps its values in a second TloDArray, so searches only touch
+ *   keys
+ * - an insert pushes the new element onto the back of the TloDArray and
+ *   rotates it down to its place, and a remove rotates the element to the
+ *   back and pops it. a rotation goes through the element in chunks of up to
+ *   64 bytes, each moving everything after the element with one memmove, so
+ *   an element bigger than 64 bytes makes several passes over the elements
+ *   after it
+ * - pointers to keys and values are invalidated by insertion and removal
+ */
+typedef struct TloFlatSet {
+  // public, use only for passing to tloSet and tlovSet functions
+  TloSet set;
+
+  // private
+  TloDArray keys;
+} TloFlatSet;
+
+typedef struct TloFlatMap {
+  // public, use only for passing to tloMap and tlovMap functions
+  TloMap map;
+
+  // private
+  TloDArray keys;
+  TloDArray values;
+} TloFlatMap;
+
+void tloFlatSetConstruct(TloFlatSet *set, const TloType *keyType,
+                         const TloAllocator *allocator);
+void tloFlatMapConstruct(TloFlatMap *map, const TloType *keyType,
+                         const TloType *valueType,
+                         const TloAllocator *allocator);
+
+/*
+ * - constructs the set with copies of the count keys in the array keys
+ * - sorts them once and drops repeated keys, which is O(n log n) instead of
+ *   the O(n^2) of inserting them one at a time. of keys that are equal, the
+ *   first one is kept
+ * - returns TLO_ERROR if memory can't be allocated or a key can't be copied,
+ *   leaving set unconstructed
+ */
+TloError tloFlatSetConstructFromArray(TloFlatSet *set, const TloType *keyType,
+                                      const TloAllocator *allocator,
+                                      const void *keys, size_t count);
+
+/*
+ * - like tloFlatSetConstructFromArray, where the value of keys[i] is
+ *   values[i], and a key that is repeated keeps its first value
+ */
+TloError tloFlatMapConstructFromArrays(TloFlatMap *map, const TloType *keyType,
+                                       const TloType *valueType,
+                                       const TloAllocator *allocator,
+                                       const void *keys, const void *values,
+                                       size_t count);
+
+TloFlatSet *tloFlatSetMake(const TloType *keyType,
+                           const TloAllocator *allocator);
+TloFlatMap *tloFlatMapMake(const TloType *keyType, const TloType *valueType,
+                           const TloAllocator *allocator);
+
+/*
+ * - uses given allocator's malloc then tloFlatSetConstructFromArray or
+ *   tloFlatMapConstructFromArrays
+ */
+TloFlatSet *tloFlatSetMakeFromArray(const TloType *keyType,
+                                    const TloAllocator *allocator,
+                                    const void *keys, size_t count);
+TloFlatMap *tloFlatMapMakeFromArrays(const TloType *keyType,
+                                     const TloType *valueType,
+                                     const TloAllocator *allocator,
+                                     const void *keys, const void *values,
+                                     size_t count);
+
+/*
+ * - returns the key at index in ascending order, which must be less than the
+ *   size
+ */
+const void *tloFlatSetKey(const TloFlatSet *set, size_t index);
+const void *tloFlatMapKey(const TloFlatMap *map, size_t index);
+
+/*
+ * - returns the value of the key at index in ascending order, which must be
+ *   less than the size
+ */
+const void *tloFlatMapValue(const TloFlatMap *map, size_t index);
+void *tloFlatMapMutableValue(TloFlatMap *map, size_t index);
+
+/*
+ * - returns the index of the first key that is not less than key, or the size
+ *   if there is none
+ * - for range queries: the keys k with low <= k < high are the ones at the
+ *   indices from LowerBound(low) up to, but not including, LowerBound(high)
+ */
+size_t tloFlatSetLowerBound(const TloFlatSet *set, const void *key);
+size_t tloFlatMapLowerBound(const TloFlatMap *map, const void *key);
+
+/*
+ * - returns the index of the first key that is greater than key, or the size
+ *   if there is none
+ * - the keys k with low <= k <= high are the ones at the indices from
+ *   LowerBound(low) up to, but not including, UpperBound(high)
+ */
+size_t tloFlatSetUpperBound(const TloFlatSet *set, const void *key);
+size_t tloFlatMapUpperBound(const TloFlatMap *map, const void *key);
+
+#endif  // TLO_FLATMAP_H
@@ -0,0 +1,74 @@
+#ifndef TLO_HUGEPAGE_H
+#define TLO_HUGEPAGE_H
+
+#include "tlo/util.h"
+
+/*
+ * - allocator that backs big allocations with huge pages to cut TLB misses
+ *   when they're accessed randomly, for example big TloDArrays and hash table
+ *   bucket arrays
+ * - allocations of at least threshold bytes get their own mapping made with
+ *   mmap, aligned to TLO_HUGE_PAGE_SIZE and marked with
+ *   madvise(MADV_HUGEPAGE). the kernel backs it with huge pages when
+ *   transparent huge pages are enabled and it can find them
+ * - a mapping is the size asked for rounded up to a multiple of
+ *   TLO_HUGE_PAGE_SIZE, so a request for exactly TLO_HUGE_PAGE_SIZE bytes
+ *   takes one huge page, but one for a byte more takes two. each mapping is
+ *   also tracked by a small node from the small allocator
+ * - realloc of a big allocation that stays big gives back the huge pages it
+ *   no longer needs when shrinking, and grows with mremap without copying,
+ *   in place if the address space after it is free, otherwise by moving its
+ *   pages to a new aligned mapping
+ * - smaller allocations go to the small allocator
+ * - the mappings are kept in a list. tloAllocatorSizedFree and
+ *   tloAllocatorRealloc only search it for big sizes, but tloAllocatorFree
+ *   doesn't know the size and searches it for every allocation, which takes
+ *   time linear in the number of big allocations, so prefer sized free
+ * - memory from big allocations starts out zeroed, so calloc doesn't need to
+ *   touch it
+ * - only Linux is supported. on other systems, every allocation goes to the
+ *   small allocator
+ * - the allocator stores the TloHugePageAllocator's address as its context, so
+ *   it must not be moved or copied after it is constructed
+ * - not thread-safe
+ */
+enum { TLO_HUGE_PAGE_SIZE = 2 * 1024 * 1024 };
+
+typedef struct TloHugePageMapping TloHugePageMapping;
+
+typedef struct TloHugePageAllocator {
+  // public, use only for passing to functions that take a TloAllocator
+  TloAllocator allocator;
+
+  // private
+  const TloAllocator *smallAllocator;
+  size_t threshold;
+  TloHugePageMapping *mappings;
+} TloHugePageAllocator;
+
+/*
+ * - if smallAllocator is NULL, uses tloCStdLibAllocator
+ * - if threshold is 0, uses TLO_HUGE_PAGE_SIZE
+ */
+void tloHugePageAllocatorConstruct(TloHugePageAllocator *allocator,
+                                   const TloAllocator *smallAllocator,
+                                   size_t threshold);
+
+/*
+ * - unmaps the mappings of big allocations that haven't been freed yet
+ * - doesn't free small allocations that haven't been freed yet
+ */
+void tloHugePageAllocatorDestruct(TloHugePageAllocator *allocator);
+
+/*
+ * - uses given small allocator's malloc then tloHugePageAllocatorConstruct
+ */
+TloHugePageAllocator *tloHugePageAllocatorMake(
+    const TloAllocator *smallAllocator, size_t threshold);
+
+/*
+ * - tloHugePageAllocatorDestruct then small allocator's free
+ */
+void tloHugePageAllocatorDelete(TloHugePageAllocator *allocator);
+
+#endif  // TLO_HUGEPAGE_H
@@ -0,0 +1,61 @@
+#ifndef TLO_IDLLIST_H
+#define TLO_IDLLIST_H
+
+#include "tlo/util.h"
+
+/*
+ * - intrusive doubly-linked list
+ * - elements are user objects that embed a TloIDLLHook. the list only links
+ *   hooks together, so it never allocates, copies, or destructs anything
+ * - use TLO_CONTAINER_OF to get from a hook back to its object
+ * - a hook can be in at most one list at a time. an object can be in several
+ *   lists at once by embedding several hooks
+ * - the objects must outlive their time in the list
+ */
+typedef struct TloIDLLHook {
+  // private
+  struct TloIDLLHook *next;
+  struct TloIDLLHook *prev;
+} TloIDLLHook;
+
+typedef struct TloIDLList {
+  // private
+  TloIDLLHook *head;
+  TloIDLLHook *tail;
+  size_t size;
+} TloIDLList;
+
+void tloIDLListConstruct(TloIDLList *list);
+
+size_t tloIDLListSize(const TloIDLList *list);
+bool tloIDLListIsEmpty(const TloIDLList *list);
+
+const TloIDLLHook *tloIDLListHead(const TloIDLList *list);
+TloIDLLHook *tloIDLListMutableHead(TloIDLList *list);
+const TloIDLLHook *tloIDLListTail(const TloIDLList *list);
+TloIDLLHook *tloIDLListMutableTail(TloIDLList *list);
+
+// hook must not be in a list
+void tloIDLListPushBack(TloIDLList *list, TloIDLLHook *hook);
+void tloIDLListPushFront(TloIDLList *list, TloIDLLHook *hook);
+
+/*
+ * - links hook right before position, which must be in list
+ * - if position is NULL, links hook at the back
+ */
+void tloIDLListInsertBefore(TloIDLList *list, TloIDLLHook *position,
+                            TloIDLLHook *hook);
+
+// O(1), hook must be in list
+void tloIDLListRemove(TloIDLList *list, TloIDLLHook *hook);
+
+// returns the unlinked hook
+TloIDLLHook *tloIDLListPopFront(TloIDLList *list);
+TloIDLLHook *tloIDLListPopBack(TloIDLList *list);
+
+const TloIDLLHook *tloIDLLHookNext(const TloIDLLHook *hook);
+TloIDLLHook *tloIDLLHookMutableNext(TloIDLLHook *hook);
+const TloIDLLHook *tloIDLLHookPrev(const TloIDLLHook *hook);
+TloIDLLHook *tloIDLLHookMutablePrev(TloIDLLHook *hook);
+
+#endif  // TLO_IDLLIST_H
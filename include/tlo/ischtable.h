@@ -0,0 +1,75 @@
+#ifndef TLO_ISCHTABLE_H
+#define TLO_ISCHTABLE_H
+
+#include "tlo/util.h"
+
+/*
+ * - intrusive separate chaining hash table
+ * - elements are user objects that embed a TloISCHTHook. the table only links
+ *   hooks into its buckets, so it never allocates, copies, or destructs
+ *   elements. only the bucket array is allocated, with the given allocator
+ * - the table finds an element's key by calling the given key function on its
+ *   hook. use TLO_CONTAINER_OF in it to get from the hook to the object
+ * - the key of an element must not change while it is in the table
+ * - a hook can be in at most one table at a time
+ */
+typedef struct TloISCHTHook {
+  // private
+  struct TloISCHTHook *next;
+
+  // points to the previous hook's next, or the bucket, for O(1) removal
+  struct TloISCHTHook **prevNext;
+
+  // cached so growing and shrinking the bucket array don't rehash keys
+  size_t hash;
+} TloISCHTHook;
+
+typedef const void *(*TloISCHTKeyFunction)(const TloISCHTHook *hook);
+
+typedef struct TloISCHTable {
+  // private
+  const TloType *keyType;
+  TloISCHTKeyFunction key;
+  const TloAllocator *allocator;
+  TloISCHTHook **array;
+  size_t size;
+  size_t capacity;
+} TloISCHTable;
+
+/*
+ * - uses keyType's equals and hash
+ * - if allocator is NULL, uses tloCStdLibAllocator
+ * - doesn't allocate. the bucket array is allocated on the first insert
+ */
+void tloISCHTableConstruct(TloISCHTable *table, const TloType *keyType,
+                           TloISCHTKeyFunction key,
+                           const TloAllocator *allocator);
+
+/*
+ * - frees the bucket array
+ * - doesn't touch the elements still in table
+ */
+void tloISCHTableDestruct(TloISCHTable *table);
+
+size_t tloISCHTableSize(const TloISCHTable *table);
+bool tloISCHTableIsEmpty(const TloISCHTable *table);
+
+/*
+ * - links hook into table
+ * - returns TLO_DUPLICATE if an element with an equal key is already in table
+ * - returns TLO_ERROR if the bucket array can't be allocated or grown
+ */
+TloError tloISCHTableInsert(TloISCHTable *table, TloISCHTHook *hook);
+
+// returns the hook of the element whose key equals key, or NULL
+const TloISCHTHook *tloISCHTableFind(const TloISCHTable *table,
+                                     const void *key);
+TloISCHTHook *tloISCHTableMutableFind(TloISCHTable *table, const void *key);
+
+/*
+ * - unlinks hook, which must be in table, in O(1) without looking at keys
+ * - may shrink the bucket array. if that fails, the array is kept as is
+ */
+void tloISCHTableRemove(TloISCHTable *table, TloISCHTHook *hook);
+
+#endif  // TLO_ISCHTABLE_H
@@ -3,6 +3,10 @@
 
 #include "tlo/util.h"
 
+// the parallel sorts only take a pointer, so users don't need threadpool.h's
+// headers
+typedef struct TloThreadPool TloThreadPool;
+
 typedef struct TloList TloList;
 
 typedef struct TloListVTable {
@@ -29,6 +33,18 @@ typedef struct TloListVTable {
   void (*popFront)(TloList *list);
   void (*popBack)(TloList *list);
   void (*unorderedRemove)(TloList *list, size_t index);
+
+  /*
+   * - calls visit on each run of elements stored one after another, from
+   *   front to back, with the run's first element, its number of elements,
+   *   which is never 0, and context
+   * - lets tlovListSort copy elements a run at a time instead of looking up
+   *   each one with element, which isn't O(1) for every list
+   */
+  void (*forEachMutableRun)(TloList *list,
+                            void (*visit)(void *run, size_t size,
+                                          void *context),
+                            void *context);
 } TloListVTable;
 
 typedef enum TloListOptionalFunction {
@@ -128,4 +144,23 @@ void tlovListPopBack(TloList *list);
  */
 void tlovListUnorderedRemove(TloList *list, size_t index);
 
+/*
+ * - assumes tloListHasFunctions(list, TLO_LIST_ELEMENT) and that value type's
+ *   compare is not NULL
+ * - sorts list's elements in ascending order with tloSort, or with
+ *   tloRadixSort if value type has an integer key and list isn't tiny
+ * - if the elements aren't stored one after another, copies them into a
+ *   buffer from list's allocator, sorts that, and copies them back, a run at
+ *   a time if list has forEachMutableRun, which all of tloc's lists with
+ *   element do
+ * - returns TLO_ERROR if that buffer can't be allocated, leaving list as is
+ */
+TloError tlovListSort(TloList *list);
+
+/*
+ * - like tlovListSort, but sorts with tloParallelSort on pool's threads
+ * - its scratch buffer comes from list's allocator too
+ */
+TloError tlovListParallelSort(TloList *list, bool stable, TloThreadPool *pool);
+
 #endif  // TLO_LIST_H
@@ -0,0 +1,116 @@
+#ifndef TLO_MPMCQUEUE_H
+#define TLO_MPMCQUEUE_H
+
+#include <stdatomic.h>
+#include "tlo/util.h"
+
+/*
+ * - bounded multi-producer/multi-consumer queue with a fixed capacity
+ * - any number of threads push and pop at the same time. construct, destruct,
+ *   make, and delete are not thread safe
+ * - Dmitry Vyukov's design: every slot has a sequence number that says whose
+ *   turn it is, so a push or pop is one compare-and-swap on a shared index plus
+ *   a release store to its slot, and producers and consumers only contend
+ *   with each other when the queue is nearly full or nearly empty
+ * - elements are stored inline in their slots. pushing copies an element in
+ *   with the value type's constructCopy, like tloSPSCRingTryPush, and moving
+ *   copies its bytes in and gives the queue ownership of it. popping moves an
+ *   element out by copying its bytes
+ * - tloMPMCQueuePush, tloMPMCQueueMove and tloMPMCQueuePop block until they
+ *   can go ahead. on Linux they sleep on a futex, elsewhere they yield in a
+ *   loop
+ */
+typedef struct TloMPMCQueue {
+  // private
+
+  // set when constructed and only read afterwards
+  const TloType *valueType;
+  const TloAllocator *allocator;
+  unsigned char *slots;
+  size_t slotSize;
+  size_t capacity;
+  unsigned char padding0[TLO_CACHE_LINE_SIZE];
+
+  atomic_size_t tail;
+  unsigned char padding1[TLO_CACHE_LINE_SIZE];
+
+  atomic_size_t head;
+  unsigned char padding2[TLO_CACHE_LINE_SIZE];
+
+  // bumped after a push when a consumer is blocked in tloMPMCQueuePop
+  atomic_uint pushEpoch;
+  atomic_uint blockedConsumers;
+  unsigned char padding3[TLO_CACHE_LINE_SIZE];
+
+  // bumped after a pop when a producer is blocked in tloMPMCQueuePush or
+  // tloMPMCQueueMove
+  atomic_uint popEpoch;
+  atomic_uint blockedProducers;
+  unsigned char padding4[TLO_CACHE_LINE_SIZE];
+} TloMPMCQueue;
+
+/*
+ * - rounds capacity up to the nearest power of 2 that is at least 2. capacity
+ *   must not be 0
+ * - if allocator is NULL, uses tloCStdLibAllocator
+ * - returns TLO_ERROR if the slots can't be allocated
+ */
+TloError tloMPMCQueueConstruct(TloMPMCQueue *queue, const TloType *valueType,
+                               const TloAllocator *allocator, size_t capacity);
+
+// destructs the elements still in queue, then frees the slots
+void tloMPMCQueueDestruct(TloMPMCQueue *queue);
+
+/*
+ * - uses given allocator's malloc then tloMPMCQueueConstruct
+ * - if allocator is NULL, uses tloCStdLibAllocator
+ */
+TloMPMCQueue *tloMPMCQueueMake(const TloType *valueType,
+                               const TloAllocator *allocator, size_t capacity);
+
+// uses tloMPMCQueueDestruct then queue's allocator's free
+void tloMPMCQueueDelete(TloMPMCQueue *queue);
+
+size_t tloMPMCQueueCapacity(const TloMPMCQueue *queue);
+
+/*
+ * - returns the number of elements in queue, counting ones being pushed or
+ *   popped, and slots left empty by failed copies until a pop skips them
+ * - only a snapshot if other threads are pushing or popping
+ */
+size_t tloMPMCQueueSize(const TloMPMCQueue *queue);
+
+/*
+ * - copies element into queue with the value type's constructCopy
+ * - returns false if queue is full or if constructCopy fails. element stays
+ *   the caller's either way
+ * - if constructCopy fails, the slot it was copying into is skipped by pops
+ */
+bool tloMPMCQueueTryPush(TloMPMCQueue *queue, const void *element);
+
+/*
+ * - moves element into queue by copying its bytes. queue then owns the
+ *   object, so the caller must not destruct element
+ * - returns false if queue is full, in which case element is left as is
+ */
+bool tloMPMCQueueTryMove(TloMPMCQueue *queue, void *element);
+
+/*
+ * - moves the front element into destination, which then owns it
+ * - returns false if queue is empty
+ */
+bool tloMPMCQueueTryPop(TloMPMCQueue *queue, void *destination);
+
+/*
+ * - like tloMPMCQueueTryPush, but waits while queue is full
+ * - returns false only if constructCopy fails
+ */
+bool tloMPMCQueuePush(TloMPMCQueue *queue, const void *element);
+
+// like tloMPMCQueueTryMove, but waits while queue is full
+void tloMPMCQueueMove(TloMPMCQueue *queue, void *element);
+
+// like tloMPMCQueueTryPop, but waits while queue is empty
+void tloMPMCQueuePop(TloMPMCQueue *queue, void *destination);
+
+#endif  // TLO_MPMCQUEUE_H
@@ -0,0 +1,69 @@
+#ifndef TLO_POOL_H
+#define TLO_POOL_H
+
+#include "tlo/util.h"
+
+/*
+ * - slab allocator for many small objects of the same few sizes, such as
+ *   list and hash table nodes
+ * - small requests are rounded up to a size class, and each size class keeps
+ *   a free list of objects carved from TLO_POOL_SLAB_SIZE-byte slabs. freed
+ *   objects go back to their size class's free list and are reused first
+ * - requests bigger than TLO_POOL_MAX_SMALL_SIZE go to the block allocator
+ * - slabs are only given back to the block allocator by tloPoolDestruct
+ * - every allocation is aligned for any type, like C's malloc
+ * - the pool's allocator stores the pool's address as its context, so a pool
+ *   must not be moved or copied after it is constructed
+ * - not thread-safe. use one pool per thread or container instead of sharing
+ */
+enum {
+  TLO_POOL_SLAB_SIZE = 4096,
+  TLO_POOL_MAX_SMALL_SIZE = 256,
+  TLO_POOL_NUM_SIZE_CLASSES = 16
+};
+
+typedef struct TloPoolSlab TloPoolSlab;
+typedef struct TloPoolObject TloPoolObject;
+
+typedef struct TloPoolSizeClass {
+  // private
+  TloPoolObject *freeList;
+  unsigned char *position;
+  unsigned char *end;
+} TloPoolSizeClass;
+
+typedef struct TloPool {
+  // public, use only for passing to functions that take a TloAllocator
+  TloAllocator allocator;
+
+  // private
+  const TloAllocator *blockAllocator;
+  TloPoolSlab *blocks;
+  unsigned char *nextSlab;
+  unsigned char *slabsEnd;
+  TloPoolSizeClass sizeClasses[TLO_POOL_NUM_SIZE_CLASSES];
+} TloPool;
+
+/*
+ * - slabs are allocated in groups with blockAllocator when needed
+ * - if blockAllocator is NULL, uses tloCStdLibAllocator
+ */
+void tloPoolConstruct(TloPool *pool, const TloAllocator *blockAllocator);
+
+/*
+ * - frees all slabs and big allocations, which invalidates all memory
+ *   allocated from pool
+ */
+void tloPoolDestruct(TloPool *pool);
+
+/*
+ * - uses given block allocator's malloc then tloPoolConstruct
+ */
+TloPool *tloPoolMake(const TloAllocator *blockAllocator);
+
+/*
+ * - tloPoolDestruct then block allocator's free
+ */
+void tloPoolDelete(TloPool *pool);
+
+#endif  // TLO_POOL_H
@@ -0,0 +1,140 @@
+#ifndef TLO_PRIORITYQUEUE_H
+#define TLO_PRIORITYQUEUE_H
+
+#include "tlo/darray.h"
+
+/*
+ * - names an element of a TloPriorityQueue made with handles, from when it's
+ *   pushed until it's popped or removed. after that, the handle may be given
+ *   to another element
+ */
+typedef size_t TloPriorityQueueHandle;
+
+/*
+ * - priority queue whose top is its least element by value type's compare,
+ *   which must not be NULL
+ * - a d-ary heap in a TloDArray: the children of the element at index i are
+ *   at indices arity * i + 1 through arity * i + arity. with an arity of 4 or
+ *   8, the children of an element share one or two cache lines and the heap
+ *   is half or a third as deep, so pops touch fewer cache lines, at the cost
+ *   of more comparisons per level
+ * - push and pop are O(log n), top is O(1)
+ * - if made with handles, each element gets a TloPriorityQueueHandle, which
+ *   can be used to decrease its value, or remove it, in O(log n). this keeps
+ *   two more TloDArrays of sizes, which are updated whenever an element moves
+ * - elements are moved around with memcpy, so pointers to them are
+ *   invalidated by anything that changes the queue
+ */
+typedef struct TloPriorityQueue {
+  // private
+  TloDArray values;
+  size_t arityShift;
+  unsigned char *scratch;
+
+  // only used if made with handles
+  bool hasHandles;
+  TloDArray handles;
+  TloDArray positions;
+  size_t firstFreeHandle;
+} TloPriorityQueue;
+
+/*
+ * - arity must be 2, 4, or 8
+ * - if hasHandles is true, the push functions give out handles
+ * - if allocator is NULL, uses tloCStdLibAllocator
+ * - returns TLO_ERROR if memory can't be allocated
+ */
+TloError tloPriorityQueueConstruct(TloPriorityQueue *queue,
+                                   const TloType *valueType,
+                                   const TloAllocator *allocator,
+                                   size_t arity, bool hasHandles);
+
+/*
+ * - takes array's elements and arranges them into a heap in O(n), which
+ *   beats pushing them one at a time. array is left empty, and still has to
+ *   be destructed
+ * - uses array's value type and allocator
+ * - if hasHandles is true, the element that was at index i of array gets
+ *   handle i
+ * - returns TLO_ERROR if memory can't be allocated, leaving array as is
+ */
+TloError tloPriorityQueueConstructFromDArray(TloPriorityQueue *queue,
+                                             TloDArray *array, size_t arity,
+                                             bool hasHandles);
+
+// uses value type's destruct if it is not NULL
+void tloPriorityQueueDestruct(TloPriorityQueue *queue);
+
+/*
+ * - uses given allocator's malloc then tloPriorityQueueConstruct
+ * - if allocator is NULL, uses tloCStdLibAllocator
+ */
+TloPriorityQueue *tloPriorityQueueMake(const TloType *valueType,
+                                       const TloAllocator *allocator,
+                                       size_t arity, bool hasHandles);
+
+// uses array's allocator's malloc then tloPriorityQueueConstructFromDArray
+TloPriorityQueue *tloPriorityQueueMakeFromDArray(TloDArray *array,
+                                                 size_t arity,
+                                                 bool hasHandles);
+
+// uses tloPriorityQueueDestruct then queue's allocator's free
+void tloPriorityQueueDelete(TloPriorityQueue *queue);
+
+size_t tloPriorityQueueSize(const TloPriorityQueue *queue);
+bool tloPriorityQueueIsEmpty(const TloPriorityQueue *queue);
+
+/*
+ * - deep copies value using value type's constructCopy if it is not null,
+ *   otherwise uses memcpy
+ * - if queue has handles and handle is not NULL, sets *handle to the new
+ *   element's handle. if queue doesn't have handles, handle must be NULL
+ * - returns TLO_ERROR if memory can't be allocated or value can't be copied
+ */
+TloError tloPriorityQueuePush(TloPriorityQueue *queue, const void *value,
+                              TloPriorityQueueHandle *handle);
+
+/*
+ * - like tloPriorityQueuePush, but assumes value points to an object whose
+ *   memory was allocated by queue's allocator's malloc, and takes ownership
+ *   of it
+ */
+TloError tloPriorityQueueMove(TloPriorityQueue *queue, void *value,
+                              TloPriorityQueueHandle *handle);
+
+// queue must not be empty
+const void *tloPriorityQueueTop(const TloPriorityQueue *queue);
+
+// queue must have handles and not be empty
+TloPriorityQueueHandle tloPriorityQueueTopHandle(
+    const TloPriorityQueue *queue);
+
+/*
+ * - removes the top element, using value type's destruct if it is not NULL
+ * - queue must not be empty
+ */
+void tloPriorityQueuePop(TloPriorityQueue *queue);
+
+// queue must have handles, and handle must name one of its elements
+const void *tloPriorityQueueValue(const TloPriorityQueue *queue,
+                                  TloPriorityQueueHandle handle);
+
+/*
+ * - replaces the value of the element named by handle with a copy of value,
+ *   which must not be greater than it, and moves the element up to its place
+ * - queue must have handles, and handle must name one of its elements
+ * - returns TLO_ERROR if value can't be copied, leaving the element as is
+ */
+TloError tloPriorityQueueDecreaseKey(TloPriorityQueue *queue,
+                                     TloPriorityQueueHandle handle,
+                                     const void *value);
+
+/*
+ * - removes the element named by handle, using value type's destruct if it
+ *   is not NULL
+ * - queue must have handles, and handle must name one of its elements
+ */
+void tloPriorityQueueRemove(TloPriorityQueue *queue,
+                            TloPriorityQueueHandle handle);
+
+#endif  // TLO_PRIORITYQUEUE_H
@@ -0,0 +1,172 @@
+#ifndef TLO_SKIPLIST_H
+#define TLO_SKIPLIST_H
+
+#include <stdatomic.h>
+#include "tlo/map.h"
+
+/*
+ * - most levels a node can be linked into. each level links about a quarter
+ *   of the nodes of the one below it, so 16 levels are plenty for 2^32 keys
+ */
+#define TLO_SKIP_LIST_MAX_HEIGHT 16
+
+/*
+ * - ordered map that any number of threads can insert into, remove from, find
+ *   in, and iterate over at the same time, kept sorted by key type's compare,
+ *   which must not be NULL
+ * - a lock-free skip list: every node is linked into level 0 and into each
+ *   level above with probability 1/4 per level, and links are changed with
+ *   compare-and-swap. a removal first marks the node's links so nothing can
+ *   be linked after it, then unlinks it, and threads that run into a marked
+ *   node help unlink it
+ * - removed nodes are freed with epoch based reclamation: a thread is pinned
+ *   while it uses the map, and a node is only freed once every thread that
+ *   was pinned when it was removed has unpinned since. a thread that stays
+ *   pinned keeps every node removed after it pinned from being freed
+ * - each thread uses the map through its own TloSkipListThread, from
+ *   tloSkipListMapAttach. construct, destruct, make, and delete are not thread
+ *   safe, and allocator must be safe to call from all of them
+ * - values can't be changed once inserted, only removed with their key and
+ *   inserted again
+ */
+typedef struct TloSkipListMap {
+  // private
+
+  // set when constructed and only read afterwards
+  const TloType *keyType;
+  const TloType *valueType;
+  const TloAllocator *allocator;
+  size_t valueOffset;
+  size_t nextOffset;
+  _Atomic(struct TloSkipListThread *) threads;
+  unsigned char padding0[TLO_CACHE_LINE_SIZE];
+
+  atomic_size_t epoch;
+  unsigned char padding1[TLO_CACHE_LINE_SIZE];
+
+  atomic_uintptr_t head[TLO_SKIP_LIST_MAX_HEIGHT];
+} TloSkipListMap;
+
+/*
+ * - a thread's handle on a TloSkipListMap, only to be used by one thread at a
+ *   time
+ * - holds the thread's pin and the nodes it removed that aren't freed yet
+ */
+typedef struct TloSkipListThread TloSkipListThread;
+
+/*
+ * - a position in a TloSkipListMap's keys in ascending order, or the end,
+ *   which is past the greatest key
+ * - only valid while the thread that made it stays pinned. keys inserted or
+ *   removed while it's moving along may or may not be seen, but it never goes
+ *   back to a key less than the one it's at
+ */
+typedef struct TloSkipListCursor {
+  // private
+  const TloSkipListThread *thread;
+  struct TloSkipListNode *node;
+} TloSkipListCursor;
+
+// if allocator is NULL, uses tloCStdLibAllocator
+void tloSkipListMapConstruct(TloSkipListMap *map, const TloType *keyType,
+                             const TloType *valueType,
+                             const TloAllocator *allocator);
+
+/*
+ * - destructs and frees every key and value, including removed ones that
+ *   weren't freed yet, and every TloSkipListThread
+ * - no thread can be using map anymore
+ */
+void tloSkipListMapDestruct(TloSkipListMap *map);
+
+/*
+ * - uses given allocator's malloc then tloSkipListMapConstruct
+ * - if allocator is NULL, uses tloCStdLibAllocator
+ */
+TloSkipListMap *tloSkipListMapMake(const TloType *keyType,
+                                   const TloType *valueType,
+                                   const TloAllocator *allocator);
+
+// uses tloSkipListMapDestruct then map's allocator's free
+void tloSkipListMapDelete(TloSkipListMap *map);
+
+/*
+ * - returns a handle for the calling thread to use map through, reusing one a
+ *   thread detached if there is one
+ * - returns NULL if memory can't be allocated
+ */
+TloSkipListThread *tloSkipListMapAttach(TloSkipListMap *map);
+
+/*
+ * - frees what it can of the nodes thread removed and gives thread back to its
+ *   map. the rest are freed by the next thread to attach, or by destruct
+ * - thread must not be pinned
+ */
+void tloSkipListMapDetach(TloSkipListThread *thread);
+
+/*
+ * - pins thread, so the keys and values it finds and the cursors it makes
+ *   stay valid until it unpins, even if other threads remove them
+ * - pins nest, and only the outermost unpin counts
+ */
+void tloSkipListThreadPin(TloSkipListThread *thread);
+void tloSkipListThreadUnpin(TloSkipListThread *thread);
+
+/*
+ * - returns the number of keys in map
+ * - only a snapshot if other threads are inserting or removing, but never
+ *   more than the number of keys map held at some point while this ran
+ */
+size_t tloSkipListMapSize(const TloSkipListMap *map);
+
+/*
+ * - inserts key and value into thread's map, like tlovMapInsert
+ * - returns TLO_DUPLICATE if key is already there, in which case keys and
+ *   values that were to be moved are left with the caller
+ * - pins thread while it runs
+ */
+TloError tloSkipListMapInsert(TloSkipListThread *thread,
+                              TloInsertMethod keyInsertMethod, void *key,
+                              TloInsertMethod valueInsertMethod, void *value);
+
+/*
+ * - removes key and its value from thread's map. they are destructed once no
+ *   pinned thread can still be looking at them
+ * - returns false if key isn't there, or another thread removed it first
+ * - pins thread while it runs
+ */
+bool tloSkipListMapRemove(TloSkipListThread *thread, const void *key);
+
+/*
+ * - returns the value of key in thread's map, or NULL if key isn't there
+ * - thread must be pinned, and the value is only valid until it unpins
+ */
+const void *tloSkipListMapFind(const TloSkipListThread *thread,
+                               const void *key);
+
+/*
+ * - point cursor at the least key in thread's map, the first key that is not
+ *   less than key, or the first key that is greater than key. cursor is at
+ *   the end if there is no such key
+ * - thread must be pinned
+ */
+void tloSkipListMapFirst(const TloSkipListThread *thread,
+                         TloSkipListCursor *cursor);
+void tloSkipListMapLowerBound(const TloSkipListThread *thread,
+                              const void *key, TloSkipListCursor *cursor);
+void tloSkipListMapUpperBound(const TloSkipListThread *thread,
+                              const void *key, TloSkipListCursor *cursor);
+
+bool tloSkipListCursorIsEnd(const TloSkipListCursor *cursor);
+
+// cursor must not be at the end
+const void *tloSkipListCursorKey(const TloSkipListCursor *cursor);
+const void *tloSkipListCursorValue(const TloSkipListCursor *cursor);
+
+/*
+ * - moves cursor to the next greater key that hasn't been removed, or the end
+ * - cursor must not be at the end
+ */
+void tloSkipListCursorNext(TloSkipListCursor *cursor);
+
+#endif  // TLO_SKIPLIST_H
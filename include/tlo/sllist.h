@@ -8,8 +8,10 @@
  */
 typedef struct TloSLLNode {
   // private
-  void *data;
   struct TloSLLNode *next;
+
+  // the element, stored in the same allocation as the node
+  _Alignas(max_align_t) unsigned char data[];
 } TloSLLNode;
 
 typedef struct TloSLList {
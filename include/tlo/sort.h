@@ -0,0 +1,57 @@
+#ifndef TLO_SORT_H
+#define TLO_SORT_H
+
+#include "tlo/util.h"
+
+// the parallel sorts only take a pointer, so users don't need threadpool.h's
+// headers
+typedef struct TloThreadPool TloThreadPool;
+
+/*
+ * - sorts count elements of type->size bytes each, starting at elements, in
+ *   ascending order using type->compare, which must not be NULL
+ * - introsort: quicksort with a median of 3 pivot, or a median of 3 medians
+ *   of 3 for big ranges, that switches to heapsort if it recurses too deep
+ *   and to insertion sort for small ranges, so it's O(n log n) worst case
+ * - when a partition moved nothing, tries finishing both sides with an
+ *   insertion sort that gives up after a few moves, so already sorted input
+ *   takes O(n)
+ * - elements are swapped in place byte for byte, with fast paths for sizes of
+ *   4, 8, and 16 bytes, so constructCopy and destruct aren't used
+ * - not stable
+ */
+void tloSort(void *elements, size_t count, const TloType *type);
+
+/*
+ * - sorts like tloSort, but splits the work between pool's threads, and is
+ *   stable if stable is true
+ * - merge sort: halves are sorted as separate tasks, and big merges split
+ *   both runs at a binary searched point so their halves merge in parallel
+ *   too. ranges that are too small to be worth a task are sorted by the
+ *   calling task, with tloSort if stable is false
+ * - needs a scratch buffer as big as the elements, from allocator. if
+ *   allocator is NULL, uses tloCStdLibAllocator
+ * - returns TLO_ERROR if the buffer can't be allocated, leaving the elements
+ *   as they were
+ */
+TloError tloParallelSort(void *elements, size_t count, const TloType *type,
+                         bool stable, TloThreadPool *pool,
+                         const TloAllocator *allocator);
+
+/*
+ * - sorts count elements of type->size bytes each, starting at elements, in
+ *   ascending order of type->integerKey, which must not be NULL
+ * - least significant digit radix sort, so it's O(n) and stable. the
+ *   histograms of all digits are counted in one pass before any are sorted,
+ *   and digits all elements share are skipped
+ * - digits are 11 bits for big arrays with 4 or 8 byte keys, which takes 3
+ *   passes instead of 4 for 4 byte keys, and 8 bits otherwise
+ * - needs a scratch buffer as big as the elements, plus the histograms, from
+ *   allocator. if allocator is NULL, uses tloCStdLibAllocator
+ * - returns TLO_ERROR if they can't be allocated, leaving the elements as
+ *   they were
+ */
+TloError tloRadixSort(void *elements, size_t count, const TloType *type,
+                      const TloAllocator *allocator);
+
+#endif  // TLO_SORT_H
@@ -0,0 +1,101 @@
+#ifndef TLO_SPSCRING_H
+#define TLO_SPSCRING_H
+
+#include <stdatomic.h>
+#include "tlo/util.h"
+
+/*
+ * - lock-free single-producer/single-consumer ring buffer with a fixed
+ *   capacity
+ * - one thread pushes and one other thread pops, at the same time, without
+ *   locks. construct, destruct, make, and delete are not thread safe
+ * - elements are stored inline in one array whose capacity is a power of 2, so
+ *   wrapping an index around is a mask
+ * - head and tail are on different cache lines, so the producer and consumer
+ *   don't write to the same one. each side also keeps a cached copy of the
+ *   other side's index and reads the shared one only when its copy says the
+ *   ring is full or empty
+ */
+typedef struct TloSPSCRing {
+  // private
+
+  // set when constructed and only read afterwards
+  const TloType *valueType;
+  const TloAllocator *allocator;
+  unsigned char *array;
+  size_t capacity;
+  unsigned char padding0[TLO_CACHE_LINE_SIZE];
+
+  // written by only the consumer
+  atomic_size_t head;
+  size_t cachedTail;
+  unsigned char padding1[TLO_CACHE_LINE_SIZE];
+
+  // written by only the producer
+  atomic_size_t tail;
+  size_t cachedHead;
+  unsigned char padding2[TLO_CACHE_LINE_SIZE];
+} TloSPSCRing;
+
+/*
+ * - rounds capacity up to the nearest power of 2. capacity must not be 0
+ * - if allocator is NULL, uses tloCStdLibAllocator
+ * - returns TLO_ERROR if the array can't be allocated
+ */
+TloError tloSPSCRingConstruct(TloSPSCRing *ring, const TloType *valueType,
+                              const TloAllocator *allocator, size_t capacity);
+
+// destructs the elements still in ring, then frees the array
+void tloSPSCRingDestruct(TloSPSCRing *ring);
+
+/*
+ * - uses given allocator's malloc then tloSPSCRingConstruct
+ * - if allocator is NULL, uses tloCStdLibAllocator
+ */
+TloSPSCRing *tloSPSCRingMake(const TloType *valueType,
+                             const TloAllocator *allocator, size_t capacity);
+
+// uses tloSPSCRingDestruct then ring's allocator's free
+void tloSPSCRingDelete(TloSPSCRing *ring);
+
+size_t tloSPSCRingCapacity(const TloSPSCRing *ring);
+
+/*
+ * - returns the number of elements in ring
+ * - only a snapshot if the other thread is pushing or popping
+ */
+size_t tloSPSCRingSize(const TloSPSCRing *ring);
+
+/*
+ * - producer only
+ * - copies element into ring with the value type's constructCopy
+ * - returns false if ring is full or if constructCopy fails
+ */
+bool tloSPSCRingTryPush(TloSPSCRing *ring, const void *element);
+
+/*
+ * - consumer only
+ * - moves the front element into destination, which then owns it
+ * - returns false if ring is empty
+ */
+bool tloSPSCRingTryPop(TloSPSCRing *ring, void *destination);
+
+/*
+ * - producer only
+ * - like tloSPSCRingTryPush for each of the count elements in elements, but
+ *   publishes them all at once
+ * - stops early if ring gets full or if constructCopy fails
+ * - returns the number of elements pushed
+ */
+size_t tloSPSCRingPushMany(TloSPSCRing *ring, const void *elements,
+                           size_t count);
+
+/*
+ * - consumer only
+ * - like tloSPSCRingTryPop for up to count elements, into consecutive
+ *   elements of destination, but frees their slots all at once
+ * - returns the number of elements popped
+ */
+size_t tloSPSCRingPopMany(TloSPSCRing *ring, void *destination, size_t count);
+
+#endif  // TLO_SPSCRING_H
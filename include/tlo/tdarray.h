@@ -0,0 +1,288 @@
+#ifndef TLO_TDARRAY_H
+#define TLO_TDARRAY_H
+
+#include <assert.h>
+#include <string.h>
+#include "tlo/util.h"
+
+/*
+ * - type-specialized dynamic array
+ * - TLO_DEFINE_DARRAY(_name, _valueType) defines a struct type named _name and
+ *   static inline functions whose names start with _name, for example
+ *   TLO_DEFINE_DARRAY(IntArray, int) defines IntArray, IntArrayConstruct,
+ *   IntArrayPushBack, and so on
+ * - unlike TloDArray, there is no TloList or TloType involved. element size is
+ *   a compile-time constant and elements are copied using plain assignment, so
+ *   _valueType should be a type that doesn't need to be deep copied or
+ *   destructed
+ * - growing and shrinking behave the same way as in TloDArray
+ * - functions whose names contain Private are used by the generated functions
+ *   and shouldn't be called directly
+ */
+#define TLO_DEFINE_DARRAY(_name, _valueType)                                   \
+  typedef struct _name {                                                       \
+    /* private */                                                              \
+    const TloAllocator *allocator;                                             \
+    _valueType *array;                                                         \
+    size_t size;                                                               \
+    size_t capacity;                                                           \
+  } _name;                                                                     \
+                                                                               \
+  /*                                                                           \
+   * - if allocator is NULL, uses tloCStdLibAllocator                          \
+   */                                                                          \
+  static inline TloError _name##Construct(                                     \
+      _name *array, const TloAllocator *allocator, size_t capacity) {          \
+    assert(array);                                                             \
+                                                                               \
+    if (!allocator) {                                                          \
+      allocator = &tloCStdLibAllocator;                                        \
+    }                                                                          \
+                                                                               \
+    _valueType *newArray = NULL;                                               \
+    if (capacity) {                                                            \
+      newArray = tloAllocatorMalloc(allocator, capacity * sizeof(*newArray));  \
+      if (!newArray) {                                                         \
+        return TLO_ERROR;                                                      \
+      }                                                                        \
+    }                                                                          \
+                                                                               \
+    array->allocator = allocator;                                              \
+    array->array = newArray;                                                   \
+    array->size = 0;                                                           \
+    array->capacity = capacity;                                                \
+                                                                               \
+    return TLO_SUCCESS;                                                        \
+  }                                                                            \
+                                                                               \
+  static inline void _name##Destruct(_name *array) {                           \
+    if (!array) {                                                              \
+      return;                                                                  \
+    }                                                                          \
+                                                                               \
+    if (!array->array) {                                                       \
+      return;                                                                  \
+    }                                                                          \
+                                                                               \
+    tloAllocatorSizedFree(array->allocator, array->array,                      \
+                          array->capacity * sizeof(*array->array));            \
+    array->array = NULL;                                                       \
+    array->size = 0;                                                           \
+    array->capacity = 0;                                                       \
+  }                                                                            \
+                                                                               \
+  static inline TloError _name##ConstructCopy(_name *array,                    \
+                                              const _name *other) {            \
+    assert(array);                                                             \
+    assert(other);                                                             \
+                                                                               \
+    if (_name##Construct(array, other->allocator, other->capacity) !=          \
+        TLO_SUCCESS) {                                                         \
+      return TLO_ERROR;                                                        \
+    }                                                                          \
+                                                                               \
+    if (other->size) {                                                         \
+      memcpy(array->array, other->array, other->size * sizeof(_valueType));    \
+    }                                                                          \
+    array->size = other->size;                                                 \
+                                                                               \
+    return TLO_SUCCESS;                                                        \
+  }                                                                            \
+                                                                               \
+  /*                                                                           \
+   * - uses given allocator's malloc then _name##Construct                     \
+   */                                                                          \
+  static inline _name *_name##Make(const TloAllocator *allocator,              \
+                                   size_t capacity) {                          \
+    if (!allocator) {                                                          \
+      allocator = &tloCStdLibAllocator;                                        \
+    }                                                                          \
+                                                                               \
+    _name *array = tloAllocatorMalloc(allocator, sizeof(*array));              \
+    if (!array) {                                                              \
+      return NULL;                                                             \
+    }                                                                          \
+                                                                               \
+    if (_name##Construct(array, allocator, capacity) != TLO_SUCCESS) {         \
+      tloAllocatorSizedFree(allocator, array, sizeof(*array));                 \
+      return NULL;                                                             \
+    }                                                                          \
+                                                                               \
+    return array;                                                              \
+  }                                                                            \
+                                                                               \
+  /*                                                                           \
+   * - uses malloc of other's allocator then _name##ConstructCopy              \
+   */                                                                          \
+  static inline _name *_name##MakeCopy(const _name *other) {                   \
+    assert(other);                                                             \
+                                                                               \
+    _name *array = tloAllocatorMalloc(other->allocator, sizeof(*array));       \
+    if (!array) {                                                              \
+      return NULL;                                                             \
+    }                                                                          \
+                                                                               \
+    if (_name##ConstructCopy(array, other) != TLO_SUCCESS) {                   \
+      tloAllocatorSizedFree(other->allocator, array, sizeof(*array));          \
+      return NULL;                                                             \
+    }                                                                          \
+                                                                               \
+    return array;                                                              \
+  }                                                                            \
+                                                                               \
+  /*                                                                           \
+   * - _name##Destruct then allocator's free                                   \
+   */                                                                          \
+  static inline void _name##Delete(_name *array) {                             \
+    if (!array) {                                                              \
+      return;                                                                  \
+    }                                                                          \
+                                                                               \
+    const TloAllocator *allocator = array->allocator;                          \
+    _name##Destruct(array);                                                    \
+    tloAllocatorSizedFree(allocator, array, sizeof(*array));                   \
+  }                                                                            \
+                                                                               \
+  /*                                                                           \
+   * - uses _name##ConstructCopy and _name##Destruct                           \
+   */                                                                          \
+  static inline TloError _name##Copy(_name *array, const _name *other) {       \
+    assert(array);                                                             \
+    assert(other);                                                             \
+                                                                               \
+    _name copy;                                                                \
+    if (_name##ConstructCopy(&copy, other) != TLO_SUCCESS) {                   \
+      return TLO_ERROR;                                                        \
+    }                                                                          \
+                                                                               \
+    _name##Destruct(array);                                                    \
+    *array = copy;                                                             \
+                                                                               \
+    return TLO_SUCCESS;                                                        \
+  }                                                                            \
+                                                                               \
+  static inline const TloAllocator *_name##Allocator(const _name *array) {     \
+    assert(array);                                                             \
+                                                                               \
+    return array->allocator;                                                   \
+  }                                                                            \
+                                                                               \
+  static inline size_t _name##Size(const _name *array) {                       \
+    assert(array);                                                             \
+                                                                               \
+    return array->size;                                                        \
+  }                                                                            \
+                                                                               \
+  static inline bool _name##IsEmpty(const _name *array) {                      \
+    assert(array);                                                             \
+                                                                               \
+    return array->size == 0;                                                   \
+  }                                                                            \
+                                                                               \
+  static inline size_t _name##Capacity(const _name *array) {                   \
+    assert(array);                                                             \
+                                                                               \
+    return array->capacity;                                                    \
+  }                                                                            \
+                                                                               \
+  static inline const _valueType *_name##Element(const _name *array,           \
+                                                 size_t index) {               \
+    assert(array);                                                             \
+    assert(index < array->size);                                               \
+                                                                               \
+    return array->array + index;                                               \
+  }                                                                            \
+                                                                               \
+  static inline _valueType *_name##MutableElement(_name *array,                \
+                                                  size_t index) {              \
+    assert(array);                                                             \
+    assert(index < array->size);                                               \
+                                                                               \
+    return array->array + index;                                               \
+  }                                                                            \
+                                                                               \
+  static inline const _valueType *_name##Front(const _name *array) {           \
+    return _name##Element(array, 0);                                           \
+  }                                                                            \
+                                                                               \
+  static inline _valueType *_name##MutableFront(_name *array) {                \
+    return _name##MutableElement(array, 0);                                    \
+  }                                                                            \
+                                                                               \
+  static inline const _valueType *_name##Back(const _name *array) {            \
+    assert(array);                                                             \
+                                                                               \
+    return _name##Element(array, array->size - 1);                             \
+  }                                                                            \
+                                                                               \
+  static inline _valueType *_name##MutableBack(_name *array) {                 \
+    assert(array);                                                             \
+                                                                               \
+    return _name##MutableElement(array, array->size - 1);                      \
+  }                                                                            \
+                                                                               \
+  static inline TloError _name##PrivateResize(_name *array,                    \
+                                              size_t newCapacity) {            \
+    _valueType *newArray;                                                      \
+    if (array->array) {                                                        \
+      newArray = tloAllocatorRealloc(array->allocator, array->array,           \
+                                     array->capacity * sizeof(*newArray),      \
+                                     newCapacity * sizeof(*newArray));         \
+    } else {                                                                   \
+      newArray = tloAllocatorMalloc(array->allocator,                          \
+                                    newCapacity * sizeof(*newArray));          \
+    }                                                                          \
+    if (!newArray) {                                                           \
+      return TLO_ERROR;                                                        \
+    }                                                                          \
+                                                                               \
+    array->array = newArray;                                                   \
+    array->capacity = newCapacity;                                             \
+                                                                               \
+    return TLO_SUCCESS;                                                        \
+  }                                                                            \
+                                                                               \
+  static inline TloError _name##PushBack(_name *array, _valueType value) {     \
+    assert(array);                                                             \
+                                                                               \
+    if (array->size == array->capacity) {                                      \
+      size_t newCapacity = array->capacity ? array->capacity * 2 : 1;          \
+      if (_name##PrivateResize(array, newCapacity) != TLO_SUCCESS) {           \
+        return TLO_ERROR;                                                      \
+      }                                                                        \
+    }                                                                          \
+                                                                               \
+    array->array[array->size] = value;                                         \
+    ++array->size;                                                             \
+                                                                               \
+    return TLO_SUCCESS;                                                        \
+  }                                                                            \
+                                                                               \
+  /*                                                                           \
+   * - if allocation of smaller array fails, just returns without reporting    \
+   *   any error                                                               \
+   */                                                                          \
+  static inline void _name##PrivateShrinkIfNeeded(_name *array) {              \
+    if (array->size <= array->capacity / 4 && array->size) {                   \
+      _name##PrivateResize(array, array->capacity / 2);                        \
+    }                                                                          \
+  }                                                                            \
+                                                                               \
+  static inline void _name##PopBack(_name *array) {                            \
+    assert(array);                                                             \
+    assert(array->size);                                                       \
+                                                                               \
+    --array->size;                                                             \
+    _name##PrivateShrinkIfNeeded(array);                                       \
+  }                                                                            \
+                                                                               \
+  static inline void _name##UnorderedRemove(_name *array, size_t index) {      \
+    assert(array);                                                             \
+    assert(index < array->size);                                               \
+                                                                               \
+    array->array[index] = array->array[array->size - 1];                       \
+    --array->size;                                                             \
+    _name##PrivateShrinkIfNeeded(array);                                       \
+  }
+
+#endif  // TLO_TDARRAY_H
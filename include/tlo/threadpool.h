@@ -0,0 +1,108 @@
+#ifndef TLO_THREADPOOL_H
+#define TLO_THREADPOOL_H
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include "tlo/mpmcqueue.h"
+#include "tlo/util.h"
+
+typedef void (*TloTaskFunction)(void *argument);
+
+/*
+ * - counts the unfinished tasks submitted with it, so tloThreadPoolWait can
+ *   wait for just those
+ * - tasks can submit more tasks with their own groups and wait for them, so
+ *   fork-join algorithms can nest
+ */
+typedef struct TloTaskGroup {
+  // private
+  atomic_size_t numPending;
+} TloTaskGroup;
+
+void tloTaskGroupConstruct(TloTaskGroup *group);
+
+/*
+ * - fixed set of worker threads that run submitted tasks
+ * - each worker has a Chase-Lev deque. tasks submitted from a worker go on the
+ *   bottom of its own deque, which it takes from last in first out, while idle
+ *   workers steal from the top of other workers' deques
+ * - tasks submitted from other threads go through a shared TloMPMCQueue
+ * - if a deque or the shared queue is full, the submitting thread runs the
+ *   task itself
+ * - idle workers yield for a while, then sleep until a task is submitted
+ */
+typedef struct TloThreadPool {
+  // private
+  const TloAllocator *allocator;
+  struct TloThreadPoolWorker **workers;
+  size_t numThreads;
+  TloMPMCQueue submitted;
+  TloTaskGroup defaultGroup;
+  atomic_bool stopping;
+  atomic_size_t numSleepers;
+  pthread_mutex_t mutex;
+  pthread_cond_t wakeUp;
+  unsigned long epoch;
+} TloThreadPool;
+
+/*
+ * - starts numThreads worker threads. if numThreads is 0, starts one per core
+ * - if allocator is NULL, uses tloCStdLibAllocator
+ * - returns TLO_ERROR if memory can't be allocated or threads can't be started
+ */
+TloError tloThreadPoolConstruct(TloThreadPool *pool, size_t numThreads,
+                                const TloAllocator *allocator);
+
+/*
+ * - waits for the tasks submitted without a group to finish, then stops the
+ *   worker threads
+ * - tasks submitted with a group must have been waited for, and it must not
+ *   be called from a task
+ */
+void tloThreadPoolDestruct(TloThreadPool *pool);
+
+/*
+ * - uses given allocator's malloc then tloThreadPoolConstruct
+ * - if allocator is NULL, uses tloCStdLibAllocator
+ */
+TloThreadPool *tloThreadPoolMake(size_t numThreads,
+                                 const TloAllocator *allocator);
+
+// uses tloThreadPoolDestruct then pool's allocator's free
+void tloThreadPoolDelete(TloThreadPool *pool);
+
+size_t tloThreadPoolNumThreads(const TloThreadPool *pool);
+
+/*
+ * - makes a worker run function(argument) at some point
+ * - group counts the task until it finishes. if group is NULL, pool's default
+ *   group does
+ * - can be called from any thread, including from tasks
+ */
+void tloThreadPoolSubmit(TloThreadPool *pool, TloTaskGroup *group,
+                         TloTaskFunction function, void *argument);
+
+/*
+ * - returns once all tasks submitted with group have finished
+ * - if group is NULL, waits for the tasks submitted without a group
+ * - runs tasks while it waits, so it can be called from a task without tying
+ *   up a worker
+ */
+void tloThreadPoolWait(TloThreadPool *pool, TloTaskGroup *group);
+
+typedef void (*TloParallelForBody)(size_t begin, size_t end, void *argument);
+
+/*
+ * - calls body on chunks of at most grainSize indexes that together cover
+ *   [begin, end) exactly once, in parallel, then returns once all are done
+ * - if grainSize is 0, picks one that makes a few chunks per thread
+ * - splits the range in halves recursively, so chunks spread to idle workers
+ *   through stealing instead of all going through one queue
+ * - if memory for the chunks can't be allocated, calls body on the whole range
+ *   in the calling thread
+ */
+void tloThreadPoolParallelFor(TloThreadPool *pool, size_t begin, size_t end,
+                              size_t grainSize, TloParallelForBody body,
+                              void *argument);
+
+#endif  // TLO_THREADPOOL_H
@@ -0,0 +1,105 @@
+#ifndef TLO_TIMERWHEEL_H
+#define TLO_TIMERWHEEL_H
+
+#include <stdint.h>
+#include "tlo/idllist.h"
+
+/*
+ * - each level of a TloTimerWheel has this many slots, and each of its slots
+ *   spans as much time as a whole level below it
+ * - 11 levels of 64 slots cover every uint64_t deadline
+ */
+#define TLO_TIMER_WHEEL_NUM_SLOTS 64
+#define TLO_TIMER_WHEEL_NUM_LEVELS 11
+
+/*
+ * - a timer in a TloTimerWheel, embedded in a user object like a TloIDLLHook
+ * - use TLO_CONTAINER_OF to get from hook to the timer, then from the timer
+ *   to its object
+ */
+typedef struct TloTimer {
+  // public
+
+  // links the timer into a slot while scheduled, and into the list given to
+  // tloTimerWheelAdvance once expired
+  TloIDLLHook hook;
+
+  // private
+  TloIDLList *slot;
+  uint64_t deadline;
+} TloTimer;
+
+/*
+ * - hierarchical timing wheel: schedules timers to expire at a deadline, in
+ *   whatever unit of time the user ticks it in
+ * - level 0 has a slot for each of the next 64 ticks, level 1 a slot for
+ *   each of the next 64 spans of 64 ticks, and so on. a timer goes in the
+ *   lowest level whose slots tell its deadline apart from now. when now
+ *   reaches a slot of a level above 0, the slot's timers are moved down to
+ *   the levels below, so timers still expire at their exact deadline
+ * - scheduling and canceling are O(1), and don't allocate. advancing costs
+ *   O(1) per timer that expires or moves down, and each timer moves down at
+ *   most once per level, while a heap pays O(log n) cache misses per
+ *   operation once it's much bigger than the cache
+ * - a bitmap per level records which slots have timers, so advancing skips
+ *   empty slots instead of ticking through them
+ * - the timers must outlive their time in the wheel
+ */
+typedef struct TloTimerWheel {
+  // private
+  uint64_t now;
+  size_t size;
+  uint64_t occupied[TLO_TIMER_WHEEL_NUM_LEVELS];
+  TloIDLList slots[TLO_TIMER_WHEEL_NUM_LEVELS * TLO_TIMER_WHEEL_NUM_SLOTS];
+} TloTimerWheel;
+
+// a timer has to be constructed before anything else is done with it
+void tloTimerConstruct(TloTimer *timer);
+
+bool tloTimerIsScheduled(const TloTimer *timer);
+
+// timer must have been scheduled at least once
+uint64_t tloTimerDeadline(const TloTimer *timer);
+
+void tloTimerWheelConstruct(TloTimerWheel *wheel, uint64_t now);
+
+uint64_t tloTimerWheelNow(const TloTimerWheel *wheel);
+
+// number of scheduled timers
+size_t tloTimerWheelSize(const TloTimerWheel *wheel);
+bool tloTimerWheelIsEmpty(const TloTimerWheel *wheel);
+
+/*
+ * - timer must not be scheduled. if it's in the list given to
+ *   tloTimerWheelAdvance, it has to be removed from there first
+ * - a deadline that's not after now expires on the next advance
+ */
+void tloTimerWheelSchedule(TloTimerWheel *wheel, TloTimer *timer,
+                           uint64_t deadline);
+
+/*
+ * - unschedules timer, in O(1)
+ * - returns false if timer wasn't scheduled
+ */
+bool tloTimerWheelCancel(TloTimerWheel *wheel, TloTimer *timer);
+
+/*
+ * - moves now forward to given now, which must not be before it
+ * - pushes the timers whose deadline is not after now to the back of expired,
+ *   by their hooks, in order of deadline, and unschedules them. expired must
+ *   not be a slot of wheel
+ * - returns the number of timers that expired
+ */
+size_t tloTimerWheelAdvance(TloTimerWheel *wheel, uint64_t now,
+                            TloIDLList *expired);
+
+/*
+ * - if wheel isn't empty, sets *time to a time before which no timer will
+ *   expire, and returns true. it's the earliest deadline if that's in the
+ *   same span of 64 ticks as now, and otherwise the start of the slot that
+ *   the earliest timer is in
+ * - for sleeping until there's work to do
+ */
+bool tloTimerWheelNextExpiry(const TloTimerWheel *wheel, uint64_t *time);
+
+#endif  // TLO_TIMERWHEEL_H
@@ -0,0 +1,282 @@
+#ifndef TLO_TSCHTABLE_H
+#define TLO_TSCHTABLE_H
+
+#include <assert.h>
+#include "tlo/util.h"
+
+/*
+ * - type-specialized separate chaining hash table map
+ * - TLO_DEFINE_SCHTABLE_MAP(_name, _keyType, _valueType, _hash, _equals)
+ *   defines a struct type named _name, a node type named _name##Node, and
+ *   static inline functions whose names start with _name, for example
+ *   TLO_DEFINE_SCHTABLE_MAP(U64U32Map, uint64_t, uint32_t, hashU64, equalsU64)
+ *   defines U64U32Map, U64U32MapConstruct, U64U32MapInsert, and so on
+ * - _hash should be a function or function-like macro that takes a _keyType
+ *   and returns a size_t
+ * - _equals should be a function or function-like macro that takes two
+ *   _keyTypes and returns whether they are equal
+ * - unlike TloSCHTableMap, there is no TloMap or TloType involved. each key and
+ *   value is stored inline in its node, which is a single allocation, and keys
+ *   and values are copied using plain assignment, so _keyType and _valueType
+ *   should be types that don't need to be deep copied or destructed
+ * - growing and shrinking behave the same way as in TloSCHTableMap: insert
+ *   returns TLO_ERROR if the bucket array can't be grown, and a failed
+ *   shrink is ignored
+ * - functions whose names contain Private are used by the generated functions
+ *   and shouldn't be called directly
+ */
+#define TLO_DEFINE_SCHTABLE_MAP(_name, _keyType, _valueType, _hash, _equals) \
+  typedef struct _name##Node {                                               \
+    /* private */                                                            \
+    struct _name##Node *next;                                                \
+    _keyType key;                                                            \
+    _valueType value;                                                        \
+  } _name##Node;                                                             \
+                                                                             \
+  typedef struct _name {                                                     \
+    /* private */                                                            \
+    const TloAllocator *allocator;                                           \
+    _name##Node **array;                                                     \
+    size_t size;                                                             \
+    size_t capacity;                                                         \
+  } _name;                                                                   \
+                                                                             \
+  /*                                                                         \
+   * - if allocator is NULL, uses tloCStdLibAllocator                        \
+   */                                                                        \
+  static inline void _name##Construct(_name *map,                            \
+                                      const TloAllocator *allocator) {       \
+    assert(map);                                                             \
+                                                                             \
+    if (!allocator) {                                                        \
+      allocator = &tloCStdLibAllocator;                                      \
+    }                                                                        \
+                                                                             \
+    map->allocator = allocator;                                              \
+    map->array = NULL;                                                       \
+    map->size = 0;                                                           \
+    map->capacity = 0;                                                       \
+  }                                                                          \
+                                                                             \
+  static inline void _name##Destruct(_name *map) {                           \
+    if (!map) {                                                              \
+      return;                                                                \
+    }                                                                        \
+                                                                             \
+    if (!map->array) {                                                       \
+      return;                                                                \
+    }                                                                        \
+                                                                             \
+    for (size_t i = 0; i < map->capacity; ++i) {                             \
+      _name##Node *node = map->array[i];                                     \
+                                                                             \
+      while (node) {                                                         \
+        _name##Node *next = node->next;                                      \
+        tloAllocatorSizedFree(map->allocator, node, sizeof(*node));          \
+        node = next;                                                         \
+      }                                                                      \
+    }                                                                        \
+                                                                             \
+    tloAllocatorSizedFree(map->allocator, map->array,                        \
+                          map->capacity * sizeof(*map->array));              \
+    map->array = NULL;                                                       \
+    map->size = 0;                                                           \
+    map->capacity = 0;                                                       \
+  }                                                                          \
+                                                                             \
+  /*                                                                         \
+   * - uses given allocator's malloc then _name##Construct                   \
+   */                                                                        \
+  static inline _name *_name##Make(const TloAllocator *allocator) {          \
+    if (!allocator) {                                                        \
+      allocator = &tloCStdLibAllocator;                                      \
+    }                                                                        \
+                                                                             \
+    _name *map = tloAllocatorMalloc(allocator, sizeof(*map));                \
+    if (!map) {                                                              \
+      return NULL;                                                           \
+    }                                                                        \
+                                                                             \
+    _name##Construct(map, allocator);                                        \
+    return map;                                                              \
+  }                                                                          \
+                                                                             \
+  /*                                                                         \
+   * - _name##Destruct then allocator's free                                 \
+   */                                                                        \
+  static inline void _name##Delete(_name *map) {                             \
+    if (!map) {                                                              \
+      return;                                                                \
+    }                                                                        \
+                                                                             \
+    const TloAllocator *allocator = map->allocator;                          \
+    _name##Destruct(map);                                                    \
+    tloAllocatorSizedFree(allocator, map, sizeof(*map));                     \
+  }                                                                          \
+                                                                             \
+  static inline const TloAllocator *_name##Allocator(const _name *map) {     \
+    assert(map);                                                             \
+                                                                             \
+    return map->allocator;                                                   \
+  }                                                                          \
+                                                                             \
+  static inline size_t _name##Size(const _name *map) {                       \
+    assert(map);                                                             \
+                                                                             \
+    return map->size;                                                        \
+  }                                                                          \
+                                                                             \
+  static inline bool _name##IsEmpty(const _name *map) {                      \
+    assert(map);                                                             \
+                                                                             \
+    return map->size == 0;                                                   \
+  }                                                                          \
+                                                                             \
+  /*                                                                         \
+   * - returns the address of the pointer that points to the node with the   \
+   *   given key, or the address of the null pointer that ends the key's     \
+   *   bucket if there is no such node                                       \
+   * - assumes map->capacity > 0                                             \
+   */                                                                        \
+  static inline _name##Node **_name##PrivateFind(const _name *map,           \
+                                                 _keyType key) {             \
+    _name##Node **link = &map->array[(_hash(key)) % map->capacity];          \
+                                                                             \
+    while (*link && !(_equals((*link)->key, key))) {                         \
+      link = &(*link)->next;                                                 \
+    }                                                                        \
+                                                                             \
+    return link;                                                             \
+  }                                                                          \
+                                                                             \
+  static inline const _valueType *_name##Find(const _name *map,              \
+                                              _keyType key) {                \
+    assert(map);                                                             \
+                                                                             \
+    if (!map->capacity) {                                                    \
+      return NULL;                                                           \
+    }                                                                        \
+                                                                             \
+    _name##Node *node = *_name##PrivateFind(map, key);                       \
+    return node ? &node->value : NULL;                                       \
+  }                                                                          \
+                                                                             \
+  static inline _valueType *_name##FindMutable(_name *map, _keyType key) {   \
+    assert(map);                                                             \
+                                                                             \
+    if (!map->capacity) {                                                    \
+      return NULL;                                                           \
+    }                                                                        \
+                                                                             \
+    _name##Node *node = *_name##PrivateFind(map, key);                       \
+    return node ? &node->value : NULL;                                       \
+  }                                                                          \
+                                                                             \
+  /*                                                                         \
+   * - returns TLO_ERROR if allocation of new array fails, leaving the table \
+   *   as is and still usable with its current capacity                      \
+   */                                                                        \
+  static inline TloError _name##PrivateResize(_name *map,                    \
+                                              size_t newCapacity) {          \
+    _name##Node **newArray =                                                 \
+        tloAllocatorCalloc(map->allocator, newCapacity, sizeof(*newArray));  \
+    if (!newArray) {                                                         \
+      return TLO_ERROR;                                                      \
+    }                                                                        \
+                                                                             \
+    for (size_t i = 0; i < map->capacity; ++i) {                             \
+      _name##Node *node = map->array[i];                                     \
+                                                                             \
+      while (node) {                                                         \
+        _name##Node *next = node->next;                                      \
+        size_t index = (_hash(node->key)) % newCapacity;                     \
+        node->next = newArray[index];                                        \
+        newArray[index] = node;                                              \
+        node = next;                                                         \
+      }                                                                      \
+    }                                                                        \
+                                                                             \
+    tloAllocatorSizedFree(map->allocator, map->array,                        \
+                          map->capacity * sizeof(*map->array));              \
+    map->array = newArray;                                                   \
+    map->capacity = newCapacity;                                             \
+    return TLO_SUCCESS;                                                      \
+  }                                                                          \
+                                                                             \
+  static inline TloError _name##PrivateAllocateArrayIfNeeded(_name *map) {   \
+    if (!map->array) {                                                       \
+      map->array =                                                           \
+          tloAllocatorCalloc(map->allocator, 1, sizeof(*map->array));        \
+      if (!map->array) {                                                     \
+        return TLO_ERROR;                                                    \
+      }                                                                      \
+                                                                             \
+      map->capacity = 1;                                                     \
+    }                                                                        \
+    return TLO_SUCCESS;                                                      \
+  }                                                                          \
+                                                                             \
+  /*                                                                         \
+   * - returns TLO_DUPLICATE if the key is already in the map                \
+   * - returns TLO_ERROR if memory can't be allocated, leaving the map's     \
+   *   keys as they were                                                     \
+   */                                                                        \
+  static inline TloError _name##Insert(_name *map, _keyType key,             \
+                                       _valueType value) {                   \
+    assert(map);                                                             \
+                                                                             \
+    if (_name##PrivateAllocateArrayIfNeeded(map) != TLO_SUCCESS) {           \
+      return TLO_ERROR;                                                      \
+    }                                                                        \
+                                                                             \
+    if (*_name##PrivateFind(map, key)) {                                     \
+      return TLO_DUPLICATE;                                                  \
+    }                                                                        \
+                                                                             \
+    if (map->size == map->capacity &&                                        \
+        _name##PrivateResize(map, map->capacity * 2) != TLO_SUCCESS) {       \
+      return TLO_ERROR;                                                      \
+    }                                                                        \
+                                                                             \
+    _name##Node *node = tloAllocatorMalloc(map->allocator, sizeof(*node));   \
+    if (!node) {                                                             \
+      return TLO_ERROR;                                                      \
+    }                                                                        \
+                                                                             \
+    node->key = key;                                                         \
+    node->value = value;                                                     \
+                                                                             \
+    _name##Node **bucket = &map->array[(_hash(key)) % map->capacity];        \
+    node->next = *bucket;                                                    \
+    *bucket = node;                                                          \
+    ++map->size;                                                             \
+                                                                             \
+    return TLO_SUCCESS;                                                      \
+  }                                                                          \
+                                                                             \
+  static inline bool _name##Remove(_name *map, _keyType key) {               \
+    assert(map);                                                             \
+                                                                             \
+    if (!map->capacity) {                                                    \
+      return false;                                                          \
+    }                                                                        \
+                                                                             \
+    _name##Node **link = _name##PrivateFind(map, key);                       \
+    _name##Node *node = *link;                                               \
+    if (!node) {                                                             \
+      return false;                                                          \
+    }                                                                        \
+                                                                             \
+    *link = node->next;                                                      \
+    tloAllocatorSizedFree(map->allocator, node, sizeof(*node));              \
+    --map->size;                                                             \
+                                                                             \
+    /* if shrinking fails, the table just stays bigger */                    \
+    if (map->size <= map->capacity / 4 && map->size) {                       \
+      _name##PrivateResize(map, map->capacity / 2);                          \
+    }                                                                        \
+                                                                             \
+    return true;                                                             \
+  }
+
+#endif  // TLO_TSCHTABLE_H
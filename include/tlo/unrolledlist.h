@@ -0,0 +1,96 @@
+#ifndef TLO_UNROLLEDLIST_H
+#define TLO_UNROLLEDLIST_H
+
+#include "tlo/list.h"
+
+/*
+ * - unrolled doubly-linked list
+ * - each node stores up to nodeCapacity elements inline, so pushing and
+ *   popping at either end only allocate or free a node once per nodeCapacity
+ *   elements, and traversal walks contiguous memory
+ * - element is O(n / nodeCapacity), starting from whichever end is closer
+ */
+enum { TLO_UNROLLED_LIST_NODE_SIZE = 512 };
+
+typedef struct TloUnrolledListNode {
+  // private
+  struct TloUnrolledListNode *next;
+  struct TloUnrolledListNode *prev;
+
+  // the node's elements are data[begin] to data[end - 1]
+  size_t begin;
+  size_t end;
+  _Alignas(max_align_t) unsigned char data[];
+} TloUnrolledListNode;
+
+typedef struct TloUnrolledList {
+  // public, use only for passing to tloList and tlovList functions
+  TloList list;
+
+  // private
+  TloUnrolledListNode *head;
+  TloUnrolledListNode *tail;
+
+  // a node that was emptied and kept so pushes and pops near a node boundary
+  // don't allocate and free over and over
+  TloUnrolledListNode *spare;
+  size_t size;
+  size_t nodeCapacity;
+} TloUnrolledList;
+
+/*
+ * - if nodeCapacity is 0, fits as many elements as possible in nodes of
+ *   TLO_UNROLLED_LIST_NODE_SIZE bytes
+ */
+void tloUnrolledListConstruct(TloUnrolledList *ulist, const TloType *valueType,
+                              const TloAllocator *allocator,
+                              size_t nodeCapacity);
+
+/*
+ * - uses TloUnrolledList's pushBack
+ */
+TloError tloUnrolledListConstructCopy(TloUnrolledList *ulist,
+                                      const TloUnrolledList *other);
+
+/*
+ * - uses given allocator's malloc then tloUnrolledListConstruct
+ */
+TloUnrolledList *tloUnrolledListMake(const TloType *valueType,
+                                     const TloAllocator *allocator,
+                                     size_t nodeCapacity);
+
+/*
+ * - uses malloc of other's allocator then tloUnrolledListConstructCopy
+ */
+TloUnrolledList *tloUnrolledListMakeCopy(const TloUnrolledList *other);
+
+/*
+ * - uses tloUnrolledListConstructCopy and TloUnrolledList's destruct
+ */
+TloError tloUnrolledListCopy(TloUnrolledList *ulist,
+                             const TloUnrolledList *other);
+
+const TloUnrolledListNode *tloUnrolledListHead(const TloUnrolledList *ulist);
+TloUnrolledListNode *tloUnrolledListMutableHead(TloUnrolledList *ulist);
+const TloUnrolledListNode *tloUnrolledListTail(const TloUnrolledList *ulist);
+TloUnrolledListNode *tloUnrolledListMutableTail(TloUnrolledList *ulist);
+
+/*
+ * - a node's elements are contiguous, so element i + 1 directly follows
+ *   element i, valueType->size bytes later
+ */
+size_t tloUnrolledListNodeSize(const TloUnrolledListNode *node);
+const void *tloUnrolledListNodeElement(const TloUnrolledList *ulist,
+                                       const TloUnrolledListNode *node,
+                                       size_t index);
+void *tloUnrolledListNodeMutableElement(TloUnrolledList *ulist,
+                                        TloUnrolledListNode *node,
+                                        size_t index);
+const TloUnrolledListNode *tloUnrolledListNodeNext(
+    const TloUnrolledListNode *node);
+TloUnrolledListNode *tloUnrolledListNodeMutableNext(TloUnrolledListNode *node);
+const TloUnrolledListNode *tloUnrolledListNodePrev(
+    const TloUnrolledListNode *node);
+TloUnrolledListNode *tloUnrolledListNodeMutablePrev(TloUnrolledListNode *node);
+
+#endif  // TLO_UNROLLEDLIST_H
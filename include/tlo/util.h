@@ -3,6 +3,7 @@
 
 #include <stdbool.h>
 #include <stddef.h>
+#include <stdint.h>
 #include "tlo/hash.h"
 
 /*
@@ -10,8 +11,8 @@
  * - return value TLO_SUCCESS means function succeeded (no error occurred)
  * - return value TLO_ERROR means function failed (error occurred)
  * - TLO_DUPLICATE is returned by only the TloSet and TloMap insertion functions
- *   when they fail because the value or key being inserted already exists in
- *   the set or map
+ *   and tloISCHTableInsert when they fail because the value or key being
+ *   inserted already exists in the set, map, or table
  */
 typedef enum TloError {
   TLO_SUCCESS = 0,
@@ -19,6 +20,33 @@ typedef enum TloError {
   TLO_DUPLICATE = -2
 } TloError;
 
+/*
+ * - returns a pointer to the object of type _type whose member _member is
+ *   pointed to by _pointer
+ * - used to get from the hook of an intrusive container back to the object
+ *   that embeds it
+ */
+#define TLO_CONTAINER_OF(_pointer, _type, _member) \
+  ((_type *)((uintptr_t)(_pointer) - offsetof(_type, _member)))
+
+/*
+ * - size in bytes of a cache line on the CPUs we care about
+ * - used to keep data written by different threads on different cache lines
+ */
+#define TLO_CACHE_LINE_SIZE 64
+
+/*
+ * - an integer key inside objects of some type, which orders them
+ * - the key is size bytes long, 1, 2, 4, or 8, starts offset bytes into the
+ *   object, and is in the machine's byte order
+ * - if isSigned is true, the key is a two's complement signed integer
+ */
+typedef struct TloIntegerKey {
+  size_t offset;
+  size_t size;
+  bool isSigned;
+} TloIntegerKey;
+
 typedef struct TloType {
   // public
   size_t size;
@@ -50,6 +78,12 @@ typedef struct TloType {
    * - returns >0 if pointee of object1 is greater than pointee of object2
    */
   int (*compare)(const void *object1, const void *object2);
+
+  /*
+   * - optional. if not NULL, ordering objects by this key must give the same
+   *   order as compare, which lets sorts radix sort them instead
+   */
+  const TloIntegerKey *integerKey;
 } TloType;
 
 /*
@@ -83,13 +117,76 @@ extern const TloType tloInt;
 
 typedef struct TloAllocator {
   // public
-  void *(*malloc)(size_t size);
-  void (*free)(void *memory);
+
+  // passed as the first argument to each of the functions below
+  void *context;
+
+  // all of the following must be implemented
+  void *(*malloc)(void *context, size_t size);
+  void (*free)(void *context, void *memory);
+
+  // all of the following are optional
+
+  /*
+   * - like C's realloc, but is also given the size that memory was allocated or
+   *   last reallocated with
+   * - memory is never NULL and newSize is never 0
+   * - on failure, should return NULL and leave memory as is
+   */
+  void *(*realloc)(void *context, void *memory, size_t size, size_t newSize);
+
+  // like C's calloc
+  void *(*calloc)(void *context, size_t count, size_t size);
+
+  /*
+   * - like free, but is also given the size that memory was allocated or last
+   *   reallocated with
+   */
+  void (*sizedFree)(void *context, void *memory, size_t size);
 } TloAllocator;
 
+// calls allocator->malloc(allocator->context, size)
+void *tloAllocatorMalloc(const TloAllocator *allocator, size_t size);
+
+// calls allocator->free(allocator->context, memory)
+void tloAllocatorFree(const TloAllocator *allocator, void *memory);
+
+/*
+ * - if allocator->sizedFree is not NULL, calls
+ *   allocator->sizedFree(allocator->context, memory, size)
+ * - otherwise, calls allocator->free(allocator->context, memory)
+ * - size should be the size that memory was allocated or last reallocated with
+ */
+void tloAllocatorSizedFree(const TloAllocator *allocator, void *memory,
+                           size_t size);
+
+/*
+ * - if allocator->realloc is not NULL, calls
+ *   allocator->realloc(allocator->context, memory, size, newSize)
+ * - otherwise, uses allocator's malloc, memcpy, then tloAllocatorSizedFree
+ * - size should be the size that memory was allocated or last reallocated with
+ * - on failure, returns NULL and leaves memory as is
+ */
+void *tloAllocatorRealloc(const TloAllocator *allocator, void *memory,
+                          size_t size, size_t newSize);
+
+/*
+ * - if allocator->calloc is not NULL, calls
+ *   allocator->calloc(allocator->context, count, size)
+ * - otherwise, uses allocator's malloc then memset
+ * - returns NULL if count * size overflows
+ * - prefer this over malloc then memset for big zeroed arrays, since an
+ *   allocator can hand out memory that is already zeroed, such as fresh pages
+ *   from the OS, without touching it
+ */
+void *tloAllocatorCalloc(const TloAllocator *allocator, size_t count,
+                         size_t size);
+
+// tloAllocatorCalloc(allocator, 1, size)
 void *tloAllocatorMallocAndZeroInitialize(const TloAllocator *allocator,
                                           size_t size);
 
+// uses C's malloc, free, realloc, and calloc
 extern const TloAllocator tloCStdLibAllocator;
 
 void tloPtrDestruct(void *ptr);
@@ -0,0 +1,245 @@
+#include "tlo/arena.h"
+#include <assert.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include "util.h"
+
+struct TloArenaBlock {
+  TloArenaBlock *next;
+  size_t size;
+};
+
+enum {
+  ALIGNMENT = _Alignof(max_align_t),
+  HEADER_SIZE = (sizeof(TloArenaBlock) + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT
+};
+
+static size_t roundUpToAlignment(size_t size) {
+  return (size + ALIGNMENT - 1) & ~(size_t)(ALIGNMENT - 1);
+}
+
+#ifndef NDEBUG
+static bool arenaIsValid(const TloArena *arena) {
+  return arena && arena->allocator.context == arena &&
+         allocatorIsValid(arena->blockAllocator) &&
+         arena->blockSize > HEADER_SIZE && (arena->position <= arena->end) &&
+         ((arena->position == NULL) == (arena->end == NULL));
+}
+#endif
+
+static unsigned char *blockData(TloArenaBlock *block) {
+  return (unsigned char *)block + HEADER_SIZE;
+}
+
+static TloArenaBlock *makeBlock(TloArena *arena, size_t size) {
+  TloArenaBlock *block = tloAllocatorMalloc(arena->blockAllocator, size);
+  if (!block) {
+    return NULL;
+  }
+
+  block->next = NULL;
+  block->size = size;
+  return block;
+}
+
+static void *allocateFromOwnBlock(TloArena *arena, size_t size) {
+  TloArenaBlock *block = makeBlock(arena, HEADER_SIZE + size);
+  if (!block) {
+    return NULL;
+  }
+
+  // keep the current block at the front so it stays in use
+  if (arena->blocks) {
+    block->next = arena->blocks->next;
+    arena->blocks->next = block;
+  } else {
+    arena->blocks = block;
+  }
+
+  return blockData(block);
+}
+
+static void *allocateFromNewBlock(TloArena *arena, size_t size) {
+  TloArenaBlock *block = makeBlock(arena, arena->blockSize);
+  if (!block) {
+    return NULL;
+  }
+
+  block->next = arena->blocks;
+  arena->blocks = block;
+  arena->position = blockData(block) + size;
+  arena->end = (unsigned char *)block + block->size;
+
+  return blockData(block);
+}
+
+static void *arenaMalloc(void *context, size_t size) {
+  TloArena *arena = context;
+  assert(arenaIsValid(arena));
+
+  if (size > SIZE_MAX - ALIGNMENT - arena->blockSize) {
+    return NULL;
+  }
+
+  size = roundUpToAlignment(size ? size : 1);
+
+  if (size <= (size_t)(arena->end - arena->position)) {
+    void *memory = arena->position;
+    arena->position += size;
+    return memory;
+  }
+
+  if (size > arena->blockSize - HEADER_SIZE) {
+    return allocateFromOwnBlock(arena, size);
+  }
+
+  return allocateFromNewBlock(arena, size);
+}
+
+static void arenaFree(void *context, void *memory) {
+  (void)context;
+  (void)memory;
+}
+
+static bool isMostRecentAllocation(const TloArena *arena,
+                                   const unsigned char *memory, size_t size) {
+  return memory + size == arena->position;
+}
+
+static void *arenaRealloc(void *context, void *memory, size_t size,
+                          size_t newSize) {
+  TloArena *arena = context;
+  assert(arenaIsValid(arena));
+  assert(memory);
+  assert(newSize);
+
+  size = roundUpToAlignment(size ? size : 1);
+
+  if (isMostRecentAllocation(arena, memory, size) &&
+      newSize <= (size_t)(arena->end - (unsigned char *)memory)) {
+    arena->position = (unsigned char *)memory + roundUpToAlignment(newSize);
+    return memory;
+  }
+
+  void *newMemory = arenaMalloc(arena, newSize);
+  if (!newMemory) {
+    return NULL;
+  }
+
+  memcpy(newMemory, memory, size < newSize ? size : newSize);
+  return newMemory;
+}
+
+static void *arenaCalloc(void *context, size_t count, size_t size) {
+  if (size && count > SIZE_MAX / size) {
+    return NULL;
+  }
+
+  void *memory = arenaMalloc(context, count * size);
+  if (!memory) {
+    return NULL;
+  }
+
+  memset(memory, 0, count * size);
+  return memory;
+}
+
+static void arenaSizedFree(void *context, void *memory, size_t size) {
+  TloArena *arena = context;
+  assert(arenaIsValid(arena));
+
+  size = roundUpToAlignment(size ? size : 1);
+
+  if (memory && isMostRecentAllocation(arena, memory, size)) {
+    arena->position = memory;
+  }
+}
+
+void tloArenaConstruct(TloArena *arena, const TloAllocator *blockAllocator,
+                       size_t blockSize) {
+  assert(arena);
+  assert(blockAllocator == NULL || allocatorIsValid(blockAllocator));
+
+  if (!blockAllocator) {
+    blockAllocator = &tloCStdLibAllocator;
+  }
+
+  if (!blockSize) {
+    blockSize = TLO_ARENA_DEFAULT_BLOCK_SIZE;
+  }
+
+  arena->allocator = (TloAllocator){.context = arena,
+                                    .malloc = arenaMalloc,
+                                    .free = arenaFree,
+                                    .realloc = arenaRealloc,
+                                    .calloc = arenaCalloc,
+                                    .sizedFree = arenaSizedFree};
+  arena->blockAllocator = blockAllocator;
+  arena->blockSize = HEADER_SIZE + roundUpToAlignment(blockSize);
+  arena->blocks = NULL;
+  arena->position = NULL;
+  arena->end = NULL;
+}
+
+static void freeBlocks(TloArena *arena, TloArenaBlock *block) {
+  while (block) {
+    TloArenaBlock *next = block->next;
+    tloAllocatorSizedFree(arena->blockAllocator, block, block->size);
+    block = next;
+  }
+}
+
+void tloArenaDestruct(TloArena *arena) {
+  if (!arena) {
+    return;
+  }
+
+  assert(arenaIsValid(arena));
+
+  freeBlocks(arena, arena->blocks);
+  arena->blocks = NULL;
+  arena->position = NULL;
+  arena->end = NULL;
+}
+
+TloArena *tloArenaMake(const TloAllocator *blockAllocator, size_t blockSize) {
+  if (!blockAllocator) {
+    blockAllocator = &tloCStdLibAllocator;
+  }
+
+  assert(allocatorIsValid(blockAllocator));
+
+  TloArena *arena = tloAllocatorMalloc(blockAllocator, sizeof(*arena));
+  if (!arena) {
+    return NULL;
+  }
+
+  tloArenaConstruct(arena, blockAllocator, blockSize);
+
+  return arena;
+}
+
+void tloArenaDelete(TloArena *arena) {
+  if (!arena) {
+    return;
+  }
+
+  const TloAllocator *blockAllocator = arena->blockAllocator;
+  tloArenaDestruct(arena);
+  tloAllocatorSizedFree(blockAllocator, arena, sizeof(*arena));
+}
+
+void tloArenaReset(TloArena *arena) {
+  assert(arenaIsValid(arena));
+
+  if (!arena->blocks) {
+    return;
+  }
+
+  TloArenaBlock *block = arena->blocks;
+  freeBlocks(arena, block->next);
+  block->next = NULL;
+  arena->position = blockData(block);
+  arena->end = (unsigned char *)block + block->size;
+}
@@ -0,0 +1,392 @@
+#include "tlo/bitset.h"
+#include <assert.h>
+#include "util.h"
+
+enum { WORD_BITS = 64 };
+
+static size_t wordsFor(size_t size) {
+  return size / WORD_BITS + (size % WORD_BITS != 0);
+}
+
+// the bits of the last word that are within size, or all of them
+static uint64_t lastWordMask(size_t size) {
+  size_t numBits = size % WORD_BITS;
+  return numBits ? ((uint64_t)1 << numBits) - 1 : ~(uint64_t)0;
+}
+
+static uint64_t bitOf(size_t index) {
+  return (uint64_t)1 << (index % WORD_BITS);
+}
+
+#ifndef NDEBUG
+static bool bitsetIsValid(const TloBitset *bitset) {
+  if (!bitset || !allocatorIsValid(bitset->allocator) ||
+      (!bitset->words && bitset->capacity) ||
+      wordsFor(bitset->size) > bitset->capacity) {
+    return false;
+  }
+
+  size_t numWords = wordsFor(bitset->size);
+  return !numWords || !(bitset->words[numWords - 1] &
+                        ~lastWordMask(bitset->size));
+}
+#endif
+
+TloError tloBitsetConstruct(TloBitset *bitset, size_t size,
+                            const TloAllocator *allocator) {
+  assert(bitset);
+  assert(allocator == NULL || allocatorIsValid(allocator));
+
+  if (!allocator) {
+    allocator = &tloCStdLibAllocator;
+  }
+
+  size_t numWords = wordsFor(size);
+  if (numWords) {
+    bitset->words =
+        tloAllocatorCalloc(allocator, numWords, sizeof(*bitset->words));
+    if (!bitset->words) {
+      return TLO_ERROR;
+    }
+  } else {
+    bitset->words = NULL;
+  }
+
+  bitset->size = size;
+  bitset->capacity = numWords;
+  bitset->allocator = allocator;
+  return TLO_SUCCESS;
+}
+
+void tloBitsetDestruct(TloBitset *bitset) {
+  if (!bitset) {
+    return;
+  }
+
+  assert(bitsetIsValid(bitset));
+
+  if (bitset->words) {
+    tloAllocatorSizedFree(bitset->allocator, bitset->words,
+                          bitset->capacity * sizeof(*bitset->words));
+    bitset->words = NULL;
+  }
+  bitset->size = 0;
+  bitset->capacity = 0;
+}
+
+TloBitset *tloBitsetMake(size_t size, const TloAllocator *allocator) {
+  if (!allocator) {
+    allocator = &tloCStdLibAllocator;
+  }
+
+  assert(allocatorIsValid(allocator));
+
+  TloBitset *bitset = tloAllocatorMalloc(allocator, sizeof(*bitset));
+  if (!bitset) {
+    return NULL;
+  }
+
+  if (tloBitsetConstruct(bitset, size, allocator) != TLO_SUCCESS) {
+    tloAllocatorSizedFree(allocator, bitset, sizeof(*bitset));
+    return NULL;
+  }
+
+  return bitset;
+}
+
+void tloBitsetDelete(TloBitset *bitset) {
+  if (!bitset) {
+    return;
+  }
+
+  const TloAllocator *allocator = bitset->allocator;
+  tloBitsetDestruct(bitset);
+  tloAllocatorSizedFree(allocator, bitset, sizeof(*bitset));
+}
+
+size_t tloBitsetSize(const TloBitset *bitset) {
+  assert(bitsetIsValid(bitset));
+
+  return bitset->size;
+}
+
+// makes room for at least numWords words. the new words are 0
+static TloError reserveWords(TloBitset *bitset, size_t numWords) {
+  if (numWords <= bitset->capacity) {
+    return TLO_SUCCESS;
+  }
+
+  if (numWords > SIZE_MAX / sizeof(*bitset->words)) {
+    return TLO_ERROR;
+  }
+
+  if (!bitset->words) {
+    bitset->words =
+        tloAllocatorCalloc(bitset->allocator, numWords, sizeof(*bitset->words));
+    if (!bitset->words) {
+      return TLO_ERROR;
+    }
+    bitset->capacity = numWords;
+    return TLO_SUCCESS;
+  }
+
+  uint64_t *newWords = tloAllocatorRealloc(
+      bitset->allocator, bitset->words,
+      bitset->capacity * sizeof(*bitset->words),
+      numWords * sizeof(*bitset->words));
+  if (!newWords) {
+    return TLO_ERROR;
+  }
+
+  for (size_t i = bitset->capacity; i < numWords; ++i) {
+    newWords[i] = 0;
+  }
+  bitset->words = newWords;
+  bitset->capacity = numWords;
+  return TLO_SUCCESS;
+}
+
+TloError tloBitsetResize(TloBitset *bitset, size_t size) {
+  assert(bitsetIsValid(bitset));
+
+  if (reserveWords(bitset, wordsFor(size)) != TLO_SUCCESS) {
+    return TLO_ERROR;
+  }
+
+  // the bits cut off are cleared, so they're 0 if bitset grows again
+  if (size < bitset->size) {
+    size_t numWords = wordsFor(size);
+    if (numWords) {
+      bitset->words[numWords - 1] &= lastWordMask(size);
+    }
+    for (size_t i = numWords; i < wordsFor(bitset->size); ++i) {
+      bitset->words[i] = 0;
+    }
+  }
+
+  bitset->size = size;
+  return TLO_SUCCESS;
+}
+
+bool tloBitsetTest(const TloBitset *bitset, size_t index) {
+  assert(bitsetIsValid(bitset));
+  assert(index < bitset->size);
+
+  return (bitset->words[index / WORD_BITS] & bitOf(index)) != 0;
+}
+
+void tloBitsetSet(TloBitset *bitset, size_t index) {
+  assert(bitsetIsValid(bitset));
+  assert(index < bitset->size);
+
+  bitset->words[index / WORD_BITS] |= bitOf(index);
+}
+
+void tloBitsetClear(TloBitset *bitset, size_t index) {
+  assert(bitsetIsValid(bitset));
+  assert(index < bitset->size);
+
+  bitset->words[index / WORD_BITS] &= ~bitOf(index);
+}
+
+void tloBitsetFlip(TloBitset *bitset, size_t index) {
+  assert(bitsetIsValid(bitset));
+  assert(index < bitset->size);
+
+  bitset->words[index / WORD_BITS] ^= bitOf(index);
+}
+
+void tloBitsetSetAll(TloBitset *bitset) {
+  assert(bitsetIsValid(bitset));
+
+  size_t numWords = wordsFor(bitset->size);
+  for (size_t i = 0; i < numWords; ++i) {
+    bitset->words[i] = ~(uint64_t)0;
+  }
+  if (numWords) {
+    bitset->words[numWords - 1] = lastWordMask(bitset->size);
+  }
+}
+
+void tloBitsetClearAll(TloBitset *bitset) {
+  assert(bitsetIsValid(bitset));
+
+  size_t numWords = wordsFor(bitset->size);
+  for (size_t i = 0; i < numWords; ++i) {
+    bitset->words[i] = 0;
+  }
+}
+
+// counts the bits in pairs, then nibbles, then bytes, then adds the bytes up
+static size_t popCount(uint64_t word) {
+  word -= (word >> 1) & UINT64_C(0x5555555555555555);
+  word = (word & UINT64_C(0x3333333333333333)) +
+         ((word >> 2) & UINT64_C(0x3333333333333333));
+  word = (word + (word >> 4)) & UINT64_C(0x0F0F0F0F0F0F0F0F);
+  return (size_t)((word * UINT64_C(0x0101010101010101)) >> 56);
+}
+
+size_t tloBitsetCount(const TloBitset *bitset) {
+  assert(bitsetIsValid(bitset));
+
+  size_t numWords = wordsFor(bitset->size);
+  size_t count = 0;
+  for (size_t i = 0; i < numWords; ++i) {
+    count += popCount(bitset->words[i]);
+  }
+  return count;
+}
+
+bool tloBitsetAny(const TloBitset *bitset) {
+  assert(bitsetIsValid(bitset));
+
+  size_t numWords = wordsFor(bitset->size);
+  for (size_t i = 0; i < numWords; ++i) {
+    if (bitset->words[i]) {
+      return true;
+    }
+  }
+  return false;
+}
+
+size_t tloBitsetFindNext(const TloBitset *bitset, size_t index) {
+  assert(bitsetIsValid(bitset));
+  assert(index <= bitset->size);
+
+  if (index == bitset->size) {
+    return bitset->size;
+  }
+
+  // the bits past size are 0, so a 1 bit that's found is within size
+  size_t numWords = wordsFor(bitset->size);
+  size_t i = index / WORD_BITS;
+  uint64_t word = bitset->words[i] & (~(uint64_t)0 << (index % WORD_BITS));
+  while (!word) {
+    if (++i == numWords) {
+      return bitset->size;
+    }
+    word = bitset->words[i];
+  }
+
+  return i * WORD_BITS + lowestSetBit(word);
+}
+
+static size_t minWords(const TloBitset *bitset, const TloBitset *other) {
+  size_t numWords = wordsFor(bitset->size);
+  size_t numOtherWords = wordsFor(other->size);
+  return numWords < numOtherWords ? numWords : numOtherWords;
+}
+
+void tloBitsetAnd(TloBitset *bitset, const TloBitset *other) {
+  assert(bitsetIsValid(bitset));
+  assert(bitsetIsValid(other));
+
+  size_t numWords = wordsFor(bitset->size);
+  size_t numCommonWords = minWords(bitset, other);
+  uint64_t *words = bitset->words;
+  const uint64_t *otherWords = other->words;
+  for (size_t i = 0; i < numCommonWords; ++i) {
+    words[i] &= otherWords[i];
+  }
+  for (size_t i = numCommonWords; i < numWords; ++i) {
+    words[i] = 0;
+  }
+}
+
+void tloBitsetAndNot(TloBitset *bitset, const TloBitset *other) {
+  assert(bitsetIsValid(bitset));
+  assert(bitsetIsValid(other));
+
+  size_t numCommonWords = minWords(bitset, other);
+  uint64_t *words = bitset->words;
+  const uint64_t *otherWords = other->words;
+  for (size_t i = 0; i < numCommonWords; ++i) {
+    words[i] &= ~otherWords[i];
+  }
+}
+
+/*
+ * - other's bits past its size are 0 and bitset ends up at least as big, so
+ *   these keep bitset's bits past its size 0
+ */
+TloError tloBitsetOr(TloBitset *bitset, const TloBitset *other) {
+  assert(bitsetIsValid(bitset));
+  assert(bitsetIsValid(other));
+
+  if (other->size > bitset->size &&
+      tloBitsetResize(bitset, other->size) != TLO_SUCCESS) {
+    return TLO_ERROR;
+  }
+
+  size_t numOtherWords = wordsFor(other->size);
+  uint64_t *words = bitset->words;
+  const uint64_t *otherWords = other->words;
+  for (size_t i = 0; i < numOtherWords; ++i) {
+    words[i] |= otherWords[i];
+  }
+  return TLO_SUCCESS;
+}
+
+TloError tloBitsetXor(TloBitset *bitset, const TloBitset *other) {
+  assert(bitsetIsValid(bitset));
+  assert(bitsetIsValid(other));
+
+  if (other->size > bitset->size &&
+      tloBitsetResize(bitset, other->size) != TLO_SUCCESS) {
+    return TLO_ERROR;
+  }
+
+  size_t numOtherWords = wordsFor(other->size);
+  uint64_t *words = bitset->words;
+  const uint64_t *otherWords = other->words;
+  for (size_t i = 0; i < numOtherWords; ++i) {
+    words[i] ^= otherWords[i];
+  }
+  return TLO_SUCCESS;
+}
+
+TloError tloBitsetInsert(TloBitset *bitset, size_t key) {
+  assert(bitsetIsValid(bitset));
+
+  if (key >= bitset->size) {
+    if (key == SIZE_MAX) {
+      return TLO_ERROR;
+    }
+
+    size_t numWords = wordsFor(key + 1);
+    if (numWords > bitset->capacity) {
+      size_t doubled = bitset->capacity * 2;
+      if (reserveWords(bitset, doubled > numWords ? doubled : numWords) !=
+          TLO_SUCCESS) {
+        return TLO_ERROR;
+      }
+    }
+    bitset->size = key + 1;
+  }
+
+  uint64_t *word = &bitset->words[key / WORD_BITS];
+  if (*word & bitOf(key)) {
+    return TLO_DUPLICATE;
+  }
+
+  *word |= bitOf(key);
+  return TLO_SUCCESS;
+}
+
+bool tloBitsetContains(const TloBitset *bitset, size_t key) {
+  assert(bitsetIsValid(bitset));
+
+  return key < bitset->size &&
+         (bitset->words[key / WORD_BITS] & bitOf(key)) != 0;
+}
+
+bool tloBitsetRemove(TloBitset *bitset, size_t key) {
+  assert(bitsetIsValid(bitset));
+
+  if (!tloBitsetContains(bitset, key)) {
+    return false;
+  }
+
+  bitset->words[key / WORD_BITS] &= ~bitOf(key);
+  return true;
+}
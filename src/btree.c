@@ -0,0 +1,781 @@
+#include "tlo/btree.h"
+#include <assert.h>
+#include <string.h>
+#include "map.h"
+#include "util.h"
+
+/*
+ * - NODE_SIZE is what an internal node aims for, header, keys, values, and
+ *   children together. leaves don't have children, so they're a bit smaller.
+ *   8 cache lines beat 4 and 16 in tloc_btree_benchmark
+ * - keys, values, and children each start on a max_align_t boundary, like the
+ *   elements of the other containers
+ */
+enum {
+  NODE_SIZE = 8 * TLO_CACHE_LINE_SIZE,
+  MIN_MIN_DEGREE = 2,
+  ALIGNMENT = _Alignof(max_align_t),
+  KEYS_OFFSET = (sizeof(TloBTreeNode) + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT
+};
+
+static size_t roundUpToAlignment(size_t size) {
+  return (size + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT;
+}
+
+static size_t maxNumKeys(const TloBTreeMap *btree) {
+  return 2 * btree->minDegree - 1;
+}
+
+#ifndef NDEBUG
+static bool btreeMapIsValid(const TloMap *map) {
+  const TloBTreeMap *btree = (const TloBTreeMap *)map;
+  return mapIsValid(map) && map->keyType->compare &&
+         btree->minDegree >= MIN_MIN_DEGREE &&
+         (btree->root == NULL) == (btree->size == 0) &&
+         (!btree->root || btree->root->parent == NULL);
+}
+
+static bool cursorIsValid(const TloBTreeCursor *cursor) {
+  return cursor && btreeMapIsValid(&cursor->btree->map) &&
+         (!cursor->node || cursor->index < cursor->node->numKeys);
+}
+#endif
+
+static unsigned char *keyAt(const TloBTreeMap *btree, TloBTreeNode *node,
+                            size_t index) {
+  return (unsigned char *)node + KEYS_OFFSET +
+         index * btree->map.keyType->size;
+}
+
+static unsigned char *valueAt(const TloBTreeMap *btree, TloBTreeNode *node,
+                              size_t index) {
+  return (unsigned char *)node + btree->valuesOffset +
+         index * btree->map.valueType->size;
+}
+
+static TloBTreeNode **childrenOf(const TloBTreeMap *btree,
+                                 TloBTreeNode *node) {
+  return (TloBTreeNode **)((unsigned char *)node + btree->childrenOffset);
+}
+
+static size_t nodeSize(const TloBTreeMap *btree, bool isLeaf) {
+  if (isLeaf) {
+    return btree->childrenOffset;
+  }
+
+  return btree->childrenOffset + (maxNumKeys(btree) + 1) * sizeof(void *);
+}
+
+static TloBTreeNode *makeNode(const TloBTreeMap *btree, bool isLeaf) {
+  TloBTreeNode *node =
+      tloAllocatorMalloc(btree->map.allocator, nodeSize(btree, isLeaf));
+  if (!node) {
+    return NULL;
+  }
+
+  node->parent = NULL;
+  node->numKeys = 0;
+  node->isLeaf = isLeaf;
+  return node;
+}
+
+static void freeNode(const TloBTreeMap *btree, TloBTreeNode *node) {
+  tloAllocatorSizedFree(btree->map.allocator, node,
+                        nodeSize(btree, node->isLeaf));
+}
+
+static void deleteSubtree(const TloBTreeMap *btree, TloBTreeNode *node) {
+  for (size_t i = 0; i < node->numKeys; ++i) {
+    tloTypeDestruct(btree->map.valueType, valueAt(btree, node, i));
+    tloTypeDestruct(btree->map.keyType, keyAt(btree, node, i));
+  }
+
+  if (!node->isLeaf) {
+    for (size_t i = 0; i <= node->numKeys; ++i) {
+      deleteSubtree(btree, childrenOf(btree, node)[i]);
+    }
+  }
+
+  freeNode(btree, node);
+}
+
+// with memmove, so source and destination can be the same node
+static void moveEntries(const TloBTreeMap *btree, TloBTreeNode *destination,
+                        size_t destinationIndex, TloBTreeNode *source,
+                        size_t sourceIndex, size_t count) {
+  memmove(keyAt(btree, destination, destinationIndex),
+          keyAt(btree, source, sourceIndex), count * btree->map.keyType->size);
+  memmove(valueAt(btree, destination, destinationIndex),
+          valueAt(btree, source, sourceIndex),
+          count * btree->map.valueType->size);
+}
+
+// also makes destination the parent of the moved children
+static void moveChildren(const TloBTreeMap *btree, TloBTreeNode *destination,
+                         size_t destinationIndex, TloBTreeNode *source,
+                         size_t sourceIndex, size_t count) {
+  TloBTreeNode **destinationChildren = childrenOf(btree, destination);
+  memmove(destinationChildren + destinationIndex,
+          childrenOf(btree, source) + sourceIndex, count * sizeof(void *));
+
+  for (size_t i = destinationIndex; i < destinationIndex + count; ++i) {
+    destinationChildren[i]->parent = destination;
+  }
+}
+
+/*
+ * - returns the index of the first key in node that compares greater than key,
+ *   or greater than or equal to it if orEqual is false
+ * - nodes are only a few cache lines, but comparisons are indirect calls, so
+ *   binary search still beats a linear scan
+ */
+static size_t bound(const TloBTreeMap *btree, TloBTreeNode *node,
+                    const void *key, bool orEqual) {
+  int (*compare)(const void *, const void *) = btree->map.keyType->compare;
+  // keys that compare less than this come before the bound
+  int limit = orEqual ? 1 : 0;
+  size_t low = 0;
+  size_t high = node->numKeys;
+
+  while (low < high) {
+    size_t middle = low + (high - low) / 2;
+    if (compare(keyAt(btree, node, middle), key) < limit) {
+      low = middle + 1;
+    } else {
+      high = middle;
+    }
+  }
+
+  return low;
+}
+
+// sets index to where key is in node, or the child it would be under
+static bool findInNode(const TloBTreeMap *btree, TloBTreeNode *node,
+                       const void *key, size_t *index) {
+  *index = bound(btree, node, key, false);
+  return *index < node->numKeys &&
+         btree->map.keyType->compare(keyAt(btree, node, *index), key) == 0;
+}
+
+static TloBTreeNode *findNode(const TloBTreeMap *btree, const void *key,
+                              size_t *index) {
+  TloBTreeNode *node = btree->root;
+
+  while (node) {
+    if (findInNode(btree, node, key, index)) {
+      return node;
+    }
+
+    node = node->isLeaf ? NULL : childrenOf(btree, node)[*index];
+  }
+
+  return NULL;
+}
+
+static void btreeMapDestruct(TloMap *map) {
+  if (!map) {
+    return;
+  }
+
+  assert(btreeMapIsValid(map));
+
+  TloBTreeMap *btree = (TloBTreeMap *)map;
+  if (!btree->root) {
+    return;
+  }
+
+  deleteSubtree(btree, btree->root);
+  btree->root = NULL;
+  btree->size = 0;
+}
+
+static size_t btreeMapSize(const TloMap *map) {
+  assert(btreeMapIsValid(map));
+
+  const TloBTreeMap *btree = (const TloBTreeMap *)map;
+  return btree->size;
+}
+
+static bool btreeMapIsEmpty(const TloMap *map) {
+  assert(btreeMapIsValid(map));
+
+  const TloBTreeMap *btree = (const TloBTreeMap *)map;
+  return btree->size == 0;
+}
+
+static const void *btreeMapFind(const TloMap *map, const void *key) {
+  assert(btreeMapIsValid(map));
+  assert(key);
+
+  const TloBTreeMap *btree = (const TloBTreeMap *)map;
+  size_t index;
+  TloBTreeNode *node = findNode(btree, key, &index);
+  if (!node) {
+    return NULL;
+  }
+
+  return valueAt(btree, node, index);
+}
+
+static void *btreeMapFindMutable(TloMap *map, const void *key) {
+  assert(btreeMapIsValid(map));
+  assert(key);
+
+  TloBTreeMap *btree = (TloBTreeMap *)map;
+  size_t index;
+  TloBTreeNode *node = findNode(btree, key, &index);
+  if (!node) {
+    return NULL;
+  }
+
+  return valueAt(btree, node, index);
+}
+
+/*
+ * - splits the full child at index of parent, which isn't full, in two around
+ *   its middle key, which moves up into parent
+ */
+static TloError splitChild(const TloBTreeMap *btree, TloBTreeNode *parent,
+                           size_t index) {
+  TloBTreeNode *child = childrenOf(btree, parent)[index];
+  TloBTreeNode *sibling = makeNode(btree, child->isLeaf);
+  if (!sibling) {
+    return TLO_ERROR;
+  }
+
+  size_t t = btree->minDegree;
+  moveEntries(btree, sibling, 0, child, t, t - 1);
+  if (!child->isLeaf) {
+    moveChildren(btree, sibling, 0, child, t, t);
+  }
+  sibling->numKeys = t - 1;
+  sibling->parent = parent;
+
+  moveEntries(btree, parent, index + 1, parent, index,
+              parent->numKeys - index);
+  moveChildren(btree, parent, index + 2, parent, index + 1,
+               parent->numKeys - index);
+  moveEntries(btree, parent, index, child, t - 1, 1);
+  childrenOf(btree, parent)[index + 1] = sibling;
+  ++parent->numKeys;
+  child->numKeys = t - 1;
+
+  return TLO_SUCCESS;
+}
+
+static TloError splitRootIfFull(TloBTreeMap *btree) {
+  if (btree->root->numKeys < maxNumKeys(btree)) {
+    return TLO_SUCCESS;
+  }
+
+  TloBTreeNode *newRoot = makeNode(btree, false);
+  if (!newRoot) {
+    return TLO_ERROR;
+  }
+
+  childrenOf(btree, newRoot)[0] = btree->root;
+  btree->root->parent = newRoot;
+
+  if (splitChild(btree, newRoot, 0) != TLO_SUCCESS) {
+    btree->root->parent = NULL;
+    freeNode(btree, newRoot);
+    return TLO_ERROR;
+  }
+
+  btree->root = newRoot;
+  return TLO_SUCCESS;
+}
+
+static TloError constructEntry(const TloBTreeMap *btree, TloBTreeNode *leaf,
+                               size_t index, TloInsertMethod keyInsertMethod,
+                               void *key, TloInsertMethod valueInsertMethod,
+                               void *value) {
+  const TloMap *map = &btree->map;
+
+  if (keyInsertMethod == TLO_COPY) {
+    if (tloTypeConstructCopy(map->keyType, keyAt(btree, leaf, index), key) !=
+        TLO_SUCCESS) {
+      return TLO_ERROR;
+    }
+  } else if (keyInsertMethod == TLO_MOVE) {
+    memcpy(keyAt(btree, leaf, index), key, map->keyType->size);
+  } else {
+    return TLO_ERROR;
+  }
+
+  if (valueInsertMethod == TLO_COPY) {
+    if (tloTypeConstructCopy(map->valueType, valueAt(btree, leaf, index),
+                             value) != TLO_SUCCESS) {
+      goto error;
+    }
+  } else if (valueInsertMethod == TLO_MOVE) {
+    memcpy(valueAt(btree, leaf, index), value, map->valueType->size);
+  } else {
+    goto error;
+  }
+
+  // moved objects are only freed once nothing can fail, so a failed insert
+  // leaves them with the caller
+  if (keyInsertMethod == TLO_MOVE) {
+    tloAllocatorSizedFree(map->allocator, key, map->keyType->size);
+  }
+  if (valueInsertMethod == TLO_MOVE) {
+    tloAllocatorSizedFree(map->allocator, value, map->valueType->size);
+  }
+  return TLO_SUCCESS;
+
+error:
+  if (keyInsertMethod == TLO_COPY) {
+    tloTypeDestruct(map->keyType, keyAt(btree, leaf, index));
+  }
+  return TLO_ERROR;
+}
+
+static TloError btreeMapInsert(TloMap *map, TloInsertMethod keyInsertMethod,
+                               void *key, TloInsertMethod valueInsertMethod,
+                               void *value) {
+  assert(btreeMapIsValid(map));
+  assert(key);
+  assert(value);
+
+  TloBTreeMap *btree = (TloBTreeMap *)map;
+  if (!btree->root) {
+    btree->root = makeNode(btree, true);
+    if (!btree->root) {
+      return TLO_ERROR;
+    }
+  }
+
+  // full nodes are split on the way down, so there's always room for the key
+  // that moves up out of a split
+  if (splitRootIfFull(btree) != TLO_SUCCESS) {
+    goto error;
+  }
+
+  TloBTreeNode *node = btree->root;
+  size_t index;
+
+  for (;;) {
+    if (findInNode(btree, node, key, &index)) {
+      return TLO_DUPLICATE;
+    }
+
+    if (node->isLeaf) {
+      break;
+    }
+
+    if (childrenOf(btree, node)[index]->numKeys == maxNumKeys(btree)) {
+      if (splitChild(btree, node, index) != TLO_SUCCESS) {
+        goto error;
+      }
+
+      int result = map->keyType->compare(key, keyAt(btree, node, index));
+      if (result == 0) {
+        return TLO_DUPLICATE;
+      }
+
+      index += result > 0;
+    }
+
+    node = childrenOf(btree, node)[index];
+  }
+
+  moveEntries(btree, node, index + 1, node, index, node->numKeys - index);
+  if (constructEntry(btree, node, index, keyInsertMethod, key,
+                     valueInsertMethod, value) != TLO_SUCCESS) {
+    moveEntries(btree, node, index, node, index + 1, node->numKeys - index);
+    goto error;
+  }
+
+  ++node->numKeys;
+  ++btree->size;
+  return TLO_SUCCESS;
+
+error:
+  // splits leave a valid tree, so all there is to undo is a new empty root
+  if (btree->size == 0) {
+    freeNode(btree, btree->root);
+    btree->root = NULL;
+  }
+  return TLO_ERROR;
+}
+
+/*
+ * - the child at index of parent has minDegree - 1 keys. moves a key into it
+ *   from the sibling on its left through parent
+ */
+static void borrowFromLeft(const TloBTreeMap *btree, TloBTreeNode *parent,
+                           size_t index) {
+  TloBTreeNode *child = childrenOf(btree, parent)[index];
+  TloBTreeNode *left = childrenOf(btree, parent)[index - 1];
+
+  moveEntries(btree, child, 1, child, 0, child->numKeys);
+  moveEntries(btree, child, 0, parent, index - 1, 1);
+  moveEntries(btree, parent, index - 1, left, left->numKeys - 1, 1);
+
+  if (!child->isLeaf) {
+    moveChildren(btree, child, 1, child, 0, child->numKeys + 1);
+    moveChildren(btree, child, 0, left, left->numKeys, 1);
+  }
+
+  --left->numKeys;
+  ++child->numKeys;
+}
+
+static void borrowFromRight(const TloBTreeMap *btree, TloBTreeNode *parent,
+                            size_t index) {
+  TloBTreeNode *child = childrenOf(btree, parent)[index];
+  TloBTreeNode *right = childrenOf(btree, parent)[index + 1];
+
+  moveEntries(btree, child, child->numKeys, parent, index, 1);
+  moveEntries(btree, parent, index, right, 0, 1);
+  moveEntries(btree, right, 0, right, 1, right->numKeys - 1);
+
+  if (!child->isLeaf) {
+    moveChildren(btree, child, child->numKeys + 1, right, 0, 1);
+    moveChildren(btree, right, 0, right, 1, right->numKeys);
+  }
+
+  --right->numKeys;
+  ++child->numKeys;
+}
+
+/*
+ * - the children at index and index + 1 of parent both have minDegree - 1
+ *   keys. merges the second one and the key between them into the first
+ */
+static void mergeChildren(const TloBTreeMap *btree, TloBTreeNode *parent,
+                          size_t index) {
+  TloBTreeNode *child = childrenOf(btree, parent)[index];
+  TloBTreeNode *right = childrenOf(btree, parent)[index + 1];
+
+  moveEntries(btree, child, child->numKeys, parent, index, 1);
+  moveEntries(btree, child, child->numKeys + 1, right, 0, right->numKeys);
+  if (!child->isLeaf) {
+    moveChildren(btree, child, child->numKeys + 1, right, 0,
+                 right->numKeys + 1);
+  }
+  child->numKeys += right->numKeys + 1;
+
+  moveEntries(btree, parent, index, parent, index + 1,
+              parent->numKeys - index - 1);
+  moveChildren(btree, parent, index + 1, parent, index + 2,
+               parent->numKeys - index - 1);
+  --parent->numKeys;
+
+  freeNode(btree, right);
+}
+
+/*
+ * - makes sure the child at index of parent has at least minDegree keys, so
+ *   one can be removed from under it, by borrowing from a sibling or merging
+ *   with one
+ * - returns the index of the child to go down into, which changes if it was
+ *   merged into its left sibling
+ */
+static size_t fillChild(const TloBTreeMap *btree, TloBTreeNode *parent,
+                        size_t index) {
+  TloBTreeNode **parentChildren = childrenOf(btree, parent);
+  if (parentChildren[index]->numKeys >= btree->minDegree) {
+    return index;
+  }
+
+  if (index > 0 && parentChildren[index - 1]->numKeys >= btree->minDegree) {
+    borrowFromLeft(btree, parent, index);
+    return index;
+  }
+
+  if (index < parent->numKeys &&
+      parentChildren[index + 1]->numKeys >= btree->minDegree) {
+    borrowFromRight(btree, parent, index);
+    return index;
+  }
+
+  if (index < parent->numKeys) {
+    mergeChildren(btree, parent, index);
+    return index;
+  }
+
+  mergeChildren(btree, parent, index - 1);
+  return index - 1;
+}
+
+/*
+ * - moves the greatest or least entry under node, which has at least
+ *   minDegree keys, into the already destructed entry at index of
+ *   destination
+ */
+static void moveOutExtreme(const TloBTreeMap *btree, TloBTreeNode *node,
+                           bool greatest, TloBTreeNode *destination,
+                           size_t index) {
+  while (!node->isLeaf) {
+    size_t childIndex = greatest ? node->numKeys : 0;
+    childIndex = fillChild(btree, node, childIndex);
+    node = childrenOf(btree, node)[childIndex];
+  }
+
+  size_t extremeIndex = greatest ? node->numKeys - 1 : 0;
+  moveEntries(btree, destination, index, node, extremeIndex, 1);
+  moveEntries(btree, node, extremeIndex, node, extremeIndex + 1,
+              node->numKeys - extremeIndex - 1);
+  --node->numKeys;
+}
+
+static void removeFromInternalNode(const TloBTreeMap *btree,
+                                   TloBTreeNode *node, size_t index) {
+  TloBTreeNode **nodeChildren = childrenOf(btree, node);
+  tloTypeDestruct(btree->map.valueType, valueAt(btree, node, index));
+  tloTypeDestruct(btree->map.keyType, keyAt(btree, node, index));
+
+  if (nodeChildren[index]->numKeys >= btree->minDegree) {
+    moveOutExtreme(btree, nodeChildren[index], true, node, index);
+  } else {
+    moveOutExtreme(btree, nodeChildren[index + 1], false, node, index);
+  }
+}
+
+static bool btreeMapRemove(TloMap *map, const void *key) {
+  assert(btreeMapIsValid(map));
+  assert(key);
+
+  TloBTreeMap *btree = (TloBTreeMap *)map;
+  TloBTreeNode *node = btree->root;
+  bool removed = false;
+
+  // every node below the root is filled before going down into it, so
+  // removing a key or merging two children never leaves one too empty
+  while (node) {
+    size_t index;
+
+    if (findInNode(btree, node, key, &index)) {
+      if (node->isLeaf) {
+        tloTypeDestruct(map->valueType, valueAt(btree, node, index));
+        tloTypeDestruct(map->keyType, keyAt(btree, node, index));
+        moveEntries(btree, node, index, node, index + 1,
+                    node->numKeys - index - 1);
+        --node->numKeys;
+        removed = true;
+        break;
+      }
+
+      TloBTreeNode **nodeChildren = childrenOf(btree, node);
+      if (nodeChildren[index]->numKeys >= btree->minDegree ||
+          nodeChildren[index + 1]->numKeys >= btree->minDegree) {
+        removeFromInternalNode(btree, node, index);
+        removed = true;
+        break;
+      }
+
+      // the key moves down into the merged child, and is removed from there
+      mergeChildren(btree, node, index);
+      node = nodeChildren[index];
+      continue;
+    }
+
+    if (node->isLeaf) {
+      break;
+    }
+
+    index = fillChild(btree, node, index);
+    node = childrenOf(btree, node)[index];
+  }
+
+  // merging the root's last two children leaves it without keys
+  if (btree->root && btree->root->numKeys == 0) {
+    TloBTreeNode *root = btree->root;
+    btree->root = root->isLeaf ? NULL : childrenOf(btree, root)[0];
+    if (btree->root) {
+      btree->root->parent = NULL;
+    }
+    freeNode(btree, root);
+  }
+
+  btree->size -= removed;
+  return removed;
+}
+
+static const TloMapVTable vTable = {.type = "TloBTreeMap",
+                                    .destruct = btreeMapDestruct,
+                                    .size = btreeMapSize,
+                                    .isEmpty = btreeMapIsEmpty,
+                                    .find = btreeMapFind,
+                                    .findMutable = btreeMapFindMutable,
+                                    .insert = btreeMapInsert,
+                                    .remove = btreeMapRemove};
+
+void tloBTreeMapConstruct(TloBTreeMap *btree, const TloType *keyType,
+                          const TloType *valueType,
+                          const TloAllocator *allocator) {
+  assert(btree);
+  assert(typeIsValid(keyType));
+  assert(keyType->compare);
+  assert(typeIsValid(valueType));
+  assert(allocator == NULL || allocatorIsValid(allocator));
+
+  tloMapConstruct(&btree->map, &vTable, keyType, valueType, allocator);
+  btree->root = NULL;
+  btree->size = 0;
+
+  // an internal node with 2 * t - 1 keys has 2 * t children
+  size_t entrySize = keyType->size + valueType->size + sizeof(void *);
+  size_t maxKeys = (NODE_SIZE - KEYS_OFFSET) / entrySize;
+  btree->minDegree = (maxKeys + 1) / 2;
+  if (btree->minDegree < MIN_MIN_DEGREE) {
+    btree->minDegree = MIN_MIN_DEGREE;
+  }
+
+  btree->valuesOffset =
+      roundUpToAlignment(KEYS_OFFSET + maxNumKeys(btree) * keyType->size);
+  btree->childrenOffset = roundUpToAlignment(
+      btree->valuesOffset + maxNumKeys(btree) * valueType->size);
+}
+
+TloBTreeMap *tloBTreeMapMake(const TloType *keyType, const TloType *valueType,
+                             const TloAllocator *allocator) {
+  assert(typeIsValid(keyType));
+  assert(typeIsValid(valueType));
+
+  if (!allocator) {
+    allocator = &tloCStdLibAllocator;
+  }
+
+  assert(allocatorIsValid(allocator));
+
+  TloBTreeMap *btree = tloAllocatorMalloc(allocator, sizeof(*btree));
+  if (!btree) {
+    return NULL;
+  }
+
+  tloBTreeMapConstruct(btree, keyType, valueType, allocator);
+  return btree;
+}
+
+void tloBTreeMapFirst(const TloBTreeMap *btree, TloBTreeCursor *cursor) {
+  assert(btreeMapIsValid(&btree->map));
+  assert(cursor);
+
+  cursor->btree = btree;
+  cursor->node = btree->root;
+  cursor->index = 0;
+
+  if (!cursor->node) {
+    return;
+  }
+
+  while (!cursor->node->isLeaf) {
+    cursor->node = childrenOf(btree, cursor->node)[0];
+  }
+}
+
+/*
+ * - the bound is either under the child the search goes down into, or the
+ *   last key passed on the way down that is past it
+ */
+static void boundCursor(const TloBTreeMap *btree, const void *key,
+                        bool orEqual, TloBTreeCursor *cursor) {
+  cursor->btree = btree;
+  cursor->node = NULL;
+  cursor->index = 0;
+
+  for (TloBTreeNode *node = btree->root; node;) {
+    size_t index = bound(btree, node, key, orEqual);
+    if (index < node->numKeys) {
+      cursor->node = node;
+      cursor->index = index;
+    }
+
+    node = node->isLeaf ? NULL : childrenOf(btree, node)[index];
+  }
+}
+
+void tloBTreeMapLowerBound(const TloBTreeMap *btree, const void *key,
+                           TloBTreeCursor *cursor) {
+  assert(btreeMapIsValid(&btree->map));
+  assert(key);
+  assert(cursor);
+
+  boundCursor(btree, key, false, cursor);
+}
+
+void tloBTreeMapUpperBound(const TloBTreeMap *btree, const void *key,
+                           TloBTreeCursor *cursor) {
+  assert(btreeMapIsValid(&btree->map));
+  assert(key);
+  assert(cursor);
+
+  boundCursor(btree, key, true, cursor);
+}
+
+bool tloBTreeCursorIsEnd(const TloBTreeCursor *cursor) {
+  assert(cursorIsValid(cursor));
+
+  return cursor->node == NULL;
+}
+
+const void *tloBTreeCursorKey(const TloBTreeCursor *cursor) {
+  assert(cursorIsValid(cursor));
+  assert(!tloBTreeCursorIsEnd(cursor));
+
+  return keyAt(cursor->btree, cursor->node, cursor->index);
+}
+
+const void *tloBTreeCursorValue(const TloBTreeCursor *cursor) {
+  assert(cursorIsValid(cursor));
+  assert(!tloBTreeCursorIsEnd(cursor));
+
+  return valueAt(cursor->btree, cursor->node, cursor->index);
+}
+
+void *tloBTreeCursorMutableValue(TloBTreeCursor *cursor) {
+  assert(cursorIsValid(cursor));
+  assert(!tloBTreeCursorIsEnd(cursor));
+
+  return valueAt(cursor->btree, cursor->node, cursor->index);
+}
+
+void tloBTreeCursorNext(TloBTreeCursor *cursor) {
+  assert(cursorIsValid(cursor));
+  assert(!tloBTreeCursorIsEnd(cursor));
+
+  const TloBTreeMap *btree = cursor->btree;
+  TloBTreeNode *node = cursor->node;
+
+  // the next key is the least one in the subtree to the right of this one
+  if (!node->isLeaf) {
+    node = childrenOf(btree, node)[cursor->index + 1];
+    while (!node->isLeaf) {
+      node = childrenOf(btree, node)[0];
+    }
+
+    cursor->node = node;
+    cursor->index = 0;
+    return;
+  }
+
+  if (cursor->index + 1 < node->numKeys) {
+    ++cursor->index;
+    return;
+  }
+
+  // or the key in the first ancestor whose subtree this leaf ends on the left
+  // of
+  while (node->parent) {
+    TloBTreeNode *parent = node->parent;
+    TloBTreeNode **parentChildren = childrenOf(btree, parent);
+    size_t index = 0;
+    while (parentChildren[index] != node) {
+      ++index;
+    }
+
+    if (index < parent->numKeys) {
+      cursor->node = parent;
+      cursor->index = index;
+      return;
+    }
+
+    node = parent;
+  }
+
+  cursor->node = NULL;
+  cursor->index = 0;
+}
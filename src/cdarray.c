@@ -9,19 +9,29 @@ static bool cdarrayIsValid(const TloList *list) {
   const TloCDArray *array = (const TloCDArray *)list;
   return listIsValid(list) &&
          (array->capacity == 0 ? array->front == 0
-                               : array->front < array->capacity) &&
+                               : isPowerOfTwo(array->capacity) &&
+                                     array->front < array->capacity) &&
          (array->size <= array->capacity);
 }
 #endif
 
+/*
+ * - capacity is always a power of 2, so wrapping an index around it is a mask
+ *   instead of a division
+ * - capacity must not be 0
+ */
+static size_t wrap(const TloCDArray *array, size_t index) {
+  return index & (array->capacity - 1);
+}
+
 static const void *constElement(const TloCDArray *array, size_t index) {
-  return array->array + ((array->front + index) % array->capacity) *
-                            array->list.valueType->size;
+  return array->array +
+         wrap(array, array->front + index) * array->list.valueType->size;
 }
 
 static void *mutableElement(TloCDArray *array, size_t index) {
-  return array->array + ((array->front + index) % array->capacity) *
-                            array->list.valueType->size;
+  return array->array +
+         wrap(array, array->front + index) * array->list.valueType->size;
 }
 
 static void destructAllElements(TloCDArray *array) {
@@ -45,7 +55,8 @@ static void cdarrayDestruct(TloList *list) {
 
   destructAllElements(array);
 
-  array->list.allocator->free(array->array);
+  tloAllocatorSizedFree(array->list.allocator, array->array,
+                        array->capacity * array->list.valueType->size);
   array->array = NULL;
 }
 
@@ -99,8 +110,8 @@ enum { STARTING_CAPACITY = 1 };
 
 static TloError allocateArrayIfNeeded(TloCDArray *array) {
   if (!array->array) {
-    array->array = array->list.allocator->malloc(STARTING_CAPACITY *
-                                                 array->list.valueType->size);
+    array->array = tloAllocatorMalloc(
+        array->list.allocator, STARTING_CAPACITY * array->list.valueType->size);
     if (!array->array) {
       return TLO_ERROR;
     }
@@ -120,29 +131,48 @@ static void *mutableElement_(unsigned char *array, size_t index,
   return array + index * valueSize;
 }
 
-static TloError expandArrayIfNeeded(TloCDArray *array) {
-  if (array->size == array->capacity) {
-    size_t newCapacity = array->capacity * 2;
-    size_t valueSize = array->list.valueType->size;
-    unsigned char *newArray =
-        array->list.allocator->malloc(newCapacity * valueSize);
-    if (!newArray) {
-      return TLO_ERROR;
-    }
+/*
+ * - newCapacity must be a power of 2 bigger than the current capacity, which
+ *   must not be 0. so it's at least double the current capacity
+ * - elements are relocated with memcpy anyway, so the allocator is free to
+ *   grow the array in place
+ * - the elements may wrap around at the old capacity. to make them contiguous
+ *   again, moves whichever part is smaller: the left part to just after the old
+ *   capacity, or the right part to the end of the new array
+ */
+static TloError growArray(TloCDArray *array, size_t newCapacity) {
+  size_t capacity = array->capacity;
+  size_t valueSize = array->list.valueType->size;
+  unsigned char *newArray =
+      tloAllocatorRealloc(array->list.allocator, array->array,
+                          capacity * valueSize, newCapacity * valueSize);
+  if (!newArray) {
+    return TLO_ERROR;
+  }
 
-    size_t newFront = newCapacity / 4;
-    size_t oldRightPartSize = array->capacity - array->front;
-    size_t oldLeftPartSize = array->front;
-    memcpy(mutableElement_(newArray, newFront, valueSize),
-           constElement_(array->array, array->front, valueSize),
-           oldRightPartSize * valueSize);
-    memcpy(mutableElement_(newArray, newFront + oldRightPartSize, valueSize),
-           array->array, oldLeftPartSize * valueSize);
+  size_t rightPartSize = capacity - array->front;
+  size_t leftPartSize =
+      array->size > rightPartSize ? array->size - rightPartSize : 0;
 
-    array->list.allocator->free(array->array);
-    array->array = newArray;
+  if (leftPartSize <= rightPartSize) {
+    memcpy(mutableElement_(newArray, capacity, valueSize), newArray,
+           leftPartSize * valueSize);
+  } else {
+    size_t newFront = newCapacity - rightPartSize;
+    memcpy(mutableElement_(newArray, newFront, valueSize),
+           constElement_(newArray, array->front, valueSize),
+           rightPartSize * valueSize);
     array->front = newFront;
-    array->capacity = newCapacity;
+  }
+
+  array->array = newArray;
+  array->capacity = newCapacity;
+  return TLO_SUCCESS;
+}
+
+static TloError expandArrayIfNeeded(TloCDArray *array) {
+  if (array->size == array->capacity) {
+    return growArray(array, array->capacity * 2);
   }
   return TLO_SUCCESS;
 }
@@ -184,7 +214,8 @@ static void pushBackMovedData(TloCDArray *array, void *data) {
   void *destination = mutableElement(array, array->size);
 
   memcpy(destination, data, array->list.valueType->size);
-  array->list.allocator->free(data);
+  tloAllocatorSizedFree(array->list.allocator, data,
+                        array->list.valueType->size);
 
   ++array->size;
 }
@@ -233,10 +264,7 @@ static void *cdarrayMutableElement(TloList *list, size_t index) {
 }
 
 static size_t newFrontAfterPushFront(TloCDArray *array) {
-  if (array->front == 0) {
-    return array->capacity - 1;
-  }
-  return array->front - 1;
+  return wrap(array, array->front - 1);
 }
 
 static TloError pushFrontCopiedData(TloCDArray *array, const void *data) {
@@ -281,7 +309,8 @@ static void pushFrontMovedData(TloCDArray *array, void *data) {
   void *destination = mutableElement_(array->array, newFront, valueSize);
 
   memcpy(destination, data, valueSize);
-  array->list.allocator->free(data);
+  tloAllocatorSizedFree(array->list.allocator, data,
+                        array->list.valueType->size);
 
   array->front = newFront;
   ++array->size;
@@ -312,7 +341,7 @@ static void shrinkArrayIfNeeded(TloCDArray *array) {
     size_t newCapacity = array->capacity / 2;
     size_t valueSize = array->list.valueType->size;
     unsigned char *newArray =
-        array->list.allocator->malloc(newCapacity * valueSize);
+        tloAllocatorMalloc(array->list.allocator, newCapacity * valueSize);
     if (!newArray) {
       return;
     }
@@ -333,7 +362,8 @@ static void shrinkArrayIfNeeded(TloCDArray *array) {
              array->array, oldLeftPartSize * valueSize);
     }
 
-    array->list.allocator->free(array->array);
+    tloAllocatorSizedFree(array->list.allocator, array->array,
+                          array->capacity * valueSize);
     array->array = newArray;
     array->front = newFront;
     array->capacity = newCapacity;
@@ -347,11 +377,7 @@ static void cdarrayPopFront(TloList *list) {
   TloCDArray *array = (TloCDArray *)list;
   void *front = mutableElement(array, 0);
   tloTypeDestruct(array->list.valueType, front);
-  if (array->front == array->capacity - 1) {
-    array->front = 0;
-  } else {
-    ++array->front;
-  }
+  array->front = wrap(array, array->front + 1);
   --array->size;
   shrinkArrayIfNeeded(array);
 }
@@ -386,6 +412,49 @@ static void cdarrayUnorderedRemove(TloList *list, size_t index) {
   shrinkArrayIfNeeded(array);
 }
 
+/*
+ * - sets spans to the elements in the count slots starting at slot, wrapping
+ *   around at capacity
+ * - returns the number of spans that aren't empty
+ */
+static size_t spansOf(const TloCDArray *array, size_t slot, size_t count,
+                      TloCDArrayMutableSpan spans[2]) {
+  spans[0] = (TloCDArrayMutableSpan){.elements = NULL, .size = 0};
+  spans[1] = (TloCDArrayMutableSpan){.elements = NULL, .size = 0};
+  if (!count) {
+    return 0;
+  }
+
+  size_t valueSize = array->list.valueType->size;
+  size_t firstSize = array->capacity - slot;
+  if (count <= firstSize) {
+    spans[0].elements = mutableElement_(array->array, slot, valueSize);
+    spans[0].size = count;
+    return 1;
+  }
+
+  spans[0].elements = mutableElement_(array->array, slot, valueSize);
+  spans[0].size = firstSize;
+  spans[1].elements = array->array;
+  spans[1].size = count - firstSize;
+  return 2;
+}
+
+static void cdarrayForEachMutableRun(TloList *list,
+                                     void (*visit)(void *run, size_t size,
+                                                   void *context),
+                                     void *context) {
+  assert(cdarrayIsValid(list));
+  assert(visit);
+  TloCDArray *array = (TloCDArray *)list;
+
+  TloCDArrayMutableSpan spans[2];
+  size_t numSpans = spansOf(array, array->front, array->size, spans);
+  for (size_t i = 0; i < numSpans; ++i) {
+    visit(spans[i].elements, spans[i].size, context);
+  }
+}
+
 static const TloListVTable vTable = {.type = "TloCDArray",
                                      .destruct = cdarrayDestruct,
                                      .size = cdarraySize,
@@ -403,7 +472,9 @@ static const TloListVTable vTable = {.type = "TloCDArray",
                                      .moveFront = cdarrayMoveFront,
                                      .popFront = cdarrayPopFront,
                                      .popBack = cdarrayPopBack,
-                                     .unorderedRemove = cdarrayUnorderedRemove};
+                                     .unorderedRemove = cdarrayUnorderedRemove,
+                                     .forEachMutableRun =
+                                         cdarrayForEachMutableRun};
 
 TloError tloCDArrayConstruct(TloCDArray *array, const TloType *valueType,
                              const TloAllocator *allocator, size_t capacity) {
@@ -411,9 +482,19 @@ TloError tloCDArrayConstruct(TloCDArray *array, const TloType *valueType,
   assert(typeIsValid(valueType));
   assert(allocator == NULL || allocatorIsValid(allocator));
 
+  if (!allocator) {
+    allocator = &tloCStdLibAllocator;
+  }
+
+  size_t roundedCapacity = roundUpToPowerOfTwo(capacity);
+  if (capacity && !roundedCapacity) {
+    return TLO_ERROR;
+  }
+  capacity = roundedCapacity;
+
   unsigned char *newArray = NULL;
   if (capacity) {
-    newArray = allocator->malloc(capacity * valueType->size);
+    newArray = tloAllocatorMalloc(allocator, capacity * valueType->size);
     if (!newArray) {
       return TLO_ERROR;
     }
@@ -467,14 +548,14 @@ TloCDArray *tloCDArrayMake(const TloType *valueType,
 
   assert(allocatorIsValid(allocator));
 
-  TloCDArray *array = allocator->malloc(sizeof(*array));
+  TloCDArray *array = tloAllocatorMalloc(allocator, sizeof(*array));
   if (!array) {
     return NULL;
   }
 
   if (tloCDArrayConstruct(array, valueType, allocator, capacity) !=
       TLO_SUCCESS) {
-    allocator->free(array);
+    tloAllocatorSizedFree(allocator, array, sizeof(*array));
     return NULL;
   }
 
@@ -484,13 +565,14 @@ TloCDArray *tloCDArrayMake(const TloType *valueType,
 TloCDArray *tloCDArrayMakeCopy(const TloCDArray *other) {
   assert(cdarrayIsValid(&other->list));
 
-  TloCDArray *array = other->list.allocator->malloc(sizeof(*array));
+  TloCDArray *array =
+      tloAllocatorMalloc(other->list.allocator, sizeof(*array));
   if (!array) {
     return NULL;
   }
 
   if (tloCDArrayConstructCopy(array, other) != TLO_SUCCESS) {
-    other->list.allocator->free(array);
+    tloAllocatorSizedFree(other->list.allocator, array, sizeof(*array));
     return NULL;
   }
 
@@ -511,3 +593,82 @@ TloError tloCDArrayCopy(TloCDArray *array, const TloCDArray *other) {
 
   return TLO_SUCCESS;
 }
+
+size_t tloCDArraySpans(const TloCDArray *array, TloCDArraySpan spans[2]) {
+  assert(cdarrayIsValid(&array->list));
+  assert(spans);
+
+  TloCDArrayMutableSpan mutableSpans[2];
+  size_t count = spansOf(array, array->front, array->size, mutableSpans);
+  for (size_t i = 0; i < 2; ++i) {
+    spans[i].elements = mutableSpans[i].elements;
+    spans[i].size = mutableSpans[i].size;
+  }
+  return count;
+}
+
+size_t tloCDArrayMutableSpans(TloCDArray *array,
+                              TloCDArrayMutableSpan spans[2]) {
+  assert(cdarrayIsValid(&array->list));
+  assert(spans);
+
+  return spansOf(array, array->front, array->size, spans);
+}
+
+size_t tloCDArrayFreeSpans(TloCDArray *array, TloCDArrayMutableSpan spans[2]) {
+  assert(cdarrayIsValid(&array->list));
+  assert(spans);
+
+  size_t back = array->capacity ? wrap(array, array->front + array->size) : 0;
+  return spansOf(array, back, array->capacity - array->size, spans);
+}
+
+TloError tloCDArrayReserve(TloCDArray *array, size_t capacity) {
+  assert(cdarrayIsValid(&array->list));
+
+  if (capacity <= array->capacity) {
+    return TLO_SUCCESS;
+  }
+
+  size_t newCapacity = roundUpToPowerOfTwo(capacity);
+  if (!newCapacity) {
+    return TLO_ERROR;
+  }
+
+  if (!array->array) {
+    array->array = tloAllocatorMalloc(
+        array->list.allocator, newCapacity * array->list.valueType->size);
+    if (!array->array) {
+      return TLO_ERROR;
+    }
+    array->front = newCapacity / 4;
+    array->capacity = newCapacity;
+    return TLO_SUCCESS;
+  }
+
+  return growArray(array, newCapacity);
+}
+
+void tloCDArrayConsume(TloCDArray *array, size_t count) {
+  assert(cdarrayIsValid(&array->list));
+  assert(count <= array->size);
+
+  if (!count) {
+    return;
+  }
+
+  for (size_t i = 0; i < count; ++i) {
+    tloTypeDestruct(array->list.valueType, mutableElement(array, i));
+  }
+
+  array->front = wrap(array, array->front + count);
+  array->size -= count;
+  shrinkArrayIfNeeded(array);
+}
+
+void tloCDArrayProduce(TloCDArray *array, size_t count) {
+  assert(cdarrayIsValid(&array->list));
+  assert(count <= array->capacity - array->size);
+
+  array->size += count;
+}
@@ -40,7 +40,8 @@ static void darrayDestruct(TloList *list) {
 
   destructAllElements(array);
 
-  array->list.allocator->free(array->array);
+  tloAllocatorSizedFree(array->list.allocator, array->array,
+                        array->capacity * array->list.valueType->size);
   array->array = NULL;
 }
 
@@ -94,8 +95,8 @@ enum { STARTING_CAPACITY = 1 };
 
 static TloError allocateArrayIfNeeded(TloDArray *array) {
   if (!array->array) {
-    array->array = array->list.allocator->malloc(STARTING_CAPACITY *
-                                                 array->list.valueType->size);
+    array->array = tloAllocatorMalloc(
+        array->list.allocator, STARTING_CAPACITY * array->list.valueType->size);
     if (!array->array) {
       return TLO_ERROR;
     }
@@ -104,20 +105,25 @@ static TloError allocateArrayIfNeeded(TloDArray *array) {
   return TLO_SUCCESS;
 }
 
-static TloError expandArrayIfNeeded(TloDArray *array) {
-  if (array->size == array->capacity) {
-    size_t newCapacity = array->capacity * 2;
-    unsigned char *newArray = array->list.allocator->malloc(
-        newCapacity * array->list.valueType->size);
-    if (!newArray) {
-      return TLO_ERROR;
-    }
+// elements are relocated with memcpy anyway, so the allocator is free to grow
+// or shrink the array in place
+static TloError resizeArray(TloDArray *array, size_t newCapacity) {
+  unsigned char *newArray = tloAllocatorRealloc(
+      array->list.allocator, array->array,
+      array->capacity * array->list.valueType->size,
+      newCapacity * array->list.valueType->size);
+  if (!newArray) {
+    return TLO_ERROR;
+  }
 
-    memcpy(newArray, array->array, array->size * array->list.valueType->size);
+  array->array = newArray;
+  array->capacity = newCapacity;
+  return TLO_SUCCESS;
+}
 
-    array->list.allocator->free(array->array);
-    array->array = newArray;
-    array->capacity = newCapacity;
+static TloError expandArrayIfNeeded(TloDArray *array) {
+  if (array->size == array->capacity) {
+    return resizeArray(array, array->capacity * 2);
   }
   return TLO_SUCCESS;
 }
@@ -159,7 +165,8 @@ static void pushBackMovedData(TloDArray *array, void *data) {
   void *destination = mutableElement(array, array->size);
 
   memcpy(destination, data, array->list.valueType->size);
-  array->list.allocator->free(data);
+  tloAllocatorSizedFree(array->list.allocator, data,
+                        array->list.valueType->size);
 
   ++array->size;
 }
@@ -211,18 +218,7 @@ static void *darrayMutableElement(TloList *list, size_t index) {
 // error
 static void shrinkArrayIfNeeded(TloDArray *array) {
   if (array->size <= array->capacity / 4 && array->size) {
-    size_t newCapacity = array->capacity / 2;
-    unsigned char *newArray = array->list.allocator->malloc(
-        newCapacity * array->list.valueType->size);
-    if (!newArray) {
-      return;
-    }
-
-    memcpy(newArray, array->array, array->size * array->list.valueType->size);
-
-    array->list.allocator->free(array->array);
-    array->array = newArray;
-    array->capacity = newCapacity;
+    resizeArray(array, array->capacity / 2);
   }
 }
 
@@ -256,6 +252,19 @@ static void darrayUnorderedRemove(TloList *list, size_t index) {
   shrinkArrayIfNeeded(array);
 }
 
+static void darrayForEachMutableRun(TloList *list,
+                                    void (*visit)(void *run, size_t size,
+                                                  void *context),
+                                    void *context) {
+  assert(darrayIsValid(list));
+  assert(visit);
+  TloDArray *array = (TloDArray *)list;
+
+  if (array->size) {
+    visit(mutableElement(array, 0), array->size, context);
+  }
+}
+
 static const TloListVTable vTable = {.type = "TloDArray",
                                      .destruct = darrayDestruct,
                                      .size = darraySize,
@@ -270,7 +279,9 @@ static const TloListVTable vTable = {.type = "TloDArray",
                                      .element = darrayElement,
                                      .mutableElement = darrayMutableElement,
                                      .popBack = darrayPopBack,
-                                     .unorderedRemove = darrayUnorderedRemove};
+                                     .unorderedRemove = darrayUnorderedRemove,
+                                     .forEachMutableRun =
+                                         darrayForEachMutableRun};
 
 TloError tloDArrayConstruct(TloDArray *array, const TloType *valueType,
                             const TloAllocator *allocator, size_t capacity) {
@@ -278,9 +289,13 @@ TloError tloDArrayConstruct(TloDArray *array, const TloType *valueType,
   assert(typeIsValid(valueType));
   assert(allocator == NULL || allocatorIsValid(allocator));
 
+  if (!allocator) {
+    allocator = &tloCStdLibAllocator;
+  }
+
   unsigned char *newArray = NULL;
   if (capacity) {
-    newArray = allocator->malloc(capacity * valueType->size);
+    newArray = tloAllocatorMalloc(allocator, capacity * valueType->size);
     if (!newArray) {
       return TLO_ERROR;
     }
@@ -333,14 +348,14 @@ TloDArray *tloDArrayMake(const TloType *valueType,
 
   assert(allocatorIsValid(allocator));
 
-  TloDArray *array = allocator->malloc(sizeof(*array));
+  TloDArray *array = tloAllocatorMalloc(allocator, sizeof(*array));
   if (!array) {
     return NULL;
   }
 
   if (tloDArrayConstruct(array, valueType, allocator, capacity) !=
       TLO_SUCCESS) {
-    allocator->free(array);
+    tloAllocatorSizedFree(allocator, array, sizeof(*array));
     return NULL;
   }
 
@@ -350,13 +365,14 @@ TloDArray *tloDArrayMake(const TloType *valueType,
 TloDArray *tloDArrayMakeCopy(const TloDArray *other) {
   assert(darrayIsValid(&other->list));
 
-  TloDArray *array = other->list.allocator->malloc(sizeof(*array));
+  TloDArray *array =
+      tloAllocatorMalloc(other->list.allocator, sizeof(*array));
   if (!array) {
     return NULL;
   }
 
   if (tloDArrayConstructCopy(array, other) != TLO_SUCCESS) {
-    other->list.allocator->free(array);
+    tloAllocatorSizedFree(other->list.allocator, array, sizeof(*array));
     return NULL;
   }
 
@@ -16,10 +16,14 @@ static bool dllistIsValid(const TloList *list) {
 }
 #endif
 
+// the element is stored inline, right after the node's links
+static size_t nodeSize(const TloDLList *llist) {
+  return sizeof(TloDLLNode) + llist->list.valueType->size;
+}
+
 static void deleteNode(TloDLList *llist, TloDLLNode *node) {
   tloTypeDestruct(llist->list.valueType, node->data);
-  llist->list.allocator->free(node->data);
-  llist->list.allocator->free(node);
+  tloAllocatorSizedFree(llist->list.allocator, node, nodeSize(llist));
 }
 
 static void deleteAllNodes(TloDLList *llist) {
@@ -97,21 +101,14 @@ static void *dllistMutableBack(TloList *list) {
 }
 
 static TloDLLNode *makeNodeWithCopiedData(TloDLList *llist, const void *data) {
-  TloDLLNode *node = llist->list.allocator->malloc(sizeof(*node));
+  TloDLLNode *node = tloAllocatorMalloc(llist->list.allocator, nodeSize(llist));
   if (!node) {
     return NULL;
   }
 
-  node->data = llist->list.allocator->malloc(llist->list.valueType->size);
-  if (!node->data) {
-    llist->list.allocator->free(node);
-    return NULL;
-  }
-
   if (tloTypeConstructCopy(llist->list.valueType, node->data, data) !=
       TLO_SUCCESS) {
-    llist->list.allocator->free(node->data);
-    llist->list.allocator->free(node);
+    tloAllocatorSizedFree(llist->list.allocator, node, nodeSize(llist));
     return NULL;
   }
 
@@ -149,12 +146,15 @@ static TloError dllistPushBack(TloList *list, const void *data) {
 }
 
 static TloDLLNode *makeNodeWithMovedData(TloDLList *llist, void *data) {
-  TloDLLNode *node = llist->list.allocator->malloc(sizeof(*node));
+  TloDLLNode *node = tloAllocatorMalloc(llist->list.allocator, nodeSize(llist));
   if (!node) {
     return NULL;
   }
 
-  node->data = data;
+  memcpy(node->data, data, llist->list.valueType->size);
+  tloAllocatorSizedFree(llist->list.allocator, data,
+                        llist->list.valueType->size);
+
   node->next = NULL;
   node->prev = NULL;
   return node;
@@ -315,7 +315,7 @@ TloDLList *tloDLListMake(const TloType *valueType,
 
   assert(allocatorIsValid(allocator));
 
-  TloDLList *llist = allocator->malloc(sizeof(*llist));
+  TloDLList *llist = tloAllocatorMalloc(allocator, sizeof(*llist));
   if (!llist) {
     return NULL;
   }
@@ -328,13 +328,14 @@ TloDLList *tloDLListMake(const TloType *valueType,
 TloDLList *tloDLListMakeCopy(const TloDLList *other) {
   assert(dllistIsValid(&other->list));
 
-  TloDLList *llist = other->list.allocator->malloc(sizeof(*llist));
+  TloDLList *llist =
+      tloAllocatorMalloc(other->list.allocator, sizeof(*llist));
   if (!llist) {
     return NULL;
   }
 
   if (tloDLListConstructCopy(llist, other) != TLO_SUCCESS) {
-    other->list.allocator->free(llist);
+    tloAllocatorSizedFree(other->list.allocator, llist, sizeof(*llist));
     return NULL;
   }
 
@@ -382,7 +383,7 @@ TloDLLNode *tloDLListMutableTail(TloDLList *llist) {
 
 #ifndef NDEBUG
 static bool dllnodeIsValid(const TloDLLNode *node) {
-  return node && node->data;
+  return node != NULL;
 }
 #endif
 
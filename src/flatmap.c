@@ -0,0 +1,737 @@
+#include "tlo/flatmap.h"
+#include <assert.h>
+#include <string.h>
+#include "list.h"
+#include "map.h"
+#include "set.h"
+#include "util.h"
+
+#ifndef NDEBUG
+static bool keysAreValid(const TloDArray *keys, const TloType *keyType) {
+  return listIsValid(&keys->list) && keys->list.valueType == keyType &&
+         keyType->compare;
+}
+
+static bool flatSetIsValid(const TloSet *set) {
+  const TloFlatSet *flatSet = (const TloFlatSet *)set;
+  return setIsValid(set) && keysAreValid(&flatSet->keys, set->keyType);
+}
+
+static bool flatMapIsValid(const TloMap *map) {
+  const TloFlatMap *flatMap = (const TloFlatMap *)map;
+  return mapIsValid(map) && keysAreValid(&flatMap->keys, map->keyType) &&
+         listIsValid(&flatMap->values.list) &&
+         flatMap->values.list.valueType == map->valueType &&
+         tlovListSize(&flatMap->keys.list) ==
+             tlovListSize(&flatMap->values.list);
+}
+#endif
+
+/*
+ * - returns the index of the first key that compares greater than key, or
+ *   greater than or equal to it if orEqual is false
+ * - halves the range every step whatever the comparison says, so every search
+ *   takes the same number of steps and picking the half is a conditional move
+ *   instead of a branch the CPU could mispredict
+ */
+static size_t bound(const TloDArray *keys, const void *key, bool orEqual) {
+  size_t size = tlovListSize(&keys->list);
+  if (!size) {
+    return 0;
+  }
+
+  const TloType *keyType = keys->list.valueType;
+  const unsigned char *first = tlovListElement(&keys->list, 0);
+  int (*compare)(const void *, const void *) = keyType->compare;
+  size_t keySize = keyType->size;
+  // keys that compare less than this come before the bound
+  int limit = orEqual ? 1 : 0;
+  size_t base = 0;
+
+  while (size > 1) {
+    size_t half = size / 2;
+    bool isBefore = compare(first + (base + half) * keySize, key) < limit;
+    base += isBefore ? half : 0;
+    size -= half;
+  }
+
+  return base + (compare(first + base * keySize, key) < limit);
+}
+
+// sets index to where key is, or would be inserted if it isn't there
+static bool find(const TloDArray *keys, const void *key, size_t *index) {
+  *index = bound(keys, key, false);
+  if (*index == tlovListSize(&keys->list)) {
+    return false;
+  }
+
+  const void *found = tlovListElement(&keys->list, *index);
+  return keys->list.valueType->compare(found, key) == 0;
+}
+
+enum { ROTATION_CHUNK_SIZE = 64 };
+
+// moves the last shift of the length bytes to the front
+static void rotateRight(unsigned char *bytes, size_t length, size_t shift) {
+  unsigned char chunk[ROTATION_CHUNK_SIZE];
+
+  while (shift) {
+    size_t chunkSize =
+        shift < ROTATION_CHUNK_SIZE ? shift : ROTATION_CHUNK_SIZE;
+    memcpy(chunk, bytes + length - chunkSize, chunkSize);
+    memmove(bytes + chunkSize, bytes, length - chunkSize);
+    memcpy(bytes, chunk, chunkSize);
+    shift -= chunkSize;
+  }
+}
+
+// moves the first shift of the length bytes to the back
+static void rotateLeft(unsigned char *bytes, size_t length, size_t shift) {
+  unsigned char chunk[ROTATION_CHUNK_SIZE];
+
+  while (shift) {
+    size_t chunkSize =
+        shift < ROTATION_CHUNK_SIZE ? shift : ROTATION_CHUNK_SIZE;
+    memcpy(chunk, bytes, chunkSize);
+    memmove(bytes, bytes + chunkSize, length - chunkSize);
+    memcpy(bytes + length - chunkSize, chunk, chunkSize);
+    shift -= chunkSize;
+  }
+}
+
+/*
+ * - elements are inserted by pushing them onto the back and rotating them
+ *   down to their index, and removed by rotating them to the back and popping
+ *   them, so the TloDArray constructs and destructs them and no object is
+ *   ever in two places
+ */
+static void moveBackTo(TloDArray *array, size_t index) {
+  size_t size = tlovListSize(&array->list);
+  size_t elementSize = array->list.valueType->size;
+  unsigned char *element = tlovListMutableElement(&array->list, index);
+  rotateRight(element, (size - index) * elementSize, elementSize);
+}
+
+static void moveToBack(TloDArray *array, size_t index) {
+  size_t size = tlovListSize(&array->list);
+  size_t elementSize = array->list.valueType->size;
+  unsigned char *element = tlovListMutableElement(&array->list, index);
+  rotateLeft(element, (size - index) * elementSize, elementSize);
+}
+
+static void flatSetDestruct(TloSet *set) {
+  if (!set) {
+    return;
+  }
+
+  assert(flatSetIsValid(set));
+
+  TloFlatSet *flatSet = (TloFlatSet *)set;
+  tlovListDestruct(&flatSet->keys.list);
+}
+
+static void flatMapDestruct(TloMap *map) {
+  if (!map) {
+    return;
+  }
+
+  assert(flatMapIsValid(map));
+
+  TloFlatMap *flatMap = (TloFlatMap *)map;
+  tlovListDestruct(&flatMap->values.list);
+  tlovListDestruct(&flatMap->keys.list);
+}
+
+static size_t flatSetSize(const TloSet *set) {
+  assert(flatSetIsValid(set));
+
+  const TloFlatSet *flatSet = (const TloFlatSet *)set;
+  return tlovListSize(&flatSet->keys.list);
+}
+
+static size_t flatMapSize(const TloMap *map) {
+  assert(flatMapIsValid(map));
+
+  const TloFlatMap *flatMap = (const TloFlatMap *)map;
+  return tlovListSize(&flatMap->keys.list);
+}
+
+static bool flatSetIsEmpty(const TloSet *set) {
+  assert(flatSetIsValid(set));
+
+  const TloFlatSet *flatSet = (const TloFlatSet *)set;
+  return tlovListIsEmpty(&flatSet->keys.list);
+}
+
+static bool flatMapIsEmpty(const TloMap *map) {
+  assert(flatMapIsValid(map));
+
+  const TloFlatMap *flatMap = (const TloFlatMap *)map;
+  return tlovListIsEmpty(&flatMap->keys.list);
+}
+
+static const void *flatSetFind(const TloSet *set, const void *key) {
+  assert(flatSetIsValid(set));
+  assert(key);
+
+  const TloFlatSet *flatSet = (const TloFlatSet *)set;
+  size_t index;
+  if (!find(&flatSet->keys, key, &index)) {
+    return NULL;
+  }
+
+  return tlovListElement(&flatSet->keys.list, index);
+}
+
+static const void *flatMapFind(const TloMap *map, const void *key) {
+  assert(flatMapIsValid(map));
+  assert(key);
+
+  const TloFlatMap *flatMap = (const TloFlatMap *)map;
+  size_t index;
+  if (!find(&flatMap->keys, key, &index)) {
+    return NULL;
+  }
+
+  return tlovListElement(&flatMap->values.list, index);
+}
+
+static void *flatMapFindMutable(TloMap *map, const void *key) {
+  assert(flatMapIsValid(map));
+  assert(key);
+
+  TloFlatMap *flatMap = (TloFlatMap *)map;
+  size_t index;
+  if (!find(&flatMap->keys, key, &index)) {
+    return NULL;
+  }
+
+  return tlovListMutableElement(&flatMap->values.list, index);
+}
+
+static TloError pushBack(TloDArray *array, TloInsertMethod insertMethod,
+                         void *data) {
+  if (insertMethod == TLO_COPY) {
+    return tlovListPushBack(&array->list, data);
+  }
+
+  if (insertMethod == TLO_MOVE) {
+    return tlovListMoveBack(&array->list, data);
+  }
+
+  return TLO_ERROR;
+}
+
+static TloError flatSetInsert(TloSet *set, const void *key) {
+  assert(flatSetIsValid(set));
+  assert(key);
+
+  TloFlatSet *flatSet = (TloFlatSet *)set;
+  size_t index;
+  if (find(&flatSet->keys, key, &index)) {
+    return TLO_DUPLICATE;
+  }
+
+  if (tlovListPushBack(&flatSet->keys.list, key) != TLO_SUCCESS) {
+    return TLO_ERROR;
+  }
+
+  moveBackTo(&flatSet->keys, index);
+  return TLO_SUCCESS;
+}
+
+static TloError flatSetMoveInsert(TloSet *set, void *key) {
+  assert(flatSetIsValid(set));
+  assert(key);
+
+  TloFlatSet *flatSet = (TloFlatSet *)set;
+  size_t index;
+  if (find(&flatSet->keys, key, &index)) {
+    return TLO_DUPLICATE;
+  }
+
+  if (tlovListMoveBack(&flatSet->keys.list, key) != TLO_SUCCESS) {
+    return TLO_ERROR;
+  }
+
+  moveBackTo(&flatSet->keys, index);
+  return TLO_SUCCESS;
+}
+
+static TloError flatMapInsert(TloMap *map, TloInsertMethod keyInsertMethod,
+                              void *key, TloInsertMethod valueInsertMethod,
+                              void *value) {
+  assert(flatMapIsValid(map));
+  assert(key);
+  assert(value);
+
+  TloFlatMap *flatMap = (TloFlatMap *)map;
+  size_t index;
+  if (find(&flatMap->keys, key, &index)) {
+    return TLO_DUPLICATE;
+  }
+
+  if (pushBack(&flatMap->keys, keyInsertMethod, key) != TLO_SUCCESS) {
+    return TLO_ERROR;
+  }
+
+  if (pushBack(&flatMap->values, valueInsertMethod, value) != TLO_SUCCESS) {
+    tlovListPopBack(&flatMap->keys.list);
+    return TLO_ERROR;
+  }
+
+  moveBackTo(&flatMap->keys, index);
+  moveBackTo(&flatMap->values, index);
+  return TLO_SUCCESS;
+}
+
+static bool flatSetRemove(TloSet *set, const void *key) {
+  assert(flatSetIsValid(set));
+  assert(key);
+
+  TloFlatSet *flatSet = (TloFlatSet *)set;
+  size_t index;
+  if (!find(&flatSet->keys, key, &index)) {
+    return false;
+  }
+
+  moveToBack(&flatSet->keys, index);
+  tlovListPopBack(&flatSet->keys.list);
+  return true;
+}
+
+static bool flatMapRemove(TloMap *map, const void *key) {
+  assert(flatMapIsValid(map));
+  assert(key);
+
+  TloFlatMap *flatMap = (TloFlatMap *)map;
+  size_t index;
+  if (!find(&flatMap->keys, key, &index)) {
+    return false;
+  }
+
+  moveToBack(&flatMap->keys, index);
+  tlovListPopBack(&flatMap->keys.list);
+  moveToBack(&flatMap->values, index);
+  tlovListPopBack(&flatMap->values.list);
+  return true;
+}
+
+static const TloSetVTable setVTable = {.type = "TloFlatSet",
+                                       .destruct = flatSetDestruct,
+                                       .size = flatSetSize,
+                                       .isEmpty = flatSetIsEmpty,
+                                       .find = flatSetFind,
+                                       .insert = flatSetInsert,
+                                       .moveInsert = flatSetMoveInsert,
+                                       .remove = flatSetRemove};
+
+static const TloMapVTable mapVTable = {.type = "TloFlatMap",
+                                       .destruct = flatMapDestruct,
+                                       .size = flatMapSize,
+                                       .isEmpty = flatMapIsEmpty,
+                                       .find = flatMapFind,
+                                       .findMutable = flatMapFindMutable,
+                                       .insert = flatMapInsert,
+                                       .remove = flatMapRemove};
+
+void tloFlatSetConstruct(TloFlatSet *set, const TloType *keyType,
+                         const TloAllocator *allocator) {
+  assert(set);
+  assert(typeIsValid(keyType));
+  assert(keyType->compare);
+  assert(allocator == NULL || allocatorIsValid(allocator));
+
+  tloSetConstruct(&set->set, &setVTable, keyType, allocator);
+
+  // can't fail without a capacity to allocate
+  TloError error = tloDArrayConstruct(&set->keys, keyType, allocator, 0);
+  assert(error == TLO_SUCCESS);
+  (void)error;
+}
+
+void tloFlatMapConstruct(TloFlatMap *map, const TloType *keyType,
+                         const TloType *valueType,
+                         const TloAllocator *allocator) {
+  assert(map);
+  assert(typeIsValid(keyType));
+  assert(keyType->compare);
+  assert(typeIsValid(valueType));
+  assert(allocator == NULL || allocatorIsValid(allocator));
+
+  tloMapConstruct(&map->map, &mapVTable, keyType, valueType, allocator);
+
+  // can't fail without a capacity to allocate
+  TloError error = tloDArrayConstruct(&map->keys, keyType, allocator, 0);
+  assert(error == TLO_SUCCESS);
+  error = tloDArrayConstruct(&map->values, valueType, allocator, 0);
+  assert(error == TLO_SUCCESS);
+  (void)error;
+}
+
+enum { INSERTION_SORT_RUN_SIZE = 16 };
+
+static int compareKeysAt(const unsigned char *keys, const TloType *keyType,
+                         size_t index1, size_t index2) {
+  return keyType->compare(keys + index1 * keyType->size,
+                          keys + index2 * keyType->size);
+}
+
+static void insertionSortIndices(size_t *indices, size_t count,
+                                 const unsigned char *keys,
+                                 const TloType *keyType) {
+  for (size_t i = 1; i < count; ++i) {
+    size_t index = indices[i];
+    size_t j = i;
+
+    for (; j > 0 && compareKeysAt(keys, keyType, index, indices[j - 1]) < 0;
+         --j) {
+      indices[j] = indices[j - 1];
+    }
+
+    indices[j] = index;
+  }
+}
+
+// takes from left when keys are equal, which keeps the sort stable
+static void mergeIndices(const size_t *left, size_t leftCount,
+                         const size_t *right, size_t rightCount,
+                         size_t *destination, const unsigned char *keys,
+                         const TloType *keyType) {
+  while (leftCount && rightCount) {
+    if (compareKeysAt(keys, keyType, *right, *left) < 0) {
+      *destination++ = *right++;
+      --rightCount;
+    } else {
+      *destination++ = *left++;
+      --leftCount;
+    }
+  }
+
+  memcpy(destination, left, leftCount * sizeof(*left));
+  memcpy(destination + leftCount, right, rightCount * sizeof(*right));
+}
+
+/*
+ * - stably sorts indices by the keys they index, with insertion sorted runs
+ *   merged bottom up, back and forth between indices and buffer
+ * - tloSort can't be used, since it isn't stable, and the compare function it
+ *   takes couldn't get at the keys from an index anyway
+ * - returns whichever of indices and buffer ended up sorted
+ */
+static size_t *sortIndices(size_t *indices, size_t *buffer, size_t count,
+                           const unsigned char *keys,
+                           const TloType *keyType) {
+  for (size_t begin = 0; begin < count; begin += INSERTION_SORT_RUN_SIZE) {
+    size_t runSize = count - begin < INSERTION_SORT_RUN_SIZE
+                         ? count - begin
+                         : INSERTION_SORT_RUN_SIZE;
+    insertionSortIndices(indices + begin, runSize, keys, keyType);
+  }
+
+  for (size_t width = INSERTION_SORT_RUN_SIZE; width < count; width *= 2) {
+    for (size_t begin = 0; begin < count; begin += 2 * width) {
+      size_t middle = count - begin < width ? count : begin + width;
+      size_t end = count - middle < width ? count : middle + width;
+      mergeIndices(indices + begin, middle - begin, indices + middle,
+                   end - middle, buffer + begin, keys, keyType);
+    }
+
+    size_t *sorted = buffer;
+    buffer = indices;
+    indices = sorted;
+  }
+
+  return indices;
+}
+
+static bool isStrictlyAscending(const unsigned char *keys, size_t count,
+                                const TloType *keyType) {
+  for (size_t i = 1; i < count; ++i) {
+    if (compareKeysAt(keys, keyType, i - 1, i) >= 0) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+static TloError pushBackEntry(TloDArray *keys, TloDArray *values,
+                              const unsigned char *keyArray,
+                              const unsigned char *valueArray, size_t index) {
+  if (tlovListPushBack(&keys->list,
+                       keyArray + index * keys->list.valueType->size) !=
+      TLO_SUCCESS) {
+    return TLO_ERROR;
+  }
+
+  if (values &&
+      tlovListPushBack(&values->list,
+                       valueArray + index * values->list.valueType->size) !=
+          TLO_SUCCESS) {
+    tlovListPopBack(&keys->list);
+    return TLO_ERROR;
+  }
+
+  return TLO_SUCCESS;
+}
+
+/*
+ * - keys and values, which is NULL for sets, must be empty, with a capacity of
+ *   count, so pushing onto them doesn't reallocate
+ * - input that's already sorted without repeats, like a dump of another
+ *   sorted map, is copied over as is
+ */
+static TloError pushBackSortedUnique(TloDArray *keys, TloDArray *values,
+                                     const unsigned char *keyArray,
+                                     const unsigned char *valueArray,
+                                     size_t count) {
+  const TloType *keyType = keys->list.valueType;
+
+  if (isStrictlyAscending(keyArray, count, keyType)) {
+    for (size_t i = 0; i < count; ++i) {
+      if (pushBackEntry(keys, values, keyArray, valueArray, i) !=
+          TLO_SUCCESS) {
+        return TLO_ERROR;
+      }
+    }
+
+    return TLO_SUCCESS;
+  }
+
+  const TloAllocator *allocator = keys->list.allocator;
+  size_t *indices = tloAllocatorMalloc(allocator, 2 * count * sizeof(size_t));
+  if (!indices) {
+    return TLO_ERROR;
+  }
+
+  for (size_t i = 0; i < count; ++i) {
+    indices[i] = i;
+  }
+
+  const size_t *sorted =
+      sortIndices(indices, indices + count, count, keyArray, keyType);
+
+  TloError error = TLO_SUCCESS;
+  for (size_t i = 0; i < count; ++i) {
+    if (i && compareKeysAt(keyArray, keyType, sorted[i - 1], sorted[i]) == 0) {
+      continue;
+    }
+
+    error = pushBackEntry(keys, values, keyArray, valueArray, sorted[i]);
+    if (error != TLO_SUCCESS) {
+      break;
+    }
+  }
+
+  tloAllocatorSizedFree(allocator, indices, 2 * count * sizeof(size_t));
+  return error;
+}
+
+TloError tloFlatSetConstructFromArray(TloFlatSet *set, const TloType *keyType,
+                                      const TloAllocator *allocator,
+                                      const void *keys, size_t count) {
+  assert(set);
+  assert(typeIsValid(keyType));
+  assert(keyType->compare);
+  assert(allocator == NULL || allocatorIsValid(allocator));
+  assert(keys || !count);
+
+  if (tloDArrayConstruct(&set->keys, keyType, allocator, count) !=
+      TLO_SUCCESS) {
+    return TLO_ERROR;
+  }
+
+  tloSetConstruct(&set->set, &setVTable, keyType, allocator);
+
+  if (pushBackSortedUnique(&set->keys, NULL, keys, NULL, count) !=
+      TLO_SUCCESS) {
+    tlovListDestruct(&set->keys.list);
+    return TLO_ERROR;
+  }
+
+  return TLO_SUCCESS;
+}
+
+TloError tloFlatMapConstructFromArrays(TloFlatMap *map, const TloType *keyType,
+                                       const TloType *valueType,
+                                       const TloAllocator *allocator,
+                                       const void *keys, const void *values,
+                                       size_t count) {
+  assert(map);
+  assert(typeIsValid(keyType));
+  assert(keyType->compare);
+  assert(typeIsValid(valueType));
+  assert(allocator == NULL || allocatorIsValid(allocator));
+  assert((keys && values) || !count);
+
+  if (tloDArrayConstruct(&map->keys, keyType, allocator, count) !=
+      TLO_SUCCESS) {
+    goto error0;
+  }
+
+  if (tloDArrayConstruct(&map->values, valueType, allocator, count) !=
+      TLO_SUCCESS) {
+    goto error1;
+  }
+
+  tloMapConstruct(&map->map, &mapVTable, keyType, valueType, allocator);
+
+  if (pushBackSortedUnique(&map->keys, &map->values, keys, values, count) !=
+      TLO_SUCCESS) {
+    goto error2;
+  }
+
+  return TLO_SUCCESS;
+
+error2:
+  tlovListDestruct(&map->values.list);
+error1:
+  tlovListDestruct(&map->keys.list);
+error0:
+  return TLO_ERROR;
+}
+
+TloFlatSet *tloFlatSetMake(const TloType *keyType,
+                           const TloAllocator *allocator) {
+  assert(typeIsValid(keyType));
+
+  if (!allocator) {
+    allocator = &tloCStdLibAllocator;
+  }
+
+  assert(allocatorIsValid(allocator));
+
+  TloFlatSet *set = tloAllocatorMalloc(allocator, sizeof(*set));
+  if (!set) {
+    return NULL;
+  }
+
+  tloFlatSetConstruct(set, keyType, allocator);
+  return set;
+}
+
+TloFlatMap *tloFlatMapMake(const TloType *keyType, const TloType *valueType,
+                           const TloAllocator *allocator) {
+  assert(typeIsValid(keyType));
+  assert(typeIsValid(valueType));
+
+  if (!allocator) {
+    allocator = &tloCStdLibAllocator;
+  }
+
+  assert(allocatorIsValid(allocator));
+
+  TloFlatMap *map = tloAllocatorMalloc(allocator, sizeof(*map));
+  if (!map) {
+    return NULL;
+  }
+
+  tloFlatMapConstruct(map, keyType, valueType, allocator);
+  return map;
+}
+
+TloFlatSet *tloFlatSetMakeFromArray(const TloType *keyType,
+                                    const TloAllocator *allocator,
+                                    const void *keys, size_t count) {
+  assert(typeIsValid(keyType));
+
+  if (!allocator) {
+    allocator = &tloCStdLibAllocator;
+  }
+
+  assert(allocatorIsValid(allocator));
+
+  TloFlatSet *set = tloAllocatorMalloc(allocator, sizeof(*set));
+  if (!set) {
+    return NULL;
+  }
+
+  if (tloFlatSetConstructFromArray(set, keyType, allocator, keys, count) !=
+      TLO_SUCCESS) {
+    tloAllocatorSizedFree(allocator, set, sizeof(*set));
+    return NULL;
+  }
+
+  return set;
+}
+
+TloFlatMap *tloFlatMapMakeFromArrays(const TloType *keyType,
+                                     const TloType *valueType,
+                                     const TloAllocator *allocator,
+                                     const void *keys, const void *values,
+                                     size_t count) {
+  assert(typeIsValid(keyType));
+  assert(typeIsValid(valueType));
+
+  if (!allocator) {
+    allocator = &tloCStdLibAllocator;
+  }
+
+  assert(allocatorIsValid(allocator));
+
+  TloFlatMap *map = tloAllocatorMalloc(allocator, sizeof(*map));
+  if (!map) {
+    return NULL;
+  }
+
+  if (tloFlatMapConstructFromArrays(map, keyType, valueType, allocator, keys,
+                                    values, count) != TLO_SUCCESS) {
+    tloAllocatorSizedFree(allocator, map, sizeof(*map));
+    return NULL;
+  }
+
+  return map;
+}
+
+const void *tloFlatSetKey(const TloFlatSet *set, size_t index) {
+  assert(flatSetIsValid(&set->set));
+
+  return tlovListElement(&set->keys.list, index);
+}
+
+const void *tloFlatMapKey(const TloFlatMap *map, size_t index) {
+  assert(flatMapIsValid(&map->map));
+
+  return tlovListElement(&map->keys.list, index);
+}
+
+const void *tloFlatMapValue(const TloFlatMap *map, size_t index) {
+  assert(flatMapIsValid(&map->map));
+
+  return tlovListElement(&map->values.list, index);
+}
+
+void *tloFlatMapMutableValue(TloFlatMap *map, size_t index) {
+  assert(flatMapIsValid(&map->map));
+
+  return tlovListMutableElement(&map->values.list, index);
+}
+
+size_t tloFlatSetLowerBound(const TloFlatSet *set, const void *key) {
+  assert(flatSetIsValid(&set->set));
+  assert(key);
+
+  return bound(&set->keys, key, false);
+}
+
+size_t tloFlatMapLowerBound(const TloFlatMap *map, const void *key) {
+  assert(flatMapIsValid(&map->map));
+  assert(key);
+
+  return bound(&map->keys, key, false);
+}
+
+size_t tloFlatSetUpperBound(const TloFlatSet *set, const void *key) {
+  assert(flatSetIsValid(&set->set));
+  assert(key);
+
+  return bound(&set->keys, key, true);
+}
+
+size_t tloFlatMapUpperBound(const TloFlatMap *map, const void *key) {
+  assert(flatMapIsValid(&map->map));
+  assert(key);
+
+  return bound(&map->keys, key, true);
+}
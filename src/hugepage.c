@@ -0,0 +1,363 @@
+// for MAP_ANONYMOUS, madvise, and mremap, which aren't part of C or POSIX
+#define _GNU_SOURCE
+#include "tlo/hugepage.h"
+#include <assert.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include "util.h"
+
+#ifdef __linux__
+#include <sys/mman.h>
+#endif
+
+/*
+ * - every big allocation has one of these, allocated from the small
+ *   allocator, so the mapping holds nothing but the memory handed out and a
+ *   request for a multiple of TLO_HUGE_PAGE_SIZE maps exactly that much
+ * - data is the start of the mapping, and length is its length, which is the
+ *   size asked for rounded up to a multiple of TLO_HUGE_PAGE_SIZE
+ */
+struct TloHugePageMapping {
+  TloHugePageMapping *next;
+  TloHugePageMapping *previous;
+  unsigned char *data;
+  size_t length;
+};
+
+#ifndef NDEBUG
+static bool hugePageAllocatorIsValid(const TloHugePageAllocator *allocator) {
+  return allocator && allocator->allocator.context == allocator &&
+         allocatorIsValid(allocator->smallAllocator) && allocator->threshold;
+}
+#endif
+
+// returns false if the length would overflow, leaving room for mapAligned
+static bool mappingLength(size_t size, size_t *length) {
+  if (size > SIZE_MAX - 2 * TLO_HUGE_PAGE_SIZE) {
+    return false;
+  }
+
+  *length = (size + TLO_HUGE_PAGE_SIZE - 1) & ~(size_t)(TLO_HUGE_PAGE_SIZE - 1);
+  return true;
+}
+
+#ifdef __linux__
+// maps length bytes aligned to TLO_HUGE_PAGE_SIZE by over-mapping and then
+// unmapping the unaligned ends
+static unsigned char *mapAligned(size_t length) {
+  size_t mappedLength = length + TLO_HUGE_PAGE_SIZE;
+  unsigned char *memory = mmap(NULL, mappedLength, PROT_READ | PROT_WRITE,
+                               MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if (memory == MAP_FAILED) {
+    return NULL;
+  }
+
+  uintptr_t address = (uintptr_t)memory;
+  uintptr_t alignedAddress = (address + TLO_HUGE_PAGE_SIZE - 1) &
+                             ~(uintptr_t)(TLO_HUGE_PAGE_SIZE - 1);
+  size_t leadingLength = alignedAddress - address;
+  size_t trailingLength = mappedLength - leadingLength - length;
+
+  if (leadingLength) {
+    munmap(memory, leadingLength);
+  }
+  if (trailingLength) {
+    munmap(memory + leadingLength + length, trailingLength);
+  }
+
+  // just a hint, so failure is fine
+  madvise(memory + leadingLength, length, MADV_HUGEPAGE);
+
+  return memory + leadingLength;
+}
+
+static void unmap(unsigned char *data, size_t length) { munmap(data, length); }
+
+/*
+ * - grows mapping to length without copying its pages: in place if the
+ *   address space after it is free, otherwise by moving its pages with
+ *   mremap over the start of a new aligned mapping
+ * - returns false if neither works, leaving mapping as is
+ */
+static bool remapLonger(TloHugePageMapping *mapping, size_t length) {
+  if (mremap(mapping->data, mapping->length, length, 0) != MAP_FAILED) {
+    mapping->length = length;
+    return true;
+  }
+
+  unsigned char *data = mapAligned(length);
+  if (!data) {
+    return false;
+  }
+
+  if (mremap(mapping->data, mapping->length, mapping->length,
+             MREMAP_MAYMOVE | MREMAP_FIXED, data) == MAP_FAILED) {
+    munmap(data, length);
+    return false;
+  }
+
+  mapping->data = data;
+  mapping->length = length;
+  return true;
+}
+#else
+static unsigned char *mapAligned(size_t length) {
+  (void)length;
+  return NULL;
+}
+
+static void unmap(unsigned char *data, size_t length) {
+  (void)data;
+  (void)length;
+}
+
+static bool remapLonger(TloHugePageMapping *mapping, size_t length) {
+  (void)mapping;
+  (void)length;
+  return false;
+}
+#endif
+
+// returns NULL if mapping fails, so callers can fall back to small allocator
+static void *mallocBig(TloHugePageAllocator *allocator, size_t size) {
+  size_t length;
+  if (!mappingLength(size, &length)) {
+    return NULL;
+  }
+
+  unsigned char *data = mapAligned(length);
+  if (!data) {
+    return NULL;
+  }
+
+  TloHugePageMapping *mapping =
+      tloAllocatorMalloc(allocator->smallAllocator, sizeof(*mapping));
+  if (!mapping) {
+    unmap(data, length);
+    return NULL;
+  }
+
+  mapping->data = data;
+  mapping->length = length;
+  mapping->previous = NULL;
+  mapping->next = allocator->mappings;
+  if (allocator->mappings) {
+    allocator->mappings->previous = mapping;
+  }
+  allocator->mappings = mapping;
+
+  return data;
+}
+
+/*
+ * - gives the whole huge pages past size back when shrinking, and grows with
+ *   remapLonger
+ * - returns false if growing fails, leaving mapping as is
+ */
+static bool resizeBig(TloHugePageMapping *mapping, size_t size) {
+  size_t length;
+  if (!mappingLength(size, &length)) {
+    return false;
+  }
+
+  if (length > mapping->length) {
+    return remapLonger(mapping, length);
+  }
+
+  if (length < mapping->length) {
+    unmap(mapping->data + length, mapping->length - length);
+    mapping->length = length;
+  }
+  return true;
+}
+
+static TloHugePageMapping *findMapping(const TloHugePageAllocator *allocator,
+                                       const void *memory) {
+  for (TloHugePageMapping *mapping = allocator->mappings; mapping;
+       mapping = mapping->next) {
+    if (mapping->data == memory) {
+      return mapping;
+    }
+  }
+
+  return NULL;
+}
+
+static void freeBig(TloHugePageAllocator *allocator,
+                    TloHugePageMapping *mapping) {
+  if (mapping->previous) {
+    mapping->previous->next = mapping->next;
+  } else {
+    allocator->mappings = mapping->next;
+  }
+
+  if (mapping->next) {
+    mapping->next->previous = mapping->previous;
+  }
+
+  unmap(mapping->data, mapping->length);
+  tloAllocatorSizedFree(allocator->smallAllocator, mapping, sizeof(*mapping));
+}
+
+static void *hugePageMalloc(void *context, size_t size) {
+  TloHugePageAllocator *allocator = context;
+  assert(hugePageAllocatorIsValid(allocator));
+
+  if (size >= allocator->threshold) {
+    void *memory = mallocBig(allocator, size);
+    if (memory) {
+      return memory;
+    }
+  }
+
+  return tloAllocatorMalloc(allocator->smallAllocator, size);
+}
+
+static void hugePageFree(void *context, void *memory) {
+  TloHugePageAllocator *allocator = context;
+  assert(hugePageAllocatorIsValid(allocator));
+
+  TloHugePageMapping *mapping = findMapping(allocator, memory);
+  if (mapping) {
+    freeBig(allocator, mapping);
+    return;
+  }
+
+  tloAllocatorFree(allocator->smallAllocator, memory);
+}
+
+static void hugePageSizedFree(void *context, void *memory, size_t size) {
+  TloHugePageAllocator *allocator = context;
+  assert(hugePageAllocatorIsValid(allocator));
+
+  // big allocations fall back to the small allocator if mapping fails
+  TloHugePageMapping *mapping =
+      size >= allocator->threshold ? findMapping(allocator, memory) : NULL;
+  if (mapping) {
+    freeBig(allocator, mapping);
+    return;
+  }
+
+  tloAllocatorSizedFree(allocator->smallAllocator, memory, size);
+}
+
+static void *hugePageRealloc(void *context, void *memory, size_t size,
+                             size_t newSize) {
+  TloHugePageAllocator *allocator = context;
+  assert(hugePageAllocatorIsValid(allocator));
+  assert(memory);
+  assert(newSize);
+
+  // like hugePageSizedFree, only a big allocation can have a mapping
+  TloHugePageMapping *mapping =
+      size >= allocator->threshold ? findMapping(allocator, memory) : NULL;
+
+  if (mapping && newSize >= allocator->threshold &&
+      resizeBig(mapping, newSize)) {
+    return mapping->data;
+  }
+
+  if (!mapping && newSize < allocator->threshold) {
+    return tloAllocatorRealloc(allocator->smallAllocator, memory, size,
+                               newSize);
+  }
+
+  void *newMemory = hugePageMalloc(allocator, newSize);
+  if (!newMemory) {
+    return NULL;
+  }
+
+  memcpy(newMemory, memory, size < newSize ? size : newSize);
+  if (mapping) {
+    freeBig(allocator, mapping);
+  } else {
+    tloAllocatorSizedFree(allocator->smallAllocator, memory, size);
+  }
+  return newMemory;
+}
+
+static void *hugePageCalloc(void *context, size_t count, size_t size) {
+  TloHugePageAllocator *allocator = context;
+  assert(hugePageAllocatorIsValid(allocator));
+
+  if (size && count > SIZE_MAX / size) {
+    return NULL;
+  }
+
+  // fresh anonymous mappings are already zeroed
+  if (count * size >= allocator->threshold) {
+    void *memory = mallocBig(allocator, count * size);
+    if (memory) {
+      return memory;
+    }
+  }
+
+  return tloAllocatorCalloc(allocator->smallAllocator, count, size);
+}
+
+void tloHugePageAllocatorConstruct(TloHugePageAllocator *allocator,
+                                   const TloAllocator *smallAllocator,
+                                   size_t threshold) {
+  assert(allocator);
+  assert(smallAllocator == NULL || allocatorIsValid(smallAllocator));
+
+  if (!smallAllocator) {
+    smallAllocator = &tloCStdLibAllocator;
+  }
+
+  if (!threshold) {
+    threshold = TLO_HUGE_PAGE_SIZE;
+  }
+
+  allocator->allocator = (TloAllocator){.context = allocator,
+                                        .malloc = hugePageMalloc,
+                                        .free = hugePageFree,
+                                        .realloc = hugePageRealloc,
+                                        .calloc = hugePageCalloc,
+                                        .sizedFree = hugePageSizedFree};
+  allocator->smallAllocator = smallAllocator;
+  allocator->threshold = threshold;
+  allocator->mappings = NULL;
+}
+
+void tloHugePageAllocatorDestruct(TloHugePageAllocator *allocator) {
+  if (!allocator) {
+    return;
+  }
+
+  assert(hugePageAllocatorIsValid(allocator));
+
+  while (allocator->mappings) {
+    freeBig(allocator, allocator->mappings);
+  }
+}
+
+TloHugePageAllocator *tloHugePageAllocatorMake(
+    const TloAllocator *smallAllocator, size_t threshold) {
+  if (!smallAllocator) {
+    smallAllocator = &tloCStdLibAllocator;
+  }
+
+  assert(allocatorIsValid(smallAllocator));
+
+  TloHugePageAllocator *allocator =
+      tloAllocatorMalloc(smallAllocator, sizeof(*allocator));
+  if (!allocator) {
+    return NULL;
+  }
+
+  tloHugePageAllocatorConstruct(allocator, smallAllocator, threshold);
+
+  return allocator;
+}
+
+void tloHugePageAllocatorDelete(TloHugePageAllocator *allocator) {
+  if (!allocator) {
+    return;
+  }
+
+  const TloAllocator *smallAllocator = allocator->smallAllocator;
+  tloHugePageAllocatorDestruct(allocator);
+  tloAllocatorSizedFree(smallAllocator, allocator, sizeof(*allocator));
+}
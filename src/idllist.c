@@ -0,0 +1,152 @@
+#include "tlo/idllist.h"
+#include <assert.h>
+
+#ifndef NDEBUG
+static bool idllistIsValid(const TloIDLList *list) {
+  return list && ((list->head == NULL) == (list->size == 0)) &&
+         ((list->tail == NULL) == (list->size == 0)) &&
+         (list->head == NULL || list->head->prev == NULL) &&
+         (list->tail == NULL || list->tail->next == NULL);
+}
+#endif
+
+void tloIDLListConstruct(TloIDLList *list) {
+  assert(list);
+
+  list->head = NULL;
+  list->tail = NULL;
+  list->size = 0;
+}
+
+size_t tloIDLListSize(const TloIDLList *list) {
+  assert(idllistIsValid(list));
+
+  return list->size;
+}
+
+bool tloIDLListIsEmpty(const TloIDLList *list) {
+  assert(idllistIsValid(list));
+
+  return list->size == 0;
+}
+
+const TloIDLLHook *tloIDLListHead(const TloIDLList *list) {
+  assert(idllistIsValid(list));
+
+  return list->head;
+}
+
+TloIDLLHook *tloIDLListMutableHead(TloIDLList *list) {
+  assert(idllistIsValid(list));
+
+  return list->head;
+}
+
+const TloIDLLHook *tloIDLListTail(const TloIDLList *list) {
+  assert(idllistIsValid(list));
+
+  return list->tail;
+}
+
+TloIDLLHook *tloIDLListMutableTail(TloIDLList *list) {
+  assert(idllistIsValid(list));
+
+  return list->tail;
+}
+
+void tloIDLListPushBack(TloIDLList *list, TloIDLLHook *hook) {
+  tloIDLListInsertBefore(list, NULL, hook);
+}
+
+void tloIDLListPushFront(TloIDLList *list, TloIDLLHook *hook) {
+  tloIDLListInsertBefore(list, list->head, hook);
+}
+
+void tloIDLListInsertBefore(TloIDLList *list, TloIDLLHook *position,
+                            TloIDLLHook *hook) {
+  assert(idllistIsValid(list));
+  assert(hook);
+  assert(hook != position);
+
+  hook->next = position;
+
+  if (position) {
+    hook->prev = position->prev;
+    position->prev = hook;
+  } else {
+    hook->prev = list->tail;
+    list->tail = hook;
+  }
+
+  if (hook->prev) {
+    hook->prev->next = hook;
+  } else {
+    list->head = hook;
+  }
+
+  ++list->size;
+}
+
+void tloIDLListRemove(TloIDLList *list, TloIDLLHook *hook) {
+  assert(idllistIsValid(list));
+  assert(!tloIDLListIsEmpty(list));
+  assert(hook);
+
+  if (hook->prev) {
+    hook->prev->next = hook->next;
+  } else {
+    list->head = hook->next;
+  }
+
+  if (hook->next) {
+    hook->next->prev = hook->prev;
+  } else {
+    list->tail = hook->prev;
+  }
+
+  hook->next = NULL;
+  hook->prev = NULL;
+  --list->size;
+}
+
+TloIDLLHook *tloIDLListPopFront(TloIDLList *list) {
+  assert(idllistIsValid(list));
+  assert(!tloIDLListIsEmpty(list));
+
+  TloIDLLHook *hook = list->head;
+  tloIDLListRemove(list, hook);
+  return hook;
+}
+
+TloIDLLHook *tloIDLListPopBack(TloIDLList *list) {
+  assert(idllistIsValid(list));
+  assert(!tloIDLListIsEmpty(list));
+
+  TloIDLLHook *hook = list->tail;
+  tloIDLListRemove(list, hook);
+  return hook;
+}
+
+const TloIDLLHook *tloIDLLHookNext(const TloIDLLHook *hook) {
+  assert(hook);
+
+  return hook->next;
+}
+
+TloIDLLHook *tloIDLLHookMutableNext(TloIDLLHook *hook) {
+  assert(hook);
+
+  return hook->next;
+}
+
+const TloIDLLHook *tloIDLLHookPrev(const TloIDLLHook *hook) {
+  assert(hook);
+
+  return hook->prev;
+}
+
+TloIDLLHook *tloIDLLHookMutablePrev(TloIDLLHook *hook) {
+  assert(hook);
+
+  return hook->prev;
+}
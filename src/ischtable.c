@@ -0,0 +1,181 @@
+#include "tlo/ischtable.h"
+#include <assert.h>
+#include "util.h"
+
+enum { STARTING_CAPACITY = 8 };
+
+#ifndef NDEBUG
+static bool ischtableIsValid(const TloISCHTable *table) {
+  return table && typeIsValid(table->keyType) && table->key &&
+         allocatorIsValid(table->allocator) &&
+         ((table->array == NULL) == (table->capacity == 0)) &&
+         (table->size <= table->capacity);
+}
+#endif
+
+void tloISCHTableConstruct(TloISCHTable *table, const TloType *keyType,
+                           TloISCHTKeyFunction key,
+                           const TloAllocator *allocator) {
+  assert(table);
+  assert(typeIsValid(keyType));
+  assert(key);
+  assert(allocator == NULL || allocatorIsValid(allocator));
+
+  if (!allocator) {
+    allocator = &tloCStdLibAllocator;
+  }
+
+  table->keyType = keyType;
+  table->key = key;
+  table->allocator = allocator;
+  table->array = NULL;
+  table->size = 0;
+  table->capacity = 0;
+}
+
+void tloISCHTableDestruct(TloISCHTable *table) {
+  if (!table) {
+    return;
+  }
+
+  assert(ischtableIsValid(table));
+
+  if (table->array) {
+    tloAllocatorSizedFree(table->allocator, table->array,
+                          table->capacity * sizeof(*table->array));
+  }
+
+  table->array = NULL;
+  table->size = 0;
+  table->capacity = 0;
+}
+
+size_t tloISCHTableSize(const TloISCHTable *table) {
+  assert(ischtableIsValid(table));
+
+  return table->size;
+}
+
+bool tloISCHTableIsEmpty(const TloISCHTable *table) {
+  assert(ischtableIsValid(table));
+
+  return table->size == 0;
+}
+
+static void linkHook(TloISCHTHook **bucket, TloISCHTHook *hook) {
+  hook->next = *bucket;
+  if (*bucket) {
+    (*bucket)->prevNext = &hook->next;
+  }
+
+  *bucket = hook;
+  hook->prevNext = bucket;
+}
+
+static void unlinkHook(TloISCHTHook *hook) {
+  *hook->prevNext = hook->next;
+  if (hook->next) {
+    hook->next->prevNext = hook->prevNext;
+  }
+}
+
+static TloError resizeArray(TloISCHTable *table, size_t newCapacity) {
+  TloISCHTHook **newArray =
+      tloAllocatorCalloc(table->allocator, newCapacity, sizeof(*newArray));
+  if (!newArray) {
+    return TLO_ERROR;
+  }
+
+  for (size_t i = 0; i < table->capacity; ++i) {
+    TloISCHTHook *hook = table->array[i];
+
+    while (hook) {
+      TloISCHTHook *next = hook->next;
+      linkHook(&newArray[hook->hash % newCapacity], hook);
+      hook = next;
+    }
+  }
+
+  if (table->array) {
+    tloAllocatorSizedFree(table->allocator, table->array,
+                          table->capacity * sizeof(*table->array));
+  }
+
+  table->array = newArray;
+  table->capacity = newCapacity;
+  return TLO_SUCCESS;
+}
+
+static TloISCHTHook *findHook(const TloISCHTable *table, const void *key,
+                              size_t hash) {
+  if (!table->capacity) {
+    return NULL;
+  }
+
+  for (TloISCHTHook *hook = table->array[hash % table->capacity]; hook;
+       hook = hook->next) {
+    if (hook->hash == hash &&
+        tloTypeEquals(table->keyType, table->key(hook), key)) {
+      return hook;
+    }
+  }
+
+  return NULL;
+}
+
+TloError tloISCHTableInsert(TloISCHTable *table, TloISCHTHook *hook) {
+  assert(ischtableIsValid(table));
+  assert(hook);
+
+  const void *key = table->key(hook);
+  size_t hash = tloTypeHash(table->keyType, key);
+  if (findHook(table, key, hash)) {
+    return TLO_DUPLICATE;
+  }
+
+  if (table->size == table->capacity) {
+    size_t newCapacity =
+        table->capacity ? table->capacity * 2 : STARTING_CAPACITY;
+    if (resizeArray(table, newCapacity) != TLO_SUCCESS) {
+      return TLO_ERROR;
+    }
+  }
+
+  hook->hash = hash;
+  linkHook(&table->array[hash % table->capacity], hook);
+  ++table->size;
+
+  return TLO_SUCCESS;
+}
+
+const TloISCHTHook *tloISCHTableFind(const TloISCHTable *table,
+                                     const void *key) {
+  assert(ischtableIsValid(table));
+  assert(key);
+
+  return findHook(table, key, tloTypeHash(table->keyType, key));
+}
+
+TloISCHTHook *tloISCHTableMutableFind(TloISCHTable *table, const void *key) {
+  assert(ischtableIsValid(table));
+  assert(key);
+
+  return findHook(table, key, tloTypeHash(table->keyType, key));
+}
+
+void tloISCHTableRemove(TloISCHTable *table, TloISCHTHook *hook) {
+  assert(ischtableIsValid(table));
+  assert(!tloISCHTableIsEmpty(table));
+  assert(hook);
+
+  unlinkHook(hook);
+  hook->next = NULL;
+  hook->prevNext = NULL;
+  --table->size;
+
+  // if shrinking fails, the bigger array still works
+  if (table->size <= table->capacity / 4 &&
+      table->capacity > STARTING_CAPACITY) {
+    resizeArray(table, table->capacity / 2);
+  }
+}
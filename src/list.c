@@ -1,5 +1,8 @@
 #include "list.h"
 #include <assert.h>
+#include <string.h>
+#include "tlo/sort.h"
+#include "tlo/threadpool.h"
 #include "util.h"
 
 static bool listVTableIsValid(const TloListVTable *vTable) {
@@ -34,7 +37,7 @@ void tloListDelete(TloList *list) {
   assert(listIsValid(list));
 
   tlovListDestruct(list);
-  list->allocator->free(list);
+  tloAllocatorFree(list->allocator, list);
 }
 
 const TloType *tloListValueType(const TloList *list) {
@@ -201,6 +204,131 @@ void tlovListUnorderedRemove(TloList *list, size_t index) {
   list->vTable->unorderedRemove(list, index);
 }
 
+// lists with fewer elements are sorted by comparison even if they have keys
+enum { RADIX_SORT_THRESHOLD = 256 };
+
+// whether every element directly follows the one before it in memory
+static bool isContiguous(const TloList *list, size_t size) {
+  const unsigned char *first = tlovListElement(list, 0);
+  for (size_t i = 1; i < size; ++i) {
+    if (tlovListElement(list, i) != first + i * list->valueType->size) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// where the next run goes to or comes from in the sort buffer
+typedef struct RunCopy {
+  unsigned char *buffer;
+  size_t elementSize;
+} RunCopy;
+
+static void countRun(void *run, size_t size, void *context) {
+  (void)run;
+  (void)size;
+  ++*(size_t *)context;
+}
+
+static void copyRunToBuffer(void *run, size_t size, void *context) {
+  RunCopy *copy = context;
+  memcpy(copy->buffer, run, size * copy->elementSize);
+  copy->buffer += size * copy->elementSize;
+}
+
+static void copyRunFromBuffer(void *run, size_t size, void *context) {
+  RunCopy *copy = context;
+  memcpy(run, copy->buffer, size * copy->elementSize);
+  copy->buffer += size * copy->elementSize;
+}
+
+/*
+ * - sorts with tloParallelSort if pool isn't NULL
+ * - otherwise radix sorts if the value type has an integer key and there are
+ *   enough elements to pay for the passes, and falls back to tloSort
+ */
+static TloError sortElements(TloList *list, void *elements, size_t size,
+                             bool stable, TloThreadPool *pool) {
+  if (!pool) {
+    if (!list->valueType->integerKey || size < RADIX_SORT_THRESHOLD ||
+        tloRadixSort(elements, size, list->valueType, list->allocator) !=
+            TLO_SUCCESS) {
+      tloSort(elements, size, list->valueType);
+    }
+    return TLO_SUCCESS;
+  }
+
+  return tloParallelSort(elements, size, list->valueType, stable, pool,
+                         list->allocator);
+}
+
+static TloError sortList(TloList *list, bool stable, TloThreadPool *pool) {
+  assert(listIsValid(list));
+  assert(tloListHasFunctions(list, TLO_LIST_ELEMENT));
+  assert(list->valueType->compare);
+
+  size_t size = tlovListSize(list);
+  if (size < 2) {
+    return TLO_SUCCESS;
+  }
+
+  // walking the runs is O(number of runs), while isContiguous looks up each
+  // element until it finds a gap
+  bool contiguous;
+  if (list->vTable->forEachMutableRun) {
+    size_t numRuns = 0;
+    list->vTable->forEachMutableRun(list, countRun, &numRuns);
+    contiguous = numRuns == 1;
+  } else {
+    contiguous = isContiguous(list, size);
+  }
+
+  if (contiguous) {
+    return sortElements(list, tlovListMutableElement(list, 0), size, stable,
+                        pool);
+  }
+
+  size_t elementSize = list->valueType->size;
+  unsigned char *buffer =
+      tloAllocatorMalloc(list->allocator, size * elementSize);
+  if (!buffer) {
+    return TLO_ERROR;
+  }
+
+  RunCopy copy = {.buffer = buffer, .elementSize = elementSize};
+  if (list->vTable->forEachMutableRun) {
+    list->vTable->forEachMutableRun(list, copyRunToBuffer, &copy);
+  } else {
+    for (size_t i = 0; i < size; ++i) {
+      memcpy(buffer + i * elementSize, tlovListElement(list, i), elementSize);
+    }
+  }
+
+  TloError error = sortElements(list, buffer, size, stable, pool);
+  if (error == TLO_SUCCESS) {
+    if (list->vTable->forEachMutableRun) {
+      copy.buffer = buffer;
+      list->vTable->forEachMutableRun(list, copyRunFromBuffer, &copy);
+    } else {
+      for (size_t i = 0; i < size; ++i) {
+        memcpy(tlovListMutableElement(list, i), buffer + i * elementSize,
+               elementSize);
+      }
+    }
+  }
+
+  tloAllocatorSizedFree(list->allocator, buffer, size * elementSize);
+  return error;
+}
+
+TloError tlovListSort(TloList *list) { return sortList(list, false, NULL); }
+
+TloError tlovListParallelSort(TloList *list, bool stable, TloThreadPool *pool) {
+  assert(pool);
+
+  return sortList(list, stable, pool);
+}
+
 bool listIsValid(const TloList *list) {
   return list && listVTableIsValid(list->vTable) &&
          typeIsValid(list->valueType) && allocatorIsValid(list->allocator);
@@ -35,7 +35,7 @@ void tloMapDelete(TloMap *map) {
   assert(mapIsValid(map));
 
   tlovMapDestruct(map);
-  map->allocator->free(map);
+  tloAllocatorFree(map->allocator, map);
 }
 
 const TloType *tloMapKeyType(const TloMap *map) {
@@ -0,0 +1,393 @@
+#define _DEFAULT_SOURCE
+#include "tlo/mpmcqueue.h"
+#include <assert.h>
+#include <stddef.h>
+#include <string.h>
+#include "util.h"
+
+#include <sched.h>
+
+#ifdef __linux__
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+/*
+ * - each slot is this header followed by the element, both aligned to
+ *   max_align_t like the elements of the other containers
+ * - a slot at position p (mod capacity) is free for the push at p when its
+ *   sequence is p, and holds the element for the pop at p when it's p + 1
+ * - a push has to publish the slot it claimed even if copying the element
+ *   into it fails, so it marks the slot empty and pops skip it
+ */
+typedef struct SlotHeader {
+  atomic_size_t sequence;
+  bool isEmpty;
+} SlotHeader;
+
+enum { ALIGNMENT = _Alignof(max_align_t) };
+
+static size_t roundUpToAlignment(size_t size) {
+  return (size + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT;
+}
+
+static size_t elementOffset(void) {
+  return roundUpToAlignment(sizeof(SlotHeader));
+}
+
+#ifndef NDEBUG
+static bool mpmcqueueIsValid(const TloMPMCQueue *queue) {
+  return queue && typeIsValid(queue->valueType) &&
+         allocatorIsValid(queue->allocator) && queue->slots &&
+         isPowerOfTwo(queue->capacity) &&
+         queue->slotSize ==
+             elementOffset() + roundUpToAlignment(queue->valueType->size);
+}
+#endif
+
+static void *slotAt(const TloMPMCQueue *queue, size_t position) {
+  return queue->slots + (position & (queue->capacity - 1)) * queue->slotSize;
+}
+
+static SlotHeader *headerAt(const TloMPMCQueue *queue, size_t position) {
+  return slotAt(queue, position);
+}
+
+static atomic_size_t *sequenceAt(const TloMPMCQueue *queue, size_t position) {
+  return &headerAt(queue, position)->sequence;
+}
+
+static void *elementAt(const TloMPMCQueue *queue, size_t position) {
+  return (unsigned char *)slotAt(queue, position) + elementOffset();
+}
+
+#ifdef __linux__
+// sleeps unless word no longer equals value. may wake up spuriously
+static void waitWhileEquals(atomic_uint *word, unsigned value) {
+  syscall(SYS_futex, word, FUTEX_WAIT_PRIVATE, value, NULL, NULL, 0);
+}
+
+static void wakeOne(atomic_uint *word) {
+  syscall(SYS_futex, word, FUTEX_WAKE_PRIVATE, 1, NULL, NULL, 0);
+}
+#else
+static void waitWhileEquals(atomic_uint *word, unsigned value) {
+  (void)word;
+  (void)value;
+  sched_yield();
+}
+
+static void wakeOne(atomic_uint *word) { (void)word; }
+#endif
+
+/*
+ * - called after a push or pop succeeds, to wake a thread blocked waiting for
+ *   it
+ * - the fence pairs with the one in block: either this sees the blocked count
+ *   go up, or the blocked thread's retry sees the push or pop
+ */
+static void wakeBlocked(atomic_uint *epoch, atomic_uint *blocked) {
+  atomic_thread_fence(memory_order_seq_cst);
+  if (atomic_load_explicit(blocked, memory_order_relaxed)) {
+    atomic_fetch_add(epoch, 1);
+    wakeOne(epoch);
+  }
+}
+
+TloError tloMPMCQueueConstruct(TloMPMCQueue *queue, const TloType *valueType,
+                               const TloAllocator *allocator, size_t capacity) {
+  assert(queue);
+  assert(typeIsValid(valueType));
+  assert(allocator == NULL || allocatorIsValid(allocator));
+  assert(capacity > 0);
+
+  if (!allocator) {
+    allocator = &tloCStdLibAllocator;
+  }
+
+  // with 1 slot, a full slot's sequence would equal the next push's position
+  capacity = roundUpToPowerOfTwo(capacity < 2 ? 2 : capacity);
+  if (!capacity) {
+    return TLO_ERROR;
+  }
+
+  size_t slotSize = elementOffset() + roundUpToAlignment(valueType->size);
+  unsigned char *slots = tloAllocatorMalloc(allocator, capacity * slotSize);
+  if (!slots) {
+    return TLO_ERROR;
+  }
+
+  queue->valueType = valueType;
+  queue->allocator = allocator;
+  queue->slots = slots;
+  queue->slotSize = slotSize;
+  queue->capacity = capacity;
+  for (size_t i = 0; i < capacity; ++i) {
+    atomic_init(sequenceAt(queue, i), i);
+  }
+  atomic_init(&queue->tail, 0);
+  atomic_init(&queue->head, 0);
+  atomic_init(&queue->pushEpoch, 0);
+  atomic_init(&queue->blockedConsumers, 0);
+  atomic_init(&queue->popEpoch, 0);
+  atomic_init(&queue->blockedProducers, 0);
+
+  return TLO_SUCCESS;
+}
+
+void tloMPMCQueueDestruct(TloMPMCQueue *queue) {
+  if (!queue) {
+    return;
+  }
+
+  assert(mpmcqueueIsValid(queue));
+
+  size_t head = atomic_load_explicit(&queue->head, memory_order_relaxed);
+  size_t tail = atomic_load_explicit(&queue->tail, memory_order_relaxed);
+  for (size_t i = head; i != tail; ++i) {
+    if (!headerAt(queue, i)->isEmpty) {
+      tloTypeDestruct(queue->valueType, elementAt(queue, i));
+    }
+  }
+
+  tloAllocatorSizedFree(queue->allocator, queue->slots,
+                        queue->capacity * queue->slotSize);
+  queue->slots = NULL;
+}
+
+TloMPMCQueue *tloMPMCQueueMake(const TloType *valueType,
+                               const TloAllocator *allocator, size_t capacity) {
+  assert(typeIsValid(valueType));
+
+  if (!allocator) {
+    allocator = &tloCStdLibAllocator;
+  }
+
+  assert(allocatorIsValid(allocator));
+
+  TloMPMCQueue *queue = tloAllocatorMalloc(allocator, sizeof(*queue));
+  if (!queue) {
+    return NULL;
+  }
+
+  if (tloMPMCQueueConstruct(queue, valueType, allocator, capacity) !=
+      TLO_SUCCESS) {
+    tloAllocatorSizedFree(allocator, queue, sizeof(*queue));
+    return NULL;
+  }
+
+  return queue;
+}
+
+void tloMPMCQueueDelete(TloMPMCQueue *queue) {
+  if (!queue) {
+    return;
+  }
+
+  const TloAllocator *allocator = queue->allocator;
+  tloMPMCQueueDestruct(queue);
+  tloAllocatorSizedFree(allocator, queue, sizeof(*queue));
+}
+
+size_t tloMPMCQueueCapacity(const TloMPMCQueue *queue) {
+  assert(mpmcqueueIsValid(queue));
+
+  return queue->capacity;
+}
+
+size_t tloMPMCQueueSize(const TloMPMCQueue *queue) {
+  assert(mpmcqueueIsValid(queue));
+
+  // head first, so tail can only have moved further along since
+  size_t head = atomic_load_explicit(&queue->head, memory_order_acquire);
+  size_t tail = atomic_load_explicit(&queue->tail, memory_order_acquire);
+  return tail - head;
+}
+
+/*
+ * - claims the next position of index, which is tail or head, and sets
+ *   *position to it
+ * - lag is 0 for pushes and 1 for pops: the slot at a position is ready when
+ *   its sequence is the position plus lag
+ * - returns false if the slot at the current index isn't ready, which means
+ *   the queue is full for pushes or empty for pops
+ */
+static bool claim(const TloMPMCQueue *queue, atomic_size_t *index, size_t lag,
+                  size_t *position) {
+  size_t current = atomic_load_explicit(index, memory_order_relaxed);
+
+  for (;;) {
+    size_t sequence = atomic_load_explicit(sequenceAt(queue, current),
+                                           memory_order_acquire);
+    ptrdiff_t difference = (ptrdiff_t)(sequence - (current + lag));
+
+    if (difference == 0) {
+      if (atomic_compare_exchange_weak_explicit(index, &current, current + 1,
+                                                memory_order_relaxed,
+                                                memory_order_relaxed)) {
+        *position = current;
+        return true;
+      }
+    } else if (difference < 0) {
+      return false;
+    } else {
+      current = atomic_load_explicit(index, memory_order_relaxed);
+    }
+  }
+}
+
+typedef enum PushResult { PUSHED, FULL, COPY_FAILED } PushResult;
+
+// copies element into the slot with constructCopy if isCopy is true, and
+// moves its bytes in otherwise
+static PushResult tryPush(TloMPMCQueue *queue, const void *element,
+                          bool isCopy) {
+  size_t position;
+  if (!claim(queue, &queue->tail, 0, &position)) {
+    return FULL;
+  }
+
+  void *destination = elementAt(queue, position);
+  bool isEmpty = false;
+  if (isCopy) {
+    isEmpty = tloTypeConstructCopy(queue->valueType, destination, element) !=
+              TLO_SUCCESS;
+  } else {
+    memcpy(destination, element, queue->valueType->size);
+  }
+
+  headerAt(queue, position)->isEmpty = isEmpty;
+  atomic_store_explicit(sequenceAt(queue, position), position + 1,
+                        memory_order_release);
+
+  wakeBlocked(&queue->pushEpoch, &queue->blockedConsumers);
+  return isEmpty ? COPY_FAILED : PUSHED;
+}
+
+bool tloMPMCQueueTryPush(TloMPMCQueue *queue, const void *element) {
+  assert(mpmcqueueIsValid(queue));
+  assert(element);
+
+  return tryPush(queue, element, true) == PUSHED;
+}
+
+bool tloMPMCQueueTryMove(TloMPMCQueue *queue, void *element) {
+  assert(mpmcqueueIsValid(queue));
+  assert(element);
+
+  return tryPush(queue, element, false) == PUSHED;
+}
+
+bool tloMPMCQueueTryPop(TloMPMCQueue *queue, void *destination) {
+  assert(mpmcqueueIsValid(queue));
+  assert(destination);
+
+  for (;;) {
+    size_t position;
+    if (!claim(queue, &queue->head, 1, &position)) {
+      return false;
+    }
+
+    bool isEmpty = headerAt(queue, position)->isEmpty;
+    if (!isEmpty) {
+      memcpy(destination, elementAt(queue, position), queue->valueType->size);
+    }
+    atomic_store_explicit(sequenceAt(queue, position),
+                          position + queue->capacity, memory_order_release);
+
+    wakeBlocked(&queue->popEpoch, &queue->blockedProducers);
+    if (!isEmpty) {
+      return true;
+    }
+  }
+}
+
+/*
+ * - registers as blocked and returns epoch. the caller then retries once and,
+ *   if that fails too, sleeps until epoch moves on
+ * - the fence pairs with the one in wakeBlocked
+ */
+static unsigned block(atomic_uint *epoch, atomic_uint *blocked) {
+  atomic_fetch_add(blocked, 1);
+  atomic_thread_fence(memory_order_seq_cst);
+  return atomic_load(epoch);
+}
+
+static void unblock(atomic_uint *blocked) { atomic_fetch_sub(blocked, 1); }
+
+/*
+ * - how many times the blocking functions yield and retry before going to
+ *   sleep
+ * - the other side usually gets going again within a few time slices, and
+ *   sleeping costs it a syscall to wake us up
+ */
+enum { NUM_YIELDS_BEFORE_SLEEPING = 16 };
+
+// like tryPush, but waits while queue is full
+static PushResult push(TloMPMCQueue *queue, const void *element, bool isCopy) {
+  for (int i = 0; i < NUM_YIELDS_BEFORE_SLEEPING; ++i) {
+    PushResult result = tryPush(queue, element, isCopy);
+    if (result != FULL) {
+      return result;
+    }
+    sched_yield();
+  }
+
+  for (;;) {
+    PushResult result = tryPush(queue, element, isCopy);
+    if (result != FULL) {
+      return result;
+    }
+
+    unsigned epoch = block(&queue->popEpoch, &queue->blockedProducers);
+    result = tryPush(queue, element, isCopy);
+    if (result == FULL) {
+      waitWhileEquals(&queue->popEpoch, epoch);
+    }
+    unblock(&queue->blockedProducers);
+
+    if (result != FULL) {
+      return result;
+    }
+  }
+}
+
+bool tloMPMCQueuePush(TloMPMCQueue *queue, const void *element) {
+  assert(mpmcqueueIsValid(queue));
+  assert(element);
+
+  return push(queue, element, true) == PUSHED;
+}
+
+void tloMPMCQueueMove(TloMPMCQueue *queue, void *element) {
+  assert(mpmcqueueIsValid(queue));
+  assert(element);
+
+  push(queue, element, false);
+}
+
+void tloMPMCQueuePop(TloMPMCQueue *queue, void *destination) {
+  assert(mpmcqueueIsValid(queue));
+  assert(destination);
+
+  for (int i = 0; i < NUM_YIELDS_BEFORE_SLEEPING; ++i) {
+    if (tloMPMCQueueTryPop(queue, destination)) {
+      return;
+    }
+    sched_yield();
+  }
+
+  while (!tloMPMCQueueTryPop(queue, destination)) {
+    unsigned epoch = block(&queue->pushEpoch, &queue->blockedConsumers);
+    bool popped = tloMPMCQueueTryPop(queue, destination);
+    if (!popped) {
+      waitWhileEquals(&queue->pushEpoch, epoch);
+    }
+    unblock(&queue->blockedConsumers);
+
+    if (popped) {
+      return;
+    }
+  }
+}
@@ -0,0 +1,288 @@
+#include "tlo/pool.h"
+#include <assert.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include "util.h"
+
+/*
+ * - every slab starts with this header. big allocations get one too, so free
+ *   can find the header of any allocation by rounding its address down to a
+ *   multiple of TLO_POOL_SLAB_SIZE
+ * - next, previous, memory, and memorySize are only used in the first slab of
+ *   each block allocated with the block allocator
+ */
+struct TloPoolSlab {
+  size_t sizeClass;
+  TloPoolSlab *next;
+  TloPoolSlab *previous;
+  void *memory;
+  size_t memorySize;
+};
+
+struct TloPoolObject {
+  TloPoolObject *next;
+};
+
+enum {
+  ALIGNMENT = _Alignof(max_align_t),
+  SIZE_CLASS_STEP = TLO_POOL_MAX_SMALL_SIZE / TLO_POOL_NUM_SIZE_CLASSES,
+  HEADER_SIZE = (sizeof(TloPoolSlab) + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT,
+  SLABS_PER_BLOCK = 16,
+  LARGE_SIZE_CLASS = TLO_POOL_NUM_SIZE_CLASSES
+};
+
+_Static_assert(SIZE_CLASS_STEP % ALIGNMENT == 0,
+               "size classes must keep objects aligned");
+_Static_assert((TLO_POOL_SLAB_SIZE & (TLO_POOL_SLAB_SIZE - 1)) == 0,
+               "slab size must be a power of 2");
+
+#ifndef NDEBUG
+static bool poolIsValid(const TloPool *pool) {
+  return pool && pool->allocator.context == pool &&
+         allocatorIsValid(pool->blockAllocator) &&
+         (pool->nextSlab <= pool->slabsEnd);
+}
+#endif
+
+static size_t sizeClassOfSize(size_t size) {
+  return size ? (size - 1) / SIZE_CLASS_STEP : 0;
+}
+
+static size_t sizeOfSizeClass(size_t sizeClass) {
+  return (sizeClass + 1) * SIZE_CLASS_STEP;
+}
+
+static TloPoolSlab *slabOf(const void *memory) {
+  return (TloPoolSlab *)((uintptr_t)memory &
+                         ~(uintptr_t)(TLO_POOL_SLAB_SIZE - 1));
+}
+
+static unsigned char *slabData(TloPoolSlab *slab) {
+  return (unsigned char *)slab + HEADER_SIZE;
+}
+
+static TloPoolSlab *makeBlock(TloPool *pool, size_t size) {
+  size_t memorySize = size + TLO_POOL_SLAB_SIZE - 1;
+  void *memory = tloAllocatorMalloc(pool->blockAllocator, memorySize);
+  if (!memory) {
+    return NULL;
+  }
+
+  TloPoolSlab *block = slabOf((unsigned char *)memory + TLO_POOL_SLAB_SIZE - 1);
+  block->sizeClass = LARGE_SIZE_CLASS;
+  block->memory = memory;
+  block->memorySize = memorySize;
+
+  block->previous = NULL;
+  block->next = pool->blocks;
+  if (pool->blocks) {
+    pool->blocks->previous = block;
+  }
+  pool->blocks = block;
+
+  return block;
+}
+
+static void freeBlock(TloPool *pool, TloPoolSlab *block) {
+  if (block->previous) {
+    block->previous->next = block->next;
+  } else {
+    pool->blocks = block->next;
+  }
+
+  if (block->next) {
+    block->next->previous = block->previous;
+  }
+
+  tloAllocatorSizedFree(pool->blockAllocator, block->memory,
+                        block->memorySize);
+}
+
+static TloError refillSizeClass(TloPool *pool, size_t sizeClass) {
+  if (pool->nextSlab == pool->slabsEnd) {
+    TloPoolSlab *block =
+        makeBlock(pool, SLABS_PER_BLOCK * (size_t)TLO_POOL_SLAB_SIZE);
+    if (!block) {
+      return TLO_ERROR;
+    }
+
+    pool->nextSlab = (unsigned char *)block;
+    pool->slabsEnd = pool->nextSlab + SLABS_PER_BLOCK * TLO_POOL_SLAB_SIZE;
+  }
+
+  TloPoolSlab *slab = (TloPoolSlab *)pool->nextSlab;
+  pool->nextSlab += TLO_POOL_SLAB_SIZE;
+  slab->sizeClass = sizeClass;
+
+  // objects are carved from the slab lazily, as they're needed
+  size_t objectSize = sizeOfSizeClass(sizeClass);
+  size_t numObjects = (TLO_POOL_SLAB_SIZE - HEADER_SIZE) / objectSize;
+  pool->sizeClasses[sizeClass].position = slabData(slab);
+  pool->sizeClasses[sizeClass].end = slabData(slab) + numObjects * objectSize;
+
+  return TLO_SUCCESS;
+}
+
+static void *mallocLarge(TloPool *pool, size_t size) {
+  if (size > SIZE_MAX - HEADER_SIZE - TLO_POOL_SLAB_SIZE) {
+    return NULL;
+  }
+
+  TloPoolSlab *block = makeBlock(pool, HEADER_SIZE + size);
+  if (!block) {
+    return NULL;
+  }
+
+  return slabData(block);
+}
+
+static void *poolMalloc(void *context, size_t size) {
+  TloPool *pool = context;
+  assert(poolIsValid(pool));
+
+  if (size > TLO_POOL_MAX_SMALL_SIZE) {
+    return mallocLarge(pool, size);
+  }
+
+  size_t sizeClass = sizeClassOfSize(size);
+  TloPoolSizeClass *objects = &pool->sizeClasses[sizeClass];
+
+  if (objects->freeList) {
+    TloPoolObject *object = objects->freeList;
+    objects->freeList = object->next;
+    return object;
+  }
+
+  if (objects->position == objects->end) {
+    if (refillSizeClass(pool, sizeClass) != TLO_SUCCESS) {
+      return NULL;
+    }
+  }
+
+  void *memory = objects->position;
+  objects->position += sizeOfSizeClass(sizeClass);
+  return memory;
+}
+
+static void poolFree(void *context, void *memory) {
+  TloPool *pool = context;
+  assert(poolIsValid(pool));
+
+  if (!memory) {
+    return;
+  }
+
+  TloPoolSlab *slab = slabOf(memory);
+  if (slab->sizeClass == LARGE_SIZE_CLASS) {
+    freeBlock(pool, slab);
+    return;
+  }
+
+  TloPoolObject *object = memory;
+  object->next = pool->sizeClasses[slab->sizeClass].freeList;
+  pool->sizeClasses[slab->sizeClass].freeList = object;
+}
+
+static void *poolRealloc(void *context, void *memory, size_t size,
+                         size_t newSize) {
+  TloPool *pool = context;
+  assert(poolIsValid(pool));
+  assert(memory);
+  assert(newSize);
+
+  size_t sizeClass = slabOf(memory)->sizeClass;
+  if (sizeClass != LARGE_SIZE_CLASS && newSize <= TLO_POOL_MAX_SMALL_SIZE &&
+      sizeClassOfSize(newSize) == sizeClass) {
+    return memory;
+  }
+
+  void *newMemory = poolMalloc(pool, newSize);
+  if (!newMemory) {
+    return NULL;
+  }
+
+  memcpy(newMemory, memory, size < newSize ? size : newSize);
+  poolFree(pool, memory);
+  return newMemory;
+}
+
+static void *poolCalloc(void *context, size_t count, size_t size) {
+  if (size && count > SIZE_MAX / size) {
+    return NULL;
+  }
+
+  void *memory = poolMalloc(context, count * size);
+  if (!memory) {
+    return NULL;
+  }
+
+  memset(memory, 0, count * size);
+  return memory;
+}
+
+void tloPoolConstruct(TloPool *pool, const TloAllocator *blockAllocator) {
+  assert(pool);
+  assert(blockAllocator == NULL || allocatorIsValid(blockAllocator));
+
+  if (!blockAllocator) {
+    blockAllocator = &tloCStdLibAllocator;
+  }
+
+  pool->allocator = (TloAllocator){.context = pool,
+                                   .malloc = poolMalloc,
+                                   .free = poolFree,
+                                   .realloc = poolRealloc,
+                                   .calloc = poolCalloc};
+  pool->blockAllocator = blockAllocator;
+  pool->blocks = NULL;
+  pool->nextSlab = NULL;
+  pool->slabsEnd = NULL;
+
+  for (size_t i = 0; i < TLO_POOL_NUM_SIZE_CLASSES; ++i) {
+    pool->sizeClasses[i].freeList = NULL;
+    pool->sizeClasses[i].position = NULL;
+    pool->sizeClasses[i].end = NULL;
+  }
+}
+
+void tloPoolDestruct(TloPool *pool) {
+  if (!pool) {
+    return;
+  }
+
+  assert(poolIsValid(pool));
+
+  while (pool->blocks) {
+    freeBlock(pool, pool->blocks);
+  }
+
+  tloPoolConstruct(pool, pool->blockAllocator);
+}
+
+TloPool *tloPoolMake(const TloAllocator *blockAllocator) {
+  if (!blockAllocator) {
+    blockAllocator = &tloCStdLibAllocator;
+  }
+
+  assert(allocatorIsValid(blockAllocator));
+
+  TloPool *pool = tloAllocatorMalloc(blockAllocator, sizeof(*pool));
+  if (!pool) {
+    return NULL;
+  }
+
+  tloPoolConstruct(pool, blockAllocator);
+
+  return pool;
+}
+
+void tloPoolDelete(TloPool *pool) {
+  if (!pool) {
+    return;
+  }
+
+  const TloAllocator *blockAllocator = pool->blockAllocator;
+  tloPoolDestruct(pool);
+  tloAllocatorSizedFree(blockAllocator, pool, sizeof(*pool));
+}
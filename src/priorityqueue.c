@@ -0,0 +1,551 @@
+#include "tlo/priorityqueue.h"
+#include <assert.h>
+#include <string.h>
+#include "list.h"
+#include "util.h"
+
+static const TloType sizeType = {.size = sizeof(size_t)};
+
+// ends the list of free handles that runs through positions
+static const size_t NO_HANDLE = SIZE_MAX;
+
+static size_t arityShiftOf(size_t arity) {
+  switch (arity) {
+    case 2:
+      return 1;
+    case 4:
+      return 2;
+    case 8:
+      return 3;
+    default:
+      return 0;
+  }
+}
+
+#ifndef NDEBUG
+static bool priorityQueueIsValid(const TloPriorityQueue *queue) {
+  if (!queue || !listIsValid(&queue->values.list) ||
+      !queue->values.list.valueType->compare || queue->arityShift < 1 ||
+      queue->arityShift > 3 || !queue->scratch) {
+    return false;
+  }
+
+  return !queue->hasHandles ||
+         (listIsValid(&queue->handles.list) &&
+          listIsValid(&queue->positions.list) &&
+          tlovListSize(&queue->handles.list) ==
+              tlovListSize(&queue->values.list));
+}
+
+static bool handleIsValid(const TloPriorityQueue *queue,
+                          TloPriorityQueueHandle handle) {
+  if (!queue->hasHandles || handle >= tlovListSize(&queue->positions.list)) {
+    return false;
+  }
+
+  const size_t *position = tlovListElement(&queue->positions.list, handle);
+  if (*position >= tlovListSize(&queue->handles.list)) {
+    return false;
+  }
+
+  const size_t *handleThere =
+      tlovListElement(&queue->handles.list, *position);
+  return *handleThere == handle;
+}
+#endif
+
+/*
+ * - the heap's arrays, taken out of their TloDArrays once per operation so
+ *   sifting doesn't go through the list functions for every element
+ * - the heap has a hole at some index while sifting. the element that's to
+ *   fill it waits in the queue's scratch space, and elements that move are
+ *   copied into the hole, leaving a new one behind, which is one copy per
+ *   level instead of the three of a swap
+ */
+typedef struct Heap {
+  unsigned char *values;
+  size_t *handles;
+  size_t *positions;
+  size_t valueSize;
+  size_t arityShift;
+  int (*compare)(const void *, const void *);
+} Heap;
+
+static Heap heapOf(TloPriorityQueue *queue) {
+  const TloType *valueType = queue->values.list.valueType;
+  Heap heap = {.valueSize = valueType->size,
+               .arityShift = queue->arityShift,
+               .compare = valueType->compare};
+
+  if (!tlovListIsEmpty(&queue->values.list)) {
+    heap.values = tlovListMutableElement(&queue->values.list, 0);
+    if (queue->hasHandles) {
+      heap.handles = tlovListMutableElement(&queue->handles.list, 0);
+      heap.positions = tlovListMutableElement(&queue->positions.list, 0);
+    }
+  }
+
+  return heap;
+}
+
+static unsigned char *elementAt(const Heap *heap, size_t index) {
+  return heap->values + index * heap->valueSize;
+}
+
+// moves the element at source into the hole at destination
+static void moveInto(const Heap *heap, size_t destination, size_t source) {
+  memcpy(elementAt(heap, destination), elementAt(heap, source),
+         heap->valueSize);
+  if (heap->handles) {
+    size_t handle = heap->handles[source];
+    heap->handles[destination] = handle;
+    heap->positions[handle] = destination;
+  }
+}
+
+static void fillHole(const Heap *heap, size_t index, const void *value,
+                     size_t handle) {
+  memcpy(elementAt(heap, index), value, heap->valueSize);
+  if (heap->handles) {
+    heap->handles[index] = handle;
+    heap->positions[handle] = index;
+  }
+}
+
+// moves the hole at index up past the elements greater than value
+static size_t siftUp(const Heap *heap, size_t index, const void *value) {
+  while (index > 0) {
+    size_t parent = (index - 1) >> heap->arityShift;
+    if (heap->compare(value, elementAt(heap, parent)) >= 0) {
+      break;
+    }
+    moveInto(heap, index, parent);
+    index = parent;
+  }
+
+  return index;
+}
+
+/*
+ * - moves the hole at index down past the children less than value, among
+ *   the first size elements
+ */
+static size_t siftDown(const Heap *heap, size_t index, size_t size,
+                       const void *value) {
+  for (;;) {
+    size_t first = (index << heap->arityShift) + 1;
+    if (first >= size) {
+      break;
+    }
+
+    size_t end = first + ((size_t)1 << heap->arityShift);
+    if (end > size) {
+      end = size;
+    }
+
+    size_t least = first;
+    for (size_t child = first + 1; child < end; ++child) {
+      if (heap->compare(elementAt(heap, child), elementAt(heap, least)) < 0) {
+        least = child;
+      }
+    }
+
+    if (heap->compare(elementAt(heap, least), value) >= 0) {
+      break;
+    }
+    moveInto(heap, index, least);
+    index = least;
+  }
+
+  return index;
+}
+
+// arranges the elements into a heap bottom up, starting from the last parent
+static void heapify(TloPriorityQueue *queue) {
+  size_t size = tlovListSize(&queue->values.list);
+  if (size < 2) {
+    return;
+  }
+
+  Heap heap = heapOf(queue);
+  for (size_t index = ((size - 2) >> heap.arityShift) + 1; index-- > 0;) {
+    memcpy(queue->scratch, elementAt(&heap, index), heap.valueSize);
+    size_t handle = heap.handles ? heap.handles[index] : NO_HANDLE;
+    fillHole(&heap, siftDown(&heap, index, size, queue->scratch),
+             queue->scratch, handle);
+  }
+}
+
+/*
+ * - constructs everything but queue's values, which are constructed with
+ *   capacity elements
+ * - if hasHandles is true, gives handles 0 through count - 1 to the first
+ *   count elements, which must fit in capacity
+ */
+static TloError constructWithCapacity(TloPriorityQueue *queue,
+                                      const TloType *valueType,
+                                      const TloAllocator *allocator,
+                                      size_t arity, bool hasHandles,
+                                      size_t capacity, size_t count) {
+  queue->arityShift = arityShiftOf(arity);
+  if (!queue->arityShift) {
+    return TLO_ERROR;
+  }
+
+  queue->scratch = tloAllocatorMalloc(allocator, valueType->size);
+  if (!queue->scratch) {
+    goto error0;
+  }
+
+  queue->hasHandles = hasHandles;
+  queue->firstFreeHandle = NO_HANDLE;
+  if (hasHandles) {
+    if (tloDArrayConstruct(&queue->handles, &sizeType, allocator, capacity) !=
+        TLO_SUCCESS) {
+      goto error1;
+    }
+    if (tloDArrayConstruct(&queue->positions, &sizeType, allocator,
+                           capacity) != TLO_SUCCESS) {
+      goto error2;
+    }
+
+    // within capacity, so these can't fail
+    for (size_t i = 0; i < count; ++i) {
+      tlovListPushBack(&queue->handles.list, &i);
+      tlovListPushBack(&queue->positions.list, &i);
+    }
+  }
+
+  return TLO_SUCCESS;
+
+error2:
+  tlovListDestruct(&queue->handles.list);
+error1:
+  tloAllocatorSizedFree(allocator, queue->scratch, valueType->size);
+error0:
+  return TLO_ERROR;
+}
+
+TloError tloPriorityQueueConstruct(TloPriorityQueue *queue,
+                                   const TloType *valueType,
+                                   const TloAllocator *allocator,
+                                   size_t arity, bool hasHandles) {
+  assert(queue);
+  assert(typeIsValid(valueType));
+  assert(valueType->compare);
+  assert(allocator == NULL || allocatorIsValid(allocator));
+  assert(arityShiftOf(arity));
+
+  if (!allocator) {
+    allocator = &tloCStdLibAllocator;
+  }
+
+  if (constructWithCapacity(queue, valueType, allocator, arity, hasHandles, 0,
+                            0) != TLO_SUCCESS) {
+    return TLO_ERROR;
+  }
+
+  // with a capacity of 0, nothing is allocated, so this can't fail
+  tloDArrayConstruct(&queue->values, valueType, allocator, 0);
+  return TLO_SUCCESS;
+}
+
+TloError tloPriorityQueueConstructFromDArray(TloPriorityQueue *queue,
+                                             TloDArray *array, size_t arity,
+                                             bool hasHandles) {
+  assert(queue);
+  assert(array && listIsValid(&array->list));
+  assert(array->list.valueType->compare);
+  assert(arityShiftOf(arity));
+
+  const TloType *valueType = array->list.valueType;
+  const TloAllocator *allocator = array->list.allocator;
+  size_t size = tlovListSize(&array->list);
+
+  if (constructWithCapacity(queue, valueType, allocator, arity, hasHandles,
+                            size, size) != TLO_SUCCESS) {
+    return TLO_ERROR;
+  }
+
+  // a TloDArray doesn't point into itself, so it can be moved with its
+  // struct. array gets a new empty one, which can't fail without a capacity
+  queue->values = *array;
+  tloDArrayConstruct(array, valueType, allocator, 0);
+
+  heapify(queue);
+  return TLO_SUCCESS;
+}
+
+void tloPriorityQueueDestruct(TloPriorityQueue *queue) {
+  if (!queue) {
+    return;
+  }
+
+  assert(priorityQueueIsValid(queue));
+
+  const TloType *valueType = queue->values.list.valueType;
+  const TloAllocator *allocator = queue->values.list.allocator;
+  tlovListDestruct(&queue->values.list);
+  if (queue->hasHandles) {
+    tlovListDestruct(&queue->positions.list);
+    tlovListDestruct(&queue->handles.list);
+  }
+  tloAllocatorSizedFree(allocator, queue->scratch, valueType->size);
+  queue->scratch = NULL;
+}
+
+TloPriorityQueue *tloPriorityQueueMake(const TloType *valueType,
+                                       const TloAllocator *allocator,
+                                       size_t arity, bool hasHandles) {
+  assert(typeIsValid(valueType));
+  assert(valueType->compare);
+  assert(arityShiftOf(arity));
+
+  if (!allocator) {
+    allocator = &tloCStdLibAllocator;
+  }
+
+  assert(allocatorIsValid(allocator));
+
+  TloPriorityQueue *queue = tloAllocatorMalloc(allocator, sizeof(*queue));
+  if (!queue) {
+    return NULL;
+  }
+
+  if (tloPriorityQueueConstruct(queue, valueType, allocator, arity,
+                                hasHandles) != TLO_SUCCESS) {
+    tloAllocatorSizedFree(allocator, queue, sizeof(*queue));
+    return NULL;
+  }
+
+  return queue;
+}
+
+TloPriorityQueue *tloPriorityQueueMakeFromDArray(TloDArray *array,
+                                                 size_t arity,
+                                                 bool hasHandles) {
+  assert(array && listIsValid(&array->list));
+  assert(array->list.valueType->compare);
+  assert(arityShiftOf(arity));
+
+  const TloAllocator *allocator = array->list.allocator;
+  TloPriorityQueue *queue = tloAllocatorMalloc(allocator, sizeof(*queue));
+  if (!queue) {
+    return NULL;
+  }
+
+  if (tloPriorityQueueConstructFromDArray(queue, array, arity, hasHandles) !=
+      TLO_SUCCESS) {
+    tloAllocatorSizedFree(allocator, queue, sizeof(*queue));
+    return NULL;
+  }
+
+  return queue;
+}
+
+void tloPriorityQueueDelete(TloPriorityQueue *queue) {
+  if (!queue) {
+    return;
+  }
+
+  const TloAllocator *allocator = queue->values.list.allocator;
+  tloPriorityQueueDestruct(queue);
+  tloAllocatorSizedFree(allocator, queue, sizeof(*queue));
+}
+
+size_t tloPriorityQueueSize(const TloPriorityQueue *queue) {
+  assert(priorityQueueIsValid(queue));
+
+  return tlovListSize(&queue->values.list);
+}
+
+bool tloPriorityQueueIsEmpty(const TloPriorityQueue *queue) {
+  assert(priorityQueueIsValid(queue));
+
+  return tlovListIsEmpty(&queue->values.list);
+}
+
+static size_t *positionOf(TloPriorityQueue *queue,
+                          TloPriorityQueueHandle handle) {
+  return tlovListMutableElement(&queue->positions.list, handle);
+}
+
+// takes a handle off the free list, or makes a new one
+static TloError takeHandle(TloPriorityQueue *queue,
+                           TloPriorityQueueHandle *handle) {
+  if (queue->firstFreeHandle != NO_HANDLE) {
+    *handle = queue->firstFreeHandle;
+    queue->firstFreeHandle = *positionOf(queue, *handle);
+    return TLO_SUCCESS;
+  }
+
+  *handle = tlovListSize(&queue->positions.list);
+  return tlovListPushBack(&queue->positions.list, &NO_HANDLE);
+}
+
+static void freeHandle(TloPriorityQueue *queue,
+                       TloPriorityQueueHandle handle) {
+  *positionOf(queue, handle) = queue->firstFreeHandle;
+  queue->firstFreeHandle = handle;
+}
+
+/*
+ * - the new element goes on the back of values, where the TloDArray copies
+ *   value or moves movedValue in, then is sifted up
+ * - its handle is pushed first, since a moved element can't be given back
+ *   once values has taken it
+ */
+static TloError push(TloPriorityQueue *queue, const void *value,
+                     void *movedValue, TloPriorityQueueHandle *handle) {
+  TloPriorityQueueHandle newHandle = NO_HANDLE;
+  if (queue->hasHandles) {
+    if (takeHandle(queue, &newHandle) != TLO_SUCCESS) {
+      return TLO_ERROR;
+    }
+    if (tlovListPushBack(&queue->handles.list, &newHandle) != TLO_SUCCESS) {
+      goto error0;
+    }
+  }
+
+  TloError error = movedValue
+                       ? tlovListMoveBack(&queue->values.list, movedValue)
+                       : tlovListPushBack(&queue->values.list, value);
+  if (error != TLO_SUCCESS) {
+    goto error1;
+  }
+
+  Heap heap = heapOf(queue);
+  size_t last = tlovListSize(&queue->values.list) - 1;
+  memcpy(queue->scratch, elementAt(&heap, last), heap.valueSize);
+  fillHole(&heap, siftUp(&heap, last, queue->scratch), queue->scratch,
+           newHandle);
+
+  if (handle) {
+    *handle = newHandle;
+  }
+  return TLO_SUCCESS;
+
+error1:
+  if (queue->hasHandles) {
+    tlovListPopBack(&queue->handles.list);
+  }
+error0:
+  if (queue->hasHandles) {
+    freeHandle(queue, newHandle);
+  }
+  return TLO_ERROR;
+}
+
+TloError tloPriorityQueuePush(TloPriorityQueue *queue, const void *value,
+                              TloPriorityQueueHandle *handle) {
+  assert(priorityQueueIsValid(queue));
+  assert(value);
+  assert(!handle || queue->hasHandles);
+
+  return push(queue, value, NULL, handle);
+}
+
+TloError tloPriorityQueueMove(TloPriorityQueue *queue, void *value,
+                              TloPriorityQueueHandle *handle) {
+  assert(priorityQueueIsValid(queue));
+  assert(value);
+  assert(!handle || queue->hasHandles);
+
+  return push(queue, NULL, value, handle);
+}
+
+const void *tloPriorityQueueTop(const TloPriorityQueue *queue) {
+  assert(priorityQueueIsValid(queue));
+  assert(!tlovListIsEmpty(&queue->values.list));
+
+  return tlovListFront(&queue->values.list);
+}
+
+TloPriorityQueueHandle tloPriorityQueueTopHandle(
+    const TloPriorityQueue *queue) {
+  assert(priorityQueueIsValid(queue));
+  assert(queue->hasHandles);
+  assert(!tlovListIsEmpty(&queue->values.list));
+
+  const size_t *handle = tlovListFront(&queue->handles.list);
+  return *handle;
+}
+
+/*
+ * - removes the element at index. the last element takes its place and is
+ *   sifted up or down from there
+ * - the removed element is first moved to the back, so the TloDArray's
+ *   pop back destructs it, and no object is ever in two places
+ */
+static void removeAt(TloPriorityQueue *queue, size_t index) {
+  Heap heap = heapOf(queue);
+  size_t last = tlovListSize(&queue->values.list) - 1;
+
+  if (heap.handles) {
+    freeHandle(queue, heap.handles[index]);
+  }
+
+  if (index != last) {
+    memcpy(queue->scratch, elementAt(&heap, last), heap.valueSize);
+    memcpy(elementAt(&heap, last), elementAt(&heap, index), heap.valueSize);
+    size_t handle = heap.handles ? heap.handles[last] : NO_HANDLE;
+
+    size_t newIndex = siftUp(&heap, index, queue->scratch);
+    if (newIndex == index) {
+      newIndex = siftDown(&heap, index, last, queue->scratch);
+    }
+    fillHole(&heap, newIndex, queue->scratch, handle);
+  }
+
+  tlovListPopBack(&queue->values.list);
+  if (queue->hasHandles) {
+    tlovListPopBack(&queue->handles.list);
+  }
+}
+
+void tloPriorityQueuePop(TloPriorityQueue *queue) {
+  assert(priorityQueueIsValid(queue));
+  assert(!tlovListIsEmpty(&queue->values.list));
+
+  removeAt(queue, 0);
+}
+
+const void *tloPriorityQueueValue(const TloPriorityQueue *queue,
+                                  TloPriorityQueueHandle handle) {
+  assert(priorityQueueIsValid(queue));
+  assert(handleIsValid(queue, handle));
+
+  const size_t *position = tlovListElement(&queue->positions.list, handle);
+  return tlovListElement(&queue->values.list, *position);
+}
+
+TloError tloPriorityQueueDecreaseKey(TloPriorityQueue *queue,
+                                     TloPriorityQueueHandle handle,
+                                     const void *value) {
+  assert(priorityQueueIsValid(queue));
+  assert(handleIsValid(queue, handle));
+  assert(value);
+
+  const TloType *valueType = queue->values.list.valueType;
+  if (tloTypeConstructCopy(valueType, queue->scratch, value) != TLO_SUCCESS) {
+    return TLO_ERROR;
+  }
+
+  Heap heap = heapOf(queue);
+  size_t index = heap.positions[handle];
+  unsigned char *element = elementAt(&heap, index);
+  assert(heap.compare(queue->scratch, element) <= 0);
+
+  tloTypeDestruct(valueType, element);
+  fillHole(&heap, siftUp(&heap, index, queue->scratch), queue->scratch,
+           handle);
+  return TLO_SUCCESS;
+}
+
+void tloPriorityQueueRemove(TloPriorityQueue *queue,
+                            TloPriorityQueueHandle handle) {
+  assert(priorityQueueIsValid(queue));
+  assert(handleIsValid(queue, handle));
+
+  removeAt(queue, *positionOf(queue, handle));
+}
@@ -22,16 +22,17 @@ typedef void (*DeleteNodeFunction)(const void *setOrMap, TloSCHTNode *node);
 static void deleteSetNode(const void *setOrMap, TloSCHTNode *node) {
   const TloSet *set = (const TloSet *)setOrMap;
   tloTypeDestruct(set->keyType, node->data);
-  set->allocator->free(node->data);
-  set->allocator->free(node);
+  tloAllocatorSizedFree(set->allocator, node->data, set->keyType->size);
+  tloAllocatorSizedFree(set->allocator, node, sizeof(*node));
 }
 
 static void deleteMapNode(const void *setOrMap, TloSCHTNode *node) {
   const TloMap *map = (const TloMap *)setOrMap;
   tloTypeDestruct(map->valueType, node->data + map->keyType->size);
   tloTypeDestruct(map->keyType, node->data);
-  map->allocator->free(node->data);
-  map->allocator->free(node);
+  tloAllocatorSizedFree(map->allocator, node->data,
+                        map->keyType->size + map->valueType->size);
+  tloAllocatorSizedFree(map->allocator, node, sizeof(*node));
 }
 
 static void deleteAllNodesAndFreeArray(TloSCHTable *table,
@@ -48,7 +49,8 @@ static void deleteAllNodesAndFreeArray(TloSCHTable *table,
     }
   }
 
-  allocator->free(table->array);
+  tloAllocatorSizedFree(allocator, table->array,
+                        table->capacity * sizeof(*table->array));
   table->array = NULL;
 }
 
@@ -189,12 +191,12 @@ static void *schtableMapFindMutable(TloMap *map, const void *key) {
 
 static TloSCHTNode *makeSetNodeWithCopiedData(const TloSet *set,
                                               const void *key) {
-  TloSCHTNode *node = set->allocator->malloc(sizeof(*node));
+  TloSCHTNode *node = tloAllocatorMalloc(set->allocator, sizeof(*node));
   if (!node) {
     goto error0;
   }
 
-  node->data = set->allocator->malloc(set->keyType->size);
+  node->data = tloAllocatorMalloc(set->allocator, set->keyType->size);
   if (!node->data) {
     goto error1;
   }
@@ -207,16 +209,16 @@ static TloSCHTNode *makeSetNodeWithCopiedData(const TloSet *set,
   return node;
 
 error2:
-  set->allocator->free(node->data);
+  tloAllocatorSizedFree(set->allocator, node->data, set->keyType->size);
 error1:
-  set->allocator->free(node);
+  tloAllocatorSizedFree(set->allocator, node, sizeof(*node));
 error0:
   return NULL;
 }
 
 static TloSCHTNode *makeSetNodeWithMovedData(const TloAllocator *allocator,
                                              void *key) {
-  TloSCHTNode *node = allocator->malloc(sizeof(*node));
+  TloSCHTNode *node = tloAllocatorMalloc(allocator, sizeof(*node));
   if (!node) {
     return NULL;
   }
@@ -230,13 +232,13 @@ static TloSCHTNode *makeMapNode(const TloMap *map,
                                 TloInsertMethod keyInsertMethod, void *key,
                                 TloInsertMethod valueInsertMethod,
                                 void *value) {
-  TloSCHTNode *node = map->allocator->malloc(sizeof(*node));
+  TloSCHTNode *node = tloAllocatorMalloc(map->allocator, sizeof(*node));
   if (!node) {
     goto error0;
   }
 
-  node->data =
-      map->allocator->malloc(map->keyType->size + map->valueType->size);
+  node->data = tloAllocatorMalloc(map->allocator,
+                                  map->keyType->size + map->valueType->size);
   if (!node->data) {
     goto error1;
   }
@@ -247,7 +249,7 @@ static TloSCHTNode *makeMapNode(const TloMap *map,
     }
   } else if (valueInsertMethod == TLO_MOVE) {
     memcpy(node->data, key, map->keyType->size);
-    map->allocator->free(key);
+    tloAllocatorSizedFree(map->allocator, key, map->keyType->size);
   } else {
     goto error2;
   }
@@ -259,7 +261,7 @@ static TloSCHTNode *makeMapNode(const TloMap *map,
     }
   } else if (valueInsertMethod == TLO_MOVE) {
     memcpy(node->data + map->keyType->size, value, map->valueType->size);
-    map->allocator->free(value);
+    tloAllocatorSizedFree(map->allocator, value, map->valueType->size);
   } else {
     goto error3;
   }
@@ -270,9 +272,10 @@ static TloSCHTNode *makeMapNode(const TloMap *map,
 error3:
   tloTypeDestruct(map->keyType, node->data);
 error2:
-  map->allocator->free(node->data);
+  tloAllocatorSizedFree(map->allocator, node->data,
+                        map->keyType->size + map->valueType->size);
 error1:
-  map->allocator->free(node);
+  tloAllocatorSizedFree(map->allocator, node, sizeof(*node));
 error0:
   return NULL;
 }
@@ -282,8 +285,8 @@ enum { STARTING_CAPACITY = 1 };
 static TloError allocateArrayIfNeeded(TloSCHTable *table,
                                       const TloAllocator *allocator) {
   if (!table->array) {
-    table->array = tloAllocatorMallocAndZeroInitialize(
-        allocator, STARTING_CAPACITY * sizeof(*table->array));
+    table->array = tloAllocatorCalloc(allocator, STARTING_CAPACITY,
+                                      sizeof(*table->array));
     if (!table->array) {
       return TLO_ERROR;
     }
@@ -301,8 +304,12 @@ static void insertAllNodesOfOther(TloSCHTable *table, const TloSCHTable *other,
                                   const TloType *keyType,
                                   const TloAllocator *allocator) {
   for (size_t i = 0; i < other->capacity; ++i) {
-    for (TloSCHTNode *node = other->array[i]; node; node = node->next) {
+    TloSCHTNode *node = other->array[i];
+
+    while (node) {
+      TloSCHTNode *next = node->next;
       insertNode(table, keyType, allocator, NULL, node);
+      node = next;
     }
   }
 }
@@ -314,14 +321,15 @@ static TloError expandArrayIfNeeded(TloSCHTable *table, const TloType *keyType,
 
     newTable.size = 0;
     newTable.capacity = table->capacity * 2;
-    newTable.array = tloAllocatorMallocAndZeroInitialize(
-        allocator, newTable.capacity * sizeof(*newTable.array));
+    newTable.array = tloAllocatorCalloc(allocator, newTable.capacity,
+                                        sizeof(*newTable.array));
     if (!newTable.array) {
       return TLO_ERROR;
     }
 
     insertAllNodesOfOther(&newTable, table, keyType, allocator);
-    allocator->free(table->array);
+    tloAllocatorSizedFree(allocator, table->array,
+                          table->capacity * sizeof(*table->array));
     table->array = newTable.array;
     table->capacity = newTable.capacity;
   }
@@ -348,10 +356,7 @@ static TloError insertNode(TloSCHTable *table, const TloType *keyType,
     index = tloTypeHash(keyType, node->data) % table->capacity;
   }
 
-  if (table->array[index]) {
-    node->next = table->array[index];
-  }
-
+  node->next = table->array[index];
   table->array[index] = node;
   ++table->size;
   return TLO_SUCCESS;
@@ -446,14 +451,15 @@ static void shrinkArrayIfNeeded(TloSCHTable *table, const TloType *keyType,
 
     newTable.size = 0;
     newTable.capacity = table->capacity / 2;
-    newTable.array = tloAllocatorMallocAndZeroInitialize(
-        allocator, newTable.capacity * sizeof(*newTable.array));
+    newTable.array = tloAllocatorCalloc(allocator, newTable.capacity,
+                                        sizeof(*newTable.array));
     if (!newTable.array) {
       return;
     }
 
     insertAllNodesOfOther(&newTable, table, keyType, allocator);
-    allocator->free(table->array);
+    tloAllocatorSizedFree(allocator, table->array,
+                          table->capacity * sizeof(*table->array));
     table->array = newTable.array;
     table->capacity = newTable.capacity;
   }
@@ -465,7 +471,7 @@ static void remove(TloSCHTable *table, const TloType *keyType,
   if (result->prev) {
     result->prev->next = result->node->next;
   } else {
-    table->array[result->index] = NULL;
+    table->array[result->index] = result->node->next;
   }
 
   deleteNode(setOrMap, result->node);
@@ -563,7 +569,7 @@ TloSCHTableSet *tloSCHTableSetMake(const TloType *keyType,
 
   assert(allocatorIsValid(allocator));
 
-  TloSCHTableSet *htset = allocator->malloc(sizeof(*htset));
+  TloSCHTableSet *htset = tloAllocatorMalloc(allocator, sizeof(*htset));
   if (!htset) {
     return NULL;
   }
@@ -584,7 +590,7 @@ TloSCHTableMap *tloSCHTableMapMake(const TloType *keyType,
 
   assert(allocatorIsValid(allocator));
 
-  TloSCHTableMap *htmap = allocator->malloc(sizeof(*htmap));
+  TloSCHTableMap *htmap = tloAllocatorMalloc(allocator, sizeof(*htmap));
   if (!htmap) {
     return NULL;
   }
@@ -33,7 +33,7 @@ void tloSetDelete(TloSet *set) {
   assert(setIsValid(set));
 
   tlovSetDestruct(set);
-  set->allocator->free(set);
+  tloAllocatorFree(set->allocator, set);
 }
 
 const TloType *tloSetKeyType(const TloSet *set) {
@@ -0,0 +1,834 @@
+#include "tlo/skiplist.h"
+#include <assert.h>
+#include <string.h>
+#include "util.h"
+
+/*
+ * - a node is this header, then its key and value, each starting on a
+ *   max_align_t boundary like the elements of the other containers, then one
+ *   link per level it's in
+ * - a link is the address of the next node in that level, or 0 at the end,
+ *   with its lowest bit set once the node it's in is being removed. marking
+ *   level 0 is what removes a key, and only one thread can do that
+ * - retiredEpoch and nextRetired are only used once the node is removed, to
+ *   queue it on the remover's TloSkipListThread until it can be freed
+ */
+typedef struct TloSkipListNode {
+  size_t height;
+  size_t retiredEpoch;
+  struct TloSkipListNode *nextRetired;
+} TloSkipListNode;
+
+enum {
+  ALIGNMENT = _Alignof(max_align_t),
+  KEY_OFFSET = (sizeof(TloSkipListNode) + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT
+};
+
+static const uintptr_t MARK = 1;
+
+/*
+ * - a thread tries to move the epoch along after this many removals. each try
+ *   reads every thread's pinned epoch, and a node can only be freed two
+ *   epochs after it was removed
+ */
+enum { NUM_RETIRED_PER_ADVANCE = 64 };
+
+/*
+ * - threads are only ever added to their map's list, so it can be walked
+ *   without locking. detached ones are reused by the next thread to attach
+ * - pinnedEpoch is twice the epoch the thread pinned in plus 1, or 0 when it
+ *   isn't pinned. the rest is only touched by the thread it's attached to
+ * - numInserted and numRemoved are atomic so tloSkipListMapSize can read
+ *   them. an insert is counted after its node is linked in and a removal
+ *   before its node is marked, so the counts never hold more keys than map
+ */
+struct TloSkipListThread {
+  TloSkipListMap *map;
+  TloSkipListThread *next;
+  atomic_bool isAttached;
+  atomic_size_t pinnedEpoch;
+  size_t pinDepth;
+  TloSkipListNode *firstRetired;
+  TloSkipListNode *lastRetired;
+  size_t numRetiredSinceAdvance;
+  atomic_size_t numInserted;
+  atomic_size_t numRemoved;
+  uint64_t randomState;
+
+  // pinnedEpoch is written on every operation, so keeps it off the next
+  // thread's cache line
+  unsigned char padding[TLO_CACHE_LINE_SIZE];
+};
+
+static size_t roundUpToAlignment(size_t size) {
+  return (size + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT;
+}
+
+#ifndef NDEBUG
+static bool skiplistMapIsValid(const TloSkipListMap *map) {
+  return map && typeIsValid(map->keyType) && map->keyType->compare &&
+         typeIsValid(map->valueType) && allocatorIsValid(map->allocator) &&
+         map->valueOffset ==
+             KEY_OFFSET + roundUpToAlignment(map->keyType->size) &&
+         map->nextOffset ==
+             map->valueOffset + roundUpToAlignment(map->valueType->size);
+}
+
+static bool threadIsValid(const TloSkipListThread *thread) {
+  return thread && skiplistMapIsValid(thread->map) &&
+         atomic_load_explicit(&thread->isAttached, memory_order_relaxed);
+}
+
+static bool isPinned(const TloSkipListThread *thread) {
+  return threadIsValid(thread) && thread->pinDepth > 0;
+}
+
+static bool cursorIsValid(const TloSkipListCursor *cursor) {
+  return cursor && isPinned(cursor->thread);
+}
+#endif
+
+static TloSkipListNode *pointerOf(uintptr_t link) {
+  return (TloSkipListNode *)(link & ~MARK);
+}
+
+static bool isMarked(uintptr_t link) { return link & MARK; }
+
+static unsigned char *keyAt(TloSkipListNode *node) {
+  return (unsigned char *)node + KEY_OFFSET;
+}
+
+static unsigned char *valueAt(const TloSkipListMap *map,
+                              TloSkipListNode *node) {
+  return (unsigned char *)node + map->valueOffset;
+}
+
+static atomic_uintptr_t *linksOf(const TloSkipListMap *map,
+                                 TloSkipListNode *node) {
+  return (atomic_uintptr_t *)((unsigned char *)node + map->nextOffset);
+}
+
+static size_t nodeSize(const TloSkipListMap *map, size_t height) {
+  return map->nextOffset + height * sizeof(atomic_uintptr_t);
+}
+
+static int compareKeys(const TloSkipListMap *map, TloSkipListNode *node,
+                       const void *key) {
+  return map->keyType->compare(keyAt(node), key);
+}
+
+// frees the node without destructing its key and value
+static void freeNode(const TloSkipListMap *map, TloSkipListNode *node) {
+  tloAllocatorSizedFree(map->allocator, node, nodeSize(map, node->height));
+}
+
+static void deleteNode(const TloSkipListMap *map, TloSkipListNode *node) {
+  tloTypeDestruct(map->valueType, valueAt(map, node));
+  tloTypeDestruct(map->keyType, keyAt(node));
+  freeNode(map, node);
+}
+
+void tloSkipListMapConstruct(TloSkipListMap *map, const TloType *keyType,
+                             const TloType *valueType,
+                             const TloAllocator *allocator) {
+  assert(map);
+  assert(typeIsValid(keyType));
+  assert(keyType->compare);
+  assert(typeIsValid(valueType));
+  assert(allocator == NULL || allocatorIsValid(allocator));
+
+  if (!allocator) {
+    allocator = &tloCStdLibAllocator;
+  }
+
+  map->keyType = keyType;
+  map->valueType = valueType;
+  map->allocator = allocator;
+  map->valueOffset = KEY_OFFSET + roundUpToAlignment(keyType->size);
+  map->nextOffset = map->valueOffset + roundUpToAlignment(valueType->size);
+  atomic_init(&map->threads, NULL);
+  atomic_init(&map->epoch, 0);
+  for (size_t i = 0; i < TLO_SKIP_LIST_MAX_HEIGHT; ++i) {
+    atomic_init(&map->head[i], 0);
+  }
+}
+
+void tloSkipListMapDestruct(TloSkipListMap *map) {
+  if (!map) {
+    return;
+  }
+
+  assert(skiplistMapIsValid(map));
+
+  // a removal unlinks its node before returning, so every node that's still
+  // linked is one that wasn't removed
+  uintptr_t link = atomic_load_explicit(&map->head[0], memory_order_relaxed);
+  while (link) {
+    TloSkipListNode *node = pointerOf(link);
+    link = atomic_load_explicit(&linksOf(map, node)[0], memory_order_relaxed);
+    assert(!isMarked(link));
+    deleteNode(map, node);
+  }
+
+  TloSkipListThread *thread =
+      atomic_load_explicit(&map->threads, memory_order_relaxed);
+  while (thread) {
+    TloSkipListThread *next = thread->next;
+    TloSkipListNode *node = thread->firstRetired;
+    while (node) {
+      TloSkipListNode *nextRetired = node->nextRetired;
+      deleteNode(map, node);
+      node = nextRetired;
+    }
+    tloAllocatorSizedFree(map->allocator, thread, sizeof(*thread));
+    thread = next;
+  }
+
+  for (size_t i = 0; i < TLO_SKIP_LIST_MAX_HEIGHT; ++i) {
+    atomic_store_explicit(&map->head[i], 0, memory_order_relaxed);
+  }
+  atomic_store_explicit(&map->threads, NULL, memory_order_relaxed);
+}
+
+TloSkipListMap *tloSkipListMapMake(const TloType *keyType,
+                                   const TloType *valueType,
+                                   const TloAllocator *allocator) {
+  assert(typeIsValid(keyType));
+  assert(keyType->compare);
+  assert(typeIsValid(valueType));
+
+  if (!allocator) {
+    allocator = &tloCStdLibAllocator;
+  }
+
+  assert(allocatorIsValid(allocator));
+
+  TloSkipListMap *map = tloAllocatorMalloc(allocator, sizeof(*map));
+  if (!map) {
+    return NULL;
+  }
+
+  tloSkipListMapConstruct(map, keyType, valueType, allocator);
+  return map;
+}
+
+void tloSkipListMapDelete(TloSkipListMap *map) {
+  if (!map) {
+    return;
+  }
+
+  const TloAllocator *allocator = map->allocator;
+  tloSkipListMapDestruct(map);
+  tloAllocatorSizedFree(allocator, map, sizeof(*map));
+}
+
+/*
+ * - moves the epoch along if every pinned thread pinned in the current one
+ * - the fence pairs with the one in tloSkipListThreadPin: either this sees a
+ *   thread's pin, or that thread's loads see every unlink made before it
+ */
+static void tryToAdvanceEpoch(TloSkipListMap *map) {
+  size_t epoch = atomic_load(&map->epoch);
+  atomic_thread_fence(memory_order_seq_cst);
+
+  for (TloSkipListThread *thread =
+           atomic_load_explicit(&map->threads, memory_order_acquire);
+       thread; thread = thread->next) {
+    size_t pinnedEpoch = atomic_load(&thread->pinnedEpoch);
+    if (pinnedEpoch && pinnedEpoch != epoch * 2 + 1) {
+      return;
+    }
+  }
+
+  atomic_compare_exchange_strong(&map->epoch, &epoch, epoch + 1);
+}
+
+/*
+ * - frees the nodes thread removed that no pinned thread can still reach
+ * - a node removed in epoch e could have been reached by threads pinned in e
+ *   or e - 1, and the epoch can't get to e + 2 until all of those unpinned
+ */
+static void freeRetired(TloSkipListThread *thread) {
+  const TloSkipListMap *map = thread->map;
+  size_t epoch = atomic_load(&thread->map->epoch);
+
+  while (thread->firstRetired &&
+         thread->firstRetired->retiredEpoch + 2 <= epoch) {
+    TloSkipListNode *node = thread->firstRetired;
+    thread->firstRetired = node->nextRetired;
+    deleteNode(map, node);
+  }
+
+  if (!thread->firstRetired) {
+    thread->lastRetired = NULL;
+  }
+}
+
+// node must already be unlinked from every level
+static void retire(TloSkipListThread *thread, TloSkipListNode *node) {
+  node->retiredEpoch = atomic_load(&thread->map->epoch);
+  node->nextRetired = NULL;
+  if (thread->lastRetired) {
+    thread->lastRetired->nextRetired = node;
+  } else {
+    thread->firstRetired = node;
+  }
+  thread->lastRetired = node;
+
+  if (++thread->numRetiredSinceAdvance == NUM_RETIRED_PER_ADVANCE) {
+    thread->numRetiredSinceAdvance = 0;
+    tryToAdvanceEpoch(thread->map);
+  }
+  freeRetired(thread);
+}
+
+static TloSkipListThread *claimDetachedThread(TloSkipListMap *map) {
+  for (TloSkipListThread *thread =
+           atomic_load_explicit(&map->threads, memory_order_acquire);
+       thread; thread = thread->next) {
+    bool isAttached = false;
+    if (!atomic_load_explicit(&thread->isAttached, memory_order_relaxed) &&
+        atomic_compare_exchange_strong(&thread->isAttached, &isAttached,
+                                       true)) {
+      return thread;
+    }
+  }
+
+  return NULL;
+}
+
+TloSkipListThread *tloSkipListMapAttach(TloSkipListMap *map) {
+  assert(skiplistMapIsValid(map));
+
+  TloSkipListThread *thread = claimDetachedThread(map);
+  if (thread) {
+    return thread;
+  }
+
+  thread = tloAllocatorMalloc(map->allocator, sizeof(*thread));
+  if (!thread) {
+    return NULL;
+  }
+
+  thread->map = map;
+  atomic_init(&thread->isAttached, true);
+  atomic_init(&thread->pinnedEpoch, 0);
+  thread->pinDepth = 0;
+  thread->firstRetired = NULL;
+  thread->lastRetired = NULL;
+  thread->numRetiredSinceAdvance = 0;
+  atomic_init(&thread->numInserted, 0);
+  atomic_init(&thread->numRemoved, 0);
+  // any odd seed works for xorshift, and each thread gets its own
+  thread->randomState = (uint64_t)(uintptr_t)thread | 1;
+
+  thread->next = atomic_load_explicit(&map->threads, memory_order_relaxed);
+  while (!atomic_compare_exchange_weak_explicit(&map->threads, &thread->next,
+                                                thread, memory_order_release,
+                                                memory_order_relaxed)) {
+  }
+
+  return thread;
+}
+
+void tloSkipListMapDetach(TloSkipListThread *thread) {
+  if (!thread) {
+    return;
+  }
+
+  assert(threadIsValid(thread));
+  assert(thread->pinDepth == 0);
+
+  tryToAdvanceEpoch(thread->map);
+  freeRetired(thread);
+  atomic_store_explicit(&thread->isAttached, false, memory_order_release);
+}
+
+void tloSkipListThreadPin(TloSkipListThread *thread) {
+  assert(threadIsValid(thread));
+
+  if (thread->pinDepth++ == 0) {
+    size_t epoch = atomic_load(&thread->map->epoch);
+    atomic_store_explicit(&thread->pinnedEpoch, epoch * 2 + 1,
+                          memory_order_relaxed);
+    atomic_thread_fence(memory_order_seq_cst);
+  }
+}
+
+void tloSkipListThreadUnpin(TloSkipListThread *thread) {
+  assert(isPinned(thread));
+
+  if (--thread->pinDepth == 0) {
+    atomic_store_explicit(&thread->pinnedEpoch, 0, memory_order_release);
+  }
+}
+
+size_t tloSkipListMapSize(const TloSkipListMap *map) {
+  assert(skiplistMapIsValid(map));
+
+  /*
+   * - insertions read before removals, so a key that's in the counts read was
+   *   in map at some point in between, and the result is at most the number
+   *   of keys map held then
+   * - a key inserted and removed while these run can be counted as removed
+   *   but not as inserted, so the difference can go below 0, which is 0
+   */
+  size_t numInserted = 0;
+  for (const TloSkipListThread *thread =
+           atomic_load_explicit(&map->threads, memory_order_acquire);
+       thread; thread = thread->next) {
+    numInserted += atomic_load(&thread->numInserted);
+  }
+
+  size_t numRemoved = 0;
+  for (const TloSkipListThread *thread =
+           atomic_load_explicit(&map->threads, memory_order_acquire);
+       thread; thread = thread->next) {
+    numRemoved += atomic_load(&thread->numRemoved);
+  }
+
+  return numInserted > numRemoved ? numInserted - numRemoved : 0;
+}
+
+// only the thread a count belongs to changes it, so it doesn't need a
+// read-modify-write. the store is sequentially consistent so it's ordered
+// with the linking and marking of nodes
+static void incrementCount(atomic_size_t *count) {
+  atomic_store(count, atomic_load_explicit(count, memory_order_relaxed) + 1);
+}
+
+static void decrementCount(atomic_size_t *count) {
+  atomic_store(count, atomic_load_explicit(count, memory_order_relaxed) - 1);
+}
+
+// each level up holds a quarter of the nodes of the one below
+static size_t randomHeight(TloSkipListThread *thread) {
+  uint64_t state = thread->randomState;
+  state ^= state << 13;
+  state ^= state >> 7;
+  state ^= state << 17;
+  thread->randomState = state;
+
+  size_t height = 1;
+  while (height < TLO_SKIP_LIST_MAX_HEIGHT && (state & 3) == 0) {
+    ++height;
+    state >>= 2;
+  }
+  return height;
+}
+
+/*
+ * - sets links[level] to the link that points to the first node not less
+ *   than key in each level, and successors[level] to that node, or NULL
+ * - unlinks the marked nodes it comes across, and starts over if another
+ *   thread changes a link it's unlinking from
+ * - returns whether successors[0] has key
+ */
+static bool search(TloSkipListMap *map, const void *key,
+                   atomic_uintptr_t **links,
+                   TloSkipListNode **successors) {
+retry:;
+  atomic_uintptr_t *predecessorLinks = map->head;
+  // the node found at one level is often the one found at the next, so
+  // remembers it to skip comparing with it again
+  TloSkipListNode *notLess = NULL;
+
+  for (size_t level = TLO_SKIP_LIST_MAX_HEIGHT; level-- > 0;) {
+    TloSkipListNode *current = pointerOf(
+        atomic_load_explicit(&predecessorLinks[level], memory_order_acquire));
+
+    while (current) {
+      atomic_uintptr_t *currentLinks = linksOf(map, current);
+      uintptr_t next =
+          atomic_load_explicit(&currentLinks[level], memory_order_acquire);
+
+      if (isMarked(next)) {
+        uintptr_t expected = (uintptr_t)current;
+        if (!atomic_compare_exchange_strong(&predecessorLinks[level],
+                                            &expected, next & ~MARK)) {
+          goto retry;
+        }
+        current = pointerOf(next);
+        continue;
+      }
+
+      if (current == notLess || compareKeys(map, current, key) >= 0) {
+        notLess = current;
+        break;
+      }
+
+      predecessorLinks = currentLinks;
+      current = pointerOf(next);
+    }
+
+    links[level] = &predecessorLinks[level];
+    successors[level] = current;
+  }
+
+  return successors[0] && compareKeys(map, successors[0], key) == 0;
+}
+
+/*
+ * - unlinks node, which is marked in every level, from every level
+ * - unlike search, doesn't stop at a node with the same key, since a node
+ *   inserted with the key after this one was removed can be in front of it
+ */
+static void unlinkNode(TloSkipListMap *map, TloSkipListNode *node) {
+  const void *key = keyAt(node);
+
+retry:;
+  atomic_uintptr_t *predecessorLinks = map->head;
+
+  for (size_t level = TLO_SKIP_LIST_MAX_HEIGHT; level-- > 0;) {
+    TloSkipListNode *current =
+        pointerOf(atomic_load(&predecessorLinks[level]));
+
+    while (current) {
+      atomic_uintptr_t *currentLinks = linksOf(map, current);
+      uintptr_t next = atomic_load(&currentLinks[level]);
+
+      if (isMarked(next)) {
+        uintptr_t expected = (uintptr_t)current;
+        if (!atomic_compare_exchange_strong(&predecessorLinks[level],
+                                            &expected, next & ~MARK)) {
+          goto retry;
+        }
+        current = pointerOf(next);
+        continue;
+      }
+
+      if (compareKeys(map, current, key) > 0) {
+        break;
+      }
+
+      predecessorLinks = currentLinks;
+      current = pointerOf(next);
+    }
+  }
+}
+
+static TloSkipListNode *makeNode(const TloSkipListMap *map, size_t height,
+                                 TloInsertMethod keyInsertMethod, void *key,
+                                 TloInsertMethod valueInsertMethod,
+                                 void *value) {
+  if ((keyInsertMethod != TLO_COPY && keyInsertMethod != TLO_MOVE) ||
+      (valueInsertMethod != TLO_COPY && valueInsertMethod != TLO_MOVE)) {
+    return NULL;
+  }
+
+  TloSkipListNode *node =
+      tloAllocatorMalloc(map->allocator, nodeSize(map, height));
+  if (!node) {
+    return NULL;
+  }
+
+  node->height = height;
+
+  if (keyInsertMethod == TLO_COPY) {
+    if (tloTypeConstructCopy(map->keyType, keyAt(node), key) != TLO_SUCCESS) {
+      goto error0;
+    }
+  } else {
+    memcpy(keyAt(node), key, map->keyType->size);
+  }
+
+  if (valueInsertMethod == TLO_COPY) {
+    if (tloTypeConstructCopy(map->valueType, valueAt(map, node), value) !=
+        TLO_SUCCESS) {
+      goto error1;
+    }
+  } else {
+    memcpy(valueAt(map, node), value, map->valueType->size);
+  }
+
+  return node;
+
+error1:
+  if (keyInsertMethod == TLO_COPY) {
+    tloTypeDestruct(map->keyType, keyAt(node));
+  }
+error0:
+  freeNode(map, node);
+  return NULL;
+}
+
+// links node into the levels above 0, unless it's removed before it's done
+static void linkAboveLevel0(TloSkipListMap *map, TloSkipListNode *node,
+                            atomic_uintptr_t **links,
+                            TloSkipListNode **successors) {
+  atomic_uintptr_t *nodeLinks = linksOf(map, node);
+
+  for (size_t level = 1; level < node->height; ++level) {
+    for (;;) {
+      uintptr_t next = atomic_load(&nodeLinks[level]);
+      if (isMarked(next)) {
+        return;
+      }
+
+      if (pointerOf(next) != successors[level] &&
+          !atomic_compare_exchange_strong(&nodeLinks[level], &next,
+                                          (uintptr_t)successors[level])) {
+        continue;
+      }
+
+      uintptr_t expected = (uintptr_t)successors[level];
+      if (atomic_compare_exchange_strong(links[level], &expected,
+                                         (uintptr_t)node)) {
+        break;
+      }
+
+      search(map, keyAt(node), links, successors);
+    }
+  }
+}
+
+TloError tloSkipListMapInsert(TloSkipListThread *thread,
+                              TloInsertMethod keyInsertMethod, void *key,
+                              TloInsertMethod valueInsertMethod, void *value) {
+  assert(threadIsValid(thread));
+  assert(key);
+  assert(value);
+
+  TloSkipListMap *map = thread->map;
+  TloSkipListNode *node = makeNode(map, randomHeight(thread), keyInsertMethod,
+                                   key, valueInsertMethod, value);
+  if (!node) {
+    return TLO_ERROR;
+  }
+
+  atomic_uintptr_t *links[TLO_SKIP_LIST_MAX_HEIGHT];
+  TloSkipListNode *successors[TLO_SKIP_LIST_MAX_HEIGHT];
+  atomic_uintptr_t *nodeLinks = linksOf(map, node);
+
+  tloSkipListThreadPin(thread);
+
+  // the key is inserted once node is linked into level 0
+  for (;;) {
+    if (search(map, keyAt(node), links, successors)) {
+      tloSkipListThreadUnpin(thread);
+
+      if (keyInsertMethod == TLO_COPY) {
+        tloTypeDestruct(map->keyType, keyAt(node));
+      }
+      if (valueInsertMethod == TLO_COPY) {
+        tloTypeDestruct(map->valueType, valueAt(map, node));
+      }
+      freeNode(map, node);
+      return TLO_DUPLICATE;
+    }
+
+    for (size_t level = 0; level < node->height; ++level) {
+      atomic_init(&nodeLinks[level], (uintptr_t)successors[level]);
+    }
+
+    uintptr_t expected = (uintptr_t)successors[0];
+    if (atomic_compare_exchange_strong(links[0], &expected,
+                                       (uintptr_t)node)) {
+      break;
+    }
+  }
+
+  // counted only once it's linked in, see tloSkipListMapSize
+  incrementCount(&thread->numInserted);
+
+  linkAboveLevel0(map, node, links, successors);
+
+  // if node was removed while this was linking it, the remover may have
+  // unlinked it before this linked it into some level, and this is still
+  // pinned, so it can't have been freed yet
+  if (isMarked(atomic_load(&nodeLinks[0]))) {
+    unlinkNode(map, node);
+  }
+
+  tloSkipListThreadUnpin(thread);
+
+  // moved objects are only freed once nothing can fail, so a failed insert
+  // leaves them with the caller
+  if (keyInsertMethod == TLO_MOVE) {
+    tloAllocatorSizedFree(map->allocator, key, map->keyType->size);
+  }
+  if (valueInsertMethod == TLO_MOVE) {
+    tloAllocatorSizedFree(map->allocator, value, map->valueType->size);
+  }
+  return TLO_SUCCESS;
+}
+
+bool tloSkipListMapRemove(TloSkipListThread *thread, const void *key) {
+  assert(threadIsValid(thread));
+  assert(key);
+
+  TloSkipListMap *map = thread->map;
+  atomic_uintptr_t *links[TLO_SKIP_LIST_MAX_HEIGHT];
+  TloSkipListNode *successors[TLO_SKIP_LIST_MAX_HEIGHT];
+
+  tloSkipListThreadPin(thread);
+
+  if (!search(map, key, links, successors)) {
+    tloSkipListThreadUnpin(thread);
+    return false;
+  }
+
+  // marks the levels above 0 first, so once level 0 is marked nothing can be
+  // linked after node in any level
+  TloSkipListNode *node = successors[0];
+  atomic_uintptr_t *nodeLinks = linksOf(map, node);
+  for (size_t level = node->height; level-- > 1;) {
+    atomic_fetch_or(&nodeLinks[level], MARK);
+  }
+
+  // counted before it's marked and taken back if another thread marks it
+  // first, so a key is never out of map but still counted as in it
+  incrementCount(&thread->numRemoved);
+  uintptr_t next = atomic_load(&nodeLinks[0]);
+  do {
+    if (isMarked(next)) {
+      decrementCount(&thread->numRemoved);
+      tloSkipListThreadUnpin(thread);
+      return false;
+    }
+  } while (!atomic_compare_exchange_weak(&nodeLinks[0], &next, next | MARK));
+
+  unlinkNode(map, node);
+  retire(thread, node);
+
+  tloSkipListThreadUnpin(thread);
+  return true;
+}
+
+/*
+ * - returns the first node whose key is not less than key, or greater than
+ *   key if isStrict is true, and that isn't being removed. returns NULL if
+ *   there isn't one
+ * - steps over marked nodes instead of unlinking them, so readers never write
+ *   to the list
+ */
+static TloSkipListNode *findFirstAfter(const TloSkipListMap *map,
+                                       const void *key, bool isStrict) {
+  const atomic_uintptr_t *predecessorLinks = map->head;
+  TloSkipListNode *current = NULL;
+  TloSkipListNode *after = NULL;
+
+  for (size_t level = TLO_SKIP_LIST_MAX_HEIGHT; level-- > 0;) {
+    current = pointerOf(
+        atomic_load_explicit(&predecessorLinks[level], memory_order_acquire));
+
+    while (current) {
+      atomic_uintptr_t *currentLinks = linksOf(map, current);
+      uintptr_t next =
+          atomic_load_explicit(&currentLinks[level], memory_order_acquire);
+
+      if (!isMarked(next)) {
+        if (current == after) {
+          break;
+        }
+
+        int result = compareKeys(map, current, key);
+        if (isStrict ? result > 0 : result >= 0) {
+          after = current;
+          break;
+        }
+        predecessorLinks = currentLinks;
+      }
+
+      current = pointerOf(next);
+    }
+  }
+
+  return current;
+}
+
+// returns the first node from link on that isn't being removed, or NULL
+static TloSkipListNode *firstUnmarkedFrom(const TloSkipListMap *map,
+                                          uintptr_t link) {
+  TloSkipListNode *node = pointerOf(link);
+  while (node) {
+    uintptr_t next =
+        atomic_load_explicit(&linksOf(map, node)[0], memory_order_acquire);
+    if (!isMarked(next)) {
+      break;
+    }
+    node = pointerOf(next);
+  }
+
+  return node;
+}
+
+const void *tloSkipListMapFind(const TloSkipListThread *thread,
+                               const void *key) {
+  assert(isPinned(thread));
+  assert(key);
+
+  const TloSkipListMap *map = thread->map;
+  TloSkipListNode *node = findFirstAfter(map, key, false);
+  if (!node || compareKeys(map, node, key) != 0) {
+    return NULL;
+  }
+
+  return valueAt(map, node);
+}
+
+void tloSkipListMapFirst(const TloSkipListThread *thread,
+                         TloSkipListCursor *cursor) {
+  assert(isPinned(thread));
+  assert(cursor);
+
+  const TloSkipListMap *map = thread->map;
+  cursor->thread = thread;
+  cursor->node = firstUnmarkedFrom(
+      map, atomic_load_explicit(&map->head[0], memory_order_acquire));
+}
+
+void tloSkipListMapLowerBound(const TloSkipListThread *thread,
+                              const void *key, TloSkipListCursor *cursor) {
+  assert(isPinned(thread));
+  assert(key);
+  assert(cursor);
+
+  cursor->thread = thread;
+  cursor->node = findFirstAfter(thread->map, key, false);
+}
+
+void tloSkipListMapUpperBound(const TloSkipListThread *thread,
+                              const void *key, TloSkipListCursor *cursor) {
+  assert(isPinned(thread));
+  assert(key);
+  assert(cursor);
+
+  cursor->thread = thread;
+  cursor->node = findFirstAfter(thread->map, key, true);
+}
+
+bool tloSkipListCursorIsEnd(const TloSkipListCursor *cursor) {
+  assert(cursorIsValid(cursor));
+
+  return !cursor->node;
+}
+
+const void *tloSkipListCursorKey(const TloSkipListCursor *cursor) {
+  assert(cursorIsValid(cursor));
+  assert(cursor->node);
+
+  return keyAt(cursor->node);
+}
+
+const void *tloSkipListCursorValue(const TloSkipListCursor *cursor) {
+  assert(cursorIsValid(cursor));
+  assert(cursor->node);
+
+  return valueAt(cursor->thread->map, cursor->node);
+}
+
+/*
+ * - a removed node's level 0 link still points to the node after it, which
+ *   is kept from being freed the same way, so the cursor can go on from a
+ *   node that was removed under it
+ */
+void tloSkipListCursorNext(TloSkipListCursor *cursor) {
+  assert(cursorIsValid(cursor));
+  assert(cursor->node);
+
+  const TloSkipListMap *map = cursor->thread->map;
+  cursor->node = firstUnmarkedFrom(
+      map, atomic_load_explicit(&linksOf(map, cursor->node)[0],
+                                memory_order_acquire));
+}
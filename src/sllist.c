@@ -16,10 +16,14 @@ static bool sllistIsValid(const TloList *list) {
 }
 #endif
 
+// the element is stored inline, right after the node's links
+static size_t nodeSize(const TloSLList *llist) {
+  return sizeof(TloSLLNode) + llist->list.valueType->size;
+}
+
 static void deleteNode(TloSLList *llist, TloSLLNode *node) {
   tloTypeDestruct(llist->list.valueType, node->data);
-  llist->list.allocator->free(node->data);
-  llist->list.allocator->free(node);
+  tloAllocatorSizedFree(llist->list.allocator, node, nodeSize(llist));
 }
 
 static void deleteAllNodes(TloSLList *llist) {
@@ -97,21 +101,14 @@ static void *sllistMutableBack(TloList *list) {
 }
 
 static TloSLLNode *makeNodeWithCopiedData(TloSLList *llist, const void *data) {
-  TloSLLNode *node = llist->list.allocator->malloc(sizeof(*node));
+  TloSLLNode *node = tloAllocatorMalloc(llist->list.allocator, nodeSize(llist));
   if (!node) {
     return NULL;
   }
 
-  node->data = llist->list.allocator->malloc(llist->list.valueType->size);
-  if (!node->data) {
-    llist->list.allocator->free(node);
-    return NULL;
-  }
-
   if (tloTypeConstructCopy(llist->list.valueType, node->data, data) !=
       TLO_SUCCESS) {
-    llist->list.allocator->free(node->data);
-    llist->list.allocator->free(node);
+    tloAllocatorSizedFree(llist->list.allocator, node, nodeSize(llist));
     return NULL;
   }
 
@@ -147,12 +144,15 @@ static TloError sllistPushBack(TloList *list, const void *data) {
 }
 
 static TloSLLNode *makeNodeWithMovedData(TloSLList *llist, void *data) {
-  TloSLLNode *node = llist->list.allocator->malloc(sizeof(*node));
+  TloSLLNode *node = tloAllocatorMalloc(llist->list.allocator, nodeSize(llist));
   if (!node) {
     return NULL;
   }
 
-  node->data = data;
+  memcpy(node->data, data, llist->list.valueType->size);
+  tloAllocatorSizedFree(llist->list.allocator, data,
+                        llist->list.valueType->size);
+
   node->next = NULL;
   return node;
 }
@@ -291,7 +291,7 @@ TloSLList *tloSLListMake(const TloType *valueType,
 
   assert(allocatorIsValid(allocator));
 
-  TloSLList *llist = allocator->malloc(sizeof(*llist));
+  TloSLList *llist = tloAllocatorMalloc(allocator, sizeof(*llist));
   if (!llist) {
     return NULL;
   }
@@ -304,13 +304,14 @@ TloSLList *tloSLListMake(const TloType *valueType,
 TloSLList *tloSLListMakeCopy(const TloSLList *other) {
   assert(sllistIsValid(&other->list));
 
-  TloSLList *llist = other->list.allocator->malloc(sizeof(*llist));
+  TloSLList *llist =
+      tloAllocatorMalloc(other->list.allocator, sizeof(*llist));
   if (!llist) {
     return NULL;
   }
 
   if (tloSLListConstructCopy(llist, other) != TLO_SUCCESS) {
-    other->list.allocator->free(llist);
+    tloAllocatorSizedFree(other->list.allocator, llist, sizeof(*llist));
     return NULL;
   }
 
@@ -346,7 +347,7 @@ TloSLLNode *tloSLListMutableHead(TloSLList *llist) {
 
 #ifndef NDEBUG
 static bool sllnodeIsValid(const TloSLLNode *node) {
-  return node && node->data;
+  return node != NULL;
 }
 #endif
 
@@ -0,0 +1,646 @@
+#include "tlo/sort.h"
+#include <assert.h>
+#include <limits.h>
+#include <stdint.h>
+#include <string.h>
+#include "tlo/threadpool.h"
+#include "util.h"
+
+enum {
+  // ranges this small are insertion sorted
+  INSERTION_SORT_THRESHOLD = 16,
+
+  // ranges this big take the median of 3 medians of 3 as pivot
+  NINTHER_THRESHOLD = 128,
+
+  // how many moves the insertion sort after an unchanged partition may make
+  PARTIAL_INSERTION_SORT_LIMIT = 8,
+
+  // swaps of other sizes go through a buffer of this many bytes at a time
+  SWAP_BUFFER_SIZE = 64
+};
+
+typedef int (*Compare)(const void *object1, const void *object2);
+
+/*
+ * - the switch is on a size that stays the same for a whole sort, so it's
+ *   predicted right and the common sizes swap with plain loads and stores
+ */
+static inline void swap(void *a, void *b, size_t size) {
+  switch (size) {
+    case 4: {
+      uint32_t t;
+      memcpy(&t, a, 4);
+      memcpy(a, b, 4);
+      memcpy(b, &t, 4);
+      return;
+    }
+    case 8: {
+      uint64_t t;
+      memcpy(&t, a, 8);
+      memcpy(a, b, 8);
+      memcpy(b, &t, 8);
+      return;
+    }
+    case 16: {
+      uint64_t t[2];
+      memcpy(t, a, 16);
+      memcpy(a, b, 16);
+      memcpy(b, t, 16);
+      return;
+    }
+    default: {
+      unsigned char *x = a;
+      unsigned char *y = b;
+      unsigned char t[SWAP_BUFFER_SIZE];
+      while (size) {
+        size_t n = size < SWAP_BUFFER_SIZE ? size : SWAP_BUFFER_SIZE;
+        memcpy(t, x, n);
+        memcpy(x, y, n);
+        memcpy(y, t, n);
+        x += n;
+        y += n;
+        size -= n;
+      }
+      return;
+    }
+  }
+}
+
+static void insertionSort(unsigned char *first, size_t count, size_t size,
+                          Compare compare) {
+  for (size_t i = 1; i < count; ++i) {
+    for (unsigned char *p = first + i * size;
+         p > first && compare(p - size, p) > 0; p -= size) {
+      swap(p - size, p, size);
+    }
+  }
+}
+
+/*
+ * - like insertionSort, but gives up once it has moved elements
+ *   PARTIAL_INSERTION_SORT_LIMIT times
+ * - returns whether it sorted the whole range
+ */
+static bool partialInsertionSort(unsigned char *first, size_t count,
+                                 size_t size, Compare compare) {
+  size_t numMoves = 0;
+  for (size_t i = 1; i < count; ++i) {
+    for (unsigned char *p = first + i * size;
+         p > first && compare(p - size, p) > 0; p -= size) {
+      swap(p - size, p, size);
+      if (++numMoves > PARTIAL_INSERTION_SORT_LIMIT) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+static void siftDown(unsigned char *first, size_t root, size_t count,
+                     size_t size, Compare compare) {
+  for (;;) {
+    size_t child = 2 * root + 1;
+    if (child >= count) {
+      return;
+    }
+    if (child + 1 < count &&
+        compare(first + child * size, first + (child + 1) * size) < 0) {
+      ++child;
+    }
+    if (compare(first + root * size, first + child * size) >= 0) {
+      return;
+    }
+    swap(first + root * size, first + child * size, size);
+    root = child;
+  }
+}
+
+static void heapSort(unsigned char *first, size_t count, size_t size,
+                     Compare compare) {
+  for (size_t i = count / 2; i > 0; --i) {
+    siftDown(first, i - 1, count, size, compare);
+  }
+  for (size_t end = count - 1; end > 0; --end) {
+    swap(first, first + end * size, size);
+    siftDown(first, 0, end, size, compare);
+  }
+}
+
+// sorts *a, *b, and *c
+static void sort3(void *a, void *b, void *c, size_t size, Compare compare) {
+  if (compare(b, a) < 0) {
+    swap(a, b, size);
+  }
+  if (compare(c, b) < 0) {
+    swap(b, c, size);
+    if (compare(b, a) < 0) {
+      swap(a, b, size);
+    }
+  }
+}
+
+// moves the pivot to first
+static void choosePivot(unsigned char *first, size_t count, size_t size,
+                        Compare compare) {
+  unsigned char *middle = first + count / 2 * size;
+  unsigned char *last = first + (count - 1) * size;
+
+  if (count >= NINTHER_THRESHOLD) {
+    sort3(first, middle, last, size, compare);
+    sort3(first + size, middle - size, last - size, size, compare);
+    sort3(first + 2 * size, middle + size, last - 2 * size, size, compare);
+    sort3(middle - size, middle, middle + size, size, compare);
+  } else {
+    sort3(first, middle, last, size, compare);
+  }
+
+  swap(first, middle, size);
+}
+
+/*
+ * - partitions around the pivot at first and returns its index afterwards.
+ *   elements before it are <= it and elements after it are >= it
+ * - elements equal to the pivot stop both scans, so ranges of equal elements
+ *   split down the middle instead of all going to one side
+ * - sets *moved to whether any elements had to be swapped
+ */
+static size_t partition(unsigned char *first, size_t count, size_t size,
+                        Compare compare, bool *moved) {
+  size_t i = 0;
+  size_t j = count;
+  *moved = false;
+
+  for (;;) {
+    do {
+      ++i;
+    } while (i < count && compare(first + i * size, first) < 0);
+
+    // stops at the pivot at the latest
+    do {
+      --j;
+    } while (compare(first + j * size, first) > 0);
+
+    if (i >= j) {
+      break;
+    }
+
+    swap(first + i * size, first + j * size, size);
+    *moved = true;
+  }
+
+  swap(first, first + j * size, size);
+  return j;
+}
+
+static void introSort(unsigned char *first, size_t count, size_t size,
+                      Compare compare, int depthLimit) {
+  while (count > INSERTION_SORT_THRESHOLD) {
+    if (depthLimit-- == 0) {
+      heapSort(first, count, size, compare);
+      return;
+    }
+
+    choosePivot(first, count, size, compare);
+    bool moved;
+    size_t pivot = partition(first, count, size, compare, &moved);
+
+    unsigned char *right = first + (pivot + 1) * size;
+    size_t rightCount = count - pivot - 1;
+    if (!moved && partialInsertionSort(first, pivot, size, compare) &&
+        partialInsertionSort(right, rightCount, size, compare)) {
+      return;
+    }
+
+    // recurses into the smaller side, so the stack stays O(log n) deep
+    if (pivot < rightCount) {
+      introSort(first, pivot, size, compare, depthLimit);
+      first = right;
+      count = rightCount;
+    } else {
+      introSort(right, rightCount, size, compare, depthLimit);
+      count = pivot;
+    }
+  }
+
+  insertionSort(first, count, size, compare);
+}
+
+static int depthLimitOf(size_t count) {
+  int depthLimit = 0;
+  for (size_t n = count; n > 1; n /= 2) {
+    depthLimit += 2;
+  }
+  return depthLimit;
+}
+
+void tloSort(void *elements, size_t count, const TloType *type) {
+  assert(elements || count == 0);
+  assert(typeIsValid(type));
+  assert(type->compare);
+
+  introSort(elements, count, type->size, type->compare, depthLimitOf(count));
+}
+
+/*
+ * - a tloParallelSort call. ranges of more than grainSize elements are split
+ *   into tasks
+ * - grainSize is at least MIN_GRAIN_SIZE, which also makes sure both halves
+ *   of a split merge are smaller than the whole
+ */
+typedef struct ParallelSort {
+  TloThreadPool *pool;
+  size_t size;
+  Compare compare;
+  bool stable;
+  size_t grainSize;
+} ParallelSort;
+
+enum { MIN_GRAIN_SIZE = 1024, NUM_TASKS_PER_THREAD = 8 };
+
+typedef struct MergeTask {
+  const ParallelSort *sort;
+  const unsigned char *left;
+  size_t leftCount;
+  const unsigned char *right;
+  size_t rightCount;
+  unsigned char *destination;
+} MergeTask;
+
+// takes from left while right's next element isn't less, so it's stable
+static void merge(const MergeTask *task) {
+  size_t size = task->sort->size;
+  const unsigned char *left = task->left;
+  const unsigned char *leftEnd = left + task->leftCount * size;
+  const unsigned char *right = task->right;
+  const unsigned char *rightEnd = right + task->rightCount * size;
+  unsigned char *destination = task->destination;
+
+  while (left != leftEnd && right != rightEnd) {
+    if (task->sort->compare(right, left) < 0) {
+      memcpy(destination, right, size);
+      right += size;
+    } else {
+      memcpy(destination, left, size);
+      left += size;
+    }
+    destination += size;
+  }
+
+  memcpy(destination, left, (size_t)(leftEnd - left));
+  destination += leftEnd - left;
+  memcpy(destination, right, (size_t)(rightEnd - right));
+}
+
+// returns the index of the first element that isn't less than value
+static size_t lowerBound(const unsigned char *elements, size_t count,
+                         const void *value, size_t size, Compare compare) {
+  size_t low = 0;
+  while (low < count) {
+    size_t middle = low + (count - low) / 2;
+    if (compare(elements + middle * size, value) < 0) {
+      low = middle + 1;
+    } else {
+      count = middle;
+    }
+  }
+  return low;
+}
+
+// returns the index of the first element that is greater than value
+static size_t upperBound(const unsigned char *elements, size_t count,
+                         const void *value, size_t size, Compare compare) {
+  size_t low = 0;
+  while (low < count) {
+    size_t middle = low + (count - low) / 2;
+    if (compare(value, elements + middle * size) < 0) {
+      count = middle;
+    } else {
+      low = middle + 1;
+    }
+  }
+  return low;
+}
+
+/*
+ * - splits the bigger run in the middle and the other one where that middle
+ *   element would go, then merges the two pairs of halves in parallel
+ * - equal elements from left stay in the first pair or ahead of right's in
+ *   the second, so it's stable
+ */
+static void parallelMerge(void *argument) {
+  const MergeTask *task = argument;
+  const ParallelSort *sort = task->sort;
+  size_t size = sort->size;
+
+  if (task->leftCount + task->rightCount <= sort->grainSize) {
+    merge(task);
+    return;
+  }
+
+  size_t leftSplit;
+  size_t rightSplit;
+  if (task->leftCount >= task->rightCount) {
+    leftSplit = task->leftCount / 2;
+    rightSplit = lowerBound(task->right, task->rightCount,
+                            task->left + leftSplit * size, size,
+                            sort->compare);
+  } else {
+    rightSplit = task->rightCount / 2;
+    leftSplit = upperBound(task->left, task->leftCount,
+                           task->right + rightSplit * size, size,
+                           sort->compare);
+  }
+
+  MergeTask first = {.sort = sort,
+                     .left = task->left,
+                     .leftCount = leftSplit,
+                     .right = task->right,
+                     .rightCount = rightSplit,
+                     .destination = task->destination};
+  MergeTask second = {
+      .sort = sort,
+      .left = task->left + leftSplit * size,
+      .leftCount = task->leftCount - leftSplit,
+      .right = task->right + rightSplit * size,
+      .rightCount = task->rightCount - rightSplit,
+      .destination = task->destination + (leftSplit + rightSplit) * size};
+
+  TloTaskGroup group;
+  tloTaskGroupConstruct(&group);
+  tloThreadPoolSubmit(sort->pool, &group, parallelMerge, &first);
+  parallelMerge(&second);
+  tloThreadPoolWait(sort->pool, &group);
+}
+
+/*
+ * - sorts count elements, leaving them in buffer if intoBuffer is true and
+ *   in elements otherwise. the other one is scratch space
+ * - the halves are sorted into whichever of the two this doesn't end up in,
+ *   then merged back, so nothing is copied except at the bottom
+ */
+typedef struct SortTask {
+  const ParallelSort *sort;
+  unsigned char *elements;
+  unsigned char *buffer;
+  size_t count;
+  bool intoBuffer;
+} SortTask;
+
+static void parallelMergeSort(void *argument) {
+  const SortTask *task = argument;
+  const ParallelSort *sort = task->sort;
+  size_t size = sort->size;
+
+  size_t leafSize = sort->stable ? INSERTION_SORT_THRESHOLD : sort->grainSize;
+  if (task->count <= leafSize) {
+    if (sort->stable) {
+      insertionSort(task->elements, task->count, size, sort->compare);
+    } else {
+      introSort(task->elements, task->count, size, sort->compare,
+                depthLimitOf(task->count));
+    }
+    if (task->intoBuffer) {
+      memcpy(task->buffer, task->elements, task->count * size);
+    }
+    return;
+  }
+
+  size_t half = task->count / 2;
+  SortTask first = {.sort = sort,
+                    .elements = task->elements,
+                    .buffer = task->buffer,
+                    .count = half,
+                    .intoBuffer = !task->intoBuffer};
+  SortTask second = {.sort = sort,
+                     .elements = task->elements + half * size,
+                     .buffer = task->buffer + half * size,
+                     .count = task->count - half,
+                     .intoBuffer = !task->intoBuffer};
+
+  if (task->count > sort->grainSize) {
+    TloTaskGroup group;
+    tloTaskGroupConstruct(&group);
+    tloThreadPoolSubmit(sort->pool, &group, parallelMergeSort, &first);
+    parallelMergeSort(&second);
+    tloThreadPoolWait(sort->pool, &group);
+  } else {
+    parallelMergeSort(&first);
+    parallelMergeSort(&second);
+  }
+
+  const unsigned char *source =
+      task->intoBuffer ? task->elements : task->buffer;
+  MergeTask mergeTask = {
+      .sort = sort,
+      .left = source,
+      .leftCount = half,
+      .right = source + half * size,
+      .rightCount = task->count - half,
+      .destination = task->intoBuffer ? task->buffer : task->elements};
+  parallelMerge(&mergeTask);
+}
+
+TloError tloParallelSort(void *elements, size_t count, const TloType *type,
+                         bool stable, TloThreadPool *pool,
+                         const TloAllocator *allocator) {
+  assert(elements || count == 0);
+  assert(typeIsValid(type));
+  assert(type->compare);
+  assert(pool);
+  assert(allocator == NULL || allocatorIsValid(allocator));
+
+  if (!allocator) {
+    allocator = &tloCStdLibAllocator;
+  }
+
+  if (count < 2) {
+    return TLO_SUCCESS;
+  }
+
+  if (count > SIZE_MAX / type->size) {
+    return TLO_ERROR;
+  }
+
+  unsigned char *buffer = tloAllocatorMalloc(allocator, count * type->size);
+  if (!buffer) {
+    return TLO_ERROR;
+  }
+
+  size_t grainSize =
+      count / (tloThreadPoolNumThreads(pool) * NUM_TASKS_PER_THREAD);
+  ParallelSort sort = {
+      .pool = pool,
+      .size = type->size,
+      .compare = type->compare,
+      .stable = stable,
+      .grainSize = grainSize > MIN_GRAIN_SIZE ? grainSize : MIN_GRAIN_SIZE};
+  SortTask task = {.sort = &sort,
+                   .elements = elements,
+                   .buffer = buffer,
+                   .count = count,
+                   .intoBuffer = false};
+  parallelMergeSort(&task);
+
+  tloAllocatorSizedFree(allocator, buffer, count * type->size);
+  return TLO_SUCCESS;
+}
+
+enum {
+  // arrays with 4 or 8 byte keys this big get 11 bit digits
+  WIDE_DIGIT_THRESHOLD = 1 << 16,
+
+  NARROW_DIGIT_BITS = 8,
+  WIDE_DIGIT_BITS = 11
+};
+
+#ifndef NDEBUG
+static bool integerKeyIsValid(const TloIntegerKey *key, size_t typeSize) {
+  return key &&
+         (key->size == 1 || key->size == 2 || key->size == 4 ||
+          key->size == 8) &&
+         key->offset <= typeSize && key->size <= typeSize - key->offset;
+}
+#endif
+
+// returns the key of element, with signed keys mapped to the same order
+static uint64_t keyOf(const unsigned char *element, const TloIntegerKey *key) {
+  const unsigned char *bytes = element + key->offset;
+  uint64_t value;
+
+  switch (key->size) {
+    case 1: {
+      uint8_t k;
+      memcpy(&k, bytes, 1);
+      value = k;
+      break;
+    }
+    case 2: {
+      uint16_t k;
+      memcpy(&k, bytes, 2);
+      value = k;
+      break;
+    }
+    case 4: {
+      uint32_t k;
+      memcpy(&k, bytes, 4);
+      value = k;
+      break;
+    }
+    default:
+      memcpy(&value, bytes, 8);
+      break;
+  }
+
+  // flipping the sign bit puts negative keys before positive ones
+  if (key->isSigned) {
+    value ^= (uint64_t)1 << (key->size * CHAR_BIT - 1);
+  }
+  return value;
+}
+
+// like swap, the switch is predicted right, and the common sizes inline
+static inline void move(void *destination, const void *source, size_t size) {
+  switch (size) {
+    case 4:
+      memcpy(destination, source, 4);
+      return;
+    case 8:
+      memcpy(destination, source, 8);
+      return;
+    case 16:
+      memcpy(destination, source, 16);
+      return;
+    default:
+      memcpy(destination, source, size);
+      return;
+  }
+}
+
+TloError tloRadixSort(void *elements, size_t count, const TloType *type,
+                      const TloAllocator *allocator) {
+  assert(elements || count == 0);
+  assert(typeIsValid(type));
+  assert(integerKeyIsValid(type->integerKey, type->size));
+  assert(allocator == NULL || allocatorIsValid(allocator));
+
+  if (!allocator) {
+    allocator = &tloCStdLibAllocator;
+  }
+
+  if (count < 2) {
+    return TLO_SUCCESS;
+  }
+
+  const TloIntegerKey *key = type->integerKey;
+  size_t size = type->size;
+  unsigned digitBits = key->size >= 4 && count >= WIDE_DIGIT_THRESHOLD
+                           ? WIDE_DIGIT_BITS
+                           : NARROW_DIGIT_BITS;
+  size_t numDigits = (key->size * CHAR_BIT + digitBits - 1) / digitBits;
+  size_t radix = (size_t)1 << digitBits;
+  size_t mask = radix - 1;
+
+  if (count > SIZE_MAX / size) {
+    return TLO_ERROR;
+  }
+
+  unsigned char *buffer = tloAllocatorMalloc(allocator, count * size);
+  if (!buffer) {
+    return TLO_ERROR;
+  }
+
+  size_t *histograms =
+      tloAllocatorMalloc(allocator, numDigits * radix * sizeof(size_t));
+  if (!histograms) {
+    tloAllocatorSizedFree(allocator, buffer, count * size);
+    return TLO_ERROR;
+  }
+
+  memset(histograms, 0, numDigits * radix * sizeof(size_t));
+  unsigned char *source = elements;
+  for (size_t i = 0; i < count; ++i) {
+    uint64_t k = keyOf(source + i * size, key);
+    for (size_t digit = 0; digit < numDigits; ++digit) {
+      ++histograms[digit * radix + ((k >> (digit * digitBits)) & mask)];
+    }
+  }
+
+  unsigned char *destination = buffer;
+  for (size_t digit = 0; digit < numDigits; ++digit) {
+    size_t *counts = histograms + digit * radix;
+    size_t shift = digit * digitBits;
+
+    // every element would stay where it is
+    if (counts[(keyOf(source, key) >> shift) & mask] == count) {
+      continue;
+    }
+
+    // turns the counts into the index each bucket starts at
+    size_t start = 0;
+    for (size_t bucket = 0; bucket < radix; ++bucket) {
+      size_t bucketCount = counts[bucket];
+      counts[bucket] = start;
+      start += bucketCount;
+    }
+
+    for (size_t i = 0; i < count; ++i) {
+      const unsigned char *element = source + i * size;
+      size_t bucket = (keyOf(element, key) >> shift) & mask;
+      move(destination + counts[bucket]++ * size, element, size);
+    }
+
+    unsigned char *sorted = destination;
+    destination = source;
+    source = sorted;
+  }
+
+  if (source != elements) {
+    memcpy(elements, source, count * size);
+  }
+
+  tloAllocatorSizedFree(allocator, histograms,
+                        numDigits * radix * sizeof(size_t));
+  tloAllocatorSizedFree(allocator, buffer, count * size);
+  return TLO_SUCCESS;
+}
@@ -0,0 +1,258 @@
+#include "tlo/spscring.h"
+#include <assert.h>
+#include <string.h>
+#include "util.h"
+
+#ifndef NDEBUG
+static bool spscringIsValid(const TloSPSCRing *ring) {
+  return ring && typeIsValid(ring->valueType) &&
+         allocatorIsValid(ring->allocator) && ring->array &&
+         isPowerOfTwo(ring->capacity);
+}
+#endif
+
+static void *slot(const TloSPSCRing *ring, size_t index) {
+  return ring->array + (index & (ring->capacity - 1)) * ring->valueType->size;
+}
+
+/*
+ * - copies the count elements of source into the slots starting at index,
+ *   wrapping around at most once
+ */
+static void copyIntoSlots(TloSPSCRing *ring, size_t index, const void *source,
+                          size_t count) {
+  size_t valueSize = ring->valueType->size;
+  size_t first = index & (ring->capacity - 1);
+  size_t firstCount = ring->capacity - first;
+  if (firstCount > count) {
+    firstCount = count;
+  }
+
+  memcpy(slot(ring, first), source, firstCount * valueSize);
+  memcpy(ring->array, (const unsigned char *)source + firstCount * valueSize,
+         (count - firstCount) * valueSize);
+}
+
+// like copyIntoSlots, but the other way around
+static void copyFromSlots(const TloSPSCRing *ring, size_t index,
+                          void *destination, size_t count) {
+  size_t valueSize = ring->valueType->size;
+  size_t first = index & (ring->capacity - 1);
+  size_t firstCount = ring->capacity - first;
+  if (firstCount > count) {
+    firstCount = count;
+  }
+
+  memcpy(destination, slot(ring, first), firstCount * valueSize);
+  memcpy((unsigned char *)destination + firstCount * valueSize, ring->array,
+         (count - firstCount) * valueSize);
+}
+
+TloError tloSPSCRingConstruct(TloSPSCRing *ring, const TloType *valueType,
+                              const TloAllocator *allocator, size_t capacity) {
+  assert(ring);
+  assert(typeIsValid(valueType));
+  assert(allocator == NULL || allocatorIsValid(allocator));
+  assert(capacity > 0);
+
+  if (!allocator) {
+    allocator = &tloCStdLibAllocator;
+  }
+
+  capacity = roundUpToPowerOfTwo(capacity);
+  if (!capacity) {
+    return TLO_ERROR;
+  }
+
+  unsigned char *array =
+      tloAllocatorMalloc(allocator, capacity * valueType->size);
+  if (!array) {
+    return TLO_ERROR;
+  }
+
+  ring->valueType = valueType;
+  ring->allocator = allocator;
+  ring->array = array;
+  ring->capacity = capacity;
+  atomic_init(&ring->head, 0);
+  ring->cachedTail = 0;
+  atomic_init(&ring->tail, 0);
+  ring->cachedHead = 0;
+
+  return TLO_SUCCESS;
+}
+
+void tloSPSCRingDestruct(TloSPSCRing *ring) {
+  if (!ring) {
+    return;
+  }
+
+  assert(spscringIsValid(ring));
+
+  size_t head = atomic_load_explicit(&ring->head, memory_order_relaxed);
+  size_t tail = atomic_load_explicit(&ring->tail, memory_order_relaxed);
+  for (size_t i = head; i != tail; ++i) {
+    tloTypeDestruct(ring->valueType, slot(ring, i));
+  }
+
+  tloAllocatorSizedFree(ring->allocator, ring->array,
+                        ring->capacity * ring->valueType->size);
+  ring->array = NULL;
+}
+
+TloSPSCRing *tloSPSCRingMake(const TloType *valueType,
+                             const TloAllocator *allocator, size_t capacity) {
+  assert(typeIsValid(valueType));
+
+  if (!allocator) {
+    allocator = &tloCStdLibAllocator;
+  }
+
+  assert(allocatorIsValid(allocator));
+
+  TloSPSCRing *ring = tloAllocatorMalloc(allocator, sizeof(*ring));
+  if (!ring) {
+    return NULL;
+  }
+
+  if (tloSPSCRingConstruct(ring, valueType, allocator, capacity) !=
+      TLO_SUCCESS) {
+    tloAllocatorSizedFree(allocator, ring, sizeof(*ring));
+    return NULL;
+  }
+
+  return ring;
+}
+
+void tloSPSCRingDelete(TloSPSCRing *ring) {
+  if (!ring) {
+    return;
+  }
+
+  const TloAllocator *allocator = ring->allocator;
+  tloSPSCRingDestruct(ring);
+  tloAllocatorSizedFree(allocator, ring, sizeof(*ring));
+}
+
+size_t tloSPSCRingCapacity(const TloSPSCRing *ring) {
+  assert(spscringIsValid(ring));
+
+  return ring->capacity;
+}
+
+size_t tloSPSCRingSize(const TloSPSCRing *ring) {
+  assert(spscringIsValid(ring));
+
+  size_t tail = atomic_load_explicit(&ring->tail, memory_order_acquire);
+  size_t head = atomic_load_explicit(&ring->head, memory_order_acquire);
+  return tail - head;
+}
+
+/*
+ * - returns the number of free slots, up to wanted
+ * - reads the consumer's head only if the cached copy shows too few
+ * - the acquire load makes sure the consumer is done reading a slot before the
+ *   producer writes to it again
+ */
+static size_t freeSlots(TloSPSCRing *ring, size_t tail, size_t wanted) {
+  size_t free = ring->capacity - (tail - ring->cachedHead);
+  if (free < wanted) {
+    ring->cachedHead = atomic_load_explicit(&ring->head, memory_order_acquire);
+    free = ring->capacity - (tail - ring->cachedHead);
+  }
+
+  return free < wanted ? free : wanted;
+}
+
+// like freeSlots, but for the consumer and the elements ready to be popped
+static size_t readySlots(TloSPSCRing *ring, size_t head, size_t wanted) {
+  size_t ready = ring->cachedTail - head;
+  if (ready < wanted) {
+    ring->cachedTail = atomic_load_explicit(&ring->tail, memory_order_acquire);
+    ready = ring->cachedTail - head;
+  }
+
+  return ready < wanted ? ready : wanted;
+}
+
+bool tloSPSCRingTryPush(TloSPSCRing *ring, const void *element) {
+  assert(spscringIsValid(ring));
+  assert(element);
+
+  size_t tail = atomic_load_explicit(&ring->tail, memory_order_relaxed);
+  if (!freeSlots(ring, tail, 1)) {
+    return false;
+  }
+
+  if (tloTypeConstructCopy(ring->valueType, slot(ring, tail), element) !=
+      TLO_SUCCESS) {
+    return false;
+  }
+
+  atomic_store_explicit(&ring->tail, tail + 1, memory_order_release);
+  return true;
+}
+
+bool tloSPSCRingTryPop(TloSPSCRing *ring, void *destination) {
+  assert(spscringIsValid(ring));
+  assert(destination);
+
+  size_t head = atomic_load_explicit(&ring->head, memory_order_relaxed);
+  if (!readySlots(ring, head, 1)) {
+    return false;
+  }
+
+  memcpy(destination, slot(ring, head), ring->valueType->size);
+
+  atomic_store_explicit(&ring->head, head + 1, memory_order_release);
+  return true;
+}
+
+size_t tloSPSCRingPushMany(TloSPSCRing *ring, const void *elements,
+                           size_t count) {
+  assert(spscringIsValid(ring));
+  assert(elements || count == 0);
+
+  size_t tail = atomic_load_explicit(&ring->tail, memory_order_relaxed);
+  count = freeSlots(ring, tail, count);
+  if (!count) {
+    return 0;
+  }
+
+  size_t pushed = 0;
+  if (ring->valueType->constructCopy) {
+    size_t valueSize = ring->valueType->size;
+    const unsigned char *source = elements;
+    for (; pushed < count; ++pushed) {
+      if (ring->valueType->constructCopy(slot(ring, tail + pushed),
+                                         source + pushed * valueSize) !=
+          TLO_SUCCESS) {
+        break;
+      }
+    }
+  } else {
+    copyIntoSlots(ring, tail, elements, count);
+    pushed = count;
+  }
+
+  if (pushed) {
+    atomic_store_explicit(&ring->tail, tail + pushed, memory_order_release);
+  }
+  return pushed;
+}
+
+size_t tloSPSCRingPopMany(TloSPSCRing *ring, void *destination, size_t count) {
+  assert(spscringIsValid(ring));
+  assert(destination || count == 0);
+
+  size_t head = atomic_load_explicit(&ring->head, memory_order_relaxed);
+  count = readySlots(ring, head, count);
+  if (!count) {
+    return 0;
+  }
+
+  copyFromSlots(ring, head, destination, count);
+
+  atomic_store_explicit(&ring->head, head + count, memory_order_release);
+  return count;
+}
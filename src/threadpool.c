@@ -0,0 +1,571 @@
+// for sysconf(_SC_NPROCESSORS_ONLN), which isn't part of C or strict POSIX
+#define _DEFAULT_SOURCE
+#include "tlo/threadpool.h"
+#include <assert.h>
+#include <sched.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <unistd.h>
+#include "util.h"
+
+typedef struct Task {
+  TloTaskFunction function;
+  void *argument;
+  TloTaskGroup *group;
+} Task;
+
+static const TloType taskType = {.size = sizeof(Task)};
+
+/*
+ * - a task in a deque. stealers may read a slot while its owner overwrites
+ *   it, in which case their compare-and-swap on top fails and they throw away
+ *   what they read, so the fields are atomics accessed with relaxed order
+ */
+typedef struct Slot {
+  _Atomic(TloTaskFunction) function;
+  _Atomic(void *) argument;
+  _Atomic(TloTaskGroup *) group;
+} Slot;
+
+enum {
+  DEQUE_CAPACITY = 1024,
+  SUBMITTED_CAPACITY = 4096,
+
+  // how many times idle threads yield and look for work again before sleeping
+  NUM_YIELDS_BEFORE_SLEEPING = 64
+};
+
+/*
+ * - Chase-Lev deque with a fixed capacity, using the memory orders from
+ *   "Correct and Efficient Work-Stealing for Weak Memory Models" by Lê et al.
+ * - the owner pushes and takes at bottom, stealers take at top
+ */
+typedef struct TloThreadPoolWorker {
+  TloThreadPool *pool;
+  pthread_t thread;
+  unsigned char padding0[TLO_CACHE_LINE_SIZE];
+
+  atomic_ptrdiff_t top;
+  unsigned char padding1[TLO_CACHE_LINE_SIZE];
+
+  atomic_ptrdiff_t bottom;
+  unsigned char padding2[TLO_CACHE_LINE_SIZE];
+
+  Slot slots[DEQUE_CAPACITY];
+} Worker;
+
+// the worker the calling thread is, or NULL if it isn't one
+static _Thread_local Worker *currentWorker;
+
+// state of the calling thread's xorshift generator for picking victims
+static _Thread_local uint64_t randomState;
+
+#ifndef NDEBUG
+static bool threadpoolIsValid(const TloThreadPool *pool) {
+  return pool && allocatorIsValid(pool->allocator) && pool->workers &&
+         pool->numThreads > 0;
+}
+#endif
+
+static Slot *slotAt(Worker *worker, ptrdiff_t index) {
+  return &worker->slots[(size_t)index & (DEQUE_CAPACITY - 1)];
+}
+
+static void storeTask(Slot *slot, const Task *task) {
+  atomic_store_explicit(&slot->function, task->function, memory_order_relaxed);
+  atomic_store_explicit(&slot->argument, task->argument, memory_order_relaxed);
+  atomic_store_explicit(&slot->group, task->group, memory_order_relaxed);
+}
+
+static Task loadTask(Slot *slot) {
+  return (Task){
+      .function = atomic_load_explicit(&slot->function, memory_order_relaxed),
+      .argument = atomic_load_explicit(&slot->argument, memory_order_relaxed),
+      .group = atomic_load_explicit(&slot->group, memory_order_relaxed)};
+}
+
+// only called by worker's own thread. returns false if the deque is full
+static bool pushBottom(Worker *worker, const Task *task) {
+  ptrdiff_t bottom =
+      atomic_load_explicit(&worker->bottom, memory_order_relaxed);
+  ptrdiff_t top = atomic_load_explicit(&worker->top, memory_order_acquire);
+  if (bottom - top >= DEQUE_CAPACITY) {
+    return false;
+  }
+
+  // a release store rather than Lê et al.'s release fence, which is the same
+  // but which ThreadSanitizer can't follow
+  storeTask(slotAt(worker, bottom), task);
+  atomic_store_explicit(&worker->bottom, bottom + 1, memory_order_release);
+  return true;
+}
+
+// only called by worker's own thread. returns false if the deque is empty
+static bool takeBottom(Worker *worker, Task *task) {
+  ptrdiff_t bottom =
+      atomic_load_explicit(&worker->bottom, memory_order_relaxed) - 1;
+  atomic_store_explicit(&worker->bottom, bottom, memory_order_relaxed);
+  atomic_thread_fence(memory_order_seq_cst);
+  ptrdiff_t top = atomic_load_explicit(&worker->top, memory_order_relaxed);
+
+  if (top > bottom) {
+    atomic_store_explicit(&worker->bottom, bottom + 1, memory_order_relaxed);
+    return false;
+  }
+
+  *task = loadTask(slotAt(worker, bottom));
+  if (top < bottom) {
+    return true;
+  }
+
+  // the last task, which stealers may be going for too
+  bool taken = atomic_compare_exchange_strong_explicit(
+      &worker->top, &top, top + 1, memory_order_seq_cst,
+      memory_order_relaxed);
+  atomic_store_explicit(&worker->bottom, bottom + 1, memory_order_relaxed);
+  return taken;
+}
+
+// returns false if the deque is empty or another thread got there first
+static bool steal(Worker *worker, Task *task) {
+  ptrdiff_t top = atomic_load_explicit(&worker->top, memory_order_acquire);
+  atomic_thread_fence(memory_order_seq_cst);
+  ptrdiff_t bottom =
+      atomic_load_explicit(&worker->bottom, memory_order_acquire);
+  if (top >= bottom) {
+    return false;
+  }
+
+  *task = loadTask(slotAt(worker, top));
+  return atomic_compare_exchange_strong_explicit(
+      &worker->top, &top, top + 1, memory_order_seq_cst,
+      memory_order_relaxed);
+}
+
+static bool dequeIsEmpty(Worker *worker) {
+  ptrdiff_t top = atomic_load_explicit(&worker->top, memory_order_acquire);
+  ptrdiff_t bottom =
+      atomic_load_explicit(&worker->bottom, memory_order_acquire);
+  return top >= bottom;
+}
+
+static size_t nextRandom(void) {
+  if (!randomState) {
+    randomState = (uint64_t)(uintptr_t)&randomState | 1;
+  }
+
+  randomState ^= randomState << 13;
+  randomState ^= randomState >> 7;
+  randomState ^= randomState << 17;
+  return (size_t)randomState;
+}
+
+// tries every worker but self once, starting at a random one
+static bool stealFromAny(TloThreadPool *pool, const Worker *self, Task *task) {
+  size_t start = nextRandom() % pool->numThreads;
+  for (size_t i = 0; i < pool->numThreads; ++i) {
+    Worker *victim = pool->workers[(start + i) % pool->numThreads];
+    if (victim != self && steal(victim, task)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+static bool hasWork(TloThreadPool *pool) {
+  if (tloMPMCQueueSize(&pool->submitted)) {
+    return true;
+  }
+
+  for (size_t i = 0; i < pool->numThreads; ++i) {
+    if (!dequeIsEmpty(pool->workers[i])) {
+      return true;
+    }
+  }
+  return false;
+}
+
+/*
+ * - wakes sleeping threads, all of them or at least one
+ * - the fence pairs with the one in sleepUnless: either this sees the number
+ *   of sleepers go up, or the sleeper's last check sees what was done before
+ *   calling this
+ */
+static void wakeSleepers(TloThreadPool *pool, bool all) {
+  atomic_thread_fence(memory_order_seq_cst);
+  if (!atomic_load_explicit(&pool->numSleepers, memory_order_relaxed)) {
+    return;
+  }
+
+  pthread_mutex_lock(&pool->mutex);
+  ++pool->epoch;
+  if (all) {
+    pthread_cond_broadcast(&pool->wakeUp);
+  } else {
+    pthread_cond_signal(&pool->wakeUp);
+  }
+  pthread_mutex_unlock(&pool->mutex);
+}
+
+// sleeps until woken by wakeSleepers, unless isReady is already true
+static void sleepUnless(TloThreadPool *pool,
+                        bool (*isReady)(TloThreadPool *pool,
+                                        const TloTaskGroup *group),
+                        const TloTaskGroup *group) {
+  pthread_mutex_lock(&pool->mutex);
+  atomic_fetch_add(&pool->numSleepers, 1);
+  atomic_thread_fence(memory_order_seq_cst);
+
+  unsigned long epoch = pool->epoch;
+  if (!isReady(pool, group)) {
+    while (pool->epoch == epoch) {
+      pthread_cond_wait(&pool->wakeUp, &pool->mutex);
+    }
+  }
+
+  atomic_fetch_sub(&pool->numSleepers, 1);
+  pthread_mutex_unlock(&pool->mutex);
+}
+
+static bool workerIsReady(TloThreadPool *pool, const TloTaskGroup *group) {
+  (void)group;
+  return atomic_load(&pool->stopping) || hasWork(pool);
+}
+
+static bool waiterIsReady(TloThreadPool *pool, const TloTaskGroup *group) {
+  return !atomic_load(&group->numPending) || hasWork(pool);
+}
+
+static void runTask(TloThreadPool *pool, const Task *task) {
+  task->function(task->argument);
+
+  // the release makes what the task did visible to whoever sees the 0
+  if (atomic_fetch_sub_explicit(&task->group->numPending, 1,
+                                memory_order_acq_rel) == 1) {
+    wakeSleepers(pool, true);
+  }
+}
+
+// self is NULL if the calling thread isn't one of pool's workers
+static bool runOneTask(TloThreadPool *pool, Worker *self) {
+  Task task;
+  if ((self && takeBottom(self, &task)) ||
+      tloMPMCQueueTryPop(&pool->submitted, &task) ||
+      stealFromAny(pool, self, &task)) {
+    runTask(pool, &task);
+    return true;
+  }
+  return false;
+}
+
+static Worker *workerOf(const TloThreadPool *pool) {
+  return currentWorker && currentWorker->pool == pool ? currentWorker : NULL;
+}
+
+static void *workerMain(void *argument) {
+  Worker *self = argument;
+  TloThreadPool *pool = self->pool;
+  currentWorker = self;
+
+  int numYields = 0;
+  while (!atomic_load(&pool->stopping)) {
+    if (runOneTask(pool, self)) {
+      numYields = 0;
+    } else if (numYields < NUM_YIELDS_BEFORE_SLEEPING) {
+      ++numYields;
+      sched_yield();
+    } else {
+      sleepUnless(pool, workerIsReady, NULL);
+      numYields = 0;
+    }
+  }
+
+  return NULL;
+}
+
+void tloTaskGroupConstruct(TloTaskGroup *group) {
+  assert(group);
+
+  atomic_init(&group->numPending, 0);
+}
+
+static void deleteWorkers(TloThreadPool *pool, size_t numWorkers) {
+  for (size_t i = 0; i < numWorkers; ++i) {
+    tloAllocatorSizedFree(pool->allocator, pool->workers[i],
+                          sizeof(*pool->workers[i]));
+  }
+  tloAllocatorSizedFree(pool->allocator, pool->workers,
+                        pool->numThreads * sizeof(pool->workers[0]));
+}
+
+// stops and joins the first numStarted workers
+static void stopWorkers(TloThreadPool *pool, size_t numStarted) {
+  atomic_store(&pool->stopping, true);
+
+  pthread_mutex_lock(&pool->mutex);
+  ++pool->epoch;
+  pthread_cond_broadcast(&pool->wakeUp);
+  pthread_mutex_unlock(&pool->mutex);
+
+  for (size_t i = 0; i < numStarted; ++i) {
+    pthread_join(pool->workers[i]->thread, NULL);
+  }
+}
+
+TloError tloThreadPoolConstruct(TloThreadPool *pool, size_t numThreads,
+                                const TloAllocator *allocator) {
+  assert(pool);
+  assert(allocator == NULL || allocatorIsValid(allocator));
+
+  if (!allocator) {
+    allocator = &tloCStdLibAllocator;
+  }
+
+  if (!numThreads) {
+    long numCores = sysconf(_SC_NPROCESSORS_ONLN);
+    numThreads = numCores > 0 ? (size_t)numCores : 1;
+  }
+
+  pool->allocator = allocator;
+  pool->numThreads = numThreads;
+  pool->workers =
+      tloAllocatorMalloc(allocator, numThreads * sizeof(pool->workers[0]));
+  if (!pool->workers) {
+    return TLO_ERROR;
+  }
+
+  for (size_t i = 0; i < numThreads; ++i) {
+    Worker *worker = tloAllocatorMalloc(allocator, sizeof(*worker));
+    if (!worker) {
+      deleteWorkers(pool, i);
+      return TLO_ERROR;
+    }
+
+    worker->pool = pool;
+    atomic_init(&worker->top, 0);
+    atomic_init(&worker->bottom, 0);
+    pool->workers[i] = worker;
+  }
+
+  if (tloMPMCQueueConstruct(&pool->submitted, &taskType, allocator,
+                            SUBMITTED_CAPACITY) != TLO_SUCCESS) {
+    deleteWorkers(pool, numThreads);
+    return TLO_ERROR;
+  }
+
+  tloTaskGroupConstruct(&pool->defaultGroup);
+  atomic_init(&pool->stopping, false);
+  atomic_init(&pool->numSleepers, 0);
+  pthread_mutex_init(&pool->mutex, NULL);
+  pthread_cond_init(&pool->wakeUp, NULL);
+  pool->epoch = 0;
+
+  for (size_t i = 0; i < numThreads; ++i) {
+    Worker *worker = pool->workers[i];
+    if (pthread_create(&worker->thread, NULL, workerMain, worker) != 0) {
+      stopWorkers(pool, i);
+      pthread_cond_destroy(&pool->wakeUp);
+      pthread_mutex_destroy(&pool->mutex);
+      tloMPMCQueueDestruct(&pool->submitted);
+      deleteWorkers(pool, numThreads);
+      return TLO_ERROR;
+    }
+  }
+
+  return TLO_SUCCESS;
+}
+
+void tloThreadPoolDestruct(TloThreadPool *pool) {
+  if (!pool) {
+    return;
+  }
+
+  assert(threadpoolIsValid(pool));
+  assert(!workerOf(pool));
+
+  tloThreadPoolWait(pool, NULL);
+  stopWorkers(pool, pool->numThreads);
+
+  pthread_cond_destroy(&pool->wakeUp);
+  pthread_mutex_destroy(&pool->mutex);
+  tloMPMCQueueDestruct(&pool->submitted);
+  deleteWorkers(pool, pool->numThreads);
+  pool->workers = NULL;
+}
+
+TloThreadPool *tloThreadPoolMake(size_t numThreads,
+                                 const TloAllocator *allocator) {
+  if (!allocator) {
+    allocator = &tloCStdLibAllocator;
+  }
+
+  assert(allocatorIsValid(allocator));
+
+  TloThreadPool *pool = tloAllocatorMalloc(allocator, sizeof(*pool));
+  if (!pool) {
+    return NULL;
+  }
+
+  if (tloThreadPoolConstruct(pool, numThreads, allocator) != TLO_SUCCESS) {
+    tloAllocatorSizedFree(allocator, pool, sizeof(*pool));
+    return NULL;
+  }
+
+  return pool;
+}
+
+void tloThreadPoolDelete(TloThreadPool *pool) {
+  if (!pool) {
+    return;
+  }
+
+  const TloAllocator *allocator = pool->allocator;
+  tloThreadPoolDestruct(pool);
+  tloAllocatorSizedFree(allocator, pool, sizeof(*pool));
+}
+
+size_t tloThreadPoolNumThreads(const TloThreadPool *pool) {
+  assert(threadpoolIsValid(pool));
+
+  return pool->numThreads;
+}
+
+void tloThreadPoolSubmit(TloThreadPool *pool, TloTaskGroup *group,
+                         TloTaskFunction function, void *argument) {
+  assert(threadpoolIsValid(pool));
+  assert(function);
+
+  if (!group) {
+    group = &pool->defaultGroup;
+  }
+
+  // pushing publishes the task, which orders this before it's finished
+  atomic_fetch_add_explicit(&group->numPending, 1, memory_order_relaxed);
+
+  Task task = {.function = function, .argument = argument, .group = group};
+  Worker *self = workerOf(pool);
+  bool pushed = self ? pushBottom(self, &task)
+                     : tloMPMCQueueTryMove(&pool->submitted, &task);
+  if (!pushed) {
+    runTask(pool, &task);
+    return;
+  }
+
+  wakeSleepers(pool, false);
+}
+
+void tloThreadPoolWait(TloThreadPool *pool, TloTaskGroup *group) {
+  assert(threadpoolIsValid(pool));
+
+  if (!group) {
+    group = &pool->defaultGroup;
+  }
+
+  Worker *self = workerOf(pool);
+  int numYields = 0;
+  while (atomic_load_explicit(&group->numPending, memory_order_acquire)) {
+    if (runOneTask(pool, self)) {
+      numYields = 0;
+    } else if (numYields < NUM_YIELDS_BEFORE_SLEEPING) {
+      ++numYields;
+      sched_yield();
+    } else {
+      sleepUnless(pool, waiterIsReady, group);
+      numYields = 0;
+    }
+  }
+}
+
+/*
+ * - a run of chunks [firstChunk, endChunk) of a tloThreadPoolParallelFor call
+ * - the call allocates one range per chunk. a range that splits off its right
+ *   half uses the range of the half's first chunk for it, so no two ranges
+ *   ever share one
+ */
+typedef struct ParallelFor ParallelFor;
+
+typedef struct Range {
+  ParallelFor *parallelFor;
+  size_t firstChunk;
+  size_t endChunk;
+} Range;
+
+struct ParallelFor {
+  TloThreadPool *pool;
+  TloTaskGroup group;
+  size_t begin;
+  size_t end;
+  size_t grainSize;
+  TloParallelForBody body;
+  void *argument;
+  Range *ranges;
+};
+
+static void runRange(void *argument) {
+  const Range *range = argument;
+  ParallelFor *parallelFor = range->parallelFor;
+  size_t firstChunk = range->firstChunk;
+  size_t endChunk = range->endChunk;
+
+  while (endChunk - firstChunk > 1) {
+    size_t middleChunk = firstChunk + (endChunk - firstChunk) / 2;
+    Range *right = &parallelFor->ranges[middleChunk];
+    right->parallelFor = parallelFor;
+    right->firstChunk = middleChunk;
+    right->endChunk = endChunk;
+    tloThreadPoolSubmit(parallelFor->pool, &parallelFor->group, runRange,
+                        right);
+    endChunk = middleChunk;
+  }
+
+  size_t begin = parallelFor->begin + firstChunk * parallelFor->grainSize;
+  size_t end = parallelFor->end - begin > parallelFor->grainSize
+                   ? begin + parallelFor->grainSize
+                   : parallelFor->end;
+  parallelFor->body(begin, end, parallelFor->argument);
+}
+
+void tloThreadPoolParallelFor(TloThreadPool *pool, size_t begin, size_t end,
+                              size_t grainSize, TloParallelForBody body,
+                              void *argument) {
+  assert(threadpoolIsValid(pool));
+  assert(begin <= end);
+  assert(body);
+
+  size_t size = end - begin;
+  if (!size) {
+    return;
+  }
+
+  if (!grainSize) {
+    grainSize = size / (pool->numThreads * 8);
+    grainSize = grainSize ? grainSize : 1;
+  }
+
+  size_t numChunks = (size - 1) / grainSize + 1;
+  Range *ranges = numChunks > 1 && numChunks <= SIZE_MAX / sizeof(Range)
+                      ? tloAllocatorMalloc(pool->allocator,
+                                           numChunks * sizeof(Range))
+                      : NULL;
+  if (!ranges) {
+    body(begin, end, argument);
+    return;
+  }
+
+  ParallelFor parallelFor = {.pool = pool,
+                             .begin = begin,
+                             .end = end,
+                             .grainSize = grainSize,
+                             .body = body,
+                             .argument = argument,
+                             .ranges = ranges};
+  tloTaskGroupConstruct(&parallelFor.group);
+  ranges[0] =
+      (Range){.parallelFor = &parallelFor, .firstChunk = 0,
+              .endChunk = numChunks};
+
+  runRange(&ranges[0]);
+  tloThreadPoolWait(pool, &parallelFor.group);
+
+  tloAllocatorSizedFree(pool->allocator, ranges, numChunks * sizeof(Range));
+}
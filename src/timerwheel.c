@@ -0,0 +1,244 @@
+#include "tlo/timerwheel.h"
+#include <assert.h>
+#include "util.h"
+
+enum {
+  SLOT_BITS = 6,
+  SLOT_MASK = TLO_TIMER_WHEEL_NUM_SLOTS - 1,
+  TIME_BITS = 64
+};
+
+_Static_assert(TLO_TIMER_WHEEL_NUM_SLOTS == 1 << SLOT_BITS,
+               "slot bits don't match the number of slots");
+_Static_assert(TLO_TIMER_WHEEL_NUM_LEVELS * SLOT_BITS >= TIME_BITS,
+               "levels don't cover every deadline");
+
+/*
+ * - the level a timer due at deadline goes in: the lowest one whose slots
+ *   span all the bits in which deadline differs from now
+ * - every timer in a level is then in the same span of that level as now,
+ *   and in a slot after now's, or in now's slot at level 0
+ */
+static size_t levelOf(uint64_t deadline, uint64_t now) {
+  uint64_t differing = (deadline ^ now) >> SLOT_BITS;
+  size_t level = 0;
+  while (differing) {
+    differing >>= SLOT_BITS;
+    ++level;
+  }
+  return level;
+}
+
+static size_t slotOf(uint64_t time, size_t level) {
+  return (size_t)(time >> (level * SLOT_BITS)) & SLOT_MASK;
+}
+
+// the time at which slot of level starts, in the span of the level that now
+// is in
+static uint64_t slotStart(uint64_t now, size_t level, size_t slot) {
+  size_t shift = level * SLOT_BITS;
+  size_t spanShift = shift + SLOT_BITS;
+  uint64_t span = spanShift < TIME_BITS ? now >> spanShift << spanShift : 0;
+  return span | (uint64_t)slot << shift;
+}
+
+#ifndef NDEBUG
+static bool timerWheelIsValid(const TloTimerWheel *wheel) {
+  if (!wheel) {
+    return false;
+  }
+
+  // the slots before now's slot are empty in every level
+  for (size_t level = 0; level < TLO_TIMER_WHEEL_NUM_LEVELS; ++level) {
+    size_t slot = slotOf(wheel->now, level);
+    uint64_t before = ((uint64_t)1 << slot) - 1;
+    if (wheel->occupied[level] & before) {
+      return false;
+    }
+  }
+
+  return true;
+}
+#endif
+
+void tloTimerConstruct(TloTimer *timer) {
+  assert(timer);
+
+  timer->slot = NULL;
+  timer->deadline = 0;
+}
+
+bool tloTimerIsScheduled(const TloTimer *timer) {
+  assert(timer);
+
+  return timer->slot != NULL;
+}
+
+uint64_t tloTimerDeadline(const TloTimer *timer) {
+  assert(timer);
+
+  return timer->deadline;
+}
+
+void tloTimerWheelConstruct(TloTimerWheel *wheel, uint64_t now) {
+  assert(wheel);
+
+  wheel->now = now;
+  wheel->size = 0;
+  for (size_t level = 0; level < TLO_TIMER_WHEEL_NUM_LEVELS; ++level) {
+    wheel->occupied[level] = 0;
+  }
+  for (size_t i = 0;
+       i < TLO_TIMER_WHEEL_NUM_LEVELS * TLO_TIMER_WHEEL_NUM_SLOTS; ++i) {
+    tloIDLListConstruct(&wheel->slots[i]);
+  }
+}
+
+uint64_t tloTimerWheelNow(const TloTimerWheel *wheel) {
+  assert(timerWheelIsValid(wheel));
+
+  return wheel->now;
+}
+
+size_t tloTimerWheelSize(const TloTimerWheel *wheel) {
+  assert(timerWheelIsValid(wheel));
+
+  return wheel->size;
+}
+
+bool tloTimerWheelIsEmpty(const TloTimerWheel *wheel) {
+  assert(timerWheelIsValid(wheel));
+
+  return wheel->size == 0;
+}
+
+static TloIDLList *slotAt(TloTimerWheel *wheel, size_t level, size_t slot) {
+  return &wheel->slots[level * TLO_TIMER_WHEEL_NUM_SLOTS + slot];
+}
+
+// links timer into its slot, by its deadline, or by now if that's earlier
+static void linkTimer(TloTimerWheel *wheel, TloTimer *timer) {
+  uint64_t at = timer->deadline > wheel->now ? timer->deadline : wheel->now;
+  size_t level = levelOf(at, wheel->now);
+  size_t slot = slotOf(at, level);
+
+  timer->slot = slotAt(wheel, level, slot);
+  tloIDLListPushBack(timer->slot, &timer->hook);
+  wheel->occupied[level] |= (uint64_t)1 << slot;
+}
+
+void tloTimerWheelSchedule(TloTimerWheel *wheel, TloTimer *timer,
+                           uint64_t deadline) {
+  assert(timerWheelIsValid(wheel));
+  assert(timer && !timer->slot);
+
+  timer->deadline = deadline;
+  linkTimer(wheel, timer);
+  ++wheel->size;
+}
+
+bool tloTimerWheelCancel(TloTimerWheel *wheel, TloTimer *timer) {
+  assert(timerWheelIsValid(wheel));
+  assert(timer);
+
+  if (!timer->slot) {
+    return false;
+  }
+
+  assert(timer->slot >= wheel->slots &&
+         timer->slot < wheel->slots + TLO_TIMER_WHEEL_NUM_LEVELS *
+                                          TLO_TIMER_WHEEL_NUM_SLOTS);
+
+  tloIDLListRemove(timer->slot, &timer->hook);
+  if (tloIDLListIsEmpty(timer->slot)) {
+    size_t index = (size_t)(timer->slot - wheel->slots);
+    wheel->occupied[index / TLO_TIMER_WHEEL_NUM_SLOTS] &=
+        ~((uint64_t)1 << (index % TLO_TIMER_WHEEL_NUM_SLOTS));
+  }
+  timer->slot = NULL;
+  --wheel->size;
+  return true;
+}
+
+/*
+ * - finds the first slot with timers in the lowest level that has any, and
+ *   returns false if there's none
+ * - the levels cover ranges of time that come one after the other, and so
+ *   do the slots within a level, so that slot's start is the earliest
+ */
+static bool findFirstSlot(const TloTimerWheel *wheel, size_t *level,
+                          size_t *slot) {
+  for (size_t i = 0; i < TLO_TIMER_WHEEL_NUM_LEVELS; ++i) {
+    if (wheel->occupied[i]) {
+      *level = i;
+      *slot = lowestSetBit(wheel->occupied[i]);
+      return true;
+    }
+  }
+
+  return false;
+}
+
+/*
+ * - goes from slot to slot in order of time, up to the given now. at level
+ *   0, a slot's timers are all due at its start, so they expire. above it,
+ *   now is moved to the slot's start and its timers are linked again, which
+ *   puts each in a lower level, since its deadline is now in the same slot
+ *   as now
+ */
+size_t tloTimerWheelAdvance(TloTimerWheel *wheel, uint64_t now,
+                            TloIDLList *expired) {
+  assert(timerWheelIsValid(wheel));
+  assert(now >= wheel->now);
+  assert(expired);
+
+  size_t numExpired = 0;
+  size_t level;
+  size_t slot;
+  while (findFirstSlot(wheel, &level, &slot)) {
+    uint64_t start = slotStart(wheel->now, level, slot);
+    if (start > now) {
+      break;
+    }
+
+    if (start > wheel->now) {
+      wheel->now = start;
+    }
+
+    // a TloIDLList doesn't point into itself, so the slot's timers can be
+    // taken by copying it
+    TloIDLList due = *slotAt(wheel, level, slot);
+    tloIDLListConstruct(slotAt(wheel, level, slot));
+    wheel->occupied[level] &= ~((uint64_t)1 << slot);
+
+    while (!tloIDLListIsEmpty(&due)) {
+      TloTimer *timer =
+          TLO_CONTAINER_OF(tloIDLListPopFront(&due), TloTimer, hook);
+      if (level == 0) {
+        timer->slot = NULL;
+        tloIDLListPushBack(expired, &timer->hook);
+        ++numExpired;
+      } else {
+        linkTimer(wheel, timer);
+      }
+    }
+  }
+
+  wheel->now = now;
+  wheel->size -= numExpired;
+  return numExpired;
+}
+
+bool tloTimerWheelNextExpiry(const TloTimerWheel *wheel, uint64_t *time) {
+  assert(timerWheelIsValid(wheel));
+  assert(time);
+
+  size_t level;
+  size_t slot;
+  if (!findFirstSlot(wheel, &level, &slot)) {
+    return false;
+  }
+
+  *time = slotStart(wheel->now, level, slot);
+  return true;
+}
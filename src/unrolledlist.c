@@ -0,0 +1,595 @@
+#include "tlo/unrolledlist.h"
+#include <assert.h>
+#include <string.h>
+#include "list.h"
+#include "util.h"
+
+#ifndef NDEBUG
+static bool ulistIsValid(const TloList *list) {
+  const TloUnrolledList *ulist = (const TloUnrolledList *)list;
+  return listIsValid(list) && ulist->nodeCapacity &&
+         ((ulist->head == NULL) == (ulist->size == 0)) &&
+         ((ulist->tail == NULL) == (ulist->size == 0)) &&
+         (ulist->head == NULL || (ulist->head->begin < ulist->head->end &&
+                                  ulist->tail->begin < ulist->tail->end));
+}
+#endif
+
+static size_t nodeSize(const TloUnrolledList *ulist) {
+  return sizeof(TloUnrolledListNode) +
+         ulist->nodeCapacity * ulist->list.valueType->size;
+}
+
+static const void *constElement(const TloUnrolledList *ulist,
+                                const TloUnrolledListNode *node,
+                                size_t position) {
+  return node->data + position * ulist->list.valueType->size;
+}
+
+static void *mutableElement(const TloUnrolledList *ulist,
+                            TloUnrolledListNode *node, size_t position) {
+  return node->data + position * ulist->list.valueType->size;
+}
+
+static void freeNode(TloUnrolledList *ulist, TloUnrolledListNode *node) {
+  tloAllocatorSizedFree(ulist->list.allocator, node, nodeSize(ulist));
+}
+
+static void destructElementsOfNode(TloUnrolledList *ulist,
+                                   TloUnrolledListNode *node) {
+  if (!ulist->list.valueType->destruct) {
+    return;
+  }
+
+  for (size_t i = node->begin; i < node->end; ++i) {
+    tloTypeDestruct(ulist->list.valueType, mutableElement(ulist, node, i));
+  }
+}
+
+static void deleteAllNodes(TloUnrolledList *ulist) {
+  TloUnrolledListNode *current = ulist->head;
+
+  while (current) {
+    TloUnrolledListNode *next = current->next;
+    destructElementsOfNode(ulist, current);
+    freeNode(ulist, current);
+    current = next;
+  }
+}
+
+static void ulistDestruct(TloList *list) {
+  if (!list) {
+    return;
+  }
+
+  assert(ulistIsValid(list));
+
+  TloUnrolledList *ulist = (TloUnrolledList *)list;
+  deleteAllNodes(ulist);
+
+  if (ulist->spare) {
+    freeNode(ulist, ulist->spare);
+  }
+
+  ulist->head = NULL;
+  ulist->tail = NULL;
+  ulist->spare = NULL;
+  ulist->size = 0;
+}
+
+static size_t ulistSize(const TloList *list) {
+  assert(ulistIsValid(list));
+
+  const TloUnrolledList *ulist = (const TloUnrolledList *)list;
+  return ulist->size;
+}
+
+static bool ulistIsEmpty(const TloList *list) {
+  assert(ulistIsValid(list));
+
+  const TloUnrolledList *ulist = (const TloUnrolledList *)list;
+  return ulist->size == 0;
+}
+
+static const void *ulistFront(const TloList *list) {
+  assert(ulistIsValid(list));
+  assert(!ulistIsEmpty(list));
+
+  const TloUnrolledList *ulist = (const TloUnrolledList *)list;
+  return constElement(ulist, ulist->head, ulist->head->begin);
+}
+
+static void *ulistMutableFront(TloList *list) {
+  assert(ulistIsValid(list));
+  assert(!ulistIsEmpty(list));
+
+  TloUnrolledList *ulist = (TloUnrolledList *)list;
+  return mutableElement(ulist, ulist->head, ulist->head->begin);
+}
+
+static const void *ulistBack(const TloList *list) {
+  assert(ulistIsValid(list));
+  assert(!ulistIsEmpty(list));
+
+  const TloUnrolledList *ulist = (const TloUnrolledList *)list;
+  return constElement(ulist, ulist->tail, ulist->tail->end - 1);
+}
+
+static void *ulistMutableBack(TloList *list) {
+  assert(ulistIsValid(list));
+  assert(!ulistIsEmpty(list));
+
+  TloUnrolledList *ulist = (TloUnrolledList *)list;
+  return mutableElement(ulist, ulist->tail, ulist->tail->end - 1);
+}
+
+// begin and end are both set to position, so the new node is empty
+static TloUnrolledListNode *makeNode(TloUnrolledList *ulist, size_t position) {
+  TloUnrolledListNode *node = ulist->spare;
+  if (node) {
+    ulist->spare = NULL;
+  } else {
+    node = tloAllocatorMalloc(ulist->list.allocator, nodeSize(ulist));
+    if (!node) {
+      return NULL;
+    }
+  }
+
+  node->next = NULL;
+  node->prev = NULL;
+  node->begin = position;
+  node->end = position;
+  return node;
+}
+
+static void unlinkNode(TloUnrolledList *ulist, TloUnrolledListNode *node) {
+  if (node->prev) {
+    node->prev->next = node->next;
+  } else {
+    ulist->head = node->next;
+  }
+
+  if (node->next) {
+    node->next->prev = node->prev;
+  } else {
+    ulist->tail = node->prev;
+  }
+}
+
+static void removeNodeIfEmpty(TloUnrolledList *ulist,
+                              TloUnrolledListNode *node) {
+  if (node->begin != node->end) {
+    return;
+  }
+
+  unlinkNode(ulist, node);
+
+  if (!ulist->spare) {
+    ulist->spare = node;
+  } else {
+    freeNode(ulist, node);
+  }
+}
+
+static TloUnrolledListNode *tailWithRoom(TloUnrolledList *ulist) {
+  if (ulist->tail && ulist->tail->end < ulist->nodeCapacity) {
+    return ulist->tail;
+  }
+
+  TloUnrolledListNode *node = makeNode(ulist, 0);
+  if (!node) {
+    return NULL;
+  }
+
+  node->prev = ulist->tail;
+  if (ulist->tail) {
+    ulist->tail->next = node;
+  } else {
+    ulist->head = node;
+  }
+  ulist->tail = node;
+
+  return node;
+}
+
+static TloError ulistPushBack(TloList *list, const void *data) {
+  assert(ulistIsValid(list));
+  assert(data);
+
+  TloUnrolledList *ulist = (TloUnrolledList *)list;
+  TloUnrolledListNode *node = tailWithRoom(ulist);
+  if (!node) {
+    return TLO_ERROR;
+  }
+
+  if (tloTypeConstructCopy(ulist->list.valueType,
+                           mutableElement(ulist, node, node->end),
+                           data) != TLO_SUCCESS) {
+    removeNodeIfEmpty(ulist, node);
+    return TLO_ERROR;
+  }
+
+  ++node->end;
+  ++ulist->size;
+
+  return TLO_SUCCESS;
+}
+
+static TloError ulistMoveBack(TloList *list, void *data) {
+  assert(ulistIsValid(list));
+  assert(data);
+
+  TloUnrolledList *ulist = (TloUnrolledList *)list;
+  TloUnrolledListNode *node = tailWithRoom(ulist);
+  if (!node) {
+    return TLO_ERROR;
+  }
+
+  memcpy(mutableElement(ulist, node, node->end), data,
+         ulist->list.valueType->size);
+  tloAllocatorSizedFree(ulist->list.allocator, data,
+                        ulist->list.valueType->size);
+
+  ++node->end;
+  ++ulist->size;
+
+  return TLO_SUCCESS;
+}
+
+static TloUnrolledListNode *headWithRoom(TloUnrolledList *ulist) {
+  if (ulist->head && ulist->head->begin > 0) {
+    return ulist->head;
+  }
+
+  TloUnrolledListNode *node = makeNode(ulist, ulist->nodeCapacity);
+  if (!node) {
+    return NULL;
+  }
+
+  node->next = ulist->head;
+  if (ulist->head) {
+    ulist->head->prev = node;
+  } else {
+    ulist->tail = node;
+  }
+  ulist->head = node;
+
+  return node;
+}
+
+static TloError ulistPushFront(TloList *list, const void *data) {
+  assert(ulistIsValid(list));
+  assert(data);
+
+  TloUnrolledList *ulist = (TloUnrolledList *)list;
+  TloUnrolledListNode *node = headWithRoom(ulist);
+  if (!node) {
+    return TLO_ERROR;
+  }
+
+  if (tloTypeConstructCopy(ulist->list.valueType,
+                           mutableElement(ulist, node, node->begin - 1),
+                           data) != TLO_SUCCESS) {
+    removeNodeIfEmpty(ulist, node);
+    return TLO_ERROR;
+  }
+
+  --node->begin;
+  ++ulist->size;
+
+  return TLO_SUCCESS;
+}
+
+static TloError ulistMoveFront(TloList *list, void *data) {
+  assert(ulistIsValid(list));
+  assert(data);
+
+  TloUnrolledList *ulist = (TloUnrolledList *)list;
+  TloUnrolledListNode *node = headWithRoom(ulist);
+  if (!node) {
+    return TLO_ERROR;
+  }
+
+  memcpy(mutableElement(ulist, node, node->begin - 1), data,
+         ulist->list.valueType->size);
+  tloAllocatorSizedFree(ulist->list.allocator, data,
+                        ulist->list.valueType->size);
+
+  --node->begin;
+  ++ulist->size;
+
+  return TLO_SUCCESS;
+}
+
+static void ulistPopFront(TloList *list) {
+  assert(ulistIsValid(list));
+  assert(!ulistIsEmpty(list));
+
+  TloUnrolledList *ulist = (TloUnrolledList *)list;
+  TloUnrolledListNode *node = ulist->head;
+  tloTypeDestruct(ulist->list.valueType,
+                  mutableElement(ulist, node, node->begin));
+  ++node->begin;
+  --ulist->size;
+
+  removeNodeIfEmpty(ulist, node);
+}
+
+static void ulistPopBack(TloList *list) {
+  assert(ulistIsValid(list));
+  assert(!ulistIsEmpty(list));
+
+  TloUnrolledList *ulist = (TloUnrolledList *)list;
+  TloUnrolledListNode *node = ulist->tail;
+  --node->end;
+  tloTypeDestruct(ulist->list.valueType, mutableElement(ulist, node, node->end));
+  --ulist->size;
+
+  removeNodeIfEmpty(ulist, node);
+}
+
+// returns the node of the element at index and sets position to its position
+// in the node
+static TloUnrolledListNode *findNode(const TloUnrolledList *ulist,
+                                     size_t index, size_t *position) {
+  if (index < ulist->size / 2) {
+    TloUnrolledListNode *node = ulist->head;
+    while (index >= node->end - node->begin) {
+      index -= node->end - node->begin;
+      node = node->next;
+    }
+
+    *position = node->begin + index;
+    return node;
+  }
+
+  size_t indexFromBack = ulist->size - 1 - index;
+  TloUnrolledListNode *node = ulist->tail;
+  while (indexFromBack >= node->end - node->begin) {
+    indexFromBack -= node->end - node->begin;
+    node = node->prev;
+  }
+
+  *position = node->end - 1 - indexFromBack;
+  return node;
+}
+
+static const void *ulistElement(const TloList *list, size_t index) {
+  assert(ulistIsValid(list));
+  assert(index < ulistSize(list));
+
+  const TloUnrolledList *ulist = (const TloUnrolledList *)list;
+  size_t position;
+  const TloUnrolledListNode *node = findNode(ulist, index, &position);
+  return constElement(ulist, node, position);
+}
+
+static void *ulistMutableElement(TloList *list, size_t index) {
+  assert(ulistIsValid(list));
+  assert(index < ulistSize(list));
+
+  TloUnrolledList *ulist = (TloUnrolledList *)list;
+  size_t position;
+  TloUnrolledListNode *node = findNode(ulist, index, &position);
+  return mutableElement(ulist, node, position);
+}
+
+// a run per node, which is never empty
+static void ulistForEachMutableRun(TloList *list,
+                                   void (*visit)(void *run, size_t size,
+                                                 void *context),
+                                   void *context) {
+  assert(ulistIsValid(list));
+  assert(visit);
+  TloUnrolledList *ulist = (TloUnrolledList *)list;
+
+  for (TloUnrolledListNode *node = ulist->head; node; node = node->next) {
+    visit(mutableElement(ulist, node, node->begin), node->end - node->begin,
+          context);
+  }
+}
+
+static const TloListVTable vTable = {.type = "TloUnrolledList",
+                                     .destruct = ulistDestruct,
+                                     .size = ulistSize,
+                                     .isEmpty = ulistIsEmpty,
+                                     .front = ulistFront,
+                                     .mutableFront = ulistMutableFront,
+                                     .back = ulistBack,
+                                     .mutableBack = ulistMutableBack,
+                                     .pushBack = ulistPushBack,
+                                     .moveBack = ulistMoveBack,
+                                     .element = ulistElement,
+                                     .mutableElement = ulistMutableElement,
+                                     .pushFront = ulistPushFront,
+                                     .moveFront = ulistMoveFront,
+                                     .popFront = ulistPopFront,
+                                     .popBack = ulistPopBack,
+                                     .forEachMutableRun =
+                                         ulistForEachMutableRun};
+
+void tloUnrolledListConstruct(TloUnrolledList *ulist, const TloType *valueType,
+                              const TloAllocator *allocator,
+                              size_t nodeCapacity) {
+  assert(ulist);
+  assert(typeIsValid(valueType));
+  assert(allocator == NULL || allocatorIsValid(allocator));
+
+  if (!nodeCapacity) {
+    size_t dataSize = TLO_UNROLLED_LIST_NODE_SIZE - sizeof(TloUnrolledListNode);
+    nodeCapacity = valueType->size < dataSize ? dataSize / valueType->size : 1;
+  }
+
+  tloListConstruct(&ulist->list, &vTable, valueType, allocator);
+  ulist->head = NULL;
+  ulist->tail = NULL;
+  ulist->spare = NULL;
+  ulist->size = 0;
+  ulist->nodeCapacity = nodeCapacity;
+}
+
+static TloError pushBackAllElementsOfOther(TloUnrolledList *ulist,
+                                           const TloUnrolledList *other) {
+  for (TloUnrolledListNode *node = other->head; node; node = node->next) {
+    for (size_t i = node->begin; i < node->end; ++i) {
+      const void *element = constElement(other, node, i);
+      if (ulistPushBack(&ulist->list, element) != TLO_SUCCESS) {
+        ulistDestruct(&ulist->list);
+        return TLO_ERROR;
+      }
+    }
+  }
+
+  return TLO_SUCCESS;
+}
+
+TloError tloUnrolledListConstructCopy(TloUnrolledList *ulist,
+                                      const TloUnrolledList *other) {
+  assert(ulist);
+  assert(ulistIsValid(&other->list));
+
+  tloUnrolledListConstruct(ulist, other->list.valueType, other->list.allocator,
+                           other->nodeCapacity);
+
+  if (pushBackAllElementsOfOther(ulist, other) != TLO_SUCCESS) {
+    return TLO_ERROR;
+  }
+
+  return TLO_SUCCESS;
+}
+
+TloUnrolledList *tloUnrolledListMake(const TloType *valueType,
+                                     const TloAllocator *allocator,
+                                     size_t nodeCapacity) {
+  assert(typeIsValid(valueType));
+
+  if (!allocator) {
+    allocator = &tloCStdLibAllocator;
+  }
+
+  assert(allocatorIsValid(allocator));
+
+  TloUnrolledList *ulist = tloAllocatorMalloc(allocator, sizeof(*ulist));
+  if (!ulist) {
+    return NULL;
+  }
+
+  tloUnrolledListConstruct(ulist, valueType, allocator, nodeCapacity);
+
+  return ulist;
+}
+
+TloUnrolledList *tloUnrolledListMakeCopy(const TloUnrolledList *other) {
+  assert(ulistIsValid(&other->list));
+
+  TloUnrolledList *ulist =
+      tloAllocatorMalloc(other->list.allocator, sizeof(*ulist));
+  if (!ulist) {
+    return NULL;
+  }
+
+  if (tloUnrolledListConstructCopy(ulist, other) != TLO_SUCCESS) {
+    tloAllocatorSizedFree(other->list.allocator, ulist, sizeof(*ulist));
+    return NULL;
+  }
+
+  return ulist;
+}
+
+TloError tloUnrolledListCopy(TloUnrolledList *ulist,
+                             const TloUnrolledList *other) {
+  assert(ulistIsValid(&ulist->list));
+  assert(ulistIsValid(&other->list));
+
+  TloUnrolledList copy;
+  if (tloUnrolledListConstructCopy(&copy, other) != TLO_SUCCESS) {
+    return TLO_ERROR;
+  }
+
+  ulistDestruct(&ulist->list);
+  memcpy(ulist, &copy, sizeof(TloUnrolledList));
+
+  return TLO_SUCCESS;
+}
+
+const TloUnrolledListNode *tloUnrolledListHead(const TloUnrolledList *ulist) {
+  assert(ulistIsValid(&ulist->list));
+
+  return ulist->head;
+}
+
+TloUnrolledListNode *tloUnrolledListMutableHead(TloUnrolledList *ulist) {
+  assert(ulistIsValid(&ulist->list));
+
+  return ulist->head;
+}
+
+const TloUnrolledListNode *tloUnrolledListTail(const TloUnrolledList *ulist) {
+  assert(ulistIsValid(&ulist->list));
+
+  return ulist->tail;
+}
+
+TloUnrolledListNode *tloUnrolledListMutableTail(TloUnrolledList *ulist) {
+  assert(ulistIsValid(&ulist->list));
+
+  return ulist->tail;
+}
+
+#ifndef NDEBUG
+static bool ulistnodeIsValid(const TloUnrolledListNode *node) {
+  return node && node->begin < node->end;
+}
+#endif
+
+size_t tloUnrolledListNodeSize(const TloUnrolledListNode *node) {
+  assert(ulistnodeIsValid(node));
+
+  return node->end - node->begin;
+}
+
+const void *tloUnrolledListNodeElement(const TloUnrolledList *ulist,
+                                       const TloUnrolledListNode *node,
+                                       size_t index) {
+  assert(ulistIsValid(&ulist->list));
+  assert(ulistnodeIsValid(node));
+  assert(index < tloUnrolledListNodeSize(node));
+
+  return constElement(ulist, node, node->begin + index);
+}
+
+void *tloUnrolledListNodeMutableElement(TloUnrolledList *ulist,
+                                        TloUnrolledListNode *node,
+                                        size_t index) {
+  assert(ulistIsValid(&ulist->list));
+  assert(ulistnodeIsValid(node));
+  assert(index < tloUnrolledListNodeSize(node));
+
+  return mutableElement(ulist, node, node->begin + index);
+}
+
+const TloUnrolledListNode *tloUnrolledListNodeNext(
+    const TloUnrolledListNode *node) {
+  assert(ulistnodeIsValid(node));
+
+  return node->next;
+}
+
+TloUnrolledListNode *tloUnrolledListNodeMutableNext(TloUnrolledListNode *node) {
+  assert(ulistnodeIsValid(node));
+
+  return node->next;
+}
+
+const TloUnrolledListNode *tloUnrolledListNodePrev(
+    const TloUnrolledListNode *node) {
+  assert(ulistnodeIsValid(node));
+
+  return node->prev;
+}
+
+TloUnrolledListNode *tloUnrolledListNodeMutablePrev(TloUnrolledListNode *node) {
+  assert(ulistnodeIsValid(node));
+
+  return node->prev;
+}
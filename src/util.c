@@ -1,5 +1,7 @@
 #include "util.h"
 #include <assert.h>
+#include <limits.h>
+#include <stdint.h>
 #include <stdlib.h>
 #include <string.h>
 
@@ -68,22 +70,107 @@ static int intCompare(const void *object1, const void *object2) {
   }
 }
 
-const TloType tloInt = {.size = sizeof(int), .compare = intCompare};
+static const TloIntegerKey intKey = {
+    .offset = 0, .size = sizeof(int), .isSigned = true};
 
-void *tloAllocatorMallocAndZeroInitialize(const TloAllocator *allocator,
-                                          size_t size) {
+const TloType tloInt = {
+    .size = sizeof(int), .compare = intCompare, .integerKey = &intKey};
+
+void *tloAllocatorMalloc(const TloAllocator *allocator, size_t size) {
+  assert(allocatorIsValid(allocator));
+
+  return allocator->malloc(allocator->context, size);
+}
+
+void tloAllocatorFree(const TloAllocator *allocator, void *memory) {
   assert(allocatorIsValid(allocator));
 
-  void *memory = allocator->malloc(size);
+  allocator->free(allocator->context, memory);
+}
+
+void tloAllocatorSizedFree(const TloAllocator *allocator, void *memory,
+                           size_t size) {
+  assert(allocatorIsValid(allocator));
+
+  if (allocator->sizedFree) {
+    allocator->sizedFree(allocator->context, memory, size);
+  } else {
+    allocator->free(allocator->context, memory);
+  }
+}
+
+void *tloAllocatorRealloc(const TloAllocator *allocator, void *memory,
+                          size_t size, size_t newSize) {
+  assert(allocatorIsValid(allocator));
+  assert(memory);
+  assert(newSize);
+
+  if (allocator->realloc) {
+    return allocator->realloc(allocator->context, memory, size, newSize);
+  }
+
+  void *newMemory = allocator->malloc(allocator->context, newSize);
+  if (!newMemory) {
+    return NULL;
+  }
+
+  memcpy(newMemory, memory, size < newSize ? size : newSize);
+  tloAllocatorSizedFree(allocator, memory, size);
+  return newMemory;
+}
+
+void *tloAllocatorCalloc(const TloAllocator *allocator, size_t count,
+                         size_t size) {
+  assert(allocatorIsValid(allocator));
+
+  if (allocator->calloc) {
+    return allocator->calloc(allocator->context, count, size);
+  }
+
+  if (size && count > SIZE_MAX / size) {
+    return NULL;
+  }
+
+  void *memory = allocator->malloc(allocator->context, count * size);
   if (!memory) {
     return NULL;
   }
 
-  memset(memory, 0, size);
+  memset(memory, 0, count * size);
   return memory;
 }
 
-const TloAllocator tloCStdLibAllocator = {.malloc = malloc, .free = free};
+void *tloAllocatorMallocAndZeroInitialize(const TloAllocator *allocator,
+                                          size_t size) {
+  return tloAllocatorCalloc(allocator, 1, size);
+}
+
+static void *cstdlibMalloc(void *context, size_t size) {
+  (void)context;
+  return malloc(size);
+}
+
+static void cstdlibFree(void *context, void *memory) {
+  (void)context;
+  free(memory);
+}
+
+static void *cstdlibRealloc(void *context, void *memory, size_t size,
+                            size_t newSize) {
+  (void)context;
+  (void)size;
+  return realloc(memory, newSize);
+}
+
+static void *cstdlibCalloc(void *context, size_t count, size_t size) {
+  (void)context;
+  return calloc(count, size);
+}
+
+const TloAllocator tloCStdLibAllocator = {.malloc = cstdlibMalloc,
+                                          .free = cstdlibFree,
+                                          .realloc = cstdlibRealloc,
+                                          .calloc = cstdlibCalloc};
 
 void tloPtrDestruct(void *ptr) {
   int **ptrptr = ptr;
@@ -157,3 +244,31 @@ bool typeIsValid(const TloType *type) { return type && type->size; }
 bool allocatorIsValid(const TloAllocator *allocator) {
   return allocator && allocator->malloc && allocator->free;
 }
+
+bool isPowerOfTwo(size_t n) { return n && !(n & (n - 1)); }
+
+size_t roundUpToPowerOfTwo(size_t n) {
+  if (n <= 1) {
+    return n;
+  }
+
+  --n;
+  for (size_t shift = 1; shift < sizeof(n) * CHAR_BIT; shift *= 2) {
+    n |= n >> shift;
+  }
+  return n + 1;
+}
+
+// by de Bruijn multiplication, which needs no compiler builtins
+size_t lowestSetBit(uint64_t bits) {
+  static const unsigned char indices[64] = {
+      0,  1,  48, 2,  57, 49, 28, 3,  61, 58, 50, 42, 38, 29, 17, 4,
+      62, 55, 59, 36, 53, 51, 43, 22, 45, 39, 33, 30, 24, 18, 12, 5,
+      63, 47, 56, 27, 60, 41, 37, 16, 54, 35, 52, 21, 44, 32, 23, 11,
+      46, 26, 40, 15, 34, 20, 31, 10, 25, 14, 19, 9,  13, 8,  7,  6};
+
+  assert(bits);
+
+  uint64_t lowest = bits & (~bits + 1);
+  return indices[(lowest * UINT64_C(0x03F79D71B4CB0A89)) >> 58];
+}
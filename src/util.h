@@ -6,4 +6,15 @@
 bool typeIsValid(const TloType *type);
 bool allocatorIsValid(const TloAllocator *allocator);
 
+bool isPowerOfTwo(size_t n);
+
+/*
+ * - returns the smallest power of 2 that is >= n, or n itself if it is 0
+ * - returns 0 if that power of 2 doesn't fit in a size_t
+ */
+size_t roundUpToPowerOfTwo(size_t n);
+
+// returns the index of the lowest set bit of bits, which must not be 0
+size_t lowestSetBit(uint64_t bits);
+
 #endif  // SRC_UTIL_H
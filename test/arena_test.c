@@ -0,0 +1,237 @@
+#include "arena_test.h"
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <tlo/arena.h>
+#include <tlo/schtable.h>
+#include <tlo/sllist.h>
+#include <tlo/test.h>
+#include "list_test_utils.h"
+#include "map_test_utils.h"
+#include "util.h"
+
+enum { SMALL_BLOCK_SIZE = 256 };
+
+static bool isAligned(const void *memory) {
+  return (uintptr_t)memory % _Alignof(max_align_t) == 0;
+}
+
+static void testArenaConstructDestruct(void) {
+  unsigned long mallocCount = countingAllocatorMallocCount();
+  TloArena arena;
+  tloArenaConstruct(&arena, &countingAllocator, 0);
+
+  TLO_EXPECT(countingAllocatorMallocCount() == mallocCount);
+
+  tloArenaDestruct(&arena);
+}
+
+static void testArenaMakeDelete(void) {
+  TloArena *arena = tloArenaMake(&countingAllocator, 0);
+  TLO_ASSERT(arena);
+
+  tloArenaDelete(arena);
+}
+
+static void testArenaMallocManyTimes(void) {
+  TloArena arena;
+  tloArenaConstruct(&arena, &countingAllocator, SMALL_BLOCK_SIZE);
+  unsigned char *memories[MAX_LIST_SIZE];
+
+  unsigned long mallocCount = countingAllocatorMallocCount();
+  for (size_t i = 0; i < MAX_LIST_SIZE; ++i) {
+    memories[i] = tloAllocatorMalloc(&arena.allocator, i + 1);
+    TLO_ASSERT(memories[i]);
+    TLO_EXPECT(isAligned(memories[i]));
+    memset(memories[i], (int)i, i + 1);
+  }
+  TLO_EXPECT(countingAllocatorMallocCount() - mallocCount < MAX_LIST_SIZE);
+
+  for (size_t i = 0; i < MAX_LIST_SIZE; ++i) {
+    for (size_t j = 0; j <= i; ++j) {
+      TLO_EXPECT(memories[i][j] == i);
+    }
+  }
+
+  tloArenaDestruct(&arena);
+}
+
+static void testArenaMallocLargerThanBlock(void) {
+  TloArena arena;
+  tloArenaConstruct(&arena, &countingAllocator, SMALL_BLOCK_SIZE);
+
+  int *small1 = tloAllocatorMalloc(&arena.allocator, sizeof(*small1));
+  TLO_ASSERT(small1);
+  *small1 = 1;
+
+  unsigned char *large =
+      tloAllocatorMalloc(&arena.allocator, 4 * SMALL_BLOCK_SIZE);
+  TLO_ASSERT(large);
+  TLO_EXPECT(isAligned(large));
+  memset(large, 0xff, 4 * SMALL_BLOCK_SIZE);
+
+  // the large allocation shouldn't take the place of the current block
+  unsigned long mallocCount = countingAllocatorMallocCount();
+  int *small2 = tloAllocatorMalloc(&arena.allocator, sizeof(*small2));
+  TLO_ASSERT(small2);
+  *small2 = 2;
+  TLO_EXPECT(countingAllocatorMallocCount() == mallocCount);
+
+  TLO_EXPECT(*small1 == 1);
+  TLO_EXPECT(*small2 == 2);
+
+  tloArenaDestruct(&arena);
+}
+
+static void testArenaSizedFreeAndReallocMostRecent(void) {
+  TloArena arena;
+  tloArenaConstruct(&arena, &countingAllocator, SMALL_BLOCK_SIZE);
+
+  int *ints = tloAllocatorMalloc(&arena.allocator, 2 * sizeof(*ints));
+  TLO_ASSERT(ints);
+  ints[0] = 0;
+  ints[1] = 1;
+
+  int *grown = tloAllocatorRealloc(&arena.allocator, ints, 2 * sizeof(*ints),
+                                   4 * sizeof(*ints));
+  TLO_EXPECT(grown == ints);
+  TLO_EXPECT(grown[0] == 0);
+  TLO_EXPECT(grown[1] == 1);
+
+  tloAllocatorSizedFree(&arena.allocator, grown, 4 * sizeof(*grown));
+  int *reused = tloAllocatorMalloc(&arena.allocator, sizeof(*reused));
+  TLO_EXPECT(reused == grown);
+
+  // not the most recent allocation anymore, so it has to move
+  int *other = tloAllocatorMalloc(&arena.allocator, sizeof(*other));
+  TLO_ASSERT(other);
+  *reused = 42;
+  int *moved = tloAllocatorRealloc(&arena.allocator, reused, sizeof(*reused),
+                                   2 * sizeof(*reused));
+  TLO_ASSERT(moved);
+  TLO_EXPECT(moved != reused);
+  TLO_EXPECT(*moved == 42);
+
+  tloArenaDestruct(&arena);
+}
+
+static void testArenaMallocAndZeroInitialize(void) {
+  TloArena arena;
+  tloArenaConstruct(&arena, &countingAllocator, SMALL_BLOCK_SIZE);
+
+  unsigned char *bytes = tloAllocatorMalloc(&arena.allocator, MAX_LIST_SIZE);
+  TLO_ASSERT(bytes);
+  memset(bytes, 0xff, MAX_LIST_SIZE);
+  tloAllocatorSizedFree(&arena.allocator, bytes, MAX_LIST_SIZE);
+
+  bytes = tloAllocatorMallocAndZeroInitialize(&arena.allocator, MAX_LIST_SIZE);
+  TLO_ASSERT(bytes);
+  for (size_t i = 0; i < MAX_LIST_SIZE; ++i) {
+    TLO_EXPECT(bytes[i] == 0);
+  }
+
+  tloArenaDestruct(&arena);
+}
+
+static void testArenaResetKeepsOneBlock(void) {
+  TloArena arena;
+  tloArenaConstruct(&arena, &countingAllocator, SMALL_BLOCK_SIZE);
+
+  for (size_t i = 0; i < MAX_LIST_SIZE; ++i) {
+    TLO_ASSERT(tloAllocatorMalloc(&arena.allocator, SMALL_BLOCK_SIZE / 2));
+  }
+
+  unsigned long freeCount = countingAllocatorFreeCount();
+  tloArenaReset(&arena);
+  TLO_EXPECT(countingAllocatorFreeCount() > freeCount);
+  TLO_EXPECT(countingAllocatorMallocCount() - countingAllocatorFreeCount() ==
+             1);
+
+  unsigned long mallocCount = countingAllocatorMallocCount();
+  TLO_ASSERT(tloAllocatorMalloc(&arena.allocator, SMALL_BLOCK_SIZE / 2));
+  TLO_EXPECT(countingAllocatorMallocCount() == mallocCount);
+
+  tloArenaDestruct(&arena);
+}
+
+static void testArenaWithSLList(void) {
+  TloArena arena;
+  tloArenaConstruct(&arena, &countingAllocator, SMALL_BLOCK_SIZE);
+
+  for (int round = 0; round < 2; ++round) {
+    TloSLList ints;
+    tloSLListConstruct(&ints, &tloInt, &arena.allocator);
+
+    for (int i = 0; i < MAX_LIST_SIZE; ++i) {
+      TloError error = tlovListPushBack(&ints.list, &i);
+      TLO_ASSERT(!error);
+    }
+
+    TLO_EXPECT(tlovListSize(&ints.list) == MAX_LIST_SIZE);
+    int i = 0;
+    for (const TloSLLNode *node = tloSLListHead(&ints); node;
+         node = tloSLLNodeNext(node)) {
+      TLO_EXPECT(*(const int *)tloSLLNodeElement(node) == i);
+      ++i;
+    }
+
+    // no need to destruct the list, ints don't own any memory
+    tloArenaReset(&arena);
+  }
+
+  tloArenaDestruct(&arena);
+}
+
+static void testArenaWithSCHTableMap(void) {
+  TloArena arena;
+  tloArenaConstruct(&arena, &countingAllocator, SMALL_BLOCK_SIZE);
+
+  TloSCHTableMap intsToInts;
+  tloSCHTableMapConstruct(&intsToInts, &tloInt, &tloInt, &arena.allocator);
+
+  for (int i = 0; i < MAX_MAP_SIZE; ++i) {
+    int value = i * 2;
+    TloError error =
+        tlovMapInsert(&intsToInts.map, TLO_COPY, &i, TLO_COPY, &value);
+    TLO_ASSERT(!error);
+  }
+
+  for (int i = 0; i < MAX_MAP_SIZE; i += 2) {
+    TLO_EXPECT(tlovMapRemove(&intsToInts.map, &i));
+  }
+
+  TLO_EXPECT(tlovMapSize(&intsToInts.map) == MAX_MAP_SIZE / 2);
+  for (int i = 0; i < MAX_MAP_SIZE; ++i) {
+    const int *value = tlovMapFind(&intsToInts.map, &i);
+    if (i % 2) {
+      TLO_ASSERT(value);
+      TLO_EXPECT(*value == i * 2);
+    } else {
+      TLO_EXPECT(!value);
+    }
+  }
+
+  tlovMapDestruct(&intsToInts.map);
+  tloArenaDestruct(&arena);
+}
+
+void testArena(void) {
+  testInitialCounts();
+
+  testArenaConstructDestruct();
+  testArenaMakeDelete();
+  testArenaMallocManyTimes();
+  testArenaMallocLargerThanBlock();
+  testArenaSizedFreeAndReallocMostRecent();
+  testArenaMallocAndZeroInitialize();
+  testArenaResetKeepsOneBlock();
+  testArenaWithSLList();
+  testArenaWithSCHTableMap();
+
+  printf("sizeof(TloArena): %zu\n", sizeof(TloArena));
+  testFinalCounts();
+  puts("=================");
+  puts("Arena tests done.");
+  puts("=================");
+}
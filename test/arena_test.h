@@ -0,0 +1,6 @@
+#ifndef TEST_ARENA_TEST_H
+#define TEST_ARENA_TEST_H
+
+void testArena(void);
+
+#endif  // TEST_ARENA_TEST_H
@@ -0,0 +1,267 @@
+#include "bitset_test.h"
+#include <stdio.h>
+#include <tlo/bitset.h>
+#include <tlo/test.h>
+#include "util.h"
+
+// not a multiple of 64, so the last word is partly used
+enum { MAX_BITSET_SIZE = 300 };
+
+// expects the 1 bits of bitset to be exactly the indices i where isSet(i)
+static void expectBits(const TloBitset *bitset, bool (*isSet)(size_t)) {
+  size_t size = tloBitsetSize(bitset);
+  size_t count = 0;
+  for (size_t i = 0; i < size; ++i) {
+    TLO_EXPECT(tloBitsetTest(bitset, i) == isSet(i));
+    count += isSet(i);
+  }
+  TLO_EXPECT(tloBitsetCount(bitset) == count);
+  TLO_EXPECT(tloBitsetAny(bitset) == (count != 0));
+
+  size_t expected = 0;
+  for (size_t i = tloBitsetFindNext(bitset, 0); i < size;
+       i = tloBitsetFindNext(bitset, i + 1)) {
+    while (!isSet(expected)) {
+      ++expected;
+    }
+    TLO_EXPECT(i == expected);
+    ++expected;
+  }
+  while (expected < size && !isSet(expected)) {
+    ++expected;
+  }
+  TLO_EXPECT(expected >= size);
+}
+
+static bool isMultipleOf3(size_t i) { return i % 3 == 0; }
+static bool isMultipleOf6(size_t i) { return i % 6 == 0; }
+static bool isMultipleOf2Or3(size_t i) { return i % 2 == 0 || i % 3 == 0; }
+static bool isMultipleOf2Xor3(size_t i) { return (i % 2 == 0) != (i % 3 == 0); }
+static bool isMultipleOf2Not3(size_t i) { return i % 2 == 0 && i % 3 != 0; }
+static bool isNone(size_t i) {
+  (void)i;
+  return false;
+}
+
+static void setMultiples(TloBitset *bitset, size_t step) {
+  for (size_t i = 0; i < tloBitsetSize(bitset); i += step) {
+    tloBitsetSet(bitset, i);
+  }
+}
+
+static void testBitsetConstruct(void) {
+  const size_t sizes[] = {0, 1, 64, 65, MAX_BITSET_SIZE};
+  for (size_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); ++i) {
+    TloBitset bitset;
+    TloError error = tloBitsetConstruct(&bitset, sizes[i], &countingAllocator);
+    TLO_ASSERT(!error);
+
+    TLO_EXPECT(tloBitsetSize(&bitset) == sizes[i]);
+    TLO_EXPECT(tloBitsetFindNext(&bitset, 0) == sizes[i]);
+    expectBits(&bitset, isNone);
+
+    tloBitsetDestruct(&bitset);
+  }
+}
+
+static void testBitsetSetClearFlip(void) {
+  TloBitset *bitset = tloBitsetMake(MAX_BITSET_SIZE, &countingAllocator);
+  TLO_ASSERT(bitset);
+
+  setMultiples(bitset, 3);
+  expectBits(bitset, isMultipleOf3);
+
+  // flipping the multiples of 3 and then all the even ones leaves them XORed
+  for (size_t i = 0; i < MAX_BITSET_SIZE; i += 2) {
+    tloBitsetFlip(bitset, i);
+  }
+  expectBits(bitset, isMultipleOf2Xor3);
+
+  for (size_t i = 0; i < MAX_BITSET_SIZE; i += 2) {
+    tloBitsetClear(bitset, i);
+  }
+  for (size_t i = 0; i < MAX_BITSET_SIZE; i += 3) {
+    tloBitsetClear(bitset, i);
+  }
+  expectBits(bitset, isNone);
+
+  tloBitsetDelete(bitset);
+}
+
+static void testBitsetSetAllAndResize(void) {
+  TloBitset *bitset = tloBitsetMake(130, &countingAllocator);
+  TLO_ASSERT(bitset);
+
+  tloBitsetSetAll(bitset);
+  TLO_EXPECT(tloBitsetCount(bitset) == 130);
+
+  // the bits added are 0
+  TloError error = tloBitsetResize(bitset, MAX_BITSET_SIZE);
+  TLO_ASSERT(!error);
+  TLO_EXPECT(tloBitsetCount(bitset) == 130);
+  TLO_EXPECT(tloBitsetFindNext(bitset, 130) == MAX_BITSET_SIZE);
+
+  // the bits cut off don't come back when growing again
+  error = tloBitsetResize(bitset, 70);
+  TLO_ASSERT(!error);
+  TLO_EXPECT(tloBitsetCount(bitset) == 70);
+  error = tloBitsetResize(bitset, MAX_BITSET_SIZE);
+  TLO_ASSERT(!error);
+  TLO_EXPECT(tloBitsetCount(bitset) == 70);
+  TLO_EXPECT(tloBitsetFindNext(bitset, 69) == 69);
+  TLO_EXPECT(tloBitsetFindNext(bitset, 70) == MAX_BITSET_SIZE);
+
+  tloBitsetClearAll(bitset);
+  expectBits(bitset, isNone);
+
+  tloBitsetDelete(bitset);
+}
+
+/*
+ * - makes the multiples of 2 below MAX_BITSET_SIZE and the multiples of 3
+ *   below size3
+ */
+static bool makeOperands(TloBitset *multiplesOf2, TloBitset *multiplesOf3,
+                         size_t size3) {
+  if (tloBitsetConstruct(multiplesOf2, MAX_BITSET_SIZE, &countingAllocator) !=
+      TLO_SUCCESS) {
+    return false;
+  }
+  if (tloBitsetConstruct(multiplesOf3, size3, &countingAllocator) !=
+      TLO_SUCCESS) {
+    tloBitsetDestruct(multiplesOf2);
+    return false;
+  }
+
+  setMultiples(multiplesOf2, 2);
+  setMultiples(multiplesOf3, 3);
+  return true;
+}
+
+static void testBitsetBulkOperations(void) {
+  TloBitset bitset;
+  TloBitset other;
+
+  bool made = makeOperands(&bitset, &other, MAX_BITSET_SIZE);
+  TLO_ASSERT(made);
+  tloBitsetAnd(&bitset, &other);
+  expectBits(&bitset, isMultipleOf6);
+  tloBitsetDestruct(&bitset);
+  tloBitsetDestruct(&other);
+
+  made = makeOperands(&bitset, &other, MAX_BITSET_SIZE);
+  TLO_ASSERT(made);
+  TloError error = tloBitsetOr(&bitset, &other);
+  TLO_ASSERT(!error);
+  expectBits(&bitset, isMultipleOf2Or3);
+  tloBitsetDestruct(&bitset);
+  tloBitsetDestruct(&other);
+
+  made = makeOperands(&bitset, &other, MAX_BITSET_SIZE);
+  TLO_ASSERT(made);
+  error = tloBitsetXor(&bitset, &other);
+  TLO_ASSERT(!error);
+  expectBits(&bitset, isMultipleOf2Xor3);
+  tloBitsetDestruct(&bitset);
+  tloBitsetDestruct(&other);
+
+  made = makeOperands(&bitset, &other, MAX_BITSET_SIZE);
+  TLO_ASSERT(made);
+  tloBitsetAndNot(&bitset, &other);
+  expectBits(&bitset, isMultipleOf2Not3);
+
+  // with itself
+  tloBitsetXor(&bitset, &bitset);
+  expectBits(&bitset, isNone);
+  tloBitsetDestruct(&bitset);
+  tloBitsetDestruct(&other);
+}
+
+static void testBitsetBulkOperationsDifferentSizes(void) {
+  TloBitset bitset;
+  TloBitset other;
+
+  // bits past the smaller one's size count as 0
+  bool made = makeOperands(&bitset, &other, 100);
+  TLO_ASSERT(made);
+  tloBitsetAnd(&bitset, &other);
+  TLO_EXPECT(tloBitsetSize(&bitset) == MAX_BITSET_SIZE);
+  TLO_EXPECT(tloBitsetCount(&bitset) == 17);
+  TLO_EXPECT(tloBitsetFindNext(&bitset, 97) == MAX_BITSET_SIZE);
+  tloBitsetDestruct(&bitset);
+  tloBitsetDestruct(&other);
+
+  made = makeOperands(&bitset, &other, 100);
+  TLO_ASSERT(made);
+  tloBitsetAndNot(&bitset, &other);
+  TLO_EXPECT(tloBitsetCount(&bitset) == MAX_BITSET_SIZE / 2 - 17);
+  tloBitsetDestruct(&bitset);
+  tloBitsetDestruct(&other);
+
+  // the smaller one grows to the bigger one's size
+  made = makeOperands(&bitset, &other, 100);
+  TLO_ASSERT(made);
+  TloError error = tloBitsetOr(&other, &bitset);
+  TLO_ASSERT(!error);
+  TLO_EXPECT(tloBitsetSize(&other) == MAX_BITSET_SIZE);
+  TLO_EXPECT(tloBitsetCount(&other) == MAX_BITSET_SIZE / 2 + 17);
+  tloBitsetDestruct(&bitset);
+  tloBitsetDestruct(&other);
+}
+
+static void testBitsetInsertContainsRemove(void) {
+  TloBitset *keys = tloBitsetMake(0, &countingAllocator);
+  TLO_ASSERT(keys);
+  TLO_EXPECT(!tloBitsetContains(keys, 0));
+
+  // counting down, so the first insert grows it all the way
+  for (size_t key = MAX_BITSET_SIZE * 10; key-- > 0;) {
+    if (key % 3 == 0) {
+      TloError error = tloBitsetInsert(keys, key);
+      TLO_ASSERT(!error);
+    }
+  }
+  TLO_EXPECT(tloBitsetSize(keys) == MAX_BITSET_SIZE * 10 - 2);
+  TLO_EXPECT(tloBitsetInsert(keys, 3) == TLO_DUPLICATE);
+  TLO_EXPECT(tloBitsetCount(keys) == MAX_BITSET_SIZE * 10 / 3);
+
+  for (size_t key = 0; key < MAX_BITSET_SIZE * 20; ++key) {
+    TLO_EXPECT(tloBitsetContains(keys, key) ==
+               (key % 3 == 0 && key < MAX_BITSET_SIZE * 10));
+  }
+
+  for (size_t key = 0; key < MAX_BITSET_SIZE * 10; key += 2) {
+    TLO_EXPECT(tloBitsetRemove(keys, key) == (key % 3 == 0));
+  }
+  TLO_EXPECT(!tloBitsetRemove(keys, MAX_BITSET_SIZE * 20));
+  TLO_EXPECT(tloBitsetCount(keys) == MAX_BITSET_SIZE * 10 / 6);
+
+  // counting up, so it grows by doubling
+  tloBitsetDelete(keys);
+  keys = tloBitsetMake(0, &countingAllocator);
+  TLO_ASSERT(keys);
+  for (size_t key = 0; key < MAX_BITSET_SIZE * 10; ++key) {
+    TloError error = tloBitsetInsert(keys, key);
+    TLO_ASSERT(!error);
+  }
+  TLO_EXPECT(tloBitsetCount(keys) == MAX_BITSET_SIZE * 10);
+
+  tloBitsetDelete(keys);
+}
+
+void testBitset(void) {
+  testInitialCounts();
+
+  testBitsetConstruct();
+  testBitsetSetClearFlip();
+  testBitsetSetAllAndResize();
+  testBitsetBulkOperations();
+  testBitsetBulkOperationsDifferentSizes();
+  testBitsetInsertContainsRemove();
+
+  printf("sizeof(TloBitset): %zu\n", sizeof(TloBitset));
+  testFinalCounts();
+  puts("==================");
+  puts("Bitset tests done.");
+  puts("==================");
+}
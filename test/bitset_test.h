@@ -0,0 +1,6 @@
+#ifndef TEST_BITSET_TEST_H
+#define TEST_BITSET_TEST_H
+
+void testBitset(void);
+
+#endif  // TEST_BITSET_TEST_H
@@ -0,0 +1,218 @@
+#include "btree_test.h"
+#include <stdio.h>
+#include <tlo/btree.h>
+#include <tlo/test.h>
+#include "map_test_utils.h"
+#include "util.h"
+
+// enough keys for a few levels of nodes
+enum { NUM_KEYS = 2000 };
+
+// 7919 and 1009 are primes that don't divide NUM_KEYS, so these visit every
+// key once, in two different orders
+static int insertionOrder(int i) { return (i * 7919) % NUM_KEYS; }
+static int removalOrder(int i) { return (i * 1009) % NUM_KEYS; }
+
+static TloMap *makeMapIntInt(void) {
+  return (TloMap *)tloBTreeMapMake(&tloInt, &tloInt, &countingAllocator);
+}
+
+static void expectKeysInOrder(const TloBTreeMap *btree, int first, int step) {
+  TloBTreeCursor cursor;
+  size_t count = 0;
+  int expected = first;
+
+  for (tloBTreeMapFirst(btree, &cursor); !tloBTreeCursorIsEnd(&cursor);
+       tloBTreeCursorNext(&cursor)) {
+    const int *key = tloBTreeCursorKey(&cursor);
+    const int *value = tloBTreeCursorValue(&cursor);
+    TLO_EXPECT(*key == expected);
+    TLO_EXPECT(*value == expected * 2);
+    expected += step;
+    ++count;
+  }
+
+  TLO_EXPECT(count == tlovMapSize(&btree->map));
+}
+
+static void testBTreeMapIntIntManyKeys(void) {
+  TloBTreeMap *btree = tloBTreeMapMake(&tloInt, &tloInt, &countingAllocator);
+  TLO_ASSERT(btree);
+
+  for (int i = 0; i < NUM_KEYS; ++i) {
+    int key = insertionOrder(i);
+    int value = key * 2;
+    TloError error =
+        tlovMapInsert(&btree->map, TLO_COPY, &key, TLO_COPY, &value);
+    TLO_ASSERT(!error);
+  }
+
+  EXPECT_MAP_PROPERTIES(&btree->map, NUM_KEYS, false, &tloInt, &tloInt,
+                        &countingAllocator);
+  expectKeysInOrder(btree, 0, 1);
+
+  // some of these hit a full node that gets split before it's found
+  for (int i = 0; i < NUM_KEYS; ++i) {
+    int key = i;
+    int value = 0;
+    TloError error =
+        tlovMapInsert(&btree->map, TLO_COPY, &key, TLO_COPY, &value);
+    TLO_EXPECT(error == TLO_DUPLICATE);
+  }
+  TLO_EXPECT(tlovMapSize(&btree->map) == NUM_KEYS);
+
+  for (int i = 0; i < NUM_KEYS; ++i) {
+    int key = removalOrder(i);
+    if (key % 2) {
+      bool removed = tlovMapRemove(&btree->map, &key);
+      TLO_EXPECT(removed);
+    }
+  }
+
+  TLO_EXPECT(tlovMapSize(&btree->map) == NUM_KEYS / 2);
+  expectKeysInOrder(btree, 0, 2);
+  for (int i = 0; i < NUM_KEYS; ++i) {
+    const int *value = tlovMapFind(&btree->map, &i);
+    if (i % 2) {
+      TLO_EXPECT(!value);
+    } else {
+      TLO_EXPECT(value && *value == i * 2);
+    }
+  }
+
+  for (int i = 0; i < NUM_KEYS; ++i) {
+    int key = removalOrder(i);
+    bool removed = tlovMapRemove(&btree->map, &key);
+    TLO_EXPECT(removed == !(key % 2));
+  }
+
+  EXPECT_MAP_PROPERTIES(&btree->map, 0, true, &tloInt, &tloInt,
+                        &countingAllocator);
+  expectKeysInOrder(btree, 0, 1);
+
+  tloMapDelete(&btree->map);
+}
+
+static void testBTreeMapIntIntRangeScans(void) {
+  TloBTreeMap *btree = tloBTreeMapMake(&tloInt, &tloInt, &countingAllocator);
+  TLO_ASSERT(btree);
+
+  TloBTreeCursor cursor;
+  int key = 0;
+  tloBTreeMapLowerBound(btree, &key, &cursor);
+  TLO_EXPECT(tloBTreeCursorIsEnd(&cursor));
+
+  // only even keys, so the odd ones fall between them
+  for (int i = 0; i < NUM_KEYS; ++i) {
+    key = insertionOrder(i) * 2;
+    int value = key * 2;
+    TloError error =
+        tlovMapInsert(&btree->map, TLO_COPY, &key, TLO_COPY, &value);
+    TLO_ASSERT(!error);
+  }
+
+  key = -1;
+  tloBTreeMapLowerBound(btree, &key, &cursor);
+  TLO_EXPECT(*(const int *)tloBTreeCursorKey(&cursor) == 0);
+  tloBTreeMapUpperBound(btree, &key, &cursor);
+  TLO_EXPECT(*(const int *)tloBTreeCursorKey(&cursor) == 0);
+  key = 1000;
+  tloBTreeMapLowerBound(btree, &key, &cursor);
+  TLO_EXPECT(*(const int *)tloBTreeCursorKey(&cursor) == 1000);
+  tloBTreeMapUpperBound(btree, &key, &cursor);
+  TLO_EXPECT(*(const int *)tloBTreeCursorKey(&cursor) == 1002);
+  key = 1001;
+  tloBTreeMapLowerBound(btree, &key, &cursor);
+  TLO_EXPECT(*(const int *)tloBTreeCursorKey(&cursor) == 1002);
+  tloBTreeMapUpperBound(btree, &key, &cursor);
+  TLO_EXPECT(*(const int *)tloBTreeCursorKey(&cursor) == 1002);
+  key = (NUM_KEYS - 1) * 2;
+  tloBTreeMapUpperBound(btree, &key, &cursor);
+  TLO_EXPECT(tloBTreeCursorIsEnd(&cursor));
+
+  // every key in [low, high), bumping their values on the way
+  int low = 301;
+  int high = 1501;
+  int expected = 302;
+  for (tloBTreeMapLowerBound(btree, &low, &cursor);
+       !tloBTreeCursorIsEnd(&cursor) &&
+       *(const int *)tloBTreeCursorKey(&cursor) < high;
+       tloBTreeCursorNext(&cursor)) {
+    TLO_EXPECT(*(const int *)tloBTreeCursorKey(&cursor) == expected);
+    int *value = tloBTreeCursorMutableValue(&cursor);
+    ++*value;
+    expected += 2;
+  }
+  TLO_EXPECT(expected == 1502);
+
+  for (int i = 0; i < NUM_KEYS; ++i) {
+    key = i * 2;
+    const int *value = tlovMapFind(&btree->map, &key);
+    TLO_ASSERT(value);
+    TLO_EXPECT(*value == key * 2 + (key > low && key < high));
+  }
+
+  tloMapDelete(&btree->map);
+}
+
+static void testBTreeMapIntPtrIntPtr(void) {
+  TloBTreeMap *btree =
+      tloBTreeMapMake(&intPtrType, &intPtrType, &countingAllocator);
+  TLO_ASSERT(btree);
+
+  for (int i = 0; i < NUM_KEYS; ++i) {
+    IntPtr *key = intPtrMake(insertionOrder(i));
+    TLO_ASSERT(key);
+    IntPtr value;
+    TloError error = intPtrConstruct(&value, i);
+    TLO_ASSERT(!error);
+    error = tlovMapInsert(&btree->map, TLO_MOVE, key, TLO_COPY, &value);
+    tloPtrDestruct(&value);
+    TLO_ASSERT(!error);
+  }
+
+  // the deep copies get moved between nodes as they're rebalanced
+  for (int i = 0; i < NUM_KEYS; i += 3) {
+    IntPtr key;
+    TloError error = intPtrConstruct(&key, removalOrder(i));
+    TLO_ASSERT(!error);
+    bool removed = tlovMapRemove(&btree->map, &key);
+    tloPtrDestruct(&key);
+    TLO_EXPECT(removed);
+  }
+
+  TloBTreeCursor cursor;
+  tloBTreeMapFirst(btree, &cursor);
+  int previous = -1;
+  size_t count = 0;
+  for (; !tloBTreeCursorIsEnd(&cursor); tloBTreeCursorNext(&cursor)) {
+    const IntPtr *key = tloBTreeCursorKey(&cursor);
+    TLO_EXPECT(*key->ptr > previous);
+    previous = *key->ptr;
+    ++count;
+  }
+  TLO_EXPECT(count == tlovMapSize(&btree->map));
+  TLO_EXPECT(count == NUM_KEYS - (NUM_KEYS + 2) / 3);
+
+  tloMapDelete(&btree->map);
+}
+
+void testBTree(void) {
+  testInitialCounts();
+
+  testMapIntIntInsertOnce(makeMapIntInt(), true);
+  testMapIntIntInsertOnce(makeMapIntInt(), false);
+  testMapIntIntInsertManyTimes(makeMapIntInt(), true);
+  testMapIntIntInsertManyTimes(makeMapIntInt(), false);
+  testMapIntIntInsertOnceRemoveOnce(makeMapIntInt());
+  testMapIntIntInsertManyTimesRemoveUntilEmpty(makeMapIntInt());
+  testBTreeMapIntIntManyKeys();
+  testBTreeMapIntIntRangeScans();
+  testBTreeMapIntPtrIntPtr();
+
+  printf("sizeof(TloBTreeMap): %zu\n", sizeof(TloBTreeMap));
+  testFinalCounts();
+  puts("=================");
+  puts("BTree tests done.");
+  puts("=================");
+}
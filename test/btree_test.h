@@ -0,0 +1,6 @@
+#ifndef TEST_BTREE_TEST_H
+#define TEST_BTREE_TEST_H
+
+void testBTree(void);
+
+#endif  // TEST_BTREE_TEST_H
@@ -1,6 +1,7 @@
 #include "cdarray_test.h"
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <tlo/cdarray.h>
 #include <tlo/test.h>
 #include "list_test_utils.h"
@@ -32,7 +33,8 @@ static void testCDArrayIntConstructWithCapacityDestruct(void) {
       tloCDArrayConstruct(&ints, &tloInt, &countingAllocator, MAX_LIST_SIZE);
   TLO_ASSERT(!error);
 
-  EXPECT_DARRAY_ALL_PROPERTIES(&ints, 0, MAX_LIST_SIZE, true, &tloInt,
+  // capacity is rounded up to a power of 2
+  EXPECT_DARRAY_ALL_PROPERTIES(&ints, 0, 64, true, &tloInt,
                                &countingAllocator);
 
   tlovListDestruct(&ints.list);
@@ -51,8 +53,7 @@ static void testCDArrayIntMakeWithCapacityDelete(void) {
   TloCDArray *ints = tloCDArrayMake(&tloInt, &countingAllocator, MAX_LIST_SIZE);
   TLO_ASSERT(ints);
 
-  EXPECT_DARRAY_ALL_PROPERTIES(ints, 0, MAX_LIST_SIZE, true, &tloInt,
-                               &countingAllocator);
+  EXPECT_DARRAY_ALL_PROPERTIES(ints, 0, 64, true, &tloInt, &countingAllocator);
 
   tloListDelete(&ints->list);
 }
@@ -148,6 +149,39 @@ static void testCDArrayIntCopy(void) {
   tloListDelete(&copy->list);
 }
 
+static void testCDArrayIntWrapAroundWithRoundedUpCapacity(void) {
+  TloCDArray *ints = tloCDArrayMake(&tloInt, &countingAllocator, 5);
+  TLO_ASSERT(ints);
+  EXPECT_DARRAY_ALL_PROPERTIES(ints, 0, 8, true, &tloInt, &countingAllocator);
+
+  TloError error;
+
+  for (int i = 2; i >= 0; --i) {
+    error = tlovListPushFront(&ints->list, &i);
+    TLO_ASSERT(!error);
+  }
+
+  for (int i = 3; i < 8; ++i) {
+    error = tlovListPushBack(&ints->list, &i);
+    TLO_ASSERT(!error);
+  }
+
+  /*
+                 Front
+                 |
+  [1 2 3 4 5 6 7 0]
+  */
+  EXPECT_DARRAY_ALL_PROPERTIES(ints, 8, 8, false, &tloInt, &countingAllocator);
+  for (int i = 0; i < 8; ++i) {
+    TLO_EXPECT(*(const int *)tlovListElement(&ints->list, (size_t)i) == i);
+  }
+
+  tlovListPopFront(&ints->list);
+  EXPECT_LIST_INT_ELEMENTS(&ints->list, 1, 7, 6, 7);
+
+  tloListDelete(&ints->list);
+}
+
 static void testCDArrayIntShrinkWhenElementsWrapAround(void) {
   TloCDArray *ints = tloCDArrayMake(&tloInt, &countingAllocator, 0);
   TLO_ASSERT(ints);
@@ -214,6 +248,261 @@ static void testCDArrayIntShrinkWhenElementsWrapAround(void) {
   tloListDelete(&ints->list);
 }
 
+static void testCDArrayIntExpandWhenElementsWrapAround(void) {
+  TloCDArray *ints = tloCDArrayMake(&tloInt, &countingAllocator, 4);
+  TLO_ASSERT(ints);
+
+  TloError error;
+
+  for (int i = 0; i < 4; ++i) {
+    error = tlovListPushBack(&ints->list, &i);
+    TLO_ASSERT(!error);
+  }
+
+  /*
+     Front
+     |
+  [3 0 1 2]
+  */
+  EXPECT_DARRAY_ALL_PROPERTIES(ints, 4, 4, false, &tloInt, &countingAllocator);
+  EXPECT_LIST_INT_ELEMENTS(&ints->list, 0, 3, 2, 2);
+
+  int value = 4;
+  error = tlovListPushBack(&ints->list, &value);
+  TLO_ASSERT(!error);
+
+  /*
+     Front
+     |
+  [- 0 1 2 3 4 - -]
+  */
+  EXPECT_DARRAY_ALL_PROPERTIES(ints, 5, 8, false, &tloInt, &countingAllocator);
+  EXPECT_LIST_INT_ELEMENTS(&ints->list, 0, 4, 3, 3);
+
+  tloListDelete(&ints->list);
+
+  ints = tloCDArrayMake(&tloInt, &countingAllocator, 4);
+  TLO_ASSERT(ints);
+
+  for (int i = 1; i >= 0; --i) {
+    error = tlovListPushFront(&ints->list, &i);
+    TLO_ASSERT(!error);
+  }
+
+  for (int i = 2; i < 4; ++i) {
+    error = tlovListPushBack(&ints->list, &i);
+    TLO_ASSERT(!error);
+  }
+
+  /*
+         Front
+         |
+  [1 2 3 0]
+  */
+  EXPECT_DARRAY_ALL_PROPERTIES(ints, 4, 4, false, &tloInt, &countingAllocator);
+  EXPECT_LIST_INT_ELEMENTS(&ints->list, 0, 3, 1, 1);
+
+  error = tlovListPushBack(&ints->list, &value);
+  TLO_ASSERT(!error);
+
+  /*
+                 Front
+                 |
+  [1 2 3 4 - - - 0]
+  */
+  EXPECT_DARRAY_ALL_PROPERTIES(ints, 5, 8, false, &tloInt, &countingAllocator);
+  EXPECT_LIST_INT_ELEMENTS(&ints->list, 0, 4, 1, 1);
+
+  tloListDelete(&ints->list);
+}
+
+// expects the elements in spans, in order, to be first, first + 1, and so on
+static void expectSpansHoldInts(const TloCDArraySpan spans[2], size_t count,
+                                int first, size_t size) {
+  size_t total = 0;
+  int expected = first;
+  for (size_t i = 0; i < 2; ++i) {
+    TLO_EXPECT((spans[i].size == 0) == (i >= count));
+    TLO_EXPECT((spans[i].elements == NULL) == (spans[i].size == 0));
+
+    const int *elements = spans[i].elements;
+    for (size_t j = 0; j < spans[i].size; ++j) {
+      TLO_EXPECT(elements[j] == expected);
+      ++expected;
+    }
+    total += spans[i].size;
+  }
+  TLO_EXPECT(total == size);
+}
+
+static void testCDArrayIntSpans(void) {
+  TloCDArray *ints = tloCDArrayMake(&tloInt, &countingAllocator, 0);
+  TLO_ASSERT(ints);
+
+  TloCDArraySpan spans[2];
+  size_t count = tloCDArraySpans(ints, spans);
+  TLO_EXPECT(count == 0);
+  expectSpansHoldInts(spans, count, 0, 0);
+
+  TloError error = tloCDArrayReserve(ints, 5);
+  TLO_ASSERT(!error);
+  TLO_EXPECT(tlovListCapacity(&ints->list) == 8);
+
+  for (int i = 0; i < 4; ++i) {
+    error = tlovListPushBack(&ints->list, &i);
+    TLO_ASSERT(!error);
+  }
+
+  /*
+       Front
+       |
+  [- - 0 1 2 3 - -]
+  */
+  count = tloCDArraySpans(ints, spans);
+  TLO_EXPECT(count == 1);
+  expectSpansHoldInts(spans, count, 0, 4);
+
+  for (int i = 4; i < 8; ++i) {
+    error = tlovListPushBack(&ints->list, &i);
+    TLO_ASSERT(!error);
+  }
+
+  /*
+       Front
+       |
+  [6 7 0 1 2 3 4 5]
+  */
+  count = tloCDArraySpans(ints, spans);
+  TLO_EXPECT(count == 2);
+  TLO_EXPECT(spans[0].size == 6);
+  expectSpansHoldInts(spans, count, 0, 8);
+
+  TloCDArrayMutableSpan mutableSpans[2];
+  count = tloCDArrayMutableSpans(ints, mutableSpans);
+  TLO_EXPECT(count == 2);
+  *(int *)mutableSpans[1].elements = 42;
+  TLO_EXPECT(*(const int *)tlovListElement(&ints->list, 6) == 42);
+
+  tloListDelete(&ints->list);
+}
+
+static void testCDArrayIntReserveKeepsWrappedElements(void) {
+  TloCDArray *ints = tloCDArrayMake(&tloInt, &countingAllocator, 4);
+  TLO_ASSERT(ints);
+
+  TloError error;
+  for (int i = 2; i < 6; ++i) {
+    error = tlovListPushBack(&ints->list, &i);
+    TLO_ASSERT(!error);
+  }
+  tlovListPopFront(&ints->list);
+  tlovListPopFront(&ints->list);
+
+  /*
+         Front
+         |
+  [5 - - 4]
+  */
+  error = tloCDArrayReserve(ints, 3);
+  TLO_ASSERT(!error);
+  TLO_EXPECT(tlovListCapacity(&ints->list) == 4);
+
+  error = tloCDArrayReserve(ints, 16);
+  TLO_ASSERT(!error);
+  TLO_EXPECT(tlovListCapacity(&ints->list) == 16);
+
+  TloCDArraySpan spans[2];
+  size_t count = tloCDArraySpans(ints, spans);
+  TLO_EXPECT(count == 1);
+  expectSpansHoldInts(spans, count, 4, 2);
+
+  tloListDelete(&ints->list);
+}
+
+static void testCDArrayIntProduceConsume(void) {
+  TloCDArray *ints = tloCDArrayMake(&tloInt, &countingAllocator, 8);
+  TLO_ASSERT(ints);
+
+  int values[16];
+  for (int i = 0; i < 16; ++i) {
+    values[i] = i;
+  }
+
+  // fills the array through its free spans, wrapping around
+  TloCDArrayMutableSpan freeSpans[2];
+  size_t count = tloCDArrayFreeSpans(ints, freeSpans);
+  TLO_EXPECT(count == 2);
+  TLO_EXPECT(freeSpans[0].size + freeSpans[1].size == 8);
+
+  const int *source = values;
+  for (size_t i = 0; i < count; ++i) {
+    memcpy(freeSpans[i].elements, source, freeSpans[i].size * sizeof(int));
+    source += freeSpans[i].size;
+  }
+  tloCDArrayProduce(ints, 8);
+
+  TLO_EXPECT(tlovListSize(&ints->list) == 8);
+  count = tloCDArrayFreeSpans(ints, freeSpans);
+  TLO_EXPECT(count == 0);
+
+  TloCDArraySpan spans[2];
+  count = tloCDArraySpans(ints, spans);
+  expectSpansHoldInts(spans, count, 0, 8);
+
+  tloCDArrayConsume(ints, 5);
+  EXPECT_DARRAY_ALL_PROPERTIES(ints, 3, 8, false, &tloInt, &countingAllocator);
+  EXPECT_LIST_INT_ELEMENTS(&ints->list, 5, 7, 1, 6);
+
+  // the back has wrapped around, so the free slots are now in one span
+  count = tloCDArrayFreeSpans(ints, freeSpans);
+  TLO_EXPECT(count == 1);
+  TLO_EXPECT(freeSpans[0].size == 5);
+  source = values + 8;
+  for (size_t i = 0; i < count; ++i) {
+    memcpy(freeSpans[i].elements, source, freeSpans[i].size * sizeof(int));
+    source += freeSpans[i].size;
+  }
+  tloCDArrayProduce(ints, 5);
+
+  count = tloCDArraySpans(ints, spans);
+  expectSpansHoldInts(spans, count, 5, 8);
+
+  tloCDArrayConsume(ints, 0);
+  tloCDArrayConsume(ints, 8);
+  TLO_EXPECT(tlovListIsEmpty(&ints->list));
+
+  tloListDelete(&ints->list);
+}
+
+static size_t destructCount;
+
+static void countingDestruct(void *object) {
+  (void)object;
+  ++destructCount;
+}
+
+static const TloType destructCountingInt = {.size = sizeof(int),
+                                            .destruct = countingDestruct};
+
+static void testCDArrayConsumeDestructs(void) {
+  TloCDArray *ints =
+      tloCDArrayMake(&destructCountingInt, &countingAllocator, 0);
+  TLO_ASSERT(ints);
+
+  for (int i = 0; i < MAX_LIST_SIZE; ++i) {
+    TloError error = tlovListPushBack(&ints->list, &i);
+    TLO_ASSERT(!error);
+  }
+
+  destructCount = 0;
+  tloCDArrayConsume(ints, MAX_LIST_SIZE / 2);
+  TLO_EXPECT(destructCount == MAX_LIST_SIZE / 2);
+  TLO_EXPECT(*(const int *)tlovListFront(&ints->list) == MAX_LIST_SIZE / 2);
+
+  tloListDelete(&ints->list);
+  TLO_EXPECT(destructCount == MAX_LIST_SIZE);
+}
+
 static TloList *makeListInt(void) {
   return (TloList *)tloCDArrayMake(&tloInt, &countingAllocator, 0);
 }
@@ -250,6 +539,7 @@ void testCDArray(void) {
   testListIntPushFrontManyTimes(makeListInt(), false);
   testListIntPushFrontOncePopFrontOnce(makeListInt());
   testListIntPushFrontManyTimesPopFrontUntilEmpty(makeListInt());
+  testListIntSort(makeListInt());
 
   testListIntPtrPushBackOnce(makeListIntPtr(), true);
   testListIntPtrPushBackOnce(makeListIntPtr(), false);
@@ -269,6 +559,12 @@ void testCDArray(void) {
   testListIntPtrPushFrontManyTimesPopFrontUntilEmpty(makeListIntPtr());
 
   testCDArrayIntShrinkWhenElementsWrapAround();
+  testCDArrayIntExpandWhenElementsWrapAround();
+  testCDArrayIntWrapAroundWithRoundedUpCapacity();
+  testCDArrayIntSpans();
+  testCDArrayIntReserveKeepsWrappedElements();
+  testCDArrayIntProduceConsume();
+  testCDArrayConsumeDestructs();
 
   printf("sizeof(TloCDArray): %zu\n", sizeof(TloCDArray));
   testFinalCounts();
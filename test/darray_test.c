@@ -177,6 +177,7 @@ void testDArray(void) {
   testListIntPushBackManyTimes(makeListInt(), false);
   testListIntPushBackOncePopBackOnce(makeListInt());
   testListIntPushBackManyTimesPopBackUntilEmpty(makeListInt());
+  testListIntSort(makeListInt());
 
   testListIntPtrPushBackOnce(makeListIntPtr(), true);
   testListIntPtrPushBackOnce(makeListIntPtr(), false);
@@ -128,6 +128,22 @@ static void testDLListIntCopy(void) {
   tloListDelete(&copy->list);
 }
 
+static void testDLListIntPushBackAllocatesOncePerElement(void) {
+  TloDLList ints;
+  tloDLListConstruct(&ints, &tloInt, &countingAllocator);
+
+  unsigned long mallocCount = countingAllocatorMallocCount();
+  for (int i = 0; i < MAX_LIST_SIZE; ++i) {
+    TloError error = tlovListPushBack(&ints.list, &i);
+    TLO_ASSERT(!error);
+  }
+
+  // each element is stored inline in its node
+  TLO_EXPECT(countingAllocatorMallocCount() - mallocCount == MAX_LIST_SIZE);
+
+  tlovListDestruct(&ints.list);
+}
+
 static TloList *makeListInt(void) {
   return (TloList *)tloDLListMake(&tloInt, &countingAllocator);
 }
@@ -144,6 +160,7 @@ void testDLList(void) {
   testDLListIntConstructCopy();
   testDLListIntMakeCopy();
   testDLListIntCopy();
+  testDLListIntPushBackAllocatesOncePerElement();
 
   testListHasFunctions(makeListInt(), TLO_LIST_PUSH_FRONT | TLO_LIST_POP_FRONT |
                                           TLO_LIST_POP_BACK);
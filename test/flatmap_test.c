@@ -0,0 +1,234 @@
+#include "flatmap_test.h"
+#include <stdio.h>
+#include <tlo/flatmap.h>
+#include <tlo/test.h>
+#include "map_test_utils.h"
+#include "set_test_utils.h"
+#include "util.h"
+
+static TloSet *makeSetInt(void) {
+  return (TloSet *)tloFlatSetMake(&tloInt, &countingAllocator);
+}
+
+static TloMap *makeMapIntInt(void) {
+  return (TloMap *)tloFlatMapMake(&tloInt, &tloInt, &countingAllocator);
+}
+
+// visits 0 to MAX_SET_SIZE - 1 out of order, since 17 is coprime to 42
+static int shuffled(int i) { return (i * 17) % MAX_SET_SIZE; }
+
+static void testFlatSetIntKeepsKeysSorted(void) {
+  TloFlatSet *ints = tloFlatSetMake(&tloInt, &countingAllocator);
+  TLO_ASSERT(ints);
+
+  for (int i = 0; i < MAX_SET_SIZE; ++i) {
+    int key = shuffled(i);
+    TloError error = tlovSetInsert(&ints->set, &key);
+    TLO_ASSERT(!error);
+  }
+
+  for (int i = 0; i < MAX_SET_SIZE; ++i) {
+    const int *key = tloFlatSetKey(ints, (size_t)i);
+    TLO_EXPECT(*key == i);
+  }
+
+  for (int i = 0; i < MAX_SET_SIZE; i += 2) {
+    int key = shuffled(i);
+    bool removed = tlovSetRemove(&ints->set, &key);
+    TLO_ASSERT(removed);
+  }
+
+  TLO_EXPECT(tlovSetSize(&ints->set) == MAX_SET_SIZE / 2);
+  for (size_t i = 1; i < tlovSetSize(&ints->set); ++i) {
+    const int *previous = tloFlatSetKey(ints, i - 1);
+    const int *key = tloFlatSetKey(ints, i);
+    TLO_EXPECT(*previous < *key);
+  }
+
+  tloSetDelete(&ints->set);
+}
+
+static void testFlatMapIntIntRangeQueries(void) {
+  TloFlatMap *intsToInts = tloFlatMapMake(&tloInt, &tloInt, &countingAllocator);
+  TLO_ASSERT(intsToInts);
+
+  // only even keys, so the odd ones fall between them
+  for (int i = MAX_MAP_SIZE - 1; i >= 0; --i) {
+    int key = i * 2;
+    int value = i * 3;
+    TloError error =
+        tlovMapInsert(&intsToInts->map, TLO_COPY, &key, TLO_COPY, &value);
+    TLO_ASSERT(!error);
+  }
+
+  int key = -1;
+  TLO_EXPECT(tloFlatMapLowerBound(intsToInts, &key) == 0);
+  TLO_EXPECT(tloFlatMapUpperBound(intsToInts, &key) == 0);
+  key = 4;
+  TLO_EXPECT(tloFlatMapLowerBound(intsToInts, &key) == 2);
+  TLO_EXPECT(tloFlatMapUpperBound(intsToInts, &key) == 3);
+  key = 5;
+  TLO_EXPECT(tloFlatMapLowerBound(intsToInts, &key) == 3);
+  TLO_EXPECT(tloFlatMapUpperBound(intsToInts, &key) == 3);
+  key = MAX_MAP_SIZE * 2;
+  TLO_EXPECT(tloFlatMapLowerBound(intsToInts, &key) == MAX_MAP_SIZE);
+  TLO_EXPECT(tloFlatMapUpperBound(intsToInts, &key) == MAX_MAP_SIZE);
+
+  // the keys in [10, 20)
+  int low = 10;
+  int high = 20;
+  size_t begin = tloFlatMapLowerBound(intsToInts, &low);
+  size_t end = tloFlatMapLowerBound(intsToInts, &high);
+  TLO_EXPECT(end - begin == 5);
+  for (size_t i = begin; i < end; ++i) {
+    const int *rangeKey = tloFlatMapKey(intsToInts, i);
+    const int *value = tloFlatMapValue(intsToInts, i);
+    TLO_EXPECT(*rangeKey == low + (int)(i - begin) * 2);
+    TLO_EXPECT(*value == *rangeKey / 2 * 3);
+  }
+
+  int *value = tloFlatMapMutableValue(intsToInts, begin);
+  *value = -1;
+  const int *found = tlovMapFind(&intsToInts->map, &low);
+  TLO_EXPECT(found && *found == -1);
+
+  tloMapDelete(&intsToInts->map);
+}
+
+static void testFlatMapIntIntFromArrays(void) {
+  // every key is in there 3 times, out of order
+  int keys[MAX_MAP_SIZE];
+  int values[MAX_MAP_SIZE];
+  for (int i = 0; i < MAX_MAP_SIZE; ++i) {
+    keys[i] = shuffled(i) % (MAX_MAP_SIZE / 3);
+    values[i] = i;
+  }
+
+  TloFlatMap *intsToInts = tloFlatMapMakeFromArrays(
+      &tloInt, &tloInt, &countingAllocator, keys, values, MAX_MAP_SIZE);
+  TLO_ASSERT(intsToInts);
+
+  EXPECT_MAP_PROPERTIES(&intsToInts->map, MAX_MAP_SIZE / 3, false, &tloInt,
+                        &tloInt, &countingAllocator);
+  for (int i = 0; i < MAX_MAP_SIZE / 3; ++i) {
+    const int *key = tloFlatMapKey(intsToInts, (size_t)i);
+    TLO_EXPECT(*key == i);
+
+    int firstValue = 0;
+    while (keys[firstValue] != i) {
+      ++firstValue;
+    }
+
+    const int *value = tloFlatMapValue(intsToInts, (size_t)i);
+    TLO_EXPECT(*value == firstValue);
+  }
+
+  tloMapDelete(&intsToInts->map);
+}
+
+static void testFlatSetIntFromSortedArray(void) {
+  int keys[MAX_SET_SIZE];
+  for (int i = 0; i < MAX_SET_SIZE; ++i) {
+    keys[i] = i * 2;
+  }
+
+  TloFlatSet *ints =
+      tloFlatSetMakeFromArray(&tloInt, &countingAllocator, keys, MAX_SET_SIZE);
+  TLO_ASSERT(ints);
+
+  EXPECT_SET_PROPERTIES(&ints->set, MAX_SET_SIZE, false, &tloInt,
+                        &countingAllocator);
+  for (int i = 0; i < MAX_SET_SIZE; ++i) {
+    const int *key = tloFlatSetKey(ints, (size_t)i);
+    TLO_EXPECT(*key == i * 2);
+  }
+
+  int key = 1;
+  TloError error = tlovSetInsert(&ints->set, &key);
+  TLO_EXPECT(!error);
+  TLO_EXPECT(*(const int *)tloFlatSetKey(ints, 1) == 1);
+
+  tloSetDelete(&ints->set);
+}
+
+static void testFlatSetIntFromEmptyArray(void) {
+  TloFlatSet *ints = tloFlatSetMakeFromArray(&tloInt, &countingAllocator,
+                                             NULL, 0);
+  TLO_ASSERT(ints);
+
+  EXPECT_SET_PROPERTIES(&ints->set, 0, true, &tloInt, &countingAllocator);
+
+  tloSetDelete(&ints->set);
+}
+
+static void testFlatMapIntPtrIntPtrFromArrays(void) {
+  IntPtr keys[MAX_MAP_SIZE];
+  IntPtr values[MAX_MAP_SIZE];
+  for (int i = 0; i < MAX_MAP_SIZE; ++i) {
+    TloError error = intPtrConstruct(&keys[i], shuffled(i) / 2);
+    TLO_ASSERT(!error);
+    error = intPtrConstruct(&values[i], i);
+    TLO_ASSERT(!error);
+  }
+
+  TloFlatMap *intPtrsToIntPtrs =
+      tloFlatMapMakeFromArrays(&intPtrType, &intPtrType, &countingAllocator,
+                               keys, values, MAX_MAP_SIZE);
+
+  for (int i = 0; i < MAX_MAP_SIZE; ++i) {
+    tloPtrDestruct(&keys[i]);
+    tloPtrDestruct(&values[i]);
+  }
+
+  TLO_ASSERT(intPtrsToIntPtrs);
+  TLO_EXPECT(tlovMapSize(&intPtrsToIntPtrs->map) == MAX_MAP_SIZE / 2);
+
+  // the deep copies get shifted around and destructed as keys are removed
+  for (int i = 0; i < MAX_MAP_SIZE / 2; i += 3) {
+    IntPtr key;
+    TloError error = intPtrConstruct(&key, i);
+    TLO_ASSERT(!error);
+    bool removed = tlovMapRemove(&intPtrsToIntPtrs->map, &key);
+    tloPtrDestruct(&key);
+    TLO_EXPECT(removed);
+  }
+
+  for (size_t i = 1; i < tlovMapSize(&intPtrsToIntPtrs->map); ++i) {
+    const IntPtr *previous = tloFlatMapKey(intPtrsToIntPtrs, i - 1);
+    const IntPtr *key = tloFlatMapKey(intPtrsToIntPtrs, i);
+    TLO_EXPECT(*previous->ptr < *key->ptr && *key->ptr % 3);
+  }
+
+  tloMapDelete(&intPtrsToIntPtrs->map);
+}
+
+void testFlatMap(void) {
+  testInitialCounts();
+
+  testSetIntInsertOnce(makeSetInt(), true);
+  testSetIntInsertOnce(makeSetInt(), false);
+  testSetIntInsertManyTimes(makeSetInt(), true);
+  testSetIntInsertManyTimes(makeSetInt(), false);
+  testSetIntInsertOnceRemoveOnce(makeSetInt());
+  testSetIntInsertManyTimesRemoveUntilEmpty(makeSetInt());
+  testFlatSetIntKeepsKeysSorted();
+  testFlatSetIntFromSortedArray();
+  testFlatSetIntFromEmptyArray();
+
+  testMapIntIntInsertOnce(makeMapIntInt(), true);
+  testMapIntIntInsertOnce(makeMapIntInt(), false);
+  testMapIntIntInsertManyTimes(makeMapIntInt(), true);
+  testMapIntIntInsertManyTimes(makeMapIntInt(), false);
+  testMapIntIntInsertOnceRemoveOnce(makeMapIntInt());
+  testMapIntIntInsertManyTimesRemoveUntilEmpty(makeMapIntInt());
+  testFlatMapIntIntRangeQueries();
+  testFlatMapIntIntFromArrays();
+  testFlatMapIntPtrIntPtrFromArrays();
+
+  printf("sizeof(TloFlatSet): %zu\n", sizeof(TloFlatSet));
+  printf("sizeof(TloFlatMap): %zu\n", sizeof(TloFlatMap));
+  testFinalCounts();
+  puts("===================");
+  puts("FlatMap tests done.");
+  puts("===================");
+}
@@ -0,0 +1,6 @@
+#ifndef TEST_FLATMAP_TEST_H
+#define TEST_FLATMAP_TEST_H
+
+void testFlatMap(void);
+
+#endif  // TEST_FLATMAP_TEST_H
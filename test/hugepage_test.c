@@ -0,0 +1,261 @@
+#include "hugepage_test.h"
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <tlo/darray.h>
+#include <tlo/hugepage.h>
+#include <tlo/schtable.h>
+#include <tlo/test.h>
+#include "list_test_utils.h"
+#include "util.h"
+
+// small so tests don't need megabytes to cross it
+enum { THRESHOLD = 4096 };
+
+static bool isAligned(const void *memory) {
+  return (uintptr_t)memory % _Alignof(max_align_t) == 0;
+}
+
+static void testHugePageAllocatorConstructDestruct(void) {
+  unsigned long mallocCount = countingAllocatorMallocCount();
+  TloHugePageAllocator allocator;
+  tloHugePageAllocatorConstruct(&allocator, &countingAllocator, 0);
+
+  TLO_EXPECT(countingAllocatorMallocCount() == mallocCount);
+
+  tloHugePageAllocatorDestruct(&allocator);
+}
+
+static void testHugePageAllocatorMakeDelete(void) {
+  TloHugePageAllocator *allocator =
+      tloHugePageAllocatorMake(&countingAllocator, THRESHOLD);
+  TLO_ASSERT(allocator);
+
+  tloHugePageAllocatorDelete(allocator);
+}
+
+static void testHugePageAllocatorMallocSmallAndBig(void) {
+  TloHugePageAllocator allocator;
+  tloHugePageAllocatorConstruct(&allocator, &countingAllocator, THRESHOLD);
+
+  size_t sizes[] = {1, THRESHOLD - 1, THRESHOLD, 3 * THRESHOLD + 1,
+                    TLO_HUGE_PAGE_SIZE + 1};
+  unsigned char *memories[sizeof(sizes) / sizeof(sizes[0])];
+
+  for (size_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); ++i) {
+    memories[i] = tloAllocatorMalloc(&allocator.allocator, sizes[i]);
+    TLO_ASSERT(memories[i]);
+    TLO_EXPECT(isAligned(memories[i]));
+    memset(memories[i], (int)i, sizes[i]);
+  }
+
+  for (size_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); ++i) {
+    TLO_EXPECT(memories[i][0] == (unsigned char)i);
+    TLO_EXPECT(memories[i][sizes[i] - 1] == (unsigned char)i);
+  }
+
+  // mixes sized and unsized frees of small and big allocations
+  for (size_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); ++i) {
+    if (i % 2) {
+      tloAllocatorSizedFree(&allocator.allocator, memories[i], sizes[i]);
+    } else {
+      tloAllocatorFree(&allocator.allocator, memories[i]);
+    }
+  }
+
+  tloHugePageAllocatorDestruct(&allocator);
+}
+
+static void testHugePageAllocatorDestructFreesBig(void) {
+  TloHugePageAllocator allocator;
+  tloHugePageAllocatorConstruct(&allocator, &countingAllocator, THRESHOLD);
+
+  unsigned char *memory = tloAllocatorMalloc(&allocator.allocator, THRESHOLD);
+  TLO_ASSERT(memory);
+  memory[THRESHOLD - 1] = 42;
+
+  // freed by tloHugePageAllocatorDestruct
+  tloHugePageAllocatorDestruct(&allocator);
+}
+
+static void testHugePageAllocatorRealloc(void) {
+  TloHugePageAllocator allocator;
+  tloHugePageAllocatorConstruct(&allocator, &countingAllocator, THRESHOLD);
+
+  int *ints = tloAllocatorMalloc(&allocator.allocator, sizeof(*ints));
+  TLO_ASSERT(ints);
+  *ints = 42;
+
+  int *small = tloAllocatorRealloc(&allocator.allocator, ints, sizeof(*ints),
+                                   MAX_LIST_SIZE * sizeof(*ints));
+  TLO_ASSERT(small);
+  TLO_EXPECT(*small == 42);
+
+  int *big = tloAllocatorRealloc(&allocator.allocator, small,
+                                 MAX_LIST_SIZE * sizeof(*ints), THRESHOLD);
+  TLO_ASSERT(big);
+  TLO_EXPECT(*big == 42);
+  big[THRESHOLD / sizeof(*big) - 1] = 43;
+
+  int *bigger = tloAllocatorRealloc(&allocator.allocator, big, THRESHOLD,
+                                    2 * THRESHOLD);
+  TLO_ASSERT(bigger);
+  TLO_EXPECT(*bigger == 42);
+  TLO_EXPECT(bigger[THRESHOLD / sizeof(*bigger) - 1] == 43);
+
+  int *smallAgain = tloAllocatorRealloc(&allocator.allocator, bigger,
+                                        2 * THRESHOLD, sizeof(*ints));
+  TLO_ASSERT(smallAgain);
+  TLO_EXPECT(*smallAgain == 42);
+
+  tloAllocatorSizedFree(&allocator.allocator, smallAgain, sizeof(*ints));
+  tloHugePageAllocatorDestruct(&allocator);
+}
+
+// whether each of the size bytes of memory is (unsigned char)(i + seed)
+static bool hasPattern(const unsigned char *memory, size_t size, int seed) {
+  for (size_t i = 0; i < size; ++i) {
+    if (memory[i] != (unsigned char)(i + (size_t)seed)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+static void fillPattern(unsigned char *memory, size_t size, int seed) {
+  for (size_t i = 0; i < size; ++i) {
+    memory[i] = (unsigned char)(i + (size_t)seed);
+  }
+}
+
+/*
+ * - grows two big allocations over several huge pages, so whichever has a
+ *   mapping right after it has to be moved rather than grown in place, then
+ *   shrinks and grows them again
+ */
+static void testHugePageAllocatorReallocAcrossHugePages(void) {
+  TloHugePageAllocator allocator;
+  tloHugePageAllocatorConstruct(&allocator, &countingAllocator, THRESHOLD);
+
+  enum { NUM_MEMORIES = 2 };
+  const size_t sizes[] = {TLO_HUGE_PAGE_SIZE, 3 * TLO_HUGE_PAGE_SIZE,
+                          TLO_HUGE_PAGE_SIZE + 1, 2 * TLO_HUGE_PAGE_SIZE};
+  unsigned char *memories[NUM_MEMORIES];
+
+  for (int i = 0; i < NUM_MEMORIES; ++i) {
+    memories[i] = tloAllocatorMalloc(&allocator.allocator, sizes[0]);
+    TLO_ASSERT(memories[i]);
+    fillPattern(memories[i], sizes[0], i);
+  }
+
+  for (size_t j = 1; j < sizeof(sizes) / sizeof(sizes[0]); ++j) {
+    for (int i = 0; i < NUM_MEMORIES; ++i) {
+      unsigned char *memory = tloAllocatorRealloc(
+          &allocator.allocator, memories[i], sizes[j - 1], sizes[j]);
+      TLO_ASSERT(memory);
+      memories[i] = memory;
+
+      size_t kept = sizes[j - 1] < sizes[j] ? sizes[j - 1] : sizes[j];
+      TLO_EXPECT(hasPattern(memory, kept, i));
+      fillPattern(memory, sizes[j], i);
+    }
+  }
+
+  for (int i = 0; i < NUM_MEMORIES; ++i) {
+    tloAllocatorSizedFree(&allocator.allocator, memories[i],
+                          sizes[sizeof(sizes) / sizeof(sizes[0]) - 1]);
+  }
+
+  tloHugePageAllocatorDestruct(&allocator);
+}
+
+static void testHugePageAllocatorCalloc(void) {
+  TloHugePageAllocator allocator;
+  tloHugePageAllocatorConstruct(&allocator, &countingAllocator, THRESHOLD);
+
+  size_t counts[] = {1, THRESHOLD};
+  for (size_t i = 0; i < sizeof(counts) / sizeof(counts[0]); ++i) {
+    int *ints = tloAllocatorCalloc(&allocator.allocator, counts[i],
+                                   sizeof(*ints));
+    TLO_ASSERT(ints);
+
+    for (size_t j = 0; j < counts[i]; ++j) {
+      TLO_EXPECT(ints[j] == 0);
+    }
+
+    tloAllocatorSizedFree(&allocator.allocator, ints,
+                          counts[i] * sizeof(*ints));
+  }
+
+  tloHugePageAllocatorDestruct(&allocator);
+}
+
+static void testHugePageAllocatorWithDArray(void) {
+  TloHugePageAllocator allocator;
+  tloHugePageAllocatorConstruct(&allocator, &countingAllocator, THRESHOLD);
+  TloDArray ints;
+  TloError error = tloDArrayConstruct(&ints, &tloInt, &allocator.allocator, 0);
+  TLO_ASSERT(!error);
+
+  // grows from small allocations to big ones
+  enum { NUM_INTS = 4 * THRESHOLD };
+  for (int i = 0; i < NUM_INTS; ++i) {
+    error = tlovListPushBack(&ints.list, &i);
+    TLO_ASSERT(!error);
+  }
+
+  TLO_EXPECT(tlovListSize(&ints.list) == NUM_INTS);
+  for (int i = 0; i < NUM_INTS; ++i) {
+    TLO_EXPECT(*(const int *)tlovListElement(&ints.list, (size_t)i) == i);
+  }
+
+  tlovListDestruct(&ints.list);
+  tloHugePageAllocatorDestruct(&allocator);
+}
+
+static void testHugePageAllocatorWithSCHTableMap(void) {
+  TloHugePageAllocator allocator;
+  tloHugePageAllocatorConstruct(&allocator, &countingAllocator, THRESHOLD);
+  TloSCHTableMap intsToInts;
+  tloSCHTableMapConstruct(&intsToInts, &tloInt, &tloInt, &allocator.allocator);
+
+  // enough keys for the bucket array to cross the threshold
+  enum { NUM_KEYS = THRESHOLD };
+  for (int i = 0; i < NUM_KEYS; ++i) {
+    int value = i * 2;
+    TloError error =
+        tlovMapInsert(&intsToInts.map, TLO_COPY, &i, TLO_COPY, &value);
+    TLO_ASSERT(!error);
+  }
+
+  TLO_EXPECT(tlovMapSize(&intsToInts.map) == NUM_KEYS);
+  for (int i = 0; i < NUM_KEYS; ++i) {
+    const int *value = tlovMapFind(&intsToInts.map, &i);
+    TLO_ASSERT(value);
+    TLO_EXPECT(*value == i * 2);
+  }
+
+  tlovMapDestruct(&intsToInts.map);
+  tloHugePageAllocatorDestruct(&allocator);
+}
+
+void testHugePage(void) {
+  testInitialCounts();
+
+  testHugePageAllocatorConstructDestruct();
+  testHugePageAllocatorMakeDelete();
+  testHugePageAllocatorMallocSmallAndBig();
+  testHugePageAllocatorDestructFreesBig();
+  testHugePageAllocatorRealloc();
+  testHugePageAllocatorReallocAcrossHugePages();
+  testHugePageAllocatorCalloc();
+  testHugePageAllocatorWithDArray();
+  testHugePageAllocatorWithSCHTableMap();
+
+  printf("sizeof(TloHugePageAllocator): %zu\n", sizeof(TloHugePageAllocator));
+  testFinalCounts();
+  puts("====================");
+  puts("HugePage tests done.");
+  puts("====================");
+}
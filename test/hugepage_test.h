@@ -0,0 +1,6 @@
+#ifndef TEST_HUGEPAGE_TEST_H
+#define TEST_HUGEPAGE_TEST_H
+
+void testHugePage(void);
+
+#endif  // TEST_HUGEPAGE_TEST_H
@@ -0,0 +1,188 @@
+#include "idllist_test.h"
+#include <stdio.h>
+#include <tlo/idllist.h>
+#include <tlo/test.h>
+#include "list_test_utils.h"
+#include "util.h"
+
+typedef struct Item {
+  int value;
+  TloIDLLHook hook;
+  TloIDLLHook otherHook;
+} Item;
+
+static int valueOf(const TloIDLLHook *hook) {
+  return TLO_CONTAINER_OF(hook, const Item, hook)->value;
+}
+
+// expects the values in list, from head to tail, to be first to last
+static void expectValues(const TloIDLList *list, int first, int last) {
+  TLO_EXPECT(tloIDLListSize(list) == (size_t)(last - first + 1));
+
+  int expected = first;
+  for (const TloIDLLHook *hook = tloIDLListHead(list); hook;
+       hook = tloIDLLHookNext(hook)) {
+    TLO_EXPECT(valueOf(hook) == expected);
+    ++expected;
+  }
+  TLO_EXPECT(expected == last + 1);
+
+  for (const TloIDLLHook *hook = tloIDLListTail(list); hook;
+       hook = tloIDLLHookPrev(hook)) {
+    --expected;
+    TLO_EXPECT(valueOf(hook) == expected);
+  }
+  TLO_EXPECT(expected == first);
+}
+
+static void testIDLListConstruct(void) {
+  TloIDLList list;
+  tloIDLListConstruct(&list);
+
+  TLO_EXPECT(tloIDLListSize(&list) == 0);
+  TLO_EXPECT(tloIDLListIsEmpty(&list));
+  TLO_EXPECT(!tloIDLListHead(&list));
+  TLO_EXPECT(!tloIDLListTail(&list));
+}
+
+static void testIDLListPushBackAndFront(void) {
+  Item items[MAX_LIST_SIZE];
+  TloIDLList list;
+  tloIDLListConstruct(&list);
+
+  unsigned long mallocCount = countingAllocatorMallocCount();
+
+  // pushes MAX_LIST_SIZE / 2 to the back then the ones before it to the front
+  for (int i = MAX_LIST_SIZE / 2; i < MAX_LIST_SIZE; ++i) {
+    items[i].value = i;
+    tloIDLListPushBack(&list, &items[i].hook);
+  }
+  for (int i = MAX_LIST_SIZE / 2 - 1; i >= 0; --i) {
+    items[i].value = i;
+    tloIDLListPushFront(&list, &items[i].hook);
+  }
+
+  TLO_EXPECT(countingAllocatorMallocCount() == mallocCount);
+  TLO_EXPECT(!tloIDLListIsEmpty(&list));
+  TLO_EXPECT(tloIDLListHead(&list) == &items[0].hook);
+  TLO_EXPECT(tloIDLListMutableTail(&list) == &items[MAX_LIST_SIZE - 1].hook);
+  expectValues(&list, 0, MAX_LIST_SIZE - 1);
+}
+
+static void testIDLListInsertBefore(void) {
+  Item items[MAX_LIST_SIZE];
+  TloIDLList list;
+  tloIDLListConstruct(&list);
+
+  for (int i = 0; i < MAX_LIST_SIZE; i += 2) {
+    items[i].value = i;
+    tloIDLListInsertBefore(&list, NULL, &items[i].hook);
+  }
+
+  for (int i = 1; i < MAX_LIST_SIZE; i += 2) {
+    items[i].value = i;
+    TloIDLLHook *position = i + 1 < MAX_LIST_SIZE ? &items[i + 1].hook : NULL;
+    tloIDLListInsertBefore(&list, position, &items[i].hook);
+  }
+
+  expectValues(&list, 0, MAX_LIST_SIZE - 1);
+}
+
+static void testIDLListRemove(void) {
+  Item items[MAX_LIST_SIZE];
+  TloIDLList list;
+  tloIDLListConstruct(&list);
+
+  for (int i = 0; i < MAX_LIST_SIZE; ++i) {
+    items[i].value = i;
+    tloIDLListPushBack(&list, &items[i].hook);
+  }
+
+  // removes from the middle, then both ends
+  tloIDLListRemove(&list, &items[MAX_LIST_SIZE / 2].hook);
+  TLO_EXPECT(tloIDLListSize(&list) == MAX_LIST_SIZE - 1);
+  TLO_EXPECT(valueOf(tloIDLLHookNext(&items[MAX_LIST_SIZE / 2 - 1].hook)) ==
+             MAX_LIST_SIZE / 2 + 1);
+
+  tloIDLListRemove(&list, &items[0].hook);
+  tloIDLListRemove(&list, &items[MAX_LIST_SIZE - 1].hook);
+  TLO_EXPECT(tloIDLListHead(&list) == &items[1].hook);
+  TLO_EXPECT(tloIDLListTail(&list) == &items[MAX_LIST_SIZE - 2].hook);
+
+  int expected = 1;
+  for (const TloIDLLHook *hook = tloIDLListHead(&list); hook;
+       hook = tloIDLLHookNext(hook)) {
+    if (expected == MAX_LIST_SIZE / 2) {
+      ++expected;
+    }
+    TLO_EXPECT(valueOf(hook) == expected);
+    ++expected;
+  }
+  TLO_EXPECT(expected == MAX_LIST_SIZE - 1);
+}
+
+static void testIDLListPopUntilEmpty(void) {
+  Item items[MAX_LIST_SIZE];
+  TloIDLList list;
+  tloIDLListConstruct(&list);
+
+  for (int i = 0; i < MAX_LIST_SIZE; ++i) {
+    items[i].value = i;
+    tloIDLListPushBack(&list, &items[i].hook);
+  }
+
+  for (int i = 0; i < MAX_LIST_SIZE / 2; ++i) {
+    TLO_EXPECT(tloIDLListPopFront(&list) == &items[i].hook);
+    TLO_EXPECT(tloIDLListPopBack(&list) == &items[MAX_LIST_SIZE - 1 - i].hook);
+  }
+
+  TLO_EXPECT(tloIDLListIsEmpty(&list));
+  TLO_EXPECT(!tloIDLListHead(&list));
+  TLO_EXPECT(!tloIDLListTail(&list));
+}
+
+static void testIDLListItemInTwoLists(void) {
+  Item items[MAX_LIST_SIZE];
+  TloIDLList all;
+  tloIDLListConstruct(&all);
+  TloIDLList reversed;
+  tloIDLListConstruct(&reversed);
+
+  for (int i = 0; i < MAX_LIST_SIZE; ++i) {
+    items[i].value = i;
+    tloIDLListPushBack(&all, &items[i].hook);
+    tloIDLListPushFront(&reversed, &items[i].otherHook);
+  }
+
+  int expected = MAX_LIST_SIZE - 1;
+  for (TloIDLLHook *hook = tloIDLListMutableHead(&reversed); hook;
+       hook = tloIDLLHookMutableNext(hook)) {
+    TLO_EXPECT(TLO_CONTAINER_OF(hook, Item, otherHook)->value == expected);
+    --expected;
+  }
+
+  // removing from one list leaves the other alone
+  tloIDLListRemove(&reversed, &items[0].otherHook);
+  TLO_EXPECT(tloIDLListSize(&reversed) == MAX_LIST_SIZE - 1);
+  expectValues(&all, 0, MAX_LIST_SIZE - 1);
+}
+
+void testIDLList(void) {
+  testInitialCounts();
+
+  testIDLListConstruct();
+  testIDLListPushBackAndFront();
+  testIDLListInsertBefore();
+  testIDLListRemove();
+  testIDLListPopUntilEmpty();
+  testIDLListItemInTwoLists();
+
+  printf("sizeof(TloIDLList): %zu\n", sizeof(TloIDLList));
+  printf("sizeof(TloIDLLHook): %zu\n", sizeof(TloIDLLHook));
+
+  // the list never allocates, so the usual final counts don't apply
+  TLO_EXPECT(countingAllocatorMallocCount() == 0);
+  puts("===================");
+  puts("IDLList tests done.");
+  puts("===================");
+}
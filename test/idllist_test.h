@@ -0,0 +1,6 @@
+#ifndef TEST_IDLLIST_TEST_H
+#define TEST_IDLLIST_TEST_H
+
+void testIDLList(void);
+
+#endif  // TEST_IDLLIST_TEST_H
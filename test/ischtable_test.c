@@ -0,0 +1,134 @@
+#include "ischtable_test.h"
+#include <stdio.h>
+#include <tlo/ischtable.h>
+#include <tlo/test.h>
+#include "map_test_utils.h"
+#include "util.h"
+
+typedef struct Item {
+  int key;
+  int value;
+  TloISCHTHook hook;
+} Item;
+
+static const void *itemKey(const TloISCHTHook *hook) {
+  return &TLO_CONTAINER_OF(hook, const Item, hook)->key;
+}
+
+static size_t collidingHash(const void *data, size_t size) {
+  (void)data;
+  (void)size;
+  return 0;
+}
+
+static const TloType collidingInt = {.size = sizeof(int),
+                                     .hash = collidingHash};
+
+static void testISCHTableConstructDestruct(void) {
+  unsigned long mallocCount = countingAllocatorMallocCount();
+  TloISCHTable table;
+  tloISCHTableConstruct(&table, &tloInt, itemKey, &countingAllocator);
+
+  TLO_EXPECT(countingAllocatorMallocCount() == mallocCount);
+  TLO_EXPECT(tloISCHTableSize(&table) == 0);
+  TLO_EXPECT(tloISCHTableIsEmpty(&table));
+  int key = 0;
+  TLO_EXPECT(!tloISCHTableFind(&table, &key));
+
+  tloISCHTableDestruct(&table);
+}
+
+static void testISCHTableInsertFindRemove(const TloType *keyType) {
+  Item items[MAX_MAP_SIZE];
+  TloISCHTable table;
+  tloISCHTableConstruct(&table, keyType, itemKey, &countingAllocator);
+
+  for (int i = 0; i < MAX_MAP_SIZE; ++i) {
+    items[i].key = i;
+    items[i].value = i * 2;
+    TloError error = tloISCHTableInsert(&table, &items[i].hook);
+    TLO_ASSERT(!error);
+  }
+  TLO_EXPECT(tloISCHTableSize(&table) == MAX_MAP_SIZE);
+
+  for (int i = 0; i < MAX_MAP_SIZE; ++i) {
+    const TloISCHTHook *hook = tloISCHTableFind(&table, &i);
+    TLO_ASSERT(hook);
+    TLO_EXPECT(hook == &items[i].hook);
+    TLO_EXPECT(TLO_CONTAINER_OF(hook, const Item, hook)->value == i * 2);
+  }
+
+  // removes by pointer, without a lookup
+  for (int i = 0; i < MAX_MAP_SIZE; i += 2) {
+    tloISCHTableRemove(&table, &items[i].hook);
+  }
+  TLO_EXPECT(tloISCHTableSize(&table) == MAX_MAP_SIZE / 2);
+
+  for (int i = 0; i < MAX_MAP_SIZE; ++i) {
+    TloISCHTHook *hook = tloISCHTableMutableFind(&table, &i);
+    if (i % 2) {
+      TLO_ASSERT(hook);
+      TLO_EXPECT(hook == &items[i].hook);
+    } else {
+      TLO_EXPECT(!hook);
+    }
+  }
+
+  for (int i = 1; i < MAX_MAP_SIZE; i += 2) {
+    tloISCHTableRemove(&table, &items[i].hook);
+  }
+  TLO_EXPECT(tloISCHTableIsEmpty(&table));
+
+  tloISCHTableDestruct(&table);
+}
+
+static void testISCHTableInsertDuplicate(void) {
+  Item items[2] = {{.key = 42, .value = 1}, {.key = 42, .value = 2}};
+  TloISCHTable table;
+  tloISCHTableConstruct(&table, &tloInt, itemKey, &countingAllocator);
+
+  TLO_EXPECT(tloISCHTableInsert(&table, &items[0].hook) == TLO_SUCCESS);
+  TLO_EXPECT(tloISCHTableInsert(&table, &items[1].hook) == TLO_DUPLICATE);
+  TLO_EXPECT(tloISCHTableSize(&table) == 1);
+
+  const TloISCHTHook *hook = tloISCHTableFind(&table, &items[1].key);
+  TLO_ASSERT(hook);
+  TLO_EXPECT(TLO_CONTAINER_OF(hook, const Item, hook)->value == 1);
+
+  tloISCHTableDestruct(&table);
+}
+
+static void testISCHTableOnlyBucketArrayIsAllocated(void) {
+  Item items[MAX_MAP_SIZE];
+  TloISCHTable table;
+  tloISCHTableConstruct(&table, &tloInt, itemKey, &countingAllocator);
+
+  unsigned long mallocCount = countingAllocatorMallocCount();
+  for (int i = 0; i < MAX_MAP_SIZE; ++i) {
+    items[i].key = i;
+    TloError error = tloISCHTableInsert(&table, &items[i].hook);
+    TLO_ASSERT(!error);
+  }
+
+  // one allocation per bucket array growth: 8, 16, 32, then 64 buckets
+  TLO_EXPECT(countingAllocatorMallocCount() - mallocCount == 4);
+
+  tloISCHTableDestruct(&table);
+}
+
+void testISCHTable(void) {
+  testInitialCounts();
+
+  testISCHTableConstructDestruct();
+  testISCHTableInsertFindRemove(&tloInt);
+  testISCHTableInsertFindRemove(&collidingInt);
+  testISCHTableInsertDuplicate();
+  testISCHTableOnlyBucketArrayIsAllocated();
+
+  printf("sizeof(TloISCHTable): %zu\n", sizeof(TloISCHTable));
+  printf("sizeof(TloISCHTHook): %zu\n", sizeof(TloISCHTHook));
+  testFinalCounts();
+  puts("=====================");
+  puts("ISCHTable tests done.");
+  puts("=====================");
+}
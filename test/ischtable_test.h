@@ -0,0 +1,6 @@
+#ifndef TEST_ISCHTABLE_TEST_H
+#define TEST_ISCHTABLE_TEST_H
+
+void testISCHTable(void);
+
+#endif  // TEST_ISCHTABLE_TEST_H
@@ -1,4 +1,5 @@
 #include "list_test_utils.h"
+#include <string.h>
 
 void testListDeleteWithNull(void) { tloListDelete(NULL); }
 
@@ -172,6 +173,41 @@ void testListIntPushFrontManyTimesPopFrontUntilEmpty(TloList *ints) {
   tloListDelete(ints);
 }
 
+void testListIntSort(TloList *ints) {
+  TLO_ASSERT(ints);
+
+  // scrambled with duplicates, and split between the front and the back where
+  // possible so circular arrays wrap around
+  int timesPushed[MAX_LIST_SIZE] = {0};
+  for (int i = 0; i < MAX_LIST_SIZE; ++i) {
+    int value = i * 17 % MAX_LIST_SIZE / 2;
+    TloError error = i % 2 && tloListHasFunctions(ints, TLO_LIST_PUSH_FRONT)
+                         ? tlovListPushFront(ints, &value)
+                         : tlovListPushBack(ints, &value);
+    TLO_ASSERT(!error);
+    ++timesPushed[value];
+  }
+
+  TloError error = tlovListSort(ints);
+  TLO_ASSERT(!error);
+
+  EXPECT_LIST_PROPERTIES(ints, MAX_LIST_SIZE, false, &tloInt,
+                         &countingAllocator);
+  int timesSeen[MAX_LIST_SIZE] = {0};
+  bool isSorted = true;
+  int previous = 0;
+  for (size_t i = 0; i < MAX_LIST_SIZE; ++i) {
+    int value = *(const int *)tlovListElement(ints, i);
+    isSorted = isSorted && previous <= value;
+    previous = value;
+    ++timesSeen[value];
+  }
+  TLO_EXPECT(isSorted);
+  TLO_EXPECT(memcmp(timesSeen, timesPushed, sizeof(timesSeen)) == 0);
+
+  tloListDelete(ints);
+}
+
 void testListIntPtrPushBackOnce(TloList *intPtrs, bool testCopy) {
   TLO_ASSERT(intPtrs);
 
@@ -61,6 +61,8 @@ void testListIntPushFrontManyTimes(TloList *ints, bool testCopy);
 void testListIntPushFrontOncePopFrontOnce(TloList *ints);
 void testListIntPushFrontManyTimesPopFrontUntilEmpty(TloList *ints);
 
+void testListIntSort(TloList *ints);
+
 void testListIntPtrPushBackOnce(TloList *intPtrs, bool testCopy);
 void testListIntPtrPushBackManyTimes(TloList *intPtrs, bool testCopy);
 void testListIntPtrPushBackOncePopBackOnce(TloList *intPtrs);
@@ -30,8 +30,8 @@ void testMapIntIntInsertOnce(TloMap *intsToInts, bool testCopy) {
     TLO_ASSERT(value);
     error = tlovMapInsert(intsToInts, TLO_MOVE, key, TLO_MOVE, value);
     TLO_ASSERT(error == TLO_DUPLICATE);
-    countingAllocator.free(key);
-    countingAllocator.free(value);
+    tloAllocatorFree(&countingAllocator, key);
+    tloAllocatorFree(&countingAllocator, value);
   }
 
   EXPECT_MAP_PROPERTIES(intsToInts, 1, false, &tloInt, &tloInt,
@@ -74,8 +74,8 @@ void testMapIntIntInsertManyTimes(TloMap *intsToInts, bool testCopy) {
       TLO_ASSERT(value);
       error = tlovMapInsert(intsToInts, TLO_MOVE, key, TLO_MOVE, value);
       TLO_ASSERT(error == TLO_DUPLICATE);
-      countingAllocator.free(key);
-      countingAllocator.free(value);
+      tloAllocatorFree(&countingAllocator, key);
+      tloAllocatorFree(&countingAllocator, value);
     }
 
     EXPECT_MAP_PROPERTIES(intsToInts, i + 1, false, &tloInt, &tloInt,
@@ -0,0 +1,246 @@
+#include "mpmcqueue_test.h"
+#include <pthread.h>
+#include <stdio.h>
+#include <tlo/mpmcqueue.h>
+#include <tlo/test.h>
+#include "list_test_utils.h"
+#include "util.h"
+
+// small so tests wrap around and block often
+enum { CAPACITY = 4 };
+
+static void testMPMCQueueConstructDestruct(void) {
+  TloMPMCQueue queue;
+  TloError error =
+      tloMPMCQueueConstruct(&queue, &tloInt, &countingAllocator, CAPACITY - 1);
+  TLO_ASSERT(!error);
+
+  TLO_EXPECT(tloMPMCQueueCapacity(&queue) == CAPACITY);
+
+  int value;
+  TLO_EXPECT(!tloMPMCQueueTryPop(&queue, &value));
+
+  tloMPMCQueueDestruct(&queue);
+}
+
+static void testMPMCQueueMakeDelete(void) {
+  TloMPMCQueue *queue = tloMPMCQueueMake(&tloInt, &countingAllocator, 1);
+  TLO_ASSERT(queue);
+
+  TLO_EXPECT(tloMPMCQueueCapacity(queue) == 2);
+
+  int value = 42;
+  TLO_EXPECT(tloMPMCQueueTryPush(queue, &value));
+  TLO_EXPECT(tloMPMCQueueTryPush(queue, &value));
+  TLO_EXPECT(!tloMPMCQueueTryPush(queue, &value));
+
+  tloMPMCQueueDelete(queue);
+}
+
+static void testMPMCQueueTryPushTryPopWrapsAround(void) {
+  TloMPMCQueue *queue = tloMPMCQueueMake(&tloInt, &countingAllocator, CAPACITY);
+  TLO_ASSERT(queue);
+
+  int next = 0;
+  int expected = 0;
+  for (int round = 0; round < MAX_LIST_SIZE; ++round) {
+    int pushed = 0;
+    while (tloMPMCQueueTryPush(queue, &next)) {
+      ++next;
+      ++pushed;
+    }
+    // refills what the previous round popped
+    TLO_EXPECT(pushed == (round ? (round - 1) % CAPACITY + 1 : CAPACITY));
+    TLO_EXPECT(tloMPMCQueueSize(queue) == CAPACITY);
+
+    // pops a different number each round so head and tail land everywhere
+    for (int i = 0; i <= round % CAPACITY; ++i) {
+      int value;
+      bool popped = tloMPMCQueueTryPop(queue, &value);
+      TLO_ASSERT(popped);
+      TLO_EXPECT(value == expected);
+      ++expected;
+    }
+  }
+
+  int value;
+  while (tloMPMCQueueTryPop(queue, &value)) {
+    TLO_EXPECT(value == expected);
+    ++expected;
+  }
+  TLO_EXPECT(expected == next);
+
+  tloMPMCQueueDelete(queue);
+}
+
+static void testMPMCQueueDestructsLeftOverElements(void) {
+  TloMPMCQueue *queue =
+      tloMPMCQueueMake(&intPtrType, &countingAllocator, CAPACITY);
+  TLO_ASSERT(queue);
+
+  for (int i = 0; i < CAPACITY; ++i) {
+    IntPtr intPtr;
+    TloError error = intPtrConstruct(&intPtr, i);
+    TLO_ASSERT(!error);
+    TLO_EXPECT(tloMPMCQueueTryMove(queue, &intPtr));
+  }
+
+  IntPtr popped;
+  TLO_EXPECT(tloMPMCQueueTryPop(queue, &popped));
+  TLO_EXPECT(*popped.ptr == 0);
+  tloPtrDestruct(&popped);
+
+  // the queue owns the rest, and frees them
+  tloMPMCQueueDelete(queue);
+}
+
+static void testMPMCQueueTryPushCopies(void) {
+  TloMPMCQueue *queue =
+      tloMPMCQueueMake(&intPtrType, &countingAllocator, CAPACITY);
+  TLO_ASSERT(queue);
+
+  IntPtr intPtr;
+  TloError error = intPtrConstruct(&intPtr, 42);
+  TLO_ASSERT(!error);
+  TLO_EXPECT(tloMPMCQueueTryPush(queue, &intPtr));
+  TLO_EXPECT(tloMPMCQueuePush(queue, &intPtr));
+
+  // each pop is a deep copy, separate from intPtr and each other
+  IntPtr popped[2];
+  for (int i = 0; i < 2; ++i) {
+    bool wasPopped = tloMPMCQueueTryPop(queue, &popped[i]);
+    TLO_ASSERT(wasPopped);
+    TLO_EXPECT(popped[i].ptr != intPtr.ptr);
+    TLO_EXPECT(*popped[i].ptr == 42);
+  }
+  TLO_EXPECT(popped[0].ptr != popped[1].ptr);
+
+  tloPtrDestruct(&popped[0]);
+  tloPtrDestruct(&popped[1]);
+
+  // intPtr is still the caller's
+  tloPtrDestruct(&intPtr);
+  tloMPMCQueueDelete(queue);
+}
+
+static TloError failNegativeCopy(void *destination, const void *source) {
+  if (*(const int *)source < 0) {
+    return TLO_ERROR;
+  }
+
+  *(int *)destination = *(const int *)source;
+  return TLO_SUCCESS;
+}
+
+static const TloType failNegativeCopyType = {
+    .size = sizeof(int), .constructCopy = failNegativeCopy};
+
+static void testMPMCQueuePopsSkipFailedCopies(void) {
+  TloMPMCQueue *queue =
+      tloMPMCQueueMake(&failNegativeCopyType, &countingAllocator, CAPACITY);
+  TLO_ASSERT(queue);
+
+  // wraps around a few times so failed copies land in every slot
+  for (int round = 0; round < CAPACITY * 3; ++round) {
+    int value = round;
+    int failing = -1;
+    TLO_EXPECT(!tloMPMCQueueTryPush(queue, &failing));
+    TLO_EXPECT(tloMPMCQueueTryPush(queue, &value));
+    TLO_EXPECT(!tloMPMCQueuePush(queue, &failing));
+
+    int popped;
+    TLO_EXPECT(tloMPMCQueueTryPop(queue, &popped));
+    TLO_EXPECT(popped == round);
+    TLO_EXPECT(!tloMPMCQueueTryPop(queue, &popped));
+    TLO_EXPECT(tloMPMCQueueSize(queue) == 0);
+  }
+
+  // destructing skips failed copies still in queue
+  int failing = -1;
+  TLO_EXPECT(!tloMPMCQueueTryPush(queue, &failing));
+  TLO_EXPECT(tloMPMCQueueSize(queue) == 1);
+
+  tloMPMCQueueDelete(queue);
+}
+
+enum { NUM_THREADS = 4, NUM_MESSAGES_PER_THREAD = 10000 };
+
+typedef struct ThreadParameters {
+  TloMPMCQueue *queue;
+  int id;
+  int *timesSeen;
+} ThreadParameters;
+
+static void *produce(void *parameters) {
+  const ThreadParameters *p = parameters;
+  for (int i = 0; i < NUM_MESSAGES_PER_THREAD; ++i) {
+    int message = p->id * NUM_MESSAGES_PER_THREAD + i;
+    tloMPMCQueueMove(p->queue, &message);
+  }
+  return NULL;
+}
+
+static void *consume(void *parameters) {
+  const ThreadParameters *p = parameters;
+  for (int i = 0; i < NUM_MESSAGES_PER_THREAD; ++i) {
+    int message;
+    tloMPMCQueuePop(p->queue, &message);
+
+    // each message is popped by one thread, so no two threads write the same
+    // element
+    ++p->timesSeen[message];
+  }
+  return NULL;
+}
+
+static void testMPMCQueueManyProducersManyConsumers(void) {
+  TloMPMCQueue *queue = tloMPMCQueueMake(&tloInt, &countingAllocator, CAPACITY);
+  TLO_ASSERT(queue);
+
+  static int timesSeen[NUM_THREADS * NUM_MESSAGES_PER_THREAD];
+  ThreadParameters parameters[NUM_THREADS];
+  pthread_t producers[NUM_THREADS];
+  pthread_t consumers[NUM_THREADS];
+  for (int i = 0; i < NUM_THREADS; ++i) {
+    parameters[i] = (ThreadParameters){
+        .queue = queue, .id = i, .timesSeen = timesSeen};
+    int error = pthread_create(&consumers[i], NULL, consume, &parameters[i]);
+    TLO_ASSERT(!error);
+    error = pthread_create(&producers[i], NULL, produce, &parameters[i]);
+    TLO_ASSERT(!error);
+  }
+
+  for (int i = 0; i < NUM_THREADS; ++i) {
+    pthread_join(producers[i], NULL);
+    pthread_join(consumers[i], NULL);
+  }
+
+  bool eachSeenOnce = true;
+  for (int i = 0; i < NUM_THREADS * NUM_MESSAGES_PER_THREAD; ++i) {
+    eachSeenOnce = eachSeenOnce && timesSeen[i] == 1;
+  }
+  TLO_EXPECT(eachSeenOnce);
+
+  int value;
+  TLO_EXPECT(!tloMPMCQueueTryPop(queue, &value));
+
+  tloMPMCQueueDelete(queue);
+}
+
+void testMPMCQueue(void) {
+  testInitialCounts();
+
+  testMPMCQueueConstructDestruct();
+  testMPMCQueueMakeDelete();
+  testMPMCQueueTryPushTryPopWrapsAround();
+  testMPMCQueueDestructsLeftOverElements();
+  testMPMCQueueTryPushCopies();
+  testMPMCQueuePopsSkipFailedCopies();
+  testMPMCQueueManyProducersManyConsumers();
+
+  printf("sizeof(TloMPMCQueue): %zu\n", sizeof(TloMPMCQueue));
+  testFinalCounts();
+  puts("=====================");
+  puts("MPMCQueue tests done.");
+  puts("=====================");
+}
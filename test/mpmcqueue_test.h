@@ -0,0 +1,6 @@
+#ifndef TEST_MPMCQUEUE_TEST_H
+#define TEST_MPMCQUEUE_TEST_H
+
+void testMPMCQueue(void);
+
+#endif  // TEST_MPMCQUEUE_TEST_H
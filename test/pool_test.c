@@ -0,0 +1,241 @@
+#include "pool_test.h"
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <tlo/dllist.h>
+#include <tlo/pool.h>
+#include <tlo/schtable.h>
+#include <tlo/test.h>
+#include "list_test_utils.h"
+#include "map_test_utils.h"
+#include "util.h"
+
+static bool isAligned(const void *memory) {
+  return (uintptr_t)memory % _Alignof(max_align_t) == 0;
+}
+
+static void testPoolConstructDestruct(void) {
+  unsigned long mallocCount = countingAllocatorMallocCount();
+  TloPool pool;
+  tloPoolConstruct(&pool, &countingAllocator);
+
+  TLO_EXPECT(countingAllocatorMallocCount() == mallocCount);
+
+  tloPoolDestruct(&pool);
+}
+
+static void testPoolMakeDelete(void) {
+  TloPool *pool = tloPoolMake(&countingAllocator);
+  TLO_ASSERT(pool);
+
+  tloPoolDelete(pool);
+}
+
+static void testPoolMallocEverySmallSize(void) {
+  TloPool pool;
+  tloPoolConstruct(&pool, &countingAllocator);
+  unsigned char *memories[TLO_POOL_MAX_SMALL_SIZE + 1];
+
+  unsigned long mallocCount = countingAllocatorMallocCount();
+  for (size_t size = 0; size <= TLO_POOL_MAX_SMALL_SIZE; ++size) {
+    memories[size] = tloAllocatorMalloc(&pool.allocator, size);
+    TLO_ASSERT(memories[size]);
+    TLO_EXPECT(isAligned(memories[size]));
+    memset(memories[size], (int)size, size);
+  }
+  // slabs are allocated in groups, not one by one
+  TLO_EXPECT(countingAllocatorMallocCount() - mallocCount <
+             TLO_POOL_NUM_SIZE_CLASSES);
+
+  for (size_t size = 0; size <= TLO_POOL_MAX_SMALL_SIZE; ++size) {
+    for (size_t i = 0; i < size; ++i) {
+      TLO_EXPECT(memories[size][i] == (unsigned char)size);
+    }
+  }
+
+  for (size_t size = 0; size <= TLO_POOL_MAX_SMALL_SIZE; ++size) {
+    tloAllocatorFree(&pool.allocator, memories[size]);
+  }
+
+  tloPoolDestruct(&pool);
+}
+
+static void testPoolFreeThenMallocReuses(void) {
+  TloPool pool;
+  tloPoolConstruct(&pool, &countingAllocator);
+
+  int *first = tloAllocatorMalloc(&pool.allocator, sizeof(*first));
+  TLO_ASSERT(first);
+  int *second = tloAllocatorMalloc(&pool.allocator, sizeof(*second));
+  TLO_ASSERT(second);
+  TLO_EXPECT(first != second);
+
+  tloAllocatorSizedFree(&pool.allocator, first, sizeof(*first));
+  int *third = tloAllocatorMalloc(&pool.allocator, sizeof(*third));
+  TLO_EXPECT(third == first);
+
+  tloAllocatorFree(&pool.allocator, second);
+  tloAllocatorFree(&pool.allocator, third);
+  tloPoolDestruct(&pool);
+}
+
+static void testPoolMallocManySlabs(void) {
+  TloPool pool;
+  tloPoolConstruct(&pool, &countingAllocator);
+  enum { NUM_OBJECTS = 64 * TLO_POOL_SLAB_SIZE / TLO_POOL_MAX_SMALL_SIZE };
+  static void *memories[NUM_OBJECTS];
+
+  for (size_t i = 0; i < NUM_OBJECTS; ++i) {
+    memories[i] = tloAllocatorMalloc(&pool.allocator, TLO_POOL_MAX_SMALL_SIZE);
+    TLO_ASSERT(memories[i]);
+    memset(memories[i], 0, TLO_POOL_MAX_SMALL_SIZE);
+  }
+
+  for (size_t i = 0; i < NUM_OBJECTS; i += 2) {
+    tloAllocatorFree(&pool.allocator, memories[i]);
+  }
+
+  unsigned long mallocCount = countingAllocatorMallocCount();
+  for (size_t i = 0; i < NUM_OBJECTS; i += 2) {
+    memories[i] = tloAllocatorMalloc(&pool.allocator, TLO_POOL_MAX_SMALL_SIZE);
+    TLO_ASSERT(memories[i]);
+  }
+  TLO_EXPECT(countingAllocatorMallocCount() == mallocCount);
+
+  tloPoolDestruct(&pool);
+}
+
+static void testPoolMallocLarge(void) {
+  TloPool pool;
+  tloPoolConstruct(&pool, &countingAllocator);
+
+  size_t sizes[] = {TLO_POOL_MAX_SMALL_SIZE + 1, TLO_POOL_SLAB_SIZE,
+                    4 * TLO_POOL_SLAB_SIZE + 1};
+  unsigned char *memories[sizeof(sizes) / sizeof(sizes[0])];
+
+  for (size_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); ++i) {
+    memories[i] = tloAllocatorMalloc(&pool.allocator, sizes[i]);
+    TLO_ASSERT(memories[i]);
+    TLO_EXPECT(isAligned(memories[i]));
+    memset(memories[i], (int)i, sizes[i]);
+  }
+
+  unsigned long freeCount = countingAllocatorFreeCount();
+  tloAllocatorFree(&pool.allocator, memories[1]);
+  TLO_EXPECT(countingAllocatorFreeCount() == freeCount + 1);
+  TLO_EXPECT(memories[0][sizes[0] - 1] == 0);
+  TLO_EXPECT(memories[2][sizes[2] - 1] == 2);
+
+  // the others are freed by tloPoolDestruct
+  tloPoolDestruct(&pool);
+}
+
+static void testPoolRealloc(void) {
+  TloPool pool;
+  tloPoolConstruct(&pool, &countingAllocator);
+
+  int *ints = tloAllocatorMalloc(&pool.allocator, sizeof(*ints));
+  TLO_ASSERT(ints);
+  *ints = 42;
+
+  int *sameClass = tloAllocatorRealloc(&pool.allocator, ints, sizeof(*ints), 2);
+  TLO_EXPECT(sameClass == ints);
+
+  int *small = tloAllocatorRealloc(&pool.allocator, sameClass, sizeof(*ints),
+                                   MAX_LIST_SIZE * sizeof(*ints));
+  TLO_ASSERT(small);
+  TLO_EXPECT(*small == 42);
+
+  int *large = tloAllocatorRealloc(&pool.allocator, small,
+                                   MAX_LIST_SIZE * sizeof(*ints),
+                                   TLO_POOL_SLAB_SIZE);
+  TLO_ASSERT(large);
+  TLO_EXPECT(*large == 42);
+
+  tloAllocatorFree(&pool.allocator, large);
+  tloPoolDestruct(&pool);
+}
+
+static void testPoolWithDLList(void) {
+  TloPool pool;
+  tloPoolConstruct(&pool, &countingAllocator);
+  TloDLList ints;
+  tloDLListConstruct(&ints, &tloInt, &pool.allocator);
+
+  for (int round = 0; round < 2; ++round) {
+    unsigned long mallocCount = countingAllocatorMallocCount();
+
+    for (int i = 0; i < MAX_LIST_SIZE; ++i) {
+      TloError error = tlovListPushBack(&ints.list, &i);
+      TLO_ASSERT(!error);
+    }
+
+    TLO_EXPECT(tlovListSize(&ints.list) == MAX_LIST_SIZE);
+    for (int i = 0; i < MAX_LIST_SIZE; ++i) {
+      TLO_EXPECT(*(const int *)tlovListFront(&ints.list) == i);
+      tlovListPopFront(&ints.list);
+    }
+
+    // nodes freed in the first round are reused in the second
+    if (round) {
+      TLO_EXPECT(countingAllocatorMallocCount() == mallocCount);
+    }
+  }
+
+  tlovListDestruct(&ints.list);
+  tloPoolDestruct(&pool);
+}
+
+static void testPoolWithSCHTableMap(void) {
+  TloPool pool;
+  tloPoolConstruct(&pool, &countingAllocator);
+
+  TloSCHTableMap intsToInts;
+  tloSCHTableMapConstruct(&intsToInts, &tloInt, &tloInt, &pool.allocator);
+
+  for (int i = 0; i < MAX_MAP_SIZE; ++i) {
+    int value = i * 2;
+    TloError error =
+        tlovMapInsert(&intsToInts.map, TLO_COPY, &i, TLO_COPY, &value);
+    TLO_ASSERT(!error);
+  }
+
+  for (int i = 0; i < MAX_MAP_SIZE; i += 2) {
+    TLO_EXPECT(tlovMapRemove(&intsToInts.map, &i));
+  }
+
+  TLO_EXPECT(tlovMapSize(&intsToInts.map) == MAX_MAP_SIZE / 2);
+  for (int i = 0; i < MAX_MAP_SIZE; ++i) {
+    const int *value = tlovMapFind(&intsToInts.map, &i);
+    if (i % 2) {
+      TLO_ASSERT(value);
+      TLO_EXPECT(*value == i * 2);
+    } else {
+      TLO_EXPECT(!value);
+    }
+  }
+
+  tlovMapDestruct(&intsToInts.map);
+  tloPoolDestruct(&pool);
+}
+
+void testPool(void) {
+  testInitialCounts();
+
+  testPoolConstructDestruct();
+  testPoolMakeDelete();
+  testPoolMallocEverySmallSize();
+  testPoolFreeThenMallocReuses();
+  testPoolMallocManySlabs();
+  testPoolMallocLarge();
+  testPoolRealloc();
+  testPoolWithDLList();
+  testPoolWithSCHTableMap();
+
+  printf("sizeof(TloPool): %zu\n", sizeof(TloPool));
+  testFinalCounts();
+  puts("================");
+  puts("Pool tests done.");
+  puts("================");
+}
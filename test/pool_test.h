@@ -0,0 +1,6 @@
+#ifndef TEST_POOL_TEST_H
+#define TEST_POOL_TEST_H
+
+void testPool(void);
+
+#endif  // TEST_POOL_TEST_H
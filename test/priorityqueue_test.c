@@ -0,0 +1,178 @@
+#include "priorityqueue_test.h"
+#include <stdio.h>
+#include <tlo/priorityqueue.h>
+#include <tlo/test.h>
+#include "util.h"
+
+// 200 crosses a level boundary for every arity
+enum { MAX_QUEUE_SIZE = 200 };
+
+// visits 0 to MAX_QUEUE_SIZE - 1 out of order, since 17 is coprime to 200
+static int shuffled(int i) { return (i * 17) % MAX_QUEUE_SIZE; }
+
+static void testPriorityQueueIntPopsInOrder(size_t arity, bool hasHandles) {
+  TloPriorityQueue *ints =
+      tloPriorityQueueMake(&tloInt, &countingAllocator, arity, hasHandles);
+  TLO_ASSERT(ints);
+  TLO_EXPECT(tloPriorityQueueIsEmpty(ints));
+
+  // each value twice, since equal values must come out too
+  for (int i = 0; i < MAX_QUEUE_SIZE * 2; ++i) {
+    int value = shuffled(i % MAX_QUEUE_SIZE);
+    TloError error = tloPriorityQueuePush(ints, &value, NULL);
+    TLO_ASSERT(!error);
+  }
+
+  TLO_EXPECT(tloPriorityQueueSize(ints) == MAX_QUEUE_SIZE * 2);
+  for (int i = 0; i < MAX_QUEUE_SIZE * 2; ++i) {
+    const int *top = tloPriorityQueueTop(ints);
+    TLO_EXPECT(*top == i / 2);
+    tloPriorityQueuePop(ints);
+  }
+
+  TLO_EXPECT(tloPriorityQueueIsEmpty(ints));
+  tloPriorityQueueDelete(ints);
+}
+
+static void testPriorityQueueIntPtrCopyAndMove(void) {
+  TloPriorityQueue *intPtrs =
+      tloPriorityQueueMake(&intPtrType, &countingAllocator, 4, false);
+  TLO_ASSERT(intPtrs);
+
+  for (int i = 0; i < MAX_QUEUE_SIZE; ++i) {
+    TloError error;
+    if (i % 2) {
+      IntPtr value;
+      error = intPtrConstruct(&value, shuffled(i));
+      TLO_ASSERT(!error);
+      error = tloPriorityQueuePush(intPtrs, &value, NULL);
+      tloPtrDestruct(&value);
+    } else {
+      IntPtr *value = intPtrMake(shuffled(i));
+      TLO_ASSERT(value);
+      error = tloPriorityQueueMove(intPtrs, value, NULL);
+      if (error) {
+        tloPtrDestruct(value);
+        tloAllocatorFree(&countingAllocator, value);
+      }
+    }
+    TLO_ASSERT(!error);
+  }
+
+  // the rest are left for tloPriorityQueueDelete to destruct
+  for (int i = 0; i < MAX_QUEUE_SIZE / 2; ++i) {
+    const IntPtr *top = tloPriorityQueueTop(intPtrs);
+    TLO_EXPECT(*top->ptr == i);
+    tloPriorityQueuePop(intPtrs);
+  }
+
+  tloPriorityQueueDelete(intPtrs);
+}
+
+static void testPriorityQueueIntFromDArray(size_t arity, bool hasHandles) {
+  TloDArray array;
+  TloError error =
+      tloDArrayConstruct(&array, &tloInt, &countingAllocator, MAX_QUEUE_SIZE);
+  TLO_ASSERT(!error);
+  for (int i = 0; i < MAX_QUEUE_SIZE; ++i) {
+    int value = shuffled(i);
+    error = tlovListPushBack(&array.list, &value);
+    TLO_ASSERT(!error);
+  }
+
+  TloPriorityQueue *ints =
+      tloPriorityQueueMakeFromDArray(&array, arity, hasHandles);
+  TLO_EXPECT(tlovListIsEmpty(&array.list));
+  tlovListDestruct(&array.list);
+  TLO_ASSERT(ints);
+  TLO_EXPECT(tloPriorityQueueSize(ints) == MAX_QUEUE_SIZE);
+
+  if (hasHandles) {
+    for (int i = 0; i < MAX_QUEUE_SIZE; ++i) {
+      const int *value = tloPriorityQueueValue(ints, (size_t)i);
+      TLO_EXPECT(*value == shuffled(i));
+    }
+  }
+
+  for (int i = 0; i < MAX_QUEUE_SIZE; ++i) {
+    const int *top = tloPriorityQueueTop(ints);
+    TLO_EXPECT(*top == i);
+    if (hasHandles) {
+      TLO_EXPECT(shuffled((int)tloPriorityQueueTopHandle(ints)) == i);
+    }
+    tloPriorityQueuePop(ints);
+  }
+
+  tloPriorityQueueDelete(ints);
+}
+
+static void testPriorityQueueIntHandles(size_t arity) {
+  TloPriorityQueue ints;
+  TloError error = tloPriorityQueueConstruct(&ints, &tloInt, &countingAllocator,
+                                             arity, true);
+  TLO_ASSERT(!error);
+
+  TloPriorityQueueHandle handles[MAX_QUEUE_SIZE];
+  for (int i = 0; i < MAX_QUEUE_SIZE; ++i) {
+    int value = shuffled(i) + MAX_QUEUE_SIZE;
+    error = tloPriorityQueuePush(&ints, &value, &handles[i]);
+    TLO_ASSERT(!error);
+  }
+
+  // every third value goes below all the others, every third one is removed
+  for (int i = 0; i < MAX_QUEUE_SIZE; ++i) {
+    if (i % 3 == 0) {
+      int value = shuffled(i);
+      error = tloPriorityQueueDecreaseKey(&ints, handles[i], &value);
+      TLO_ASSERT(!error);
+    } else if (i % 3 == 1) {
+      tloPriorityQueueRemove(&ints, handles[i]);
+    }
+  }
+
+  for (int i = 0; i < MAX_QUEUE_SIZE; ++i) {
+    if (i % 3 != 1) {
+      const int *value = tloPriorityQueueValue(&ints, handles[i]);
+      TLO_EXPECT(*value == shuffled(i) + (i % 3 ? MAX_QUEUE_SIZE : 0));
+    }
+  }
+
+  // the freed handles are given out again
+  for (int i = 1; i < MAX_QUEUE_SIZE; i += 3) {
+    int value = shuffled(i) + MAX_QUEUE_SIZE;
+    error = tloPriorityQueuePush(&ints, &value, &handles[i]);
+    TLO_ASSERT(!error);
+    TLO_EXPECT(handles[i] < MAX_QUEUE_SIZE);
+  }
+
+  TLO_EXPECT(tloPriorityQueueSize(&ints) == MAX_QUEUE_SIZE);
+  int previous = -1;
+  while (!tloPriorityQueueIsEmpty(&ints)) {
+    const int *top = tloPriorityQueueTop(&ints);
+    TLO_EXPECT(previous < *top);
+    previous = *top;
+    tloPriorityQueuePop(&ints);
+  }
+
+  tloPriorityQueueDestruct(&ints);
+}
+
+void testPriorityQueue(void) {
+  testInitialCounts();
+
+  const size_t arities[] = {2, 4, 8};
+  for (size_t i = 0; i < sizeof(arities) / sizeof(arities[0]); ++i) {
+    testPriorityQueueIntPopsInOrder(arities[i], false);
+    testPriorityQueueIntPopsInOrder(arities[i], true);
+    testPriorityQueueIntFromDArray(arities[i], false);
+    testPriorityQueueIntFromDArray(arities[i], true);
+    testPriorityQueueIntHandles(arities[i]);
+  }
+  testPriorityQueueIntPtrCopyAndMove();
+
+  printf("sizeof(TloPriorityQueue): %zu\n", sizeof(TloPriorityQueue));
+  testFinalCounts();
+  puts("=========================");
+  puts("PriorityQueue tests done.");
+  puts("=========================");
+}
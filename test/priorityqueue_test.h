@@ -0,0 +1,6 @@
+#ifndef TEST_PRIORITYQUEUE_TEST_H
+#define TEST_PRIORITYQUEUE_TEST_H
+
+void testPriorityQueue(void);
+
+#endif  // TEST_PRIORITYQUEUE_TEST_H
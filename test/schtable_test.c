@@ -1,6 +1,7 @@
 #include "schtable_test.h"
 #include <stdio.h>
 #include <tlo/schtable.h>
+#include <tlo/test.h>
 #include "map_test_utils.h"
 #include "set_test_utils.h"
 #include "util.h"
@@ -13,6 +14,43 @@ static TloMap *makeMapIntInt(void) {
   return (TloMap *)tloSCHTableMapMake(&tloInt, &tloInt, &countingAllocator);
 }
 
+static size_t collidingHash(const void *data, size_t size) {
+  (void)data;
+  (void)size;
+  return 0;
+}
+
+static const TloType collidingInt = {.size = sizeof(int),
+                                     .hash = collidingHash};
+
+static void testMapIntIntAllKeysCollide(void) {
+  TloMap *intsToInts = (TloMap *)tloSCHTableMapMake(
+      &collidingInt, &tloInt, &countingAllocator);
+  TLO_ASSERT(intsToInts);
+
+  for (int i = 0; i < MAX_MAP_SIZE; ++i) {
+    TloError error = tlovMapInsert(intsToInts, TLO_COPY, &i, TLO_COPY, &i);
+    TLO_ASSERT(!error);
+  }
+
+  for (int i = 0; i < MAX_MAP_SIZE; i += 2) {
+    TLO_EXPECT(tlovMapRemove(intsToInts, &i));
+  }
+
+  TLO_EXPECT(tlovMapSize(intsToInts) == MAX_MAP_SIZE / 2);
+  for (int i = 0; i < MAX_MAP_SIZE; ++i) {
+    const int *value = tlovMapFind(intsToInts, &i);
+    if (i % 2) {
+      TLO_ASSERT(value);
+      TLO_EXPECT(*value == i);
+    } else {
+      TLO_EXPECT(!value);
+    }
+  }
+
+  tloMapDelete(intsToInts);
+}
+
 void testSCHTable(void) {
   testInitialCounts();
 
@@ -29,6 +67,7 @@ void testSCHTable(void) {
   testMapIntIntInsertManyTimes(makeMapIntInt(), false);
   testMapIntIntInsertOnceRemoveOnce(makeMapIntInt());
   testMapIntIntInsertManyTimesRemoveUntilEmpty(makeMapIntInt());
+  testMapIntIntAllKeysCollide();
 
   printf("sizeof(TloSCHTableSet): %zu\n", sizeof(TloSCHTableSet));
   printf("sizeof(TloSCHTableMap): %zu\n", sizeof(TloSCHTableMap));
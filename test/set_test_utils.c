@@ -22,7 +22,7 @@ void testSetIntInsertOnce(TloSet *ints, bool testCopy) {
     TLO_ASSERT(key);
     error = tlovSetMoveInsert(ints, key);
     TLO_ASSERT(error == TLO_DUPLICATE);
-    countingAllocator.free(key);
+    tloAllocatorFree(&countingAllocator, key);
   }
 
   EXPECT_SET_PROPERTIES(ints, 1, false, &tloInt, &countingAllocator);
@@ -57,7 +57,7 @@ void testSetIntInsertManyTimes(TloSet *ints, bool testCopy) {
       TLO_ASSERT(key);
       error = tlovSetMoveInsert(ints, key);
       TLO_ASSERT(error == TLO_DUPLICATE);
-      countingAllocator.free(key);
+      tloAllocatorFree(&countingAllocator, key);
     }
 
     EXPECT_SET_PROPERTIES(ints, i + 1, false, &tloInt, &countingAllocator);
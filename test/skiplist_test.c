@@ -0,0 +1,523 @@
+#include "skiplist_test.h"
+#include <pthread.h>
+#include <stdio.h>
+#include <tlo/skiplist.h>
+#include <tlo/test.h>
+#include "util.h"
+
+// enough keys for a few levels
+enum { NUM_KEYS = 2000 };
+
+// 7919 and 1009 are primes that don't divide NUM_KEYS, so these visit every
+// key once, in two different orders
+static int insertionOrder(int i) { return (i * 7919) % NUM_KEYS; }
+static int removalOrder(int i) { return (i * 1009) % NUM_KEYS; }
+
+static void expectKeysInOrder(TloSkipListThread *thread, int first, int step) {
+  TloSkipListCursor cursor;
+  size_t count = 0;
+  int expected = first;
+
+  tloSkipListThreadPin(thread);
+  for (tloSkipListMapFirst(thread, &cursor); !tloSkipListCursorIsEnd(&cursor);
+       tloSkipListCursorNext(&cursor)) {
+    const int *key = tloSkipListCursorKey(&cursor);
+    const int *value = tloSkipListCursorValue(&cursor);
+    TLO_EXPECT(*key == expected);
+    TLO_EXPECT(*value == expected * 2);
+    expected += step;
+    ++count;
+  }
+  tloSkipListThreadUnpin(thread);
+
+  TLO_EXPECT(count == (size_t)(expected - first) / (size_t)step);
+}
+
+static void testSkipListMapConstructDestruct(void) {
+  TloSkipListMap map;
+  tloSkipListMapConstruct(&map, &tloInt, &tloInt, &countingAllocator);
+
+  TLO_EXPECT(tloSkipListMapSize(&map) == 0);
+
+  TloSkipListThread *thread = tloSkipListMapAttach(&map);
+  TLO_ASSERT(thread);
+
+  int key = 1;
+  tloSkipListThreadPin(thread);
+  TLO_EXPECT(!tloSkipListMapFind(thread, &key));
+  TloSkipListCursor cursor;
+  tloSkipListMapFirst(thread, &cursor);
+  TLO_EXPECT(tloSkipListCursorIsEnd(&cursor));
+  tloSkipListThreadUnpin(thread);
+
+  TLO_EXPECT(!tloSkipListMapRemove(thread, &key));
+
+  // reused instead of allocating another
+  tloSkipListMapDetach(thread);
+  TLO_EXPECT(tloSkipListMapAttach(&map) == thread);
+
+  tloSkipListMapDestruct(&map);
+}
+
+static void testSkipListMapIntIntManyKeys(void) {
+  TloSkipListMap *map =
+      tloSkipListMapMake(&tloInt, &tloInt, &countingAllocator);
+  TLO_ASSERT(map);
+  TloSkipListThread *thread = tloSkipListMapAttach(map);
+  TLO_ASSERT(thread);
+
+  for (int i = 0; i < NUM_KEYS; ++i) {
+    int key = insertionOrder(i);
+    int value = key * 2;
+    TloError error =
+        tloSkipListMapInsert(thread, TLO_COPY, &key, TLO_COPY, &value);
+    TLO_ASSERT(!error);
+  }
+
+  TLO_EXPECT(tloSkipListMapSize(map) == NUM_KEYS);
+  expectKeysInOrder(thread, 0, 1);
+
+  for (int i = 0; i < NUM_KEYS; ++i) {
+    int key = i;
+    int value = 0;
+    TloError error =
+        tloSkipListMapInsert(thread, TLO_COPY, &key, TLO_COPY, &value);
+    TLO_EXPECT(error == TLO_DUPLICATE);
+  }
+  TLO_EXPECT(tloSkipListMapSize(map) == NUM_KEYS);
+
+  for (int i = 0; i < NUM_KEYS; ++i) {
+    int key = removalOrder(i);
+    if (key % 2) {
+      bool removed = tloSkipListMapRemove(thread, &key);
+      TLO_EXPECT(removed);
+    }
+  }
+
+  TLO_EXPECT(tloSkipListMapSize(map) == NUM_KEYS / 2);
+  expectKeysInOrder(thread, 0, 2);
+  tloSkipListThreadPin(thread);
+  for (int i = 0; i < NUM_KEYS; ++i) {
+    const int *value = tloSkipListMapFind(thread, &i);
+    if (i % 2) {
+      TLO_EXPECT(!value);
+    } else {
+      TLO_EXPECT(value && *value == i * 2);
+    }
+  }
+  tloSkipListThreadUnpin(thread);
+
+  for (int i = 0; i < NUM_KEYS; ++i) {
+    int key = removalOrder(i);
+    bool removed = tloSkipListMapRemove(thread, &key);
+    TLO_EXPECT(removed == !(key % 2));
+  }
+
+  TLO_EXPECT(tloSkipListMapSize(map) == 0);
+  expectKeysInOrder(thread, 0, 1);
+
+  // the removed keys that weren't freed yet are freed with the map
+  tloSkipListMapDetach(thread);
+  tloSkipListMapDelete(map);
+}
+
+static void testSkipListMapIntIntBounds(void) {
+  TloSkipListMap *map =
+      tloSkipListMapMake(&tloInt, &tloInt, &countingAllocator);
+  TLO_ASSERT(map);
+  TloSkipListThread *thread = tloSkipListMapAttach(map);
+  TLO_ASSERT(thread);
+
+  // only even keys, so the odd ones fall between them
+  for (int i = 0; i < NUM_KEYS; ++i) {
+    int key = insertionOrder(i) * 2;
+    int value = key * 2;
+    TloError error =
+        tloSkipListMapInsert(thread, TLO_COPY, &key, TLO_COPY, &value);
+    TLO_ASSERT(!error);
+  }
+
+  tloSkipListThreadPin(thread);
+
+  TloSkipListCursor cursor;
+  int key = -1;
+  tloSkipListMapLowerBound(thread, &key, &cursor);
+  TLO_EXPECT(*(const int *)tloSkipListCursorKey(&cursor) == 0);
+  tloSkipListMapUpperBound(thread, &key, &cursor);
+  TLO_EXPECT(*(const int *)tloSkipListCursorKey(&cursor) == 0);
+  key = 1000;
+  tloSkipListMapLowerBound(thread, &key, &cursor);
+  TLO_EXPECT(*(const int *)tloSkipListCursorKey(&cursor) == 1000);
+  tloSkipListMapUpperBound(thread, &key, &cursor);
+  TLO_EXPECT(*(const int *)tloSkipListCursorKey(&cursor) == 1002);
+  key = 1001;
+  tloSkipListMapLowerBound(thread, &key, &cursor);
+  TLO_EXPECT(*(const int *)tloSkipListCursorKey(&cursor) == 1002);
+  tloSkipListMapUpperBound(thread, &key, &cursor);
+  TLO_EXPECT(*(const int *)tloSkipListCursorKey(&cursor) == 1002);
+  key = (NUM_KEYS - 1) * 2;
+  tloSkipListMapUpperBound(thread, &key, &cursor);
+  TLO_EXPECT(tloSkipListCursorIsEnd(&cursor));
+
+  // a cursor on a key that gets removed still moves on to the next one
+  key = 1000;
+  tloSkipListMapLowerBound(thread, &key, &cursor);
+  TLO_EXPECT(tloSkipListMapRemove(thread, &key));
+  key = 1002;
+  TLO_EXPECT(tloSkipListMapRemove(thread, &key));
+  TLO_EXPECT(*(const int *)tloSkipListCursorValue(&cursor) == 2000);
+  tloSkipListCursorNext(&cursor);
+  TLO_EXPECT(*(const int *)tloSkipListCursorKey(&cursor) == 1004);
+
+  tloSkipListThreadUnpin(thread);
+
+  tloSkipListMapDetach(thread);
+  tloSkipListMapDelete(map);
+}
+
+static void testSkipListMapIntPtrIntPtr(void) {
+  TloSkipListMap *map =
+      tloSkipListMapMake(&intPtrType, &intPtrType, &countingAllocator);
+  TLO_ASSERT(map);
+  TloSkipListThread *thread = tloSkipListMapAttach(map);
+  TLO_ASSERT(thread);
+
+  for (int i = 0; i < NUM_KEYS; ++i) {
+    IntPtr *key = intPtrMake(insertionOrder(i));
+    TLO_ASSERT(key);
+    IntPtr value;
+    TloError error = intPtrConstruct(&value, i);
+    TLO_ASSERT(!error);
+    error = tloSkipListMapInsert(thread, TLO_MOVE, key, TLO_COPY, &value);
+    tloPtrDestruct(&value);
+    TLO_ASSERT(!error);
+  }
+
+  // a moved key that's a duplicate is left with the caller
+  IntPtr *key = intPtrMake(0);
+  TLO_ASSERT(key);
+  IntPtr *value = intPtrMake(0);
+  TLO_ASSERT(value);
+  TloError error = tloSkipListMapInsert(thread, TLO_MOVE, key, TLO_MOVE, value);
+  TLO_EXPECT(error == TLO_DUPLICATE);
+  tloPtrDestruct(key);
+  tloPtrDestruct(value);
+  tloAllocatorFree(&countingAllocator, key);
+  tloAllocatorFree(&countingAllocator, value);
+
+  // the deep copies are destructed once the removed nodes are freed
+  for (int i = 0; i < NUM_KEYS; i += 3) {
+    IntPtr removedKey;
+    error = intPtrConstruct(&removedKey, removalOrder(i));
+    TLO_ASSERT(!error);
+    bool removed = tloSkipListMapRemove(thread, &removedKey);
+    tloPtrDestruct(&removedKey);
+    TLO_EXPECT(removed);
+  }
+
+  TLO_EXPECT(tloSkipListMapSize(map) == NUM_KEYS - (NUM_KEYS + 2) / 3);
+
+  tloSkipListThreadPin(thread);
+  TloSkipListCursor cursor;
+  int previous = -1;
+  size_t count = 0;
+  for (tloSkipListMapFirst(thread, &cursor); !tloSkipListCursorIsEnd(&cursor);
+       tloSkipListCursorNext(&cursor)) {
+    const IntPtr *cursorKey = tloSkipListCursorKey(&cursor);
+    TLO_EXPECT(*cursorKey->ptr > previous);
+    previous = *cursorKey->ptr;
+    ++count;
+  }
+  tloSkipListThreadUnpin(thread);
+  TLO_EXPECT(count == tloSkipListMapSize(map));
+
+  tloSkipListMapDetach(thread);
+  tloSkipListMapDelete(map);
+}
+
+enum { NUM_THREADS = 4, NUM_CHURN_KEYS = 64, NUM_CHURN_ROUNDS = 20000 };
+
+typedef struct ThreadParameters {
+  TloSkipListMap *map;
+  int id;
+  size_t numInserted;
+  size_t numRemoved;
+  bool keysWereInOrder;
+  bool valuesWereRight;
+  bool sizesWereRight;
+} ThreadParameters;
+
+static bool keysAreInOrder(TloSkipListThread *thread) {
+  TloSkipListCursor cursor;
+  bool inOrder = true;
+  int previous = -1;
+
+  tloSkipListThreadPin(thread);
+  for (tloSkipListMapFirst(thread, &cursor); !tloSkipListCursorIsEnd(&cursor);
+       tloSkipListCursorNext(&cursor)) {
+    int key = *(const int *)tloSkipListCursorKey(&cursor);
+    inOrder = inOrder && key > previous;
+    previous = key;
+  }
+  tloSkipListThreadUnpin(thread);
+
+  return inOrder;
+}
+
+// every thread tries to insert every key, in its own order
+static void *insertAll(void *parameters) {
+  ThreadParameters *p = parameters;
+  TloSkipListThread *thread = tloSkipListMapAttach(p->map);
+  if (!thread) {
+    return NULL;
+  }
+
+  for (int i = 0; i < NUM_KEYS; ++i) {
+    int key = (i * 7919 + p->id * 500) % NUM_KEYS;
+    int value = key * 2;
+    if (tloSkipListMapInsert(thread, TLO_COPY, &key, TLO_COPY, &value) ==
+        TLO_SUCCESS) {
+      ++p->numInserted;
+    }
+    if (i % 256 == 0) {
+      p->keysWereInOrder = p->keysWereInOrder && keysAreInOrder(thread);
+    }
+  }
+
+  tloSkipListMapDetach(thread);
+  return NULL;
+}
+
+// every thread tries to remove every odd key, in its own order
+static void *removeOdd(void *parameters) {
+  ThreadParameters *p = parameters;
+  TloSkipListThread *thread = tloSkipListMapAttach(p->map);
+  if (!thread) {
+    return NULL;
+  }
+
+  for (int i = 0; i < NUM_KEYS; ++i) {
+    int key = (i * 1009 + p->id * 500) % NUM_KEYS;
+    if (key % 2 && tloSkipListMapRemove(thread, &key)) {
+      ++p->numRemoved;
+    }
+    if (i % 256 == 0) {
+      p->keysWereInOrder = p->keysWereInOrder && keysAreInOrder(thread);
+    }
+  }
+
+  tloSkipListMapDetach(thread);
+  return NULL;
+}
+
+static bool runThreads(void *(*function)(void *),
+                       ThreadParameters *parameters) {
+  pthread_t threads[NUM_THREADS];
+  int numStarted = 0;
+  while (numStarted < NUM_THREADS &&
+         !pthread_create(&threads[numStarted], NULL, function,
+                         &parameters[numStarted])) {
+    ++numStarted;
+  }
+
+  for (int i = 0; i < numStarted; ++i) {
+    pthread_join(threads[i], NULL);
+  }
+
+  return numStarted == NUM_THREADS;
+}
+
+/*
+ * - threads keep inserting and removing the same few keys, whose values
+ *   are deep copies, so a value freed too early gets read after it's freed
+ */
+static void *churn(void *parameters) {
+  ThreadParameters *p = parameters;
+  TloSkipListThread *thread = tloSkipListMapAttach(p->map);
+  if (!thread) {
+    return NULL;
+  }
+
+  for (int i = 0; i < NUM_CHURN_ROUNDS; ++i) {
+    int key = (i * 31 + p->id * 7) % NUM_CHURN_KEYS;
+
+    if ((i + p->id) % 2) {
+      IntPtr value;
+      if (intPtrConstruct(&value, key * 2) != TLO_SUCCESS) {
+        p->valuesWereRight = false;
+        break;
+      }
+      tloSkipListMapInsert(thread, TLO_COPY, &key, TLO_COPY, &value);
+      tloPtrDestruct(&value);
+    } else {
+      tloSkipListMapRemove(thread, &key);
+    }
+
+    tloSkipListThreadPin(thread);
+    const IntPtr *value = tloSkipListMapFind(thread, &key);
+    p->valuesWereRight =
+        p->valuesWereRight && (!value || *value->ptr == key * 2);
+    tloSkipListThreadUnpin(thread);
+  }
+
+  tloSkipListMapDetach(thread);
+  return NULL;
+}
+
+/*
+ * - thread 0 keeps reading the size while the others keep inserting and
+ *   removing the same few keys, so the size can never be more than
+ *   NUM_CHURN_KEYS, and would wrap around if removals were counted before
+ *   the insertions of the keys they removed
+ */
+static void *churnOrReadSize(void *parameters) {
+  ThreadParameters *p = parameters;
+  if (p->id == 0) {
+    for (int i = 0; i < NUM_CHURN_ROUNDS; ++i) {
+      p->sizesWereRight = p->sizesWereRight &&
+                          tloSkipListMapSize(p->map) <= NUM_CHURN_KEYS;
+    }
+    return NULL;
+  }
+
+  TloSkipListThread *thread = tloSkipListMapAttach(p->map);
+  if (!thread) {
+    return NULL;
+  }
+
+  for (int i = 0; i < NUM_CHURN_ROUNDS; ++i) {
+    int key = (i * 31 + p->id * 7) % NUM_CHURN_KEYS;
+    if ((i + p->id) % 2) {
+      tloSkipListMapInsert(thread, TLO_COPY, &key, TLO_COPY, &key);
+    } else {
+      tloSkipListMapRemove(thread, &key);
+    }
+  }
+
+  tloSkipListMapDetach(thread);
+  return NULL;
+}
+
+// allocator isn't thread safe, so these use tloCStdLibAllocator
+static void testSkipListMapManyThreadsInsertThenRemove(void) {
+  TloSkipListMap *map = tloSkipListMapMake(&tloInt, &tloInt, NULL);
+  TLO_ASSERT(map);
+
+  ThreadParameters parameters[NUM_THREADS];
+  for (int i = 0; i < NUM_THREADS; ++i) {
+    parameters[i] =
+        (ThreadParameters){.map = map, .id = i, .keysWereInOrder = true};
+  }
+
+  // so each key is inserted by exactly one thread, then each odd one removed
+  // by exactly one thread
+  bool ran = runThreads(insertAll, parameters);
+  TLO_ASSERT(ran);
+  TLO_EXPECT(tloSkipListMapSize(map) == NUM_KEYS);
+  ran = runThreads(removeOdd, parameters);
+  TLO_ASSERT(ran);
+
+  size_t numInserted = 0;
+  size_t numRemoved = 0;
+  bool keysWereInOrder = true;
+  for (int i = 0; i < NUM_THREADS; ++i) {
+    numInserted += parameters[i].numInserted;
+    numRemoved += parameters[i].numRemoved;
+    keysWereInOrder = keysWereInOrder && parameters[i].keysWereInOrder;
+  }
+
+  TLO_EXPECT(numInserted == NUM_KEYS);
+  TLO_EXPECT(numRemoved == NUM_KEYS / 2);
+  TLO_EXPECT(keysWereInOrder);
+  TLO_EXPECT(tloSkipListMapSize(map) == NUM_KEYS / 2);
+
+  TloSkipListThread *thread = tloSkipListMapAttach(map);
+  TLO_ASSERT(thread);
+  expectKeysInOrder(thread, 0, 2);
+  tloSkipListMapDetach(thread);
+
+  tloSkipListMapDelete(map);
+}
+
+static void testSkipListMapManyThreadsChurn(void) {
+  TloSkipListMap *map = tloSkipListMapMake(&tloInt, &intPtrType, NULL);
+  TLO_ASSERT(map);
+
+  ThreadParameters parameters[NUM_THREADS];
+  for (int i = 0; i < NUM_THREADS; ++i) {
+    parameters[i] =
+        (ThreadParameters){.map = map, .id = i, .valuesWereRight = true};
+  }
+
+  bool ran = runThreads(churn, parameters);
+  TLO_ASSERT(ran);
+
+  bool valuesWereRight = true;
+  for (int i = 0; i < NUM_THREADS; ++i) {
+    valuesWereRight = valuesWereRight && parameters[i].valuesWereRight;
+  }
+  TLO_EXPECT(valuesWereRight);
+
+  TloSkipListThread *thread = tloSkipListMapAttach(map);
+  TLO_ASSERT(thread);
+  TLO_EXPECT(keysAreInOrder(thread));
+
+  size_t count = 0;
+  TloSkipListCursor cursor;
+  tloSkipListThreadPin(thread);
+  for (tloSkipListMapFirst(thread, &cursor); !tloSkipListCursorIsEnd(&cursor);
+       tloSkipListCursorNext(&cursor)) {
+    ++count;
+  }
+  tloSkipListThreadUnpin(thread);
+  TLO_EXPECT(count == tloSkipListMapSize(map));
+  tloSkipListMapDetach(thread);
+
+  tloSkipListMapDelete(map);
+}
+
+static void testSkipListMapManyThreadsSize(void) {
+  TloSkipListMap *map = tloSkipListMapMake(&tloInt, &tloInt, NULL);
+  TLO_ASSERT(map);
+
+  ThreadParameters parameters[NUM_THREADS];
+  for (int i = 0; i < NUM_THREADS; ++i) {
+    parameters[i] =
+        (ThreadParameters){.map = map, .id = i, .sizesWereRight = true};
+  }
+
+  bool ran = runThreads(churnOrReadSize, parameters);
+  TLO_ASSERT(ran);
+  TLO_EXPECT(parameters[0].sizesWereRight);
+
+  TloSkipListThread *thread = tloSkipListMapAttach(map);
+  TLO_ASSERT(thread);
+  size_t count = 0;
+  for (int key = 0; key < NUM_CHURN_KEYS; ++key) {
+    tloSkipListThreadPin(thread);
+    count += tloSkipListMapFind(thread, &key) != NULL;
+    tloSkipListThreadUnpin(thread);
+  }
+  TLO_EXPECT(count == tloSkipListMapSize(map));
+  tloSkipListMapDetach(thread);
+
+  tloSkipListMapDelete(map);
+}
+
+void testSkipList(void) {
+  testInitialCounts();
+
+  testSkipListMapConstructDestruct();
+  testSkipListMapIntIntManyKeys();
+  testSkipListMapIntIntBounds();
+  testSkipListMapIntPtrIntPtr();
+  testSkipListMapManyThreadsInsertThenRemove();
+  testSkipListMapManyThreadsChurn();
+  testSkipListMapManyThreadsSize();
+
+  printf("sizeof(TloSkipListMap): %zu\n", sizeof(TloSkipListMap));
+  testFinalCounts();
+  puts("====================");
+  puts("SkipList tests done.");
+  puts("====================");
+}
@@ -0,0 +1,6 @@
+#ifndef TEST_SKIPLIST_TEST_H
+#define TEST_SKIPLIST_TEST_H
+
+void testSkipList(void);
+
+#endif  // TEST_SKIPLIST_TEST_H
@@ -0,0 +1,439 @@
+#include "sort_test.h"
+#include <limits.h>
+#include <stdatomic.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <tlo/darray.h>
+#include <tlo/sort.h>
+#include <tlo/test.h>
+#include <tlo/threadpool.h>
+#include <tlo/unrolledlist.h>
+#include "util.h"
+
+/*
+ * - big enough for the quicksort, ninther, and partial insertion sort paths
+ * - parallel sorts get enough to be split into tasks several levels deep
+ */
+enum { NUM_ELEMENTS = 2000, NUM_PARALLEL_ELEMENTS = 20000 };
+
+typedef enum Pattern {
+  ASCENDING,
+  DESCENDING,
+  ALL_EQUAL,
+  SAWTOOTH,
+  ORGAN_PIPE,
+  RANDOM,
+  NUM_PATTERNS
+} Pattern;
+
+static uint64_t nextRandom(void) {
+  static uint64_t state = 88172645463325252U;
+
+  state ^= state << 13;
+  state ^= state >> 7;
+  state ^= state << 17;
+  return state;
+}
+
+static uint32_t keyAt(Pattern pattern, size_t index, size_t count) {
+  switch (pattern) {
+    case ASCENDING:
+      return (uint32_t)index;
+    case DESCENDING:
+      return (uint32_t)(count - index);
+    case ALL_EQUAL:
+      return 42;
+    case SAWTOOTH:
+      return (uint32_t)(index % 100);
+    case ORGAN_PIPE:
+      return (uint32_t)(index < count / 2 ? index : count - index);
+    default:
+      return (uint32_t)(nextRandom() % count);
+  }
+}
+
+// parallel sorts compare on several threads
+static atomic_size_t numComparisons;
+
+/*
+ * - elements of 4, 8, 16, and 24 bytes, so every swap path runs. the bytes
+ *   after the key are derived from it, which catches elements swapped only
+ *   partly
+ */
+typedef struct Key8 {
+  uint32_t key;
+  uint32_t check;
+} Key8;
+
+typedef struct Key16 {
+  uint32_t key;
+  uint32_t check[3];
+} Key16;
+
+typedef struct Key24 {
+  uint32_t key;
+  uint32_t check[5];
+} Key24;
+
+static int compareKeys(const void *object1, const void *object2) {
+  atomic_fetch_add_explicit(&numComparisons, 1, memory_order_relaxed);
+  uint32_t key1;
+  uint32_t key2;
+  memcpy(&key1, object1, sizeof(key1));
+  memcpy(&key2, object2, sizeof(key2));
+  return key1 < key2 ? -1 : key1 > key2;
+}
+
+static const TloType key4Type = {.size = sizeof(uint32_t),
+                                 .compare = compareKeys};
+static const TloType key8Type = {.size = sizeof(Key8),
+                                 .compare = compareKeys};
+static const TloType key16Type = {.size = sizeof(Key16),
+                                  .compare = compareKeys};
+static const TloType key24Type = {.size = sizeof(Key24),
+                                  .compare = compareKeys};
+
+static void fill(unsigned char *elements, size_t count, size_t size,
+                 Pattern pattern) {
+  for (size_t i = 0; i < count; ++i) {
+    uint32_t words[sizeof(Key24) / sizeof(uint32_t)];
+    words[0] = keyAt(pattern, i, count);
+    for (size_t j = 1; j < size / sizeof(uint32_t); ++j) {
+      words[j] = words[0] * 2654435761U + (uint32_t)j;
+    }
+    memcpy(elements + i * size, words, size);
+  }
+}
+
+static bool isSortedAndIntact(const unsigned char *elements, size_t count,
+                              size_t size) {
+  uint32_t previous = 0;
+  for (size_t i = 0; i < count; ++i) {
+    uint32_t words[sizeof(Key24) / sizeof(uint32_t)];
+    memcpy(words, elements + i * size, size);
+    if (words[0] < previous) {
+      return false;
+    }
+    for (size_t j = 1; j < size / sizeof(uint32_t); ++j) {
+      if (words[j] != words[0] * 2654435761U + (uint32_t)j) {
+        return false;
+      }
+    }
+    previous = words[0];
+  }
+  return true;
+}
+
+static uint64_t sumOfKeys(const unsigned char *elements, size_t count,
+                          size_t size) {
+  uint64_t sum = 0;
+  for (size_t i = 0; i < count; ++i) {
+    uint32_t key;
+    memcpy(&key, elements + i * size, sizeof(key));
+    sum += key;
+  }
+  return sum;
+}
+
+static void testSortPatterns(const TloType *type) {
+  static unsigned char elements[NUM_ELEMENTS * sizeof(Key24)];
+
+  for (int pattern = 0; pattern < NUM_PATTERNS; ++pattern) {
+    fill(elements, NUM_ELEMENTS, type->size, (Pattern)pattern);
+    uint64_t sum = sumOfKeys(elements, NUM_ELEMENTS, type->size);
+
+    atomic_store(&numComparisons, 0);
+    tloSort(elements, NUM_ELEMENTS, type);
+
+    TLO_EXPECT(isSortedAndIntact(elements, NUM_ELEMENTS, type->size));
+    TLO_EXPECT(sumOfKeys(elements, NUM_ELEMENTS, type->size) == sum);
+
+    // well under the n * log2(n) * 4 of anything near quadratic
+    TLO_EXPECT(atomic_load(&numComparisons) < (size_t)NUM_ELEMENTS * 11 * 4);
+  }
+}
+
+static void testSortAlreadySortedTakesLinearTime(void) {
+  static uint32_t keys[NUM_ELEMENTS];
+  fill((unsigned char *)keys, NUM_ELEMENTS, sizeof(keys[0]), ASCENDING);
+
+  atomic_store(&numComparisons, 0);
+  tloSort(keys, NUM_ELEMENTS, &key4Type);
+  TLO_EXPECT(atomic_load(&numComparisons) < (size_t)NUM_ELEMENTS * 3);
+}
+
+static void testSortSmallCounts(void) {
+  for (int count = 0; count <= 20; ++count) {
+    int ints[20];
+    for (int i = 0; i < count; ++i) {
+      ints[i] = (i * 7 + 3) % (count + 1) - count / 2;
+    }
+
+    tloSort(count ? ints : NULL, (size_t)count, &tloInt);
+
+    bool isSorted = true;
+    for (int i = 1; i < count; ++i) {
+      isSorted = isSorted && ints[i - 1] <= ints[i];
+    }
+    TLO_EXPECT(isSorted);
+  }
+}
+
+static void testParallelSortPatterns(TloThreadPool *pool, const TloType *type,
+                                     bool stable) {
+  static unsigned char elements[NUM_PARALLEL_ELEMENTS * sizeof(Key24)];
+
+  for (int pattern = 0; pattern < NUM_PATTERNS; ++pattern) {
+    fill(elements, NUM_PARALLEL_ELEMENTS, type->size, (Pattern)pattern);
+    uint64_t sum = sumOfKeys(elements, NUM_PARALLEL_ELEMENTS, type->size);
+
+    TloError error = tloParallelSort(elements, NUM_PARALLEL_ELEMENTS, type,
+                                     stable, pool, &countingAllocator);
+    TLO_ASSERT(!error);
+
+    TLO_EXPECT(
+        isSortedAndIntact(elements, NUM_PARALLEL_ELEMENTS, type->size));
+    TLO_EXPECT(sumOfKeys(elements, NUM_PARALLEL_ELEMENTS, type->size) == sum);
+  }
+}
+
+static void testParallelSortIsStable(TloThreadPool *pool) {
+  // few distinct keys, each remembering where it started out
+  static Key8 elements[NUM_PARALLEL_ELEMENTS];
+  for (size_t i = 0; i < NUM_PARALLEL_ELEMENTS; ++i) {
+    elements[i] = (Key8){.key = keyAt(RANDOM, i, 16), .check = (uint32_t)i};
+  }
+
+  TloError error = tloParallelSort(elements, NUM_PARALLEL_ELEMENTS, &key8Type,
+                                   true, pool, &countingAllocator);
+  TLO_ASSERT(!error);
+
+  bool isStable = true;
+  for (size_t i = 1; i < NUM_PARALLEL_ELEMENTS; ++i) {
+    isStable = isStable && (elements[i - 1].key < elements[i].key ||
+                            (elements[i - 1].key == elements[i].key &&
+                             elements[i - 1].check < elements[i].check));
+  }
+  TLO_EXPECT(isStable);
+}
+
+// sorts with tlovListParallelSort, or with tlovListSort if pool is NULL
+static void testListSortMany(TloThreadPool *pool, TloList *ints) {
+  TLO_ASSERT(ints);
+
+  for (size_t i = 0; i < NUM_PARALLEL_ELEMENTS; ++i) {
+    int value = (int)keyAt(RANDOM, i, NUM_PARALLEL_ELEMENTS);
+    TloError error = tlovListPushBack(ints, &value);
+    TLO_ASSERT(!error);
+  }
+
+  TloError error =
+      pool ? tlovListParallelSort(ints, false, pool) : tlovListSort(ints);
+  TLO_ASSERT(!error);
+
+  bool isSorted = true;
+  for (size_t i = 1; i < NUM_PARALLEL_ELEMENTS; ++i) {
+    isSorted = isSorted && *(const int *)tlovListElement(ints, i - 1) <=
+                               *(const int *)tlovListElement(ints, i);
+  }
+  TLO_EXPECT(isSorted);
+
+  tloListDelete(ints);
+}
+
+/*
+ * - enough elements that copying them to and from the sort buffer one
+ *   tlovListElement at a time, which walks the nodes each time, takes
+ *   seconds instead of milliseconds
+ * - pushes to both ends, so the first node doesn't start at its beginning
+ */
+enum { NUM_UNROLLED_LIST_ELEMENTS = 1000000 };
+
+static void testListSortLargeUnrolledList(void) {
+  TloUnrolledList *ulist =
+      tloUnrolledListMake(&tloInt, &countingAllocator, 0);
+  TLO_ASSERT(ulist);
+
+  uint64_t sum = 0;
+  for (size_t i = 0; i < NUM_UNROLLED_LIST_ELEMENTS; ++i) {
+    int value = (int)keyAt(RANDOM, i, NUM_UNROLLED_LIST_ELEMENTS);
+    sum += (uint64_t)value;
+    TloError error = i % 2 ? tlovListPushFront(&ulist->list, &value)
+                           : tlovListPushBack(&ulist->list, &value);
+    TLO_ASSERT(!error);
+  }
+
+  TloError error = tlovListSort(&ulist->list);
+  TLO_ASSERT(!error);
+
+  // walks the nodes, since looking up each element would be just as slow
+  bool isSorted = true;
+  size_t count = 0;
+  uint64_t sortedSum = 0;
+  int previous = INT_MIN;
+  for (const TloUnrolledListNode *node = tloUnrolledListHead(ulist); node;
+       node = tloUnrolledListNodeNext(node)) {
+    for (size_t i = 0; i < tloUnrolledListNodeSize(node); ++i) {
+      int value = *(const int *)tloUnrolledListNodeElement(ulist, node, i);
+      isSorted = isSorted && previous <= value;
+      previous = value;
+      sortedSum += (uint64_t)value;
+      ++count;
+    }
+  }
+  TLO_EXPECT(isSorted);
+  TLO_EXPECT(count == NUM_UNROLLED_LIST_ELEMENTS);
+  TLO_EXPECT(sortedSum == sum);
+
+  tloListDelete(&ulist->list);
+}
+
+static void testParallelSort(size_t numThreads) {
+  TloThreadPool *pool = tloThreadPoolMake(numThreads, &countingAllocator);
+  TLO_ASSERT(pool);
+
+  for (int stable = 0; stable <= 1; ++stable) {
+    testParallelSortPatterns(pool, &key4Type, stable);
+    testParallelSortPatterns(pool, &key8Type, stable);
+    testParallelSortPatterns(pool, &key24Type, stable);
+  }
+  testParallelSortIsStable(pool);
+  testListSortMany(pool,
+                   (TloList *)tloDArrayMake(&tloInt, &countingAllocator, 0));
+  testListSortMany(pool, (TloList *)tloUnrolledListMake(
+                             &tloInt, &countingAllocator, 0));
+
+  tloThreadPoolDelete(pool);
+}
+
+// more than the threshold for wide digits
+enum { NUM_RADIX_ELEMENTS = 70000 };
+
+// compares against tloSort, which gives the same order for ints
+static void testRadixSortInts(size_t count) {
+  static int ints[NUM_RADIX_ELEMENTS];
+  static int expected[NUM_RADIX_ELEMENTS];
+  for (size_t i = 0; i < count; ++i) {
+    ints[i] = (int)(uint32_t)nextRandom();
+  }
+  ints[0] = INT_MIN;
+  ints[count - 1] = INT_MAX;
+  memcpy(expected, ints, count * sizeof(int));
+  tloSort(expected, count, &tloInt);
+
+  TloError error = tloRadixSort(ints, count, &tloInt, &countingAllocator);
+  TLO_ASSERT(!error);
+
+  TLO_EXPECT(memcmp(ints, expected, count * sizeof(int)) == 0);
+}
+
+// a signed 8 byte key after some padding, and few distinct keys
+typedef struct Record {
+  uint32_t index;
+  int64_t key;
+} Record;
+
+static int compareRecords(const void *object1, const void *object2) {
+  const Record *record1 = object1;
+  const Record *record2 = object2;
+  return record1->key < record2->key ? -1 : record1->key > record2->key;
+}
+
+static const TloIntegerKey recordKey = {
+    .offset = offsetof(Record, key), .size = 8, .isSigned = true};
+static const TloType recordType = {.size = sizeof(Record),
+                                   .compare = compareRecords,
+                                   .integerKey = &recordKey};
+
+// an unsigned 2 byte key in an element of odd size, all below 256
+typedef struct Short {
+  uint16_t key;
+  uint16_t index;
+  uint16_t unused;
+} Short;
+
+static int compareShorts(const void *object1, const void *object2) {
+  const Short *short1 = object1;
+  const Short *short2 = object2;
+  return short1->key < short2->key ? -1 : short1->key > short2->key;
+}
+
+static const TloIntegerKey shortKey = {
+    .offset = offsetof(Short, key), .size = 2, .isSigned = false};
+static const TloType shortType = {.size = sizeof(Short),
+                                  .compare = compareShorts,
+                                  .integerKey = &shortKey};
+
+static void testRadixSortIsStable(void) {
+  static Record records[NUM_RADIX_ELEMENTS];
+  for (size_t i = 0; i < NUM_RADIX_ELEMENTS; ++i) {
+    records[i] = (Record){.index = (uint32_t)i,
+                          .key = (int64_t)(nextRandom() % 64) - 32};
+  }
+  records[0].key = INT64_MIN;
+  records[1].key = INT64_MAX;
+
+  TloError error = tloRadixSort(records, NUM_RADIX_ELEMENTS, &recordType,
+                                &countingAllocator);
+  TLO_ASSERT(!error);
+
+  bool isStable = true;
+  for (size_t i = 1; i < NUM_RADIX_ELEMENTS; ++i) {
+    isStable = isStable && (records[i - 1].key < records[i].key ||
+                            (records[i - 1].key == records[i].key &&
+                             records[i - 1].index < records[i].index));
+  }
+  TLO_EXPECT(isStable);
+  TLO_EXPECT(records[0].key == INT64_MIN);
+  TLO_EXPECT(records[NUM_RADIX_ELEMENTS - 1].key == INT64_MAX);
+}
+
+static void testRadixSortSkipsSharedDigits(void) {
+  static Short shorts[NUM_ELEMENTS];
+  for (size_t i = 0; i < NUM_ELEMENTS; ++i) {
+    shorts[i] = (Short){.key = (uint16_t)(nextRandom() % 256),
+                        .index = (uint16_t)i};
+  }
+
+  TloError error =
+      tloRadixSort(shorts, NUM_ELEMENTS, &shortType, &countingAllocator);
+  TLO_ASSERT(!error);
+
+  bool isStable = true;
+  for (size_t i = 1; i < NUM_ELEMENTS; ++i) {
+    isStable = isStable && (shorts[i - 1].key < shorts[i].key ||
+                            (shorts[i - 1].key == shorts[i].key &&
+                             shorts[i - 1].index < shorts[i].index));
+  }
+  TLO_EXPECT(isStable);
+}
+
+void testSort(void) {
+  testSortPatterns(&key4Type);
+  testSortPatterns(&key8Type);
+  testSortPatterns(&key16Type);
+  testSortPatterns(&key24Type);
+  testSortAlreadySortedTakesLinearTime();
+  testSortSmallCounts();
+
+  testInitialCounts();
+  testRadixSortInts(NUM_ELEMENTS);
+  testRadixSortInts(NUM_RADIX_ELEMENTS);
+  testRadixSortIsStable();
+  testRadixSortSkipsSharedDigits();
+  testListSortMany(NULL,
+                   (TloList *)tloDArrayMake(&tloInt, &countingAllocator, 0));
+  testListSortMany(NULL, (TloList *)tloUnrolledListMake(
+                             &tloInt, &countingAllocator, 0));
+  testListSortLargeUnrolledList();
+  testParallelSort(1);
+  testParallelSort(2);
+  testParallelSort(4);
+  testFinalCounts();
+
+  puts("================");
+  puts("Sort tests done.");
+  puts("================");
+}
@@ -0,0 +1,6 @@
+#ifndef TEST_SORT_TEST_H
+#define TEST_SORT_TEST_H
+
+void testSort(void);
+
+#endif  // TEST_SORT_TEST_H
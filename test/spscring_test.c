@@ -0,0 +1,195 @@
+#define _POSIX_C_SOURCE 200809L
+#include "spscring_test.h"
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+#include <tlo/spscring.h>
+#include <tlo/test.h>
+#include "list_test_utils.h"
+#include "util.h"
+
+// small so tests wrap around often
+enum { CAPACITY = 8 };
+
+static void testSPSCRingConstructDestruct(void) {
+  TloSPSCRing ring;
+  TloError error =
+      tloSPSCRingConstruct(&ring, &tloInt, &countingAllocator, CAPACITY - 1);
+  TLO_ASSERT(!error);
+
+  TLO_EXPECT(tloSPSCRingCapacity(&ring) == CAPACITY);
+  TLO_EXPECT(tloSPSCRingSize(&ring) == 0);
+
+  int value;
+  TLO_EXPECT(!tloSPSCRingTryPop(&ring, &value));
+
+  tloSPSCRingDestruct(&ring);
+}
+
+static void testSPSCRingMakeDelete(void) {
+  TloSPSCRing *ring = tloSPSCRingMake(&tloInt, &countingAllocator, CAPACITY);
+  TLO_ASSERT(ring);
+
+  TLO_EXPECT(tloSPSCRingCapacity(ring) == CAPACITY);
+
+  tloSPSCRingDelete(ring);
+}
+
+static void testSPSCRingPushPopWrapsAround(void) {
+  TloSPSCRing *ring = tloSPSCRingMake(&tloInt, &countingAllocator, CAPACITY);
+  TLO_ASSERT(ring);
+
+  int next = 0;
+  int expected = 0;
+  for (int round = 0; round < MAX_LIST_SIZE; ++round) {
+    while (tloSPSCRingTryPush(ring, &next)) {
+      ++next;
+    }
+    TLO_EXPECT(tloSPSCRingSize(ring) == CAPACITY);
+
+    // pops a different number each round so head and tail land everywhere
+    for (int i = 0; i <= round % CAPACITY; ++i) {
+      int value;
+      bool popped = tloSPSCRingTryPop(ring, &value);
+      TLO_ASSERT(popped);
+      TLO_EXPECT(value == expected);
+      ++expected;
+    }
+  }
+
+  tloSPSCRingDelete(ring);
+}
+
+static void testSPSCRingPushManyPopMany(void) {
+  TloSPSCRing *ring = tloSPSCRingMake(&tloInt, &countingAllocator, CAPACITY);
+  TLO_ASSERT(ring);
+
+  int values[MAX_LIST_SIZE];
+  for (int i = 0; i < MAX_LIST_SIZE; ++i) {
+    values[i] = i;
+  }
+
+  TLO_EXPECT(tloSPSCRingPushMany(ring, values, 3) == 3);
+  int popped[MAX_LIST_SIZE];
+  TLO_EXPECT(tloSPSCRingPopMany(ring, popped, 2) == 2);
+
+  // only CAPACITY - 1 fit, and they wrap around
+  TLO_EXPECT(tloSPSCRingPushMany(ring, values + 3, MAX_LIST_SIZE) ==
+             CAPACITY - 1);
+  TLO_EXPECT(tloSPSCRingPushMany(ring, values, 1) == 0);
+  TLO_EXPECT(tloSPSCRingSize(ring) == CAPACITY);
+
+  TLO_EXPECT(tloSPSCRingPopMany(ring, popped + 2, MAX_LIST_SIZE) == CAPACITY);
+  for (int i = 0; i < CAPACITY + 2; ++i) {
+    TLO_EXPECT(popped[i] == i);
+  }
+  TLO_EXPECT(tloSPSCRingPopMany(ring, popped, 1) == 0);
+
+  tloSPSCRingDelete(ring);
+}
+
+static void testSPSCRingDestructsLeftOverElements(void) {
+  TloSPSCRing *ring =
+      tloSPSCRingMake(&intPtrType, &countingAllocator, CAPACITY);
+  TLO_ASSERT(ring);
+
+  IntPtr intPtrs[CAPACITY];
+  for (int i = 0; i < CAPACITY; ++i) {
+    TloError error = intPtrConstruct(&intPtrs[i], i);
+    TLO_ASSERT(!error);
+  }
+
+  TLO_EXPECT(tloSPSCRingTryPush(ring, &intPtrs[0]));
+  TLO_EXPECT(tloSPSCRingPushMany(ring, intPtrs + 1, CAPACITY - 1) ==
+             CAPACITY - 1);
+
+  IntPtr popped;
+  TLO_EXPECT(tloSPSCRingTryPop(ring, &popped));
+  TLO_EXPECT(*popped.ptr == 0);
+  tloPtrDestruct(&popped);
+
+  for (int i = 0; i < CAPACITY; ++i) {
+    tloPtrDestruct(&intPtrs[i]);
+  }
+
+  // the rest are deep copies, destructed by the ring
+  tloSPSCRingDelete(ring);
+}
+
+enum { NUM_MESSAGES = 100000, BATCH_SIZE = 5 };
+
+static void *produce(void *argument) {
+  TloSPSCRing *ring = argument;
+
+  int batch[BATCH_SIZE];
+  int next = 0;
+  while (next < NUM_MESSAGES) {
+    // alternates between single and batch pushes
+    if (next % 2) {
+      if (!tloSPSCRingTryPush(ring, &next)) {
+        sched_yield();
+        continue;
+      }
+      ++next;
+    } else {
+      int count = NUM_MESSAGES - next < BATCH_SIZE ? NUM_MESSAGES - next
+                                                   : BATCH_SIZE;
+      for (int i = 0; i < count; ++i) {
+        batch[i] = next + i;
+      }
+      size_t pushed = tloSPSCRingPushMany(ring, batch, (size_t)count);
+      if (!pushed) {
+        sched_yield();
+      }
+      next += (int)pushed;
+    }
+  }
+
+  return NULL;
+}
+
+static void testSPSCRingTwoThreads(void) {
+  TloSPSCRing *ring = tloSPSCRingMake(&tloInt, &countingAllocator, CAPACITY);
+  TLO_ASSERT(ring);
+
+  pthread_t producer;
+  int error = pthread_create(&producer, NULL, produce, ring);
+  TLO_ASSERT(!error);
+
+  int batch[BATCH_SIZE];
+  int expected = 0;
+  bool inOrder = true;
+  while (expected < NUM_MESSAGES) {
+    size_t popped = tloSPSCRingPopMany(ring, batch, BATCH_SIZE);
+    if (!popped) {
+      sched_yield();
+    }
+    for (size_t i = 0; i < popped; ++i) {
+      inOrder = inOrder && batch[i] == expected;
+      ++expected;
+    }
+  }
+
+  pthread_join(producer, NULL);
+  TLO_EXPECT(inOrder);
+  TLO_EXPECT(tloSPSCRingSize(ring) == 0);
+
+  tloSPSCRingDelete(ring);
+}
+
+void testSPSCRing(void) {
+  testInitialCounts();
+
+  testSPSCRingConstructDestruct();
+  testSPSCRingMakeDelete();
+  testSPSCRingPushPopWrapsAround();
+  testSPSCRingPushManyPopMany();
+  testSPSCRingDestructsLeftOverElements();
+  testSPSCRingTwoThreads();
+
+  printf("sizeof(TloSPSCRing): %zu\n", sizeof(TloSPSCRing));
+  testFinalCounts();
+  puts("====================");
+  puts("SPSCRing tests done.");
+  puts("====================");
+}
@@ -0,0 +1,6 @@
+#ifndef TEST_SPSCRING_TEST_H
+#define TEST_SPSCRING_TEST_H
+
+void testSPSCRing(void);
+
+#endif  // TEST_SPSCRING_TEST_H
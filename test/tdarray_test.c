@@ -0,0 +1,275 @@
+#include "tdarray_test.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <tlo/tdarray.h>
+#include <tlo/test.h>
+#include "list_test_utils.h"
+#include "util.h"
+
+TLO_DEFINE_DARRAY(IntArray, int)
+
+#define EXPECT_INTARRAY_PROPERTIES(_array, _size, _isEmpty, _allocator) \
+  do {                                                                  \
+    TLO_EXPECT(IntArraySize(_array) == (_size));                        \
+    TLO_EXPECT(IntArrayIsEmpty(_array) == (_isEmpty));                  \
+    TLO_EXPECT(IntArrayAllocator(_array) == (_allocator));              \
+    TLO_EXPECT(IntArrayCapacity(_array) >= IntArraySize(_array));       \
+  } while (0)
+
+#define EXPECT_INTARRAY_ELEMENTS(_array, _frontValue, _backValue, _index, \
+                                 _indexValue)                             \
+  do {                                                                    \
+    TLO_EXPECT(*IntArrayFront(_array) == (_frontValue));                  \
+    TLO_EXPECT(*IntArrayMutableFront(_array) == (_frontValue));           \
+    TLO_EXPECT(*IntArrayBack(_array) == (_backValue));                    \
+    TLO_EXPECT(*IntArrayMutableBack(_array) == (_backValue));             \
+    TLO_EXPECT(*IntArrayElement(_array, _index) == (_indexValue));        \
+    TLO_EXPECT(*IntArrayMutableElement(_array, _index) == (_indexValue)); \
+  } while (0)
+
+static void testTDArrayIntConstructDestruct(void) {
+  IntArray ints;
+
+  TloError error = IntArrayConstruct(&ints, &countingAllocator, 0);
+  TLO_ASSERT(!error);
+
+  EXPECT_INTARRAY_PROPERTIES(&ints, 0, true, &countingAllocator);
+  TLO_EXPECT(IntArrayCapacity(&ints) == 0);
+
+  IntArrayDestruct(&ints);
+}
+
+static void testTDArrayIntConstructWithCapacityDestruct(void) {
+  IntArray ints;
+
+  TloError error = IntArrayConstruct(&ints, &countingAllocator, MAX_LIST_SIZE);
+  TLO_ASSERT(!error);
+
+  EXPECT_INTARRAY_PROPERTIES(&ints, 0, true, &countingAllocator);
+  TLO_EXPECT(IntArrayCapacity(&ints) == MAX_LIST_SIZE);
+
+  IntArrayDestruct(&ints);
+}
+
+static void testTDArrayIntMakeDelete(void) {
+  IntArray *ints = IntArrayMake(&countingAllocator, 0);
+  TLO_ASSERT(ints);
+
+  EXPECT_INTARRAY_PROPERTIES(ints, 0, true, &countingAllocator);
+
+  IntArrayDelete(ints);
+}
+
+static void testTDArrayIntMakeWithCapacityDelete(void) {
+  IntArray *ints = IntArrayMake(&countingAllocator, MAX_LIST_SIZE);
+  TLO_ASSERT(ints);
+
+  EXPECT_INTARRAY_PROPERTIES(ints, 0, true, &countingAllocator);
+  TLO_EXPECT(IntArrayCapacity(ints) == MAX_LIST_SIZE);
+
+  IntArrayDelete(ints);
+}
+
+static IntArray *makeIntArrayWithManyElements(void) {
+  IntArray *ints = IntArrayMake(&countingAllocator, 0);
+  if (!ints) {
+    return NULL;
+  }
+
+  for (int i = 0; i < MAX_LIST_SIZE; ++i) {
+    if (IntArrayPushBack(ints, i) != TLO_SUCCESS) {
+      IntArrayDelete(ints);
+      return NULL;
+    }
+  }
+
+  return ints;
+}
+
+#define EXPECT_INTARRAYS_EQUAL(_array1, _array2)                          \
+  do {                                                                    \
+    TLO_EXPECT(IntArraySize(_array1) == IntArraySize(_array2));           \
+    TLO_EXPECT(IntArrayCapacity(_array1) == IntArrayCapacity(_array2));   \
+    TLO_EXPECT(IntArrayAllocator(_array1) == IntArrayAllocator(_array2)); \
+    for (size_t i = 0; i < IntArraySize(_array1); ++i) {                  \
+      const int *elem1 = IntArrayElement(_array1, i);                     \
+      const int *elem2 = IntArrayElement(_array2, i);                     \
+      TLO_EXPECT(elem1 != elem2);                                         \
+      TLO_EXPECT(*elem1 == *elem2);                                       \
+    }                                                                     \
+  } while (0)
+
+static void testTDArrayIntConstructCopy(void) {
+  IntArray *ints = makeIntArrayWithManyElements();
+  TLO_ASSERT(ints);
+
+  IntArray *copy = malloc(sizeof(*copy));
+  TLO_ASSERT(copy);
+
+  TloError error = IntArrayConstructCopy(copy, ints);
+  TLO_ASSERT(!error);
+
+  EXPECT_INTARRAYS_EQUAL(ints, copy);
+
+  IntArrayDelete(ints);
+  IntArrayDestruct(copy);
+  free(copy);
+}
+
+static void testTDArrayIntMakeCopy(void) {
+  IntArray *ints = makeIntArrayWithManyElements();
+  TLO_ASSERT(ints);
+
+  IntArray *copy = IntArrayMakeCopy(ints);
+  TLO_ASSERT(copy);
+
+  EXPECT_INTARRAYS_EQUAL(ints, copy);
+
+  IntArrayDelete(ints);
+  IntArrayDelete(copy);
+}
+
+static void testTDArrayIntCopy(void) {
+  IntArray *ints = makeIntArrayWithManyElements();
+  TLO_ASSERT(ints);
+
+  IntArray *copy = IntArrayMake(&countingAllocator, 0);
+  TLO_ASSERT(copy);
+
+  TloError error = IntArrayPushBack(copy, MAX_LIST_SIZE);
+  TLO_ASSERT(!error);
+
+  error = IntArrayCopy(copy, ints);
+  TLO_ASSERT(!error);
+
+  EXPECT_INTARRAYS_EQUAL(ints, copy);
+
+  IntArrayDelete(ints);
+  IntArrayDelete(copy);
+}
+
+static void testTDArrayIntPushBackOnce(void) {
+  IntArray *ints = IntArrayMake(&countingAllocator, 0);
+  TLO_ASSERT(ints);
+
+  TloError error = IntArrayPushBack(ints, MAX_LIST_SIZE);
+  TLO_ASSERT(!error);
+
+  EXPECT_INTARRAY_PROPERTIES(ints, 1, false, &countingAllocator);
+  EXPECT_INTARRAY_ELEMENTS(ints, MAX_LIST_SIZE, MAX_LIST_SIZE, 0,
+                           MAX_LIST_SIZE);
+
+  IntArrayDelete(ints);
+}
+
+static void testTDArrayIntPushBackManyTimes(void) {
+  IntArray *ints = IntArrayMake(&countingAllocator, 0);
+  TLO_ASSERT(ints);
+
+  for (size_t i = 0; i < MAX_LIST_SIZE; ++i) {
+    TloError error = IntArrayPushBack(ints, (int)i);
+    TLO_ASSERT(!error);
+
+    EXPECT_INTARRAY_PROPERTIES(ints, i + 1, false, &countingAllocator);
+    EXPECT_INTARRAY_ELEMENTS(ints, 0, (int)i, i, (int)i);
+  }
+
+  IntArrayDelete(ints);
+}
+
+static void testTDArrayIntPushBackOncePopBackOnce(void) {
+  IntArray *ints = IntArrayMake(&countingAllocator, 0);
+  TLO_ASSERT(ints);
+
+  TloError error = IntArrayPushBack(ints, MAX_LIST_SIZE);
+  TLO_ASSERT(!error);
+
+  IntArrayPopBack(ints);
+
+  EXPECT_INTARRAY_PROPERTIES(ints, 0, true, &countingAllocator);
+
+  IntArrayDelete(ints);
+}
+
+static void testTDArrayIntPushBackManyTimesPopBackUntilEmpty(void) {
+  IntArray *ints = makeIntArrayWithManyElements();
+  TLO_ASSERT(ints);
+
+  for (size_t i = MAX_LIST_SIZE - 1; i <= MAX_LIST_SIZE - 1; --i) {
+    EXPECT_INTARRAY_PROPERTIES(ints, i + 1, false, &countingAllocator);
+    EXPECT_INTARRAY_ELEMENTS(ints, 0, (int)i, i, (int)i);
+
+    IntArrayPopBack(ints);
+  }
+
+  EXPECT_INTARRAY_PROPERTIES(ints, 0, true, &countingAllocator);
+
+  IntArrayDelete(ints);
+}
+
+static void testTDArrayIntPushBackManyTimesUnorderedRemoveBackUntilEmpty(
+    void) {
+  IntArray *ints = makeIntArrayWithManyElements();
+  TLO_ASSERT(ints);
+
+  for (size_t i = MAX_LIST_SIZE - 1; i <= MAX_LIST_SIZE - 1; --i) {
+    EXPECT_INTARRAY_PROPERTIES(ints, i + 1, false, &countingAllocator);
+    EXPECT_INTARRAY_ELEMENTS(ints, 0, (int)i, i, (int)i);
+
+    IntArrayUnorderedRemove(ints, IntArraySize(ints) - 1);
+  }
+
+  EXPECT_INTARRAY_PROPERTIES(ints, 0, true, &countingAllocator);
+
+  IntArrayDelete(ints);
+}
+
+static void testTDArrayIntPushBackManyTimesUnorderedRemoveFrontUntilEmpty(
+    void) {
+  IntArray *ints = makeIntArrayWithManyElements();
+  TLO_ASSERT(ints);
+
+  for (size_t i = MAX_LIST_SIZE - 1; i <= MAX_LIST_SIZE - 1; --i) {
+    EXPECT_INTARRAY_PROPERTIES(ints, i + 1, false, &countingAllocator);
+
+    if (i == MAX_LIST_SIZE - 1) {
+      EXPECT_INTARRAY_ELEMENTS(ints, 0, MAX_LIST_SIZE - 1, i,
+                               MAX_LIST_SIZE - 1);
+    } else if (i == 0) {
+      EXPECT_INTARRAY_ELEMENTS(ints, 1, 1, i, 1);
+    } else {
+      EXPECT_INTARRAY_ELEMENTS(ints, (int)i + 1, (int)i, i, (int)i);
+    }
+
+    IntArrayUnorderedRemove(ints, 0);
+  }
+
+  EXPECT_INTARRAY_PROPERTIES(ints, 0, true, &countingAllocator);
+
+  IntArrayDelete(ints);
+}
+
+void testTDArray(void) {
+  testInitialCounts();
+
+  testTDArrayIntConstructDestruct();
+  testTDArrayIntConstructWithCapacityDestruct();
+  testTDArrayIntMakeDelete();
+  testTDArrayIntMakeWithCapacityDelete();
+  testTDArrayIntConstructCopy();
+  testTDArrayIntMakeCopy();
+  testTDArrayIntCopy();
+
+  testTDArrayIntPushBackOnce();
+  testTDArrayIntPushBackManyTimes();
+  testTDArrayIntPushBackOncePopBackOnce();
+  testTDArrayIntPushBackManyTimesPopBackUntilEmpty();
+  testTDArrayIntPushBackManyTimesUnorderedRemoveBackUntilEmpty();
+  testTDArrayIntPushBackManyTimesUnorderedRemoveFrontUntilEmpty();
+
+  printf("sizeof(IntArray): %zu\n", sizeof(IntArray));
+  testFinalCounts();
+  puts("===================");
+  puts("TDArray tests done.");
+  puts("===================");
+}
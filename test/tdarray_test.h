@@ -0,0 +1,6 @@
+#ifndef TEST_TDARRAY_TEST_H
+#define TEST_TDARRAY_TEST_H
+
+void testTDArray(void);
+
+#endif  // TEST_TDARRAY_TEST_H
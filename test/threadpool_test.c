@@ -0,0 +1,179 @@
+#include "threadpool_test.h"
+#include <stdatomic.h>
+#include <stdio.h>
+#include <tlo/test.h>
+#include <tlo/threadpool.h>
+#include "list_test_utils.h"
+#include "util.h"
+
+static const size_t numThreadsToTest[] = {1, 2, 4};
+
+enum {
+  NUM_NUM_THREADS = sizeof(numThreadsToTest) / sizeof(numThreadsToTest[0])
+};
+
+// more than fit in the queue for tasks from outside the pool
+enum { NUM_TASKS = 10000 };
+
+static void testThreadPoolConstructDestruct(void) {
+  TloThreadPool pool;
+  TloError error = tloThreadPoolConstruct(&pool, 2, &countingAllocator);
+  TLO_ASSERT(!error);
+
+  TLO_EXPECT(tloThreadPoolNumThreads(&pool) == 2);
+
+  tloThreadPoolDestruct(&pool);
+}
+
+static void testThreadPoolMakeDelete(void) {
+  TloThreadPool *pool = tloThreadPoolMake(0, &countingAllocator);
+  TLO_ASSERT(pool);
+
+  TLO_EXPECT(tloThreadPoolNumThreads(pool) >= 1);
+
+  tloThreadPoolDelete(pool);
+}
+
+static void increment(void *counter) {
+  atomic_fetch_add((atomic_int *)counter, 1);
+}
+
+static void testThreadPoolWaitForGroup(size_t numThreads) {
+  TloThreadPool *pool = tloThreadPoolMake(numThreads, &countingAllocator);
+  TLO_ASSERT(pool);
+
+  atomic_int counter = 0;
+  TloTaskGroup group;
+  tloTaskGroupConstruct(&group);
+  for (int i = 0; i < NUM_TASKS; ++i) {
+    tloThreadPoolSubmit(pool, &group, increment, &counter);
+  }
+  tloThreadPoolWait(pool, &group);
+  TLO_EXPECT(atomic_load(&counter) == NUM_TASKS);
+
+  tloThreadPoolDelete(pool);
+}
+
+static void testThreadPoolDestructRunsPendingTasks(size_t numThreads) {
+  TloThreadPool *pool = tloThreadPoolMake(numThreads, &countingAllocator);
+  TLO_ASSERT(pool);
+
+  atomic_int counter = 0;
+  for (int i = 0; i < NUM_TASKS; ++i) {
+    tloThreadPoolSubmit(pool, NULL, increment, &counter);
+  }
+
+  tloThreadPoolDelete(pool);
+  TLO_EXPECT(atomic_load(&counter) == NUM_TASKS);
+}
+
+typedef struct Fibonacci {
+  TloThreadPool *pool;
+  int n;
+  int result;
+} Fibonacci;
+
+// computes fib(n - 1) in a subtask and fib(n - 2) itself, then waits
+static void fibonacci(void *argument) {
+  Fibonacci *fib = argument;
+  if (fib->n < 2) {
+    fib->result = fib->n;
+    return;
+  }
+
+  Fibonacci first = {.pool = fib->pool, .n = fib->n - 1};
+  Fibonacci second = {.pool = fib->pool, .n = fib->n - 2};
+  TloTaskGroup group;
+  tloTaskGroupConstruct(&group);
+  tloThreadPoolSubmit(fib->pool, &group, fibonacci, &first);
+  fibonacci(&second);
+  tloThreadPoolWait(fib->pool, &group);
+
+  fib->result = first.result + second.result;
+}
+
+static void testThreadPoolNestedWaits(size_t numThreads) {
+  TloThreadPool *pool = tloThreadPoolMake(numThreads, &countingAllocator);
+  TLO_ASSERT(pool);
+
+  Fibonacci fib = {.pool = pool, .n = 20};
+  TloTaskGroup group;
+  tloTaskGroupConstruct(&group);
+  tloThreadPoolSubmit(pool, &group, fibonacci, &fib);
+  tloThreadPoolWait(pool, &group);
+  TLO_EXPECT(fib.result == 6765);
+
+  tloThreadPoolDelete(pool);
+}
+
+enum { PARALLEL_FOR_BEGIN = 3, PARALLEL_FOR_SIZE = 1000 };
+
+typedef struct Coverage {
+  size_t grainSize;
+  int timesSeen[PARALLEL_FOR_BEGIN + PARALLEL_FOR_SIZE];
+  atomic_bool chunkTooBig;
+} Coverage;
+
+static void cover(size_t begin, size_t end, void *argument) {
+  Coverage *coverage = argument;
+  if (begin >= end ||
+      (coverage->grainSize && end - begin > coverage->grainSize)) {
+    atomic_store(&coverage->chunkTooBig, true);
+  }
+
+  // chunks don't overlap, so no two threads write the same element
+  for (size_t i = begin; i < end; ++i) {
+    ++coverage->timesSeen[i];
+  }
+}
+
+static void testThreadPoolParallelForCoversRangeOnce(size_t numThreads) {
+  TloThreadPool *pool = tloThreadPoolMake(numThreads, &countingAllocator);
+  TLO_ASSERT(pool);
+
+  const size_t grainSizes[] = {0, 1, 7, PARALLEL_FOR_SIZE * 2};
+  for (size_t i = 0; i < sizeof(grainSizes) / sizeof(grainSizes[0]); ++i) {
+    static Coverage coverage;
+    coverage = (Coverage){.grainSize = grainSizes[i]};
+
+    tloThreadPoolParallelFor(pool, PARALLEL_FOR_BEGIN,
+                             PARALLEL_FOR_BEGIN + PARALLEL_FOR_SIZE,
+                             grainSizes[i], cover, &coverage);
+
+    bool eachSeenOnce = true;
+    for (int j = 0; j < PARALLEL_FOR_BEGIN + PARALLEL_FOR_SIZE; ++j) {
+      eachSeenOnce = eachSeenOnce && coverage.timesSeen[j] ==
+                                         (j >= PARALLEL_FOR_BEGIN ? 1 : 0);
+    }
+    TLO_EXPECT(eachSeenOnce);
+    TLO_EXPECT(!atomic_load(&coverage.chunkTooBig));
+  }
+
+  // an empty range calls nothing
+  static Coverage coverage;
+  coverage = (Coverage){.grainSize = 1};
+  tloThreadPoolParallelFor(pool, PARALLEL_FOR_BEGIN, PARALLEL_FOR_BEGIN, 1,
+                           cover, &coverage);
+  TLO_EXPECT(coverage.timesSeen[PARALLEL_FOR_BEGIN] == 0);
+
+  tloThreadPoolDelete(pool);
+}
+
+void testThreadPool(void) {
+  testInitialCounts();
+
+  testThreadPoolConstructDestruct();
+  testThreadPoolMakeDelete();
+  for (int i = 0; i < NUM_NUM_THREADS; ++i) {
+    testThreadPoolWaitForGroup(numThreadsToTest[i]);
+    testThreadPoolDestructRunsPendingTasks(numThreadsToTest[i]);
+    testThreadPoolNestedWaits(numThreadsToTest[i]);
+    testThreadPoolParallelForCoversRangeOnce(numThreadsToTest[i]);
+  }
+
+  printf("sizeof(TloThreadPool): %zu\n", sizeof(TloThreadPool));
+  testFinalCounts();
+  puts("======================");
+  puts("ThreadPool tests done.");
+  puts("======================");
+}
@@ -0,0 +1,6 @@
+#ifndef TEST_THREADPOOL_TEST_H
+#define TEST_THREADPOOL_TEST_H
+
+void testThreadPool(void);
+
+#endif  // TEST_THREADPOOL_TEST_H
@@ -0,0 +1,208 @@
+#include "timerwheel_test.h"
+#include <stdio.h>
+#include <tlo/test.h>
+#include <tlo/timerwheel.h>
+#include "util.h"
+
+enum { NUM_TIMERS = 200 };
+
+typedef struct Item {
+  int value;
+  TloTimer timer;
+} Item;
+
+static Item *itemOf(TloIDLLHook *hook) {
+  return TLO_CONTAINER_OF(TLO_CONTAINER_OF(hook, TloTimer, hook), Item, timer);
+}
+
+// visits 0 to NUM_TIMERS - 1 out of order, since 17 is coprime to 200
+static int shuffled(int i) { return (i * 17) % NUM_TIMERS; }
+
+// from 1000 to about 2^36, so the timers start out in most of the levels
+static uint64_t deadlineOf(int i) {
+  uint64_t j = (uint64_t)i;
+  return 1000 + j * j * j * j * 37;
+}
+
+static void scheduleAll(TloTimerWheel *wheel, Item items[]) {
+  for (int i = 0; i < NUM_TIMERS; ++i) {
+    int j = shuffled(i);
+    items[j].value = j;
+    tloTimerConstruct(&items[j].timer);
+    tloTimerWheelSchedule(wheel, &items[j].timer, deadlineOf(j));
+  }
+}
+
+static void testTimerWheelConstruct(void) {
+  TloTimerWheel wheel;
+  tloTimerWheelConstruct(&wheel, 1000);
+
+  TLO_EXPECT(tloTimerWheelNow(&wheel) == 1000);
+  TLO_EXPECT(tloTimerWheelSize(&wheel) == 0);
+  TLO_EXPECT(tloTimerWheelIsEmpty(&wheel));
+
+  uint64_t time;
+  TLO_EXPECT(!tloTimerWheelNextExpiry(&wheel, &time));
+
+  TloIDLList expired;
+  tloIDLListConstruct(&expired);
+  TLO_EXPECT(tloTimerWheelAdvance(&wheel, UINT64_MAX, &expired) == 0);
+  TLO_EXPECT(tloTimerWheelNow(&wheel) == UINT64_MAX);
+  TLO_EXPECT(tloIDLListIsEmpty(&expired));
+}
+
+static void testTimerWheelExpiresAtDeadlines(void) {
+  Item items[NUM_TIMERS];
+  TloTimerWheel wheel;
+  tloTimerWheelConstruct(&wheel, 1000);
+
+  for (int i = 0; i < NUM_TIMERS; ++i) {
+    int j = shuffled(i);
+    items[j].value = j;
+    tloTimerConstruct(&items[j].timer);
+    TLO_EXPECT(!tloTimerIsScheduled(&items[j].timer));
+    tloTimerWheelSchedule(&wheel, &items[j].timer, deadlineOf(j));
+    TLO_EXPECT(tloTimerIsScheduled(&items[j].timer));
+  }
+  TLO_EXPECT(tloTimerWheelSize(&wheel) == NUM_TIMERS);
+
+  /*
+   * - advances to each time that next expiry gives. that's never after the
+   *   earliest deadline, so every timer that expires is due right then
+   */
+  TloIDLList expired;
+  tloIDLListConstruct(&expired);
+  size_t numExpired = 0;
+  uint64_t time;
+  while (tloTimerWheelNextExpiry(&wheel, &time)) {
+    TLO_EXPECT(time >= tloTimerWheelNow(&wheel));
+    numExpired += tloTimerWheelAdvance(&wheel, time, &expired);
+
+    while (!tloIDLListIsEmpty(&expired)) {
+      Item *item = itemOf(tloIDLListPopFront(&expired));
+      TLO_EXPECT(tloTimerDeadline(&item->timer) == time);
+      TLO_EXPECT(deadlineOf(item->value) == time);
+      TLO_EXPECT(!tloTimerIsScheduled(&item->timer));
+    }
+  }
+
+  TLO_EXPECT(numExpired == NUM_TIMERS);
+  TLO_EXPECT(tloTimerWheelIsEmpty(&wheel));
+}
+
+static void testTimerWheelAdvanceInOneJump(void) {
+  Item items[NUM_TIMERS];
+  TloTimerWheel wheel;
+  tloTimerWheelConstruct(&wheel, 1000);
+
+  scheduleAll(&wheel, items);
+
+  // one tick before the last deadline, everything else has expired in order
+  uint64_t last = deadlineOf(NUM_TIMERS - 1);
+  TloIDLList expired;
+  tloIDLListConstruct(&expired);
+  TLO_EXPECT(tloTimerWheelAdvance(&wheel, last - 1, &expired) ==
+             NUM_TIMERS - 1);
+  TLO_EXPECT(tloTimerWheelSize(&wheel) == 1);
+
+  uint64_t previous = 0;
+  while (!tloIDLListIsEmpty(&expired)) {
+    Item *item = itemOf(tloIDLListPopFront(&expired));
+    TLO_EXPECT(previous < tloTimerDeadline(&item->timer));
+    previous = tloTimerDeadline(&item->timer);
+  }
+
+  uint64_t time;
+  TLO_EXPECT(tloTimerWheelNextExpiry(&wheel, &time) && time == last);
+  TLO_EXPECT(tloTimerWheelAdvance(&wheel, last, &expired) == 1);
+  TLO_EXPECT(itemOf(tloIDLListPopFront(&expired))->value == NUM_TIMERS - 1);
+}
+
+static void testTimerWheelCancel(void) {
+  Item items[NUM_TIMERS];
+  TloTimerWheel wheel;
+  tloTimerWheelConstruct(&wheel, 1000);
+
+  scheduleAll(&wheel, items);
+  TloTimer unscheduled;
+  tloTimerConstruct(&unscheduled);
+  TLO_EXPECT(!tloTimerWheelCancel(&wheel, &unscheduled));
+
+  for (int i = 0; i < NUM_TIMERS; i += 2) {
+    TLO_EXPECT(tloTimerWheelCancel(&wheel, &items[i].timer));
+    TLO_EXPECT(!tloTimerWheelCancel(&wheel, &items[i].timer));
+  }
+  TLO_EXPECT(tloTimerWheelSize(&wheel) == NUM_TIMERS / 2);
+
+  // half way through, then the rest, so some are canceled after moving down
+  TloIDLList expired;
+  tloIDLListConstruct(&expired);
+  size_t numExpired =
+      tloTimerWheelAdvance(&wheel, deadlineOf(NUM_TIMERS / 2), &expired);
+  for (int i = 1; i < NUM_TIMERS; i += 4) {
+    if (tloTimerIsScheduled(&items[i].timer)) {
+      TLO_EXPECT(tloTimerWheelCancel(&wheel, &items[i].timer));
+      items[i].value = -1;
+    }
+  }
+  numExpired += tloTimerWheelAdvance(&wheel, UINT64_MAX, &expired);
+
+  TLO_EXPECT(numExpired == tloIDLListSize(&expired));
+  TLO_EXPECT(tloTimerWheelIsEmpty(&wheel));
+  while (!tloIDLListIsEmpty(&expired)) {
+    Item *item = itemOf(tloIDLListPopFront(&expired));
+    TLO_EXPECT(item->value % 2 == 1);
+    TLO_EXPECT(!tloTimerWheelCancel(&wheel, &item->timer));
+  }
+}
+
+static void testTimerWheelPastDeadlinesAndReschedule(void) {
+  Item items[NUM_TIMERS];
+  TloTimerWheel wheel;
+  uint64_t now = deadlineOf(NUM_TIMERS / 2);
+  tloTimerWheelConstruct(&wheel, now);
+
+  // deadlines not after now are due on the next advance, even to now
+  scheduleAll(&wheel, items);
+
+  uint64_t time;
+  TLO_EXPECT(tloTimerWheelNextExpiry(&wheel, &time) && time == now);
+
+  TloIDLList expired;
+  tloIDLListConstruct(&expired);
+  size_t numExpired = tloTimerWheelAdvance(&wheel, now, &expired);
+  TLO_EXPECT(numExpired == NUM_TIMERS / 2 + 1);
+
+  // expired timers can be scheduled again once out of the list
+  uint64_t deadline = UINT64_C(1) << 41;
+  while (!tloIDLListIsEmpty(&expired)) {
+    Item *item = itemOf(tloIDLListPopFront(&expired));
+    TLO_EXPECT(tloTimerDeadline(&item->timer) <= now);
+    tloTimerWheelSchedule(&wheel, &item->timer, deadline);
+  }
+  TLO_EXPECT(tloTimerWheelSize(&wheel) == NUM_TIMERS);
+
+  TLO_EXPECT(tloTimerWheelAdvance(&wheel, deadline - 1, &expired) ==
+             NUM_TIMERS - numExpired);
+  tloIDLListConstruct(&expired);
+  TLO_EXPECT(tloTimerWheelAdvance(&wheel, deadline, &expired) == numExpired);
+}
+
+void testTimerWheel(void) {
+  testInitialCounts();
+
+  testTimerWheelConstruct();
+  testTimerWheelExpiresAtDeadlines();
+  testTimerWheelAdvanceInOneJump();
+  testTimerWheelCancel();
+  testTimerWheelPastDeadlinesAndReschedule();
+
+  printf("sizeof(TloTimerWheel): %zu\n", sizeof(TloTimerWheel));
+  printf("sizeof(TloTimer): %zu\n", sizeof(TloTimer));
+
+  // the wheel never allocates, so the usual final counts don't apply
+  TLO_EXPECT(countingAllocatorMallocCount() == 0);
+  puts("======================");
+  puts("TimerWheel tests done.");
+  puts("======================");
+}
@@ -0,0 +1,6 @@
+#ifndef TEST_TIMERWHEEL_TEST_H
+#define TEST_TIMERWHEEL_TEST_H
+
+void testTimerWheel(void);
+
+#endif  // TEST_TIMERWHEEL_TEST_H
@@ -1,13 +1,32 @@
 #include <stdio.h>
 #include <tlo/stopwatch.h>
 #include <tlo/test.h>
+#include "arena_test.h"
+#include "bitset_test.h"
+#include "btree_test.h"
 #include "cdarray_test.h"
 #include "darray_test.h"
 #include "dllist_test.h"
+#include "flatmap_test.h"
+#include "hugepage_test.h"
+#include "idllist_test.h"
+#include "ischtable_test.h"
 #include "list_test_utils.h"
+#include "mpmcqueue_test.h"
+#include "pool_test.h"
+#include "priorityqueue_test.h"
 #include "schtable_test.h"
+#include "skiplist_test.h"
 #include "sllist_test.h"
+#include "sort_test.h"
+#include "spscring_test.h"
 #include "statistics_test.h"
+#include "tdarray_test.h"
+#include "threadpool_test.h"
+#include "timerwheel_test.h"
+#include "tschtable_test.h"
+#include "unrolledlist_test.h"
+#include "util.h"
 
 static void testList(void) {
   testListDeleteWithNull();
@@ -20,13 +39,32 @@ int main(void) {
   TloStopwatch stopwatch;
 
   tloStopwatchStart(&stopwatch);
+  testAllocator();
   testList();
   testDArray();
+  testTDArray();
   testSLList();
   testCDArray();
   testDLList();
+  testUnrolledList();
+  testIDLList();
   testStatistics();
   testSCHTable();
+  testTSCHTable();
+  testISCHTable();
+  testArena();
+  testPool();
+  testHugePage();
+  testSPSCRing();
+  testMPMCQueue();
+  testThreadPool();
+  testSort();
+  testFlatMap();
+  testBTree();
+  testSkipList();
+  testPriorityQueue();
+  testTimerWheel();
+  testBitset();
   tloStopwatchStop(&stopwatch);
 
   puts("===============");
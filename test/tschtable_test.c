@@ -0,0 +1,210 @@
+#include "tschtable_test.h"
+#include <stdio.h>
+#include <tlo/test.h>
+#include <tlo/tschtable.h>
+#include "map_test_utils.h"
+#include "util.h"
+
+static size_t intHash(int key) { return tloFNV1aHash(&key, sizeof(key)); }
+
+#define INT_EQUALS(_key1, _key2) ((_key1) == (_key2))
+
+TLO_DEFINE_SCHTABLE_MAP(IntIntMap, int, int, intHash, INT_EQUALS)
+
+#define EXPECT_INTINTMAP_PROPERTIES(_map, _size, _isEmpty, _allocator) \
+  do {                                                                 \
+    TLO_EXPECT(IntIntMapSize(_map) == (_size));                        \
+    TLO_EXPECT(IntIntMapIsEmpty(_map) == (_isEmpty));                  \
+    TLO_EXPECT(IntIntMapAllocator(_map) == (_allocator));              \
+  } while (0)
+
+static int keyToValue(int key) { return key * 2; }
+
+static void testTSCHTableIntIntConstructDestruct(void) {
+  IntIntMap intsToInts;
+
+  IntIntMapConstruct(&intsToInts, &countingAllocator);
+
+  EXPECT_INTINTMAP_PROPERTIES(&intsToInts, 0, true, &countingAllocator);
+  TLO_EXPECT(!IntIntMapFind(&intsToInts, 0));
+  TLO_EXPECT(!IntIntMapRemove(&intsToInts, 0));
+
+  IntIntMapDestruct(&intsToInts);
+}
+
+static void testTSCHTableIntIntInsertOnce(void) {
+  IntIntMap *intsToInts = IntIntMapMake(&countingAllocator);
+  TLO_ASSERT(intsToInts);
+
+  int key = MAX_MAP_SIZE;
+  int value = keyToValue(key);
+
+  TloError error = IntIntMapInsert(intsToInts, key, value);
+  TLO_ASSERT(!error);
+
+  error = IntIntMapInsert(intsToInts, key, value);
+  TLO_ASSERT(error == TLO_DUPLICATE);
+
+  EXPECT_INTINTMAP_PROPERTIES(intsToInts, 1, false, &countingAllocator);
+
+  const int *result = IntIntMapFind(intsToInts, key);
+  TLO_EXPECT(result && *result == value);
+
+  int *mutableResult = IntIntMapFindMutable(intsToInts, key);
+  TLO_ASSERT(mutableResult);
+  *mutableResult = value + 1;
+  result = IntIntMapFind(intsToInts, key);
+  TLO_EXPECT(result && *result == value + 1);
+
+  IntIntMapDelete(intsToInts);
+}
+
+static void testTSCHTableIntIntInsertManyTimes(void) {
+  IntIntMap *intsToInts = IntIntMapMake(&countingAllocator);
+  TLO_ASSERT(intsToInts);
+
+  for (size_t i = 0; i < MAX_MAP_SIZE; ++i) {
+    int key = (int)i;
+    int value = keyToValue(key);
+
+    TloError error = IntIntMapInsert(intsToInts, key, value);
+    TLO_ASSERT(!error);
+
+    error = IntIntMapInsert(intsToInts, key, value);
+    TLO_ASSERT(error == TLO_DUPLICATE);
+
+    EXPECT_INTINTMAP_PROPERTIES(intsToInts, i + 1, false, &countingAllocator);
+
+    for (int j = 0; j <= key; ++j) {
+      const int *result = IntIntMapFind(intsToInts, j);
+      TLO_EXPECT(result && *result == keyToValue(j));
+    }
+  }
+
+  IntIntMapDelete(intsToInts);
+}
+
+static void testTSCHTableIntIntInsertOnceRemoveOnce(void) {
+  IntIntMap *intsToInts = IntIntMapMake(&countingAllocator);
+  TLO_ASSERT(intsToInts);
+
+  int key = MAX_MAP_SIZE;
+  int value = keyToValue(key);
+
+  TloError error = IntIntMapInsert(intsToInts, key, value);
+  TLO_ASSERT(!error);
+
+  bool removed = IntIntMapRemove(intsToInts, key);
+  TLO_ASSERT(removed);
+
+  removed = IntIntMapRemove(intsToInts, key);
+  TLO_EXPECT(!removed);
+
+  EXPECT_INTINTMAP_PROPERTIES(intsToInts, 0, true, &countingAllocator);
+  TLO_EXPECT(!IntIntMapFind(intsToInts, key));
+
+  IntIntMapDelete(intsToInts);
+}
+
+static void testTSCHTableIntIntInsertManyTimesRemoveUntilEmpty(void) {
+  IntIntMap *intsToInts = IntIntMapMake(&countingAllocator);
+  TLO_ASSERT(intsToInts);
+
+  for (size_t i = 0; i < MAX_MAP_SIZE; ++i) {
+    int key = (int)i;
+    TloError error = IntIntMapInsert(intsToInts, key, keyToValue(key));
+    TLO_ASSERT(!error);
+  }
+
+  // remove even keys first so that nodes are also removed from the middle and
+  // the front of chains
+  for (size_t i = 0; i < MAX_MAP_SIZE; i += 2) {
+    int key = (int)i;
+    bool removed = IntIntMapRemove(intsToInts, key);
+    TLO_ASSERT(removed);
+    TLO_EXPECT(!IntIntMapFind(intsToInts, key));
+  }
+
+  EXPECT_INTINTMAP_PROPERTIES(intsToInts, MAX_MAP_SIZE / 2, false,
+                              &countingAllocator);
+
+  for (size_t i = 1; i < MAX_MAP_SIZE; i += 2) {
+    int key = (int)i;
+    const int *result = IntIntMapFind(intsToInts, key);
+    TLO_EXPECT(result && *result == keyToValue(key));
+
+    bool removed = IntIntMapRemove(intsToInts, key);
+    TLO_ASSERT(removed);
+    TLO_EXPECT(!IntIntMapFind(intsToInts, key));
+  }
+
+  EXPECT_INTINTMAP_PROPERTIES(intsToInts, 0, true, &countingAllocator);
+
+  IntIntMapDelete(intsToInts);
+}
+
+// goes through countingAllocator, but calloc fails while callocFails is true
+static bool callocFails;
+
+static void *failingCallocMalloc(void *context, size_t size) {
+  (void)context;
+  return tloAllocatorMalloc(&countingAllocator, size);
+}
+
+static void failingCallocFree(void *context, void *memory) {
+  (void)context;
+  tloAllocatorFree(&countingAllocator, memory);
+}
+
+static void *failingCallocCalloc(void *context, size_t count, size_t size) {
+  (void)context;
+  if (callocFails) {
+    return NULL;
+  }
+  return tloAllocatorCalloc(&countingAllocator, count, size);
+}
+
+static const TloAllocator failingCallocAllocator = {
+    .malloc = failingCallocMalloc,
+    .free = failingCallocFree,
+    .calloc = failingCallocCalloc};
+
+static void testTSCHTableIntIntInsertFailsIfCantGrow(void) {
+  IntIntMap *intsToInts = IntIntMapMake(&failingCallocAllocator);
+  TLO_ASSERT(intsToInts);
+
+  // the first insert allocates the bucket array, which then has to grow
+  TloError error = IntIntMapInsert(intsToInts, 0, keyToValue(0));
+  TLO_ASSERT(!error);
+
+  callocFails = true;
+  error = IntIntMapInsert(intsToInts, 1, keyToValue(1));
+  callocFails = false;
+  TLO_EXPECT(error == TLO_ERROR);
+  EXPECT_INTINTMAP_PROPERTIES(intsToInts, 1, false, &failingCallocAllocator);
+  TLO_EXPECT(!IntIntMapFind(intsToInts, 1));
+
+  error = IntIntMapInsert(intsToInts, 1, keyToValue(1));
+  TLO_EXPECT(!error);
+  EXPECT_INTINTMAP_PROPERTIES(intsToInts, 2, false, &failingCallocAllocator);
+
+  IntIntMapDelete(intsToInts);
+}
+
+void testTSCHTable(void) {
+  testInitialCounts();
+
+  testTSCHTableIntIntConstructDestruct();
+  testTSCHTableIntIntInsertOnce();
+  testTSCHTableIntIntInsertManyTimes();
+  testTSCHTableIntIntInsertOnceRemoveOnce();
+  testTSCHTableIntIntInsertManyTimesRemoveUntilEmpty();
+  testTSCHTableIntIntInsertFailsIfCantGrow();
+
+  printf("sizeof(IntIntMap): %zu\n", sizeof(IntIntMap));
+  printf("sizeof(IntIntMapNode): %zu\n", sizeof(IntIntMapNode));
+  testFinalCounts();
+  puts("=====================");
+  puts("TSCHTable tests done.");
+  puts("=====================");
+}
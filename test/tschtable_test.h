@@ -0,0 +1,6 @@
+#ifndef TEST_TSCHTABLE_TEST_H
+#define TEST_TSCHTABLE_TEST_H
+
+void testTSCHTable(void);
+
+#endif  // TEST_TSCHTABLE_TEST_H
@@ -0,0 +1,241 @@
+#include "unrolledlist_test.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <tlo/test.h>
+#include <tlo/unrolledlist.h>
+#include "list_test_utils.h"
+#include "util.h"
+
+// small so MAX_LIST_SIZE elements span many nodes
+enum { NODE_CAPACITY = 4 };
+
+#define EXPECT_UNROLLEDLIST_INTS_EQUAL(_ulist1, _ulist2)            \
+  do {                                                              \
+    TLO_EXPECT(tlovListSize(&(_ulist1)->list) ==                    \
+               tlovListSize(&(_ulist2)->list));                     \
+    for (size_t i = 0; i < tlovListSize(&(_ulist1)->list); ++i) {   \
+      const int *elem1 = tlovListElement(&(_ulist1)->list, i);      \
+      const int *elem2 = tlovListElement(&(_ulist2)->list, i);      \
+      TLO_EXPECT(elem1 != elem2);                                   \
+      TLO_EXPECT(*elem1 == *elem2);                                 \
+    }                                                               \
+  } while (0)
+
+static void testUnrolledListIntConstructDestruct(void) {
+  TloUnrolledList ints;
+
+  tloUnrolledListConstruct(&ints, &tloInt, &countingAllocator, 0);
+
+  EXPECT_LIST_PROPERTIES(&ints.list, 0, true, &tloInt, &countingAllocator);
+
+  tlovListDestruct(&ints.list);
+}
+
+static void testUnrolledListIntMakeDelete(void) {
+  TloUnrolledList *ints =
+      tloUnrolledListMake(&tloInt, &countingAllocator, NODE_CAPACITY);
+  TLO_ASSERT(ints);
+
+  EXPECT_LIST_PROPERTIES(&ints->list, 0, true, &tloInt, &countingAllocator);
+
+  tloListDelete(&ints->list);
+}
+
+static void pushBackInts(TloUnrolledList *ints) {
+  for (int i = 0; i < MAX_LIST_SIZE; ++i) {
+    TloError error = tlovListPushBack(&ints->list, &i);
+    TLO_ASSERT(!error);
+  }
+}
+
+static void testUnrolledListIntConstructCopy(void) {
+  TloUnrolledList *ints =
+      tloUnrolledListMake(&tloInt, &countingAllocator, NODE_CAPACITY);
+  TLO_ASSERT(ints);
+  pushBackInts(ints);
+
+  TloUnrolledList *copy = malloc(sizeof(*copy));
+  TLO_ASSERT(copy);
+
+  TloError error = tloUnrolledListConstructCopy(copy, ints);
+  TLO_ASSERT(!error);
+
+  EXPECT_LIST_PROPERTIES(
+      &ints->list, tlovListSize(&copy->list), tlovListIsEmpty(&copy->list),
+      tloListValueType(&copy->list), tloListAllocator(&copy->list));
+  EXPECT_UNROLLEDLIST_INTS_EQUAL(ints, copy);
+
+  tloListDelete(&ints->list);
+  tlovListDestruct(&copy->list);
+  free(copy);
+}
+
+static void testUnrolledListIntMakeCopy(void) {
+  TloUnrolledList *ints =
+      tloUnrolledListMake(&tloInt, &countingAllocator, NODE_CAPACITY);
+  TLO_ASSERT(ints);
+  pushBackInts(ints);
+
+  TloUnrolledList *copy = tloUnrolledListMakeCopy(ints);
+  TLO_ASSERT(copy);
+
+  EXPECT_LIST_PROPERTIES(
+      &ints->list, tlovListSize(&copy->list), tlovListIsEmpty(&copy->list),
+      tloListValueType(&copy->list), tloListAllocator(&copy->list));
+  EXPECT_UNROLLEDLIST_INTS_EQUAL(ints, copy);
+
+  tloListDelete(&ints->list);
+  tloListDelete(&copy->list);
+}
+
+static void testUnrolledListIntCopy(void) {
+  TloUnrolledList *ints =
+      tloUnrolledListMake(&tloInt, &countingAllocator, NODE_CAPACITY);
+  TLO_ASSERT(ints);
+  pushBackInts(ints);
+
+  TloUnrolledList *copy = tloUnrolledListMake(&tloInt, &countingAllocator, 0);
+  TLO_ASSERT(copy);
+  int value = -1;
+  TloError error = tlovListPushBack(&copy->list, &value);
+  TLO_ASSERT(!error);
+
+  error = tloUnrolledListCopy(copy, ints);
+  TLO_ASSERT(!error);
+
+  EXPECT_LIST_PROPERTIES(
+      &ints->list, tlovListSize(&copy->list), tlovListIsEmpty(&copy->list),
+      tloListValueType(&copy->list), tloListAllocator(&copy->list));
+  EXPECT_UNROLLEDLIST_INTS_EQUAL(ints, copy);
+
+  tloListDelete(&ints->list);
+  tloListDelete(&copy->list);
+}
+
+static void testUnrolledListIntTraverseNodes(void) {
+  TloUnrolledList ints;
+  tloUnrolledListConstruct(&ints, &tloInt, &countingAllocator, NODE_CAPACITY);
+
+  // front elements are -MAX_LIST_SIZE to -1, back elements are 0 to
+  // MAX_LIST_SIZE - 1
+  for (int i = 0; i < MAX_LIST_SIZE; ++i) {
+    int value = -i - 1;
+    TloError error = tlovListPushFront(&ints.list, &value);
+    TLO_ASSERT(!error);
+    error = tlovListPushBack(&ints.list, &i);
+    TLO_ASSERT(!error);
+  }
+
+  int expected = -MAX_LIST_SIZE;
+  size_t numNodes = 0;
+  for (const TloUnrolledListNode *node = tloUnrolledListHead(&ints); node;
+       node = tloUnrolledListNodeNext(node)) {
+    size_t nodeSize = tloUnrolledListNodeSize(node);
+    TLO_EXPECT(nodeSize >= 1 && nodeSize <= NODE_CAPACITY);
+
+    for (size_t i = 0; i < nodeSize; ++i) {
+      const int *element = tloUnrolledListNodeElement(&ints, node, i);
+      TLO_EXPECT(*element == expected);
+      ++expected;
+    }
+
+    ++numNodes;
+  }
+
+  TLO_EXPECT(expected == MAX_LIST_SIZE);
+  TLO_EXPECT(numNodes ==
+             2 * ((MAX_LIST_SIZE + NODE_CAPACITY - 1) / NODE_CAPACITY));
+
+  for (const TloUnrolledListNode *node = tloUnrolledListTail(&ints); node;
+       node = tloUnrolledListNodePrev(node)) {
+    --numNodes;
+  }
+  TLO_EXPECT(numNodes == 0);
+
+  tlovListDestruct(&ints.list);
+}
+
+static void testUnrolledListIntPushAndPopAtNodeBoundary(void) {
+  TloUnrolledList ints;
+  tloUnrolledListConstruct(&ints, &tloInt, &countingAllocator, NODE_CAPACITY);
+
+  for (int i = 0; i < NODE_CAPACITY; ++i) {
+    TloError error = tlovListPushBack(&ints.list, &i);
+    TLO_ASSERT(!error);
+  }
+
+  // the emptied node is kept as a spare and reused
+  unsigned long mallocCount = countingAllocatorMallocCount();
+  for (int i = 0; i < MAX_LIST_SIZE; ++i) {
+    TloError error = tlovListPushBack(&ints.list, &i);
+    TLO_ASSERT(!error);
+    tlovListPopBack(&ints.list);
+  }
+  TLO_EXPECT(countingAllocatorMallocCount() - mallocCount == 1);
+
+  EXPECT_LIST_PROPERTIES(&ints.list, NODE_CAPACITY, false, &tloInt,
+                         &countingAllocator);
+  EXPECT_LIST_INT_ELEMENTS(&ints.list, 0, NODE_CAPACITY - 1, 1, 1);
+
+  tlovListDestruct(&ints.list);
+}
+
+static TloList *makeListInt(void) {
+  return (TloList *)tloUnrolledListMake(&tloInt, &countingAllocator,
+                                        NODE_CAPACITY);
+}
+
+static TloList *makeListIntPtr(void) {
+  return (TloList *)tloUnrolledListMake(&intPtrType, &countingAllocator,
+                                        NODE_CAPACITY);
+}
+
+void testUnrolledList(void) {
+  testInitialCounts();
+
+  testUnrolledListIntConstructDestruct();
+  testUnrolledListIntMakeDelete();
+  testUnrolledListIntConstructCopy();
+  testUnrolledListIntMakeCopy();
+  testUnrolledListIntCopy();
+  testUnrolledListIntTraverseNodes();
+  testUnrolledListIntPushAndPopAtNodeBoundary();
+
+  testListHasFunctions(makeListInt(), TLO_LIST_ELEMENT | TLO_LIST_PUSH_FRONT |
+                                          TLO_LIST_POP_FRONT |
+                                          TLO_LIST_POP_BACK);
+
+  testListIntPushBackOnce(makeListInt(), true);
+  testListIntPushBackOnce(makeListInt(), false);
+  testListIntPushBackManyTimes(makeListInt(), true);
+  testListIntPushBackManyTimes(makeListInt(), false);
+  testListIntPushBackOncePopBackOnce(makeListInt());
+  testListIntPushBackManyTimesPopBackUntilEmpty(makeListInt());
+  testListIntPushFrontOnce(makeListInt(), true);
+  testListIntPushFrontOnce(makeListInt(), false);
+  testListIntPushFrontManyTimes(makeListInt(), true);
+  testListIntPushFrontManyTimes(makeListInt(), false);
+  testListIntPushFrontOncePopFrontOnce(makeListInt());
+  testListIntPushFrontManyTimesPopFrontUntilEmpty(makeListInt());
+  testListIntSort(makeListInt());
+
+  testListIntPtrPushBackOnce(makeListIntPtr(), true);
+  testListIntPtrPushBackOnce(makeListIntPtr(), false);
+  testListIntPtrPushBackManyTimes(makeListIntPtr(), true);
+  testListIntPtrPushBackManyTimes(makeListIntPtr(), false);
+  testListIntPtrPushBackOncePopBackOnce(makeListIntPtr());
+  testListIntPtrPushBackManyTimesPopBackUntilEmpty(makeListIntPtr());
+  testListIntPtrPushFrontOnce(makeListIntPtr(), true);
+  testListIntPtrPushFrontOnce(makeListIntPtr(), false);
+  testListIntPtrPushFrontManyTimes(makeListIntPtr(), true);
+  testListIntPtrPushFrontManyTimes(makeListIntPtr(), false);
+  testListIntPtrPushFrontOncePopFrontOnce(makeListIntPtr());
+  testListIntPtrPushFrontManyTimesPopFrontUntilEmpty(makeListIntPtr());
+
+  printf("sizeof(TloUnrolledList): %zu\n", sizeof(TloUnrolledList));
+  printf("sizeof(TloUnrolledListNode): %zu\n", sizeof(TloUnrolledListNode));
+  testFinalCounts();
+  puts("========================");
+  puts("UnrolledList tests done.");
+  puts("========================");
+}
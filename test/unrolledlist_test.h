@@ -0,0 +1,6 @@
+#ifndef TEST_UNROLLEDLIST_TEST_H
+#define TEST_UNROLLEDLIST_TEST_H
+
+void testUnrolledList(void);
+
+#endif  // TEST_UNROLLEDLIST_TEST_H
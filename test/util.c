@@ -2,13 +2,15 @@
 #include <assert.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <tlo/test.h>
 
 static unsigned long mallocCount = 0;
 static unsigned long freeCount = 0;
 static unsigned long totalByteCount = 0;
 
-static void *countingAllocatorMalloc(size_t size) {
+static void *countingAllocatorMalloc(void *context, size_t size) {
+  (void)context;
   ++mallocCount;
   void *memory = malloc(size);
   if (memory) {
@@ -17,13 +19,216 @@ static void *countingAllocatorMalloc(size_t size) {
   return memory;
 }
 
-static void countingAllocatorFree(void *memory) {
+static void countingAllocatorFree(void *context, void *memory) {
+  (void)context;
   ++freeCount;
   free(memory);
 }
 
-const TloAllocator countingAllocator = {.malloc = countingAllocatorMalloc,
-                                        .free = countingAllocatorFree};
+static void countingAllocatorSizedFree(void *context, void *memory,
+                                       size_t size) {
+  (void)size;
+  countingAllocatorFree(context, memory);
+}
+
+const TloAllocator countingAllocator = {
+    .malloc = countingAllocatorMalloc,
+    .free = countingAllocatorFree,
+    .sizedFree = countingAllocatorSizedFree};
+
+/*
+ * - the recording allocators count the calls to each of their functions in
+ *   the AllocationRecord they get as their context, so the counts only add up
+ *   if the tloAllocator functions pass allocator->context through
+ * - malloc fills memory with 0xAA, so memory that should be zeroed but isn't
+ *   shows up
+ */
+typedef struct AllocationRecord {
+  unsigned long mallocCount;
+  unsigned long freeCount;
+  unsigned long reallocCount;
+  unsigned long callocCount;
+  unsigned long sizedFreeCount;
+  size_t lastSize;
+} AllocationRecord;
+
+static void *recordingMalloc(void *context, size_t size) {
+  AllocationRecord *record = context;
+  ++record->mallocCount;
+  record->lastSize = size;
+  void *memory = malloc(size);
+  if (memory) {
+    memset(memory, 0xAA, size);
+  }
+  return memory;
+}
+
+static void recordingFree(void *context, void *memory) {
+  AllocationRecord *record = context;
+  ++record->freeCount;
+  free(memory);
+}
+
+static void *recordingRealloc(void *context, void *memory, size_t size,
+                              size_t newSize) {
+  AllocationRecord *record = context;
+  ++record->reallocCount;
+  record->lastSize = size;
+  return realloc(memory, newSize);
+}
+
+static void *recordingCalloc(void *context, size_t count, size_t size) {
+  AllocationRecord *record = context;
+  ++record->callocCount;
+  record->lastSize = count * size;
+  return calloc(count, size);
+}
+
+static void recordingSizedFree(void *context, void *memory, size_t size) {
+  AllocationRecord *record = context;
+  ++record->sizedFreeCount;
+  record->lastSize = size;
+  free(memory);
+}
+
+static bool isZeroed(const unsigned char *memory, size_t size) {
+  for (size_t i = 0; i < size; ++i) {
+    if (memory[i]) {
+      return false;
+    }
+  }
+  return true;
+}
+
+static void testAllocatorCallsHooksWithContext(void) {
+  AllocationRecord record = {0};
+  const TloAllocator allocator = {.context = &record,
+                                  .malloc = recordingMalloc,
+                                  .free = recordingFree,
+                                  .realloc = recordingRealloc,
+                                  .calloc = recordingCalloc,
+                                  .sizedFree = recordingSizedFree};
+
+  unsigned char *memory = tloAllocatorMalloc(&allocator, 8);
+  TLO_ASSERT(memory);
+  TLO_EXPECT(record.mallocCount == 1);
+  TLO_EXPECT(record.lastSize == 8);
+  memory[7] = 42;
+
+  unsigned char *newMemory = tloAllocatorRealloc(&allocator, memory, 8, 16);
+  TLO_EXPECT(record.reallocCount == 1);
+  TLO_EXPECT(record.lastSize == 8);
+  TLO_EXPECT(record.mallocCount == 1);
+  TLO_ASSERT(newMemory);
+  TLO_EXPECT(newMemory[7] == 42);
+
+  tloAllocatorSizedFree(&allocator, newMemory, 16);
+  TLO_EXPECT(record.sizedFreeCount == 1);
+  TLO_EXPECT(record.lastSize == 16);
+  TLO_EXPECT(record.freeCount == 0);
+
+  memory = tloAllocatorMallocAndZeroInitialize(&allocator, 8);
+  TLO_ASSERT(memory);
+  TLO_EXPECT(record.callocCount == 1);
+  TLO_EXPECT(record.mallocCount == 1);
+  TLO_EXPECT(isZeroed(memory, 8));
+
+  tloAllocatorFree(&allocator, memory);
+  TLO_EXPECT(record.freeCount == 1);
+  TLO_EXPECT(record.sizedFreeCount == 1);
+}
+
+static void testAllocatorFallsBackToMallocAndFree(void) {
+  AllocationRecord record = {0};
+  const TloAllocator allocator = {
+      .context = &record, .malloc = recordingMalloc, .free = recordingFree};
+
+  unsigned char *memory = tloAllocatorMalloc(&allocator, 8);
+  TLO_ASSERT(memory);
+  for (unsigned char i = 0; i < 8; ++i) {
+    memory[i] = i;
+  }
+
+  // grows with malloc, memcpy, then free
+  unsigned char *newMemory = tloAllocatorRealloc(&allocator, memory, 8, 16);
+  TLO_ASSERT(newMemory);
+  TLO_EXPECT(record.mallocCount == 2);
+  TLO_EXPECT(record.lastSize == 16);
+  TLO_EXPECT(record.freeCount == 1);
+  for (unsigned char i = 0; i < 8; ++i) {
+    TLO_EXPECT(newMemory[i] == i);
+  }
+
+  // shrinks the same way, copying only what fits
+  memory = tloAllocatorRealloc(&allocator, newMemory, 16, 4);
+  TLO_ASSERT(memory);
+  TLO_EXPECT(record.mallocCount == 3);
+  TLO_EXPECT(record.freeCount == 2);
+  for (unsigned char i = 0; i < 4; ++i) {
+    TLO_EXPECT(memory[i] == i);
+  }
+
+  tloAllocatorSizedFree(&allocator, memory, 4);
+  TLO_EXPECT(record.freeCount == 3);
+
+  memory = tloAllocatorMallocAndZeroInitialize(&allocator, 8);
+  TLO_ASSERT(memory);
+  TLO_EXPECT(record.mallocCount == 4);
+  TLO_EXPECT(isZeroed(memory, 8));
+
+  tloAllocatorFree(&allocator, memory);
+  TLO_EXPECT(record.freeCount == 4);
+  TLO_EXPECT(record.mallocCount == record.freeCount);
+}
+
+static void testAllocatorCalloc(void) {
+  AllocationRecord record = {0};
+  const TloAllocator allocator = {.context = &record,
+                                  .malloc = recordingMalloc,
+                                  .free = recordingFree,
+                                  .calloc = recordingCalloc};
+
+  unsigned char *memory = tloAllocatorCalloc(&allocator, 3, 5);
+  TLO_ASSERT(memory);
+  TLO_EXPECT(record.callocCount == 1);
+  TLO_EXPECT(record.lastSize == 15);
+  TLO_EXPECT(record.mallocCount == 0);
+  TLO_EXPECT(isZeroed(memory, 15));
+  tloAllocatorFree(&allocator, memory);
+
+  // without a calloc hook, mallocs count * size bytes and zeroes them
+  AllocationRecord fallbackRecord = {0};
+  const TloAllocator fallbackAllocator = {.context = &fallbackRecord,
+                                          .malloc = recordingMalloc,
+                                          .free = recordingFree};
+
+  memory = tloAllocatorCalloc(&fallbackAllocator, 3, 5);
+  TLO_ASSERT(memory);
+  TLO_EXPECT(fallbackRecord.mallocCount == 1);
+  TLO_EXPECT(fallbackRecord.lastSize == 15);
+  TLO_EXPECT(isZeroed(memory, 15));
+  tloAllocatorFree(&fallbackAllocator, memory);
+
+  // count * size wraps around to 0, so this must fail without calling malloc
+  memory = tloAllocatorCalloc(&fallbackAllocator, SIZE_MAX / 2 + 1, 2);
+  TLO_EXPECT(!memory);
+  TLO_EXPECT(fallbackRecord.mallocCount == 1);
+
+  memory = tloAllocatorCalloc(&fallbackAllocator, 2, SIZE_MAX / 2 + 2);
+  TLO_EXPECT(!memory);
+  TLO_EXPECT(fallbackRecord.mallocCount == 1);
+  TLO_EXPECT(fallbackRecord.freeCount == 1);
+}
+
+void testAllocator(void) {
+  testAllocatorCallsHooksWithContext();
+  testAllocatorFallsBackToMallocAndFree();
+  testAllocatorCalloc();
+
+  puts("=====================");
+  puts("Allocator tests done.");
+  puts("=====================");
+}
 
 void countingAllocatorResetCounts(void) {
   mallocCount = 0;
@@ -58,7 +263,7 @@ void testFinalCounts(void) {
 }
 
 int *makeInt(int value) {
-  int *i = countingAllocatorMalloc(sizeof(*i));
+  int *i = countingAllocatorMalloc(NULL, sizeof(*i));
   if (!i) {
     return NULL;
   }
@@ -95,13 +300,13 @@ TloError intPtrConstructCopy(IntPtr *ptr, const IntPtr *other) {
 }
 
 IntPtr *intPtrMake(int value) {
-  IntPtr *ptr = countingAllocatorMalloc(sizeof(*ptr));
+  IntPtr *ptr = countingAllocatorMalloc(NULL, sizeof(*ptr));
   if (!ptr) {
     return NULL;
   }
 
   if (intPtrConstruct(ptr, value) != TLO_SUCCESS) {
-    countingAllocatorFree(ptr);
+    countingAllocatorFree(NULL, ptr);
     return NULL;
   }
 
@@ -12,6 +12,9 @@ void countingAllocatorPrintCounts(void);
 void testInitialCounts(void);
 void testFinalCounts(void);
 
+// tests the tloAllocator functions with allocators that record their calls
+void testAllocator(void);
+
 int *makeInt(int value);
 
 typedef struct IntPtr {